@@ -20,19 +20,30 @@
 // Include container modules.
 #include "containers/binary_tree.h"
 #include "containers/bitset.h"
+#include "containers/btree_map.h"
+#include "containers/concurrent_map.h"
 #include "containers/doubly_list.h"
 #include "containers/hash_map.h"
+#include "containers/mpmc_queue.h"
+#include "containers/pairing_heap.h"
+#include "containers/priority_queue.h"
 #include "containers/ring_list.h"
 #include "containers/singly_list.h"
 #include "containers/sort.h"
 #include "containers/stack_list.h"
+#include "containers/swiss_map.h"
 #include "containers/tree.h"
+#include "containers/typed_array.h"
+#include "containers/typed_heap.h"
+#include "containers/typed_map.h"
+#include "containers/typed_sort.h"
 
 // Include memory modules.
 #include "memory/allocator.h"
 #include "memory/arena.h"
 #include "memory/buffer.h"
 #include "memory/heap.h"
+#include "memory/heap_cache.h"
 #include "memory/memops.h"
 #include "memory/pool.h"
 #include "memory/ring.h"
@@ -118,7 +129,10 @@
 // Include threading modules.
 #include "threads/atomics.h"
 #include "threads/condvar.h"
+#include "threads/futex.h"
+#include "threads/job_system.h"
 #include "threads/mutex.h"
+#include "threads/parallel.h"
 #include "threads/rwlock.h"
 #include "threads/semaphore.h"
 #include "threads/spinlock.h"
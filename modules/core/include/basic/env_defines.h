@@ -66,6 +66,14 @@
 #  define ARCH_32
 #endif
 
+// Size of a CPU cache line. Data written by different threads is padded to this
+// size so that the threads do not invalidate each other's lines.
+#if defined(ARCH_ARM64) && defined(PLATFORM_MACOS)
+#  define ARCH_CACHE_LINE_SIZE 128
+#else
+#  define ARCH_CACHE_LINE_SIZE 64
+#endif
+
 // =========================================================================
 // Build Configuration
 // =========================================================================
@@ -9,6 +9,9 @@
 // This is the max number of iterations a safe loop can perform.
 // These loops are capped to a high value so that we can catch infinite loops.
 // Once the iteration count hits, an assertion is triggered.
+// Use them for loops with a small structural bound (retries, probe sequences,
+// tree depth). Loops whose trip count grows with the data, such as walks over
+// element arrays, tables or free lists, are written as plain for/while.
 #define SAFE_LOOP_MAX_ITERATION_COUNT 10000
 
 // You can define UNSAFE if you want to disable these.
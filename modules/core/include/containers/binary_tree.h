@@ -104,13 +104,13 @@ Example:
     })
 
 // Mutation helpers.
-#define BINARY_TREE_INSERT_LEFT(parent, node) stmt( \
-    (node)->parent = (parent);                      \
-    (parent)->left = (node);)
+#define BINARY_TREE_INSERT_LEFT(parent_node, node) stmt( \
+    (node)->parent = (parent_node);                      \
+    (parent_node)->left = (node);)
 
-#define BINARY_TREE_INSERT_RIGHT(parent, node) stmt( \
-    (node)->parent = (parent);                       \
-    (parent)->right = (node);)
+#define BINARY_TREE_INSERT_RIGHT(parent_node, node) stmt( \
+    (node)->parent = (parent_node);                       \
+    (parent_node)->right = (node);)
 
 #define BINARY_TREE_REMOVE(root_ptr, node) stmt( \
     if ((node)->parent == NULL) {                \
@@ -152,6 +152,48 @@ Example:
     } _left->right = (node);                           \
     (node)->parent = _left;)
 
+// Binary search helpers for ordered trees, red-black or not. compare_key(key, node)
+// returns <0, 0 or >0 when key orders before, equal to or after node.
+// BINARY_TREE_FIND yields the node equal to key; BINARY_TREE_LOWER_BOUND yields the
+// leftmost node that does not order before key. Both yield NULL when there is none.
+#define BINARY_TREE_FIND(root, key, compare_key, out) stmt(        \
+    (out) = (root);                                                \
+    safe_while ((out) != NULL) {                                   \
+      i32 _binary_tree_order = compare_key((key), (out));          \
+      if (_binary_tree_order == 0) {                               \
+        break;                                                     \
+      }                                                            \
+      (out) = _binary_tree_order < 0 ? (out)->left : (out)->right; \
+    })
+
+#define BINARY_TREE_LOWER_BOUND(root, key, compare_key, out) stmt( \
+    type_of((root)) _binary_tree_cursor = (root);                  \
+    (out) = NULL;                                                  \
+    safe_while (_binary_tree_cursor != NULL) {                     \
+      if (compare_key((key), _binary_tree_cursor) <= 0) {          \
+        (out) = _binary_tree_cursor;                               \
+        _binary_tree_cursor = _binary_tree_cursor->left;           \
+      } else {                                                     \
+        _binary_tree_cursor = _binary_tree_cursor->right;          \
+      }                                                            \
+    })
+
+// Puts new_node (which may be NULL) in old_node's place under old_node's parent, or
+// at the root. Only the links between the parent and the two nodes change.
+#define BINARY_TREE_REPLACE(root_ptr, old_node, new_node) stmt(      \
+    type_of((old_node)) _binary_tree_old = (old_node);               \
+    type_of((old_node)) _binary_tree_new = (new_node);               \
+    if (_binary_tree_old->parent == NULL) {                          \
+      *(root_ptr) = _binary_tree_new;                                \
+    } else if (_binary_tree_old == _binary_tree_old->parent->left) { \
+      _binary_tree_old->parent->left = _binary_tree_new;             \
+    } else {                                                         \
+      _binary_tree_old->parent->right = _binary_tree_new;            \
+    }                                                                \
+    if (_binary_tree_new != NULL) {                                  \
+      _binary_tree_new->parent = _binary_tree_old->parent;           \
+    })
+
 // Typed traversal macros.
 #define BINARY_TREE_FOREACH_PREORDER(root, it)           \
   safe_for (type_of(((root))) it = (root); (it) != NULL; \
@@ -167,6 +209,216 @@ Example:
             (it) != NULL;                       \
             (it) = ({ type_of((root)) _binary_tree_next = NULL; BINARY_TREE_NEXT_POSTORDER((root), (it), _binary_tree_next); _binary_tree_next; }))
 
+// =========================================================================
+// Red-Black Tree
+// =========================================================================
+
+/*
+BINARY_TREE_RB_* keep an intrusive binary tree balanced as a red-black tree, so
+find, insert and remove stay O(log n) even for sorted insertion orders. On top of
+`left`, `right` and `parent`, each node needs an integer `color` member. Nodes are
+never allocated or freed by the macros; root_ptr points at the caller's root
+pointer, which starts out NULL. Equal keys are allowed and insert after their
+equals, so in-order traversal keeps insertion order among them.
+
+Example:
+
+  typedef struct timer_node {
+    struct timer_node* left;
+    struct timer_node* right;
+    struct timer_node* parent;
+    u8 color;
+    u64 deadline;
+  } timer_node;
+
+  func i32 timer_compare(timer_node const* lhs, timer_node const* rhs) {
+    return lhs->deadline < rhs->deadline ? -1 : lhs->deadline > rhs->deadline;
+  }
+
+  timer_node* timers = NULL;
+  BINARY_TREE_RB_INSERT(&timers, &timer, timer_compare);
+
+  timer_node* next_due = NULL;
+  BINARY_TREE_FIRST_INORDER(timers, next_due);
+  BINARY_TREE_RB_REMOVE(&timers, next_due);
+*/
+
+#define BINARY_TREE_RB_BLACK 0
+#define BINARY_TREE_RB_RED   1
+
+#define BINARY_TREE_RB_IS_RED(node) ((node) != NULL && (node)->color == BINARY_TREE_RB_RED)
+
+// Restores the red-black properties after node was linked in as a leaf, for callers
+// that find the insert position themselves and link it with BINARY_TREE_INSERT_LEFT/RIGHT.
+#define BINARY_TREE_RB_INSERT_FIXUP(root_ptr, node) stmt(                     \
+    type_of((node)) _binary_tree_rb_node = (node);                            \
+    _binary_tree_rb_node->color = BINARY_TREE_RB_RED;                         \
+    safe_while (BINARY_TREE_RB_IS_RED(_binary_tree_rb_node->parent)) {        \
+      type_of((node)) _binary_tree_rb_parent = _binary_tree_rb_node->parent;  \
+      type_of((node)) _binary_tree_rb_grand = _binary_tree_rb_parent->parent; \
+      if (_binary_tree_rb_parent == _binary_tree_rb_grand->left) {            \
+        type_of((node)) _binary_tree_rb_uncle = _binary_tree_rb_grand->right; \
+        if (BINARY_TREE_RB_IS_RED(_binary_tree_rb_uncle)) {                   \
+          _binary_tree_rb_parent->color = BINARY_TREE_RB_BLACK;               \
+          _binary_tree_rb_uncle->color = BINARY_TREE_RB_BLACK;                \
+          _binary_tree_rb_grand->color = BINARY_TREE_RB_RED;                  \
+          _binary_tree_rb_node = _binary_tree_rb_grand;                       \
+          continue;                                                           \
+        }                                                                     \
+        if (_binary_tree_rb_node == _binary_tree_rb_parent->right) {          \
+          _binary_tree_rb_node = _binary_tree_rb_parent;                      \
+          BINARY_TREE_ROTATE_LEFT((root_ptr), _binary_tree_rb_node);          \
+          _binary_tree_rb_parent = _binary_tree_rb_node->parent;              \
+        }                                                                     \
+        _binary_tree_rb_parent->color = BINARY_TREE_RB_BLACK;                 \
+        _binary_tree_rb_grand->color = BINARY_TREE_RB_RED;                    \
+        BINARY_TREE_ROTATE_RIGHT((root_ptr), _binary_tree_rb_grand);          \
+      } else {                                                                \
+        type_of((node)) _binary_tree_rb_uncle = _binary_tree_rb_grand->left;  \
+        if (BINARY_TREE_RB_IS_RED(_binary_tree_rb_uncle)) {                   \
+          _binary_tree_rb_parent->color = BINARY_TREE_RB_BLACK;               \
+          _binary_tree_rb_uncle->color = BINARY_TREE_RB_BLACK;                \
+          _binary_tree_rb_grand->color = BINARY_TREE_RB_RED;                  \
+          _binary_tree_rb_node = _binary_tree_rb_grand;                       \
+          continue;                                                           \
+        }                                                                     \
+        if (_binary_tree_rb_node == _binary_tree_rb_parent->left) {           \
+          _binary_tree_rb_node = _binary_tree_rb_parent;                      \
+          BINARY_TREE_ROTATE_RIGHT((root_ptr), _binary_tree_rb_node);         \
+          _binary_tree_rb_parent = _binary_tree_rb_node->parent;              \
+        }                                                                     \
+        _binary_tree_rb_parent->color = BINARY_TREE_RB_BLACK;                 \
+        _binary_tree_rb_grand->color = BINARY_TREE_RB_RED;                    \
+        BINARY_TREE_ROTATE_LEFT((root_ptr), _binary_tree_rb_grand);           \
+      }                                                                       \
+    }                                                                         \
+    (*(root_ptr))->color = BINARY_TREE_RB_BLACK;)
+
+// Links node into the tree ordered by compare(lhs_node, rhs_node), which returns <0,
+// 0 or >0 like sort_compare_fn, then rebalances. node's links are overwritten.
+#define BINARY_TREE_RB_INSERT(root_ptr, node, compare) stmt(                                               \
+    type_of((node)) _binary_tree_rb_new = (node);                                                          \
+    type_of((node)) _binary_tree_rb_at = *(root_ptr);                                                      \
+    type_of((node)) _binary_tree_rb_above = NULL;                                                          \
+    b32 _binary_tree_rb_go_left = false;                                                                   \
+    safe_while (_binary_tree_rb_at != NULL) {                                                              \
+      _binary_tree_rb_above = _binary_tree_rb_at;                                                          \
+      _binary_tree_rb_go_left = compare(_binary_tree_rb_new, _binary_tree_rb_at) < 0;                      \
+      _binary_tree_rb_at = _binary_tree_rb_go_left ? _binary_tree_rb_at->left : _binary_tree_rb_at->right; \
+    }                                                                                                      \
+    _binary_tree_rb_new->left = NULL;                                                                      \
+    _binary_tree_rb_new->right = NULL;                                                                     \
+    _binary_tree_rb_new->parent = _binary_tree_rb_above;                                                   \
+    if (_binary_tree_rb_above == NULL) {                                                                   \
+      *(root_ptr) = _binary_tree_rb_new;                                                                   \
+    } else if (_binary_tree_rb_go_left) {                                                                  \
+      _binary_tree_rb_above->left = _binary_tree_rb_new;                                                   \
+    } else {                                                                                               \
+      _binary_tree_rb_above->right = _binary_tree_rb_new;                                                  \
+    }                                                                                                      \
+    BINARY_TREE_RB_INSERT_FIXUP((root_ptr), _binary_tree_rb_new);)
+
+// Unlinks node from the tree and rebalances. node must be in the tree; its links
+// are cleared afterwards so it can be inserted again.
+#define BINARY_TREE_RB_REMOVE(root_ptr, node) stmt(                                                                        \
+    type_of((node)) _binary_tree_rb_gone = (node);                                                                         \
+    type_of((node)) _binary_tree_rb_fix = NULL;                                                                            \
+    type_of((node)) _binary_tree_rb_fix_parent = NULL;                                                                     \
+    i32 _binary_tree_rb_gone_color = _binary_tree_rb_gone->color;                                                          \
+    if (_binary_tree_rb_gone->left == NULL || _binary_tree_rb_gone->right == NULL) {                                       \
+      _binary_tree_rb_fix = _binary_tree_rb_gone->left != NULL ? _binary_tree_rb_gone->left : _binary_tree_rb_gone->right; \
+      _binary_tree_rb_fix_parent = _binary_tree_rb_gone->parent;                                                           \
+      BINARY_TREE_REPLACE((root_ptr), _binary_tree_rb_gone, _binary_tree_rb_fix);                                          \
+    } else {                                                                                                               \
+      /* Two children: the in-order successor takes node's place and color. */                                             \
+      type_of((node)) _binary_tree_rb_next = _binary_tree_rb_gone->right;                                                  \
+      safe_while (_binary_tree_rb_next->left != NULL) {                                                                    \
+        _binary_tree_rb_next = _binary_tree_rb_next->left;                                                                 \
+      }                                                                                                                    \
+      _binary_tree_rb_gone_color = _binary_tree_rb_next->color;                                                            \
+      _binary_tree_rb_fix = _binary_tree_rb_next->right;                                                                   \
+      if (_binary_tree_rb_next->parent == _binary_tree_rb_gone) {                                                          \
+        _binary_tree_rb_fix_parent = _binary_tree_rb_next;                                                                 \
+      } else {                                                                                                             \
+        _binary_tree_rb_fix_parent = _binary_tree_rb_next->parent;                                                         \
+        BINARY_TREE_REPLACE((root_ptr), _binary_tree_rb_next, _binary_tree_rb_next->right);                                \
+        _binary_tree_rb_next->right = _binary_tree_rb_gone->right;                                                         \
+        _binary_tree_rb_next->right->parent = _binary_tree_rb_next;                                                        \
+      }                                                                                                                    \
+      BINARY_TREE_REPLACE((root_ptr), _binary_tree_rb_gone, _binary_tree_rb_next);                                         \
+      _binary_tree_rb_next->left = _binary_tree_rb_gone->left;                                                             \
+      _binary_tree_rb_next->left->parent = _binary_tree_rb_next;                                                           \
+      _binary_tree_rb_next->color = _binary_tree_rb_gone->color;                                                           \
+    }                                                                                                                      \
+    _binary_tree_rb_gone->left = NULL;                                                                                     \
+    _binary_tree_rb_gone->right = NULL;                                                                                    \
+    _binary_tree_rb_gone->parent = NULL;                                                                                   \
+    if (_binary_tree_rb_gone_color == BINARY_TREE_RB_BLACK) {                                                              \
+      BINARY_TREE_RB_REMOVE_FIXUP((root_ptr), _binary_tree_rb_fix, _binary_tree_rb_fix_parent);                            \
+    })
+
+// Removal rebalancing behind BINARY_TREE_RB_REMOVE. node carries an extra black and
+// may be NULL, which is why its parent is passed separately.
+#define BINARY_TREE_RB_REMOVE_FIXUP(root_ptr, node, node_parent) stmt(                                             \
+    type_of((node_parent)) _binary_tree_rb_x = (node);                                                             \
+    type_of((node_parent)) _binary_tree_rb_xp = (node_parent);                                                     \
+    safe_while (_binary_tree_rb_x != *(root_ptr) && !BINARY_TREE_RB_IS_RED(_binary_tree_rb_x)) {                   \
+      if (_binary_tree_rb_x == _binary_tree_rb_xp->left) {                                                         \
+        type_of((node_parent)) _binary_tree_rb_w = _binary_tree_rb_xp->right;                                      \
+        if (BINARY_TREE_RB_IS_RED(_binary_tree_rb_w)) {                                                            \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_BLACK;                                                         \
+          _binary_tree_rb_xp->color = BINARY_TREE_RB_RED;                                                          \
+          BINARY_TREE_ROTATE_LEFT((root_ptr), _binary_tree_rb_xp);                                                 \
+          _binary_tree_rb_w = _binary_tree_rb_xp->right;                                                           \
+        }                                                                                                          \
+        if (!BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->left) && !BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->right)) { \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_RED;                                                           \
+          _binary_tree_rb_x = _binary_tree_rb_xp;                                                                  \
+          _binary_tree_rb_xp = _binary_tree_rb_x->parent;                                                          \
+          continue;                                                                                                \
+        }                                                                                                          \
+        if (!BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->right)) {                                                    \
+          _binary_tree_rb_w->left->color = BINARY_TREE_RB_BLACK;                                                   \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_RED;                                                           \
+          BINARY_TREE_ROTATE_RIGHT((root_ptr), _binary_tree_rb_w);                                                 \
+          _binary_tree_rb_w = _binary_tree_rb_xp->right;                                                           \
+        }                                                                                                          \
+        _binary_tree_rb_w->color = _binary_tree_rb_xp->color;                                                      \
+        _binary_tree_rb_xp->color = BINARY_TREE_RB_BLACK;                                                          \
+        _binary_tree_rb_w->right->color = BINARY_TREE_RB_BLACK;                                                    \
+        BINARY_TREE_ROTATE_LEFT((root_ptr), _binary_tree_rb_xp);                                                   \
+      } else {                                                                                                     \
+        type_of((node_parent)) _binary_tree_rb_w = _binary_tree_rb_xp->left;                                       \
+        if (BINARY_TREE_RB_IS_RED(_binary_tree_rb_w)) {                                                            \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_BLACK;                                                         \
+          _binary_tree_rb_xp->color = BINARY_TREE_RB_RED;                                                          \
+          BINARY_TREE_ROTATE_RIGHT((root_ptr), _binary_tree_rb_xp);                                                \
+          _binary_tree_rb_w = _binary_tree_rb_xp->left;                                                            \
+        }                                                                                                          \
+        if (!BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->left) && !BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->right)) { \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_RED;                                                           \
+          _binary_tree_rb_x = _binary_tree_rb_xp;                                                                  \
+          _binary_tree_rb_xp = _binary_tree_rb_x->parent;                                                          \
+          continue;                                                                                                \
+        }                                                                                                          \
+        if (!BINARY_TREE_RB_IS_RED(_binary_tree_rb_w->left)) {                                                     \
+          _binary_tree_rb_w->right->color = BINARY_TREE_RB_BLACK;                                                  \
+          _binary_tree_rb_w->color = BINARY_TREE_RB_RED;                                                           \
+          BINARY_TREE_ROTATE_LEFT((root_ptr), _binary_tree_rb_w);                                                  \
+          _binary_tree_rb_w = _binary_tree_rb_xp->left;                                                            \
+        }                                                                                                          \
+        _binary_tree_rb_w->color = _binary_tree_rb_xp->color;                                                      \
+        _binary_tree_rb_xp->color = BINARY_TREE_RB_BLACK;                                                          \
+        _binary_tree_rb_w->left->color = BINARY_TREE_RB_BLACK;                                                     \
+        BINARY_TREE_ROTATE_RIGHT((root_ptr), _binary_tree_rb_xp);                                                  \
+      }                                                                                                            \
+      _binary_tree_rb_x = *(root_ptr);                                                                             \
+      break;                                                                                                       \
+    }                                                                                                              \
+    if (_binary_tree_rb_x != NULL) {                                                                               \
+      _binary_tree_rb_x->color = BINARY_TREE_RB_BLACK;                                                             \
+    })
+
 // =========================================================================
 c_end;
 // =========================================================================
@@ -0,0 +1,142 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/env_defines.h"
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "memory/allocator.h"
+#include "memory/pool.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// Keys per node. Leaves hold as many values, internal nodes one more child.
+// 30 keys make a node 504 bytes, which the pool pads to eight 64-byte cache lines.
+#define BTREE_MAP_NODE_KEYS 30
+
+// Minimum fill of every non-root node after a removal.
+#define BTREE_MAP_LEAF_MIN_KEYS     (BTREE_MAP_NODE_KEYS / 2)
+#define BTREE_MAP_INTERNAL_MIN_KEYS ((BTREE_MAP_NODE_KEYS - 1) / 2)
+
+// Deepest tree the fixed descent path can describe. With at least 15 children
+// per internal node this is far beyond any addressable key count.
+#define BTREE_MAP_MAX_HEIGHT 16
+
+// One node of the tree. keys[] is searched in both kinds of node; slots[] holds
+// the values of a leaf or the count + 1 children of an internal node. Leaves are
+// linked in key order so scans never walk back up the tree.
+typedef struct btree_map_node {
+  u16 count;
+  b16 is_leaf;
+  u32 reserved;
+  struct btree_map_node* next;  // Next leaf in key order; unused for internal nodes.
+  u64 keys[BTREE_MAP_NODE_KEYS];
+  void* slots[BTREE_MAP_NODE_KEYS + 1];
+} btree_map_node;
+
+typedef struct btree_map {
+  pool nodes;  // Every node comes from here, cache-line aligned.
+  btree_map_node* root;
+  btree_map_node* first_leaf;
+  sz count;
+  u32 height;  // 0 when empty, 1 when the root is a leaf.
+} btree_map;
+
+// Position of one entry; invalid once leaf is NULL. Any insert or removal
+// invalidates every iterator of the map.
+typedef struct btree_map_iter {
+  btree_map_node* leaf;
+  u32 idx;
+} btree_map_iter;
+
+// Callback for btree_map_range. Return false to stop the scan early.
+typedef b32 btree_map_visit_fn(u64 key, void* value, void* user_data);
+
+/*
+btree_map is an ordered u64 -> void* map. It is a B+tree: all entries live in
+the leaves, internal nodes only route lookups, and each node spans several
+whole cache lines so a lookup touches few of them. Nodes are allocated from a
+pool, so inserts and removals never go to the general-purpose allocator for
+single nodes. Prefer hash_map for pure point lookups; use btree_map when keys
+must come out in order or when ranges of keys are queried.
+
+Example:
+
+  btree_map timeline = btree_map_create((allocator){0});
+  btree_map_set(&timeline, frame_index, event_ptr);
+
+  // All events between frames 100 and 199, in order.
+  btree_map_iter it = btree_map_lower_bound(&timeline, 100);
+  for (; btree_map_iter_valid(it) && btree_map_iter_key(it) < 200; btree_map_iter_next(&it)) {
+    void* event = btree_map_iter_value(it);
+  }
+
+  BTREE_MAP_FOREACH(&timeline, entry) {
+    // btree_map_iter_key(entry), btree_map_iter_value(entry)
+  }
+
+  btree_map_destroy(&timeline);
+*/
+
+// Lifecycle.
+// Nodes are carved from pool blocks obtained from alloc; a zeroed allocator
+// falls back to the thread, then the global allocator.
+func btree_map btree_map_create(allocator alloc);
+func void btree_map_destroy(btree_map* map);
+
+// Removes every entry. Node memory stays in the pool for reuse.
+func void btree_map_clear(btree_map* map);
+
+// Occupancy.
+func sz btree_map_count(btree_map const* map);
+func u32 btree_map_height(btree_map const* map);
+
+// Key/value operations. O(log n).
+// set inserts or replaces; it returns false only when a node allocation fails.
+func b32 btree_map_set(btree_map* map, u64 key, void* value);
+func void* btree_map_get(btree_map* map, u64 key);
+func b32 btree_map_has(btree_map* map, u64 key);
+func b32 btree_map_remove(btree_map* map, u64 key);
+
+// Builds the tree bottom-up from count entries with strictly ascending keys,
+// filling every leaf, which is much faster than count calls to btree_map_set.
+// values may be NULL to store NULL for every key.
+// Returns false, leaving the map untouched, when the map is not empty or the
+// keys are not strictly ascending; also false when a node allocation fails,
+// in which case the map is left empty.
+func b32 btree_map_bulk_load(btree_map* map, u64 const* keys, void* const* values, sz count);
+
+// Ordered access.
+// first is the smallest entry, lower_bound the first entry with a key >= key,
+// and upper_bound the first entry with a key > key. Each returns an invalid
+// iterator when there is no such entry.
+func btree_map_iter btree_map_first(btree_map* map);
+func btree_map_iter btree_map_lower_bound(btree_map* map, u64 key);
+func btree_map_iter btree_map_upper_bound(btree_map* map, u64 key);
+
+func b32 btree_map_iter_valid(btree_map_iter it);
+func u64 btree_map_iter_key(btree_map_iter it);
+func void* btree_map_iter_value(btree_map_iter it);
+
+// Advances to the next entry in key order. Returns false once past the last one.
+func b32 btree_map_iter_next(btree_map_iter* it);
+
+// Calls visit for every entry with min_key <= key <= max_key, in key order.
+// Returns the number of entries visited.
+func sz btree_map_range(
+    btree_map* map,
+    u64 min_key,
+    u64 max_key,
+    btree_map_visit_fn* visit,
+    void* user_data);
+
+// Iterates every entry in ascending key order.
+#define BTREE_MAP_FOREACH(map, it) \
+  for (btree_map_iter it = btree_map_first((map)); btree_map_iter_valid(it); btree_map_iter_next(&it))
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,126 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/env_defines.h"
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "containers/hash_map.h"
+#include "memory/allocator.h"
+#include "threads/atomics.h"
+#include "threads/rwlock.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// Shard count used when concurrent_map_create is given 0.
+#define CONCURRENT_MAP_DEFAULT_SHARDS 32
+
+// Lookups only read the map and lock fields, so the counters written by
+// writers and contended lockers sit on their own cache line.
+typedef struct concurrent_map_shard {
+  hash_map map;
+  rwlock lock;
+  u8 pad_head[ARCH_CACHE_LINE_SIZE];
+  atomic_u64 writes;     // Inserts, updates and removals applied to this shard.
+  atomic_u64 contended;  // Lock acquisitions that found the lock taken and had to wait.
+  u8 pad_tail[ARCH_CACHE_LINE_SIZE];
+} concurrent_map_shard;
+
+typedef struct concurrent_map {
+  concurrent_map_shard* shards;
+  u32 shard_count;
+  u32 shard_bits;  // log2(shard_count); the shard is picked from this many top hash bits.
+  allocator alloc;
+} concurrent_map;
+
+typedef struct concurrent_map_shard_stats {
+  sz count;
+  sz capacity;
+  u64 writes;
+  u64 contended;
+} concurrent_map_shard_stats;
+
+typedef struct concurrent_map_entry {
+  u64 key;
+  void* value;
+} concurrent_map_entry;
+
+// Flat copy of a concurrent map's entries, in no particular order.
+typedef struct concurrent_map_entries {
+  concurrent_map_entry* data;
+  sz count;
+  sz cap;
+  allocator alloc;
+} concurrent_map_entries;
+
+/*
+concurrent_map is a thread-safe u64 -> void* map for tables shared between
+worker threads. Keys are spread over independent hash_map shards, each behind
+its own reader-writer lock, by the top bits of the key hash (hash_map itself
+uses the low bits, so the two never correlate). Writers to different shards
+never touch the same lock, so throughput grows with the number of cores
+instead of serialising on one lock as a single rwlock-wrapped hash_map does.
+
+Iterating a live concurrent map is not supported. Take a snapshot instead. A
+snapshot is consistent per shard, but shards are copied one after another,
+so it is not one global point in time.
+
+Example:
+
+  concurrent_map assets = concurrent_map_create(0, 4096, (allocator){0});
+
+  // Any thread.
+  concurrent_map_set(&assets, asset_id, asset_ptr);
+  void* asset = concurrent_map_get(&assets, asset_id);
+
+  concurrent_map_entries snapshot = concurrent_map_snapshot(&assets, (allocator){0});
+  for (sz idx = 0; idx < snapshot.count; idx++) {
+    // snapshot.data[idx].key, snapshot.data[idx].value
+  }
+  concurrent_map_entries_destroy(&snapshot);
+
+  concurrent_map_destroy(&assets);
+*/
+
+// Lifecycle.
+// shard_count is rounded up to a power of two; 0 picks CONCURRENT_MAP_DEFAULT_SHARDS.
+// cap is the expected total number of entries and is spread over the shards.
+// Shards grow from other threads, so a zeroed allocator falls back to the
+// global allocator rather than the calling thread's.
+func concurrent_map concurrent_map_create(sz shard_count, sz cap, allocator alloc);
+func void concurrent_map_destroy(concurrent_map* map);
+func void concurrent_map_clear(concurrent_map* map);
+
+// Occupancy. The total is summed shard by shard and may be stale on return.
+func sz concurrent_map_count(concurrent_map* map);
+func u32 concurrent_map_shard_count(concurrent_map const* map);
+
+// Grows every shard so that min_count entries, spread evenly, fit without rehashing.
+func b32 concurrent_map_reserve(concurrent_map* map, sz min_count);
+
+// Key/value operations. Each locks exactly one shard.
+func b32 concurrent_map_set(concurrent_map* map, u64 key, void* value);
+func void* concurrent_map_get(concurrent_map* map, u64 key);
+func b32 concurrent_map_has(concurrent_map* map, u64 key);
+func b32 concurrent_map_remove(concurrent_map* map, u64 key);
+
+// Inserts value unless key is already present.
+// Returns the value stored for key afterwards (the existing one if any).
+func void* concurrent_map_get_or_set(concurrent_map* map, u64 key, void* value);
+
+// Copies every entry into a flat array owned by the caller (destroy with
+// concurrent_map_entries_destroy). A zeroed allocator falls back to the
+// thread, then the global allocator. On allocation failure the result holds
+// the entries copied so far.
+func concurrent_map_entries concurrent_map_snapshot(concurrent_map* map, allocator alloc);
+func void concurrent_map_entries_destroy(concurrent_map_entries* entries);
+
+// Per-shard statistics. Returns false when shard_idx is out of range.
+func b32 concurrent_map_get_shard_stats(concurrent_map* map, u32 shard_idx, concurrent_map_shard_stats* out_stats);
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,92 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/env_defines.h"
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "memory/allocator.h"
+#include "threads/atomics.h"
+#include "threads/semaphore.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+typedef struct mpmc_queue_cell {
+  atomic_u64 sequence;
+  void* value;
+} mpmc_queue_cell;
+
+typedef struct mpmc_queue {
+  mpmc_queue_cell* cells;
+  sz cap;
+  allocator alloc;
+  semaphore items_sem;      // Signalled for blocked poppers when items are pushed.
+  semaphore slots_sem;      // Signalled for blocked pushers when items are popped.
+  atomic_u32 pop_waiters;   // Threads currently blocked in mpmc_queue_pop*.
+  atomic_u32 push_waiters;  // Threads currently blocked in mpmc_queue_push*.
+  u8 pad_enqueue[ARCH_CACHE_LINE_SIZE];
+  atomic_u64 enqueue_pos;
+  u8 pad_dequeue[ARCH_CACHE_LINE_SIZE];
+  atomic_u64 dequeue_pos;
+  u8 pad_back[ARCH_CACHE_LINE_SIZE];
+} mpmc_queue;
+
+/*
+mpmc_queue is a bounded, lock-free multi-producer/multi-consumer FIFO of
+pointers (Vyukov's sequence-numbered array queue). Every cell carries a
+sequence number that tells producers and consumers whose turn it is, so a
+push or pop costs a single compare-and-swap on the shared position counter.
+The try_* functions never block. The blocking variants spin through the
+try_* path first and only sleep on a semaphore while the queue stays full or
+empty; the semaphores are touched only when someone is actually waiting.
+
+Example:
+
+  mpmc_queue jobs = mpmc_queue_create(1024, (allocator){0});
+
+  // Producer threads.
+  mpmc_queue_push(&jobs, job);
+
+  // Consumer threads.
+  void* job = NULL;
+  mpmc_queue_pop(&jobs, &job);
+
+  mpmc_queue_destroy(&jobs);
+*/
+
+// Lifecycle.
+// cap is rounded up to a power of two (at least 2).
+// A zeroed allocator falls back to the thread, then the global allocator.
+func mpmc_queue mpmc_queue_create(sz cap, allocator alloc);
+func void mpmc_queue_destroy(mpmc_queue* que);
+
+// Capacity and occupancy.
+// mpmc_queue_count is a snapshot and may be stale by the time it returns.
+func sz mpmc_queue_capacity(mpmc_queue const* que);
+func sz mpmc_queue_count(mpmc_queue* que);
+
+// Non-blocking operations. Return false when the queue is full or empty.
+func b32 mpmc_queue_try_push(mpmc_queue* que, void* value);
+func b32 mpmc_queue_try_pop(mpmc_queue* que, void** out_value);
+
+// Non-blocking batch operations. Claim as many consecutive cells as are ready,
+// up to count, with a single compare-and-swap.
+// Return the number of values pushed or popped.
+func sz mpmc_queue_try_push_batch(mpmc_queue* que, void* const* values, sz count);
+func sz mpmc_queue_try_pop_batch(mpmc_queue* que, void** out_values, sz count);
+
+// Blocking operations. Wait until the value could be pushed or popped.
+func void mpmc_queue_push(mpmc_queue* que, void* value);
+func void mpmc_queue_pop(mpmc_queue* que, void** out_value);
+
+// Blocking operations with a timeout. Each sleep waits up to millis milliseconds.
+// Return false when the operation could not complete before the wait timed out.
+func b32 mpmc_queue_push_timeout(mpmc_queue* que, void* value, u32 millis);
+func b32 mpmc_queue_pop_timeout(mpmc_queue* que, void** out_value, u32 millis);
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,159 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/utility_defines.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+PAIRING_HEAP_* manage an intrusive pairing heap: a priority queue whose nodes
+live inside the caller's structs, so an item already in the queue can move up
+(decrease-key) or leave it without a search. Each node must provide `child`,
+`sibling` and `prev` members; prev points at the parent for a first child and
+at the left sibling otherwise. root is the caller's root pointer, NULL when
+empty. The macros never allocate.
+
+less_fn(lhs, rhs) takes two node pointers and returns nonzero when lhs must
+come out before rhs. Push, meld and decrease-key are O(1), pop and remove
+amortized O(log n). For plain values without decrease-key, the array-backed
+priority_queue.h and typed_heap.h queues are faster.
+
+Example:
+
+  typedef struct path_node {
+    struct path_node* child;
+    struct path_node* sibling;
+    struct path_node* prev;
+    f32 distance;
+  } path_node;
+
+  #define PATH_NODE_LESS(lhs, rhs) ((lhs)->distance < (rhs)->distance)
+
+  path_node* open_set = NULL;
+  PAIRING_HEAP_PUSH(open_set, &nodes[start], PATH_NODE_LESS);
+
+  // A shorter path to a queued node was found.
+  nodes[idx].distance = shorter;
+  PAIRING_HEAP_DECREASE(open_set, &nodes[idx], PATH_NODE_LESS);
+
+  path_node* best = NULL;
+  PAIRING_HEAP_POP(open_set, PATH_NODE_LESS, best);
+*/
+
+#define PAIRING_HEAP_EMPTY(root) ((root) == NULL)
+#define PAIRING_HEAP_PEEK(root)  (root)
+
+// Melds two heaps given by their roots (either may be NULL) into out.
+// On a tie, lhs stays the root.
+#define PAIRING_HEAP_MELD(lhs, rhs, less_fn, out) stmt(        \
+    type_of((lhs)) _pairing_heap_top = (lhs);                  \
+    type_of((lhs)) _pairing_heap_sub = (rhs);                  \
+    if (_pairing_heap_top == NULL) {                           \
+      _pairing_heap_top = _pairing_heap_sub;                   \
+    } else if (_pairing_heap_sub != NULL) {                    \
+      if (less_fn(_pairing_heap_sub, _pairing_heap_top)) {     \
+        type_of((lhs)) _pairing_heap_swap = _pairing_heap_top; \
+        _pairing_heap_top = _pairing_heap_sub;                 \
+        _pairing_heap_sub = _pairing_heap_swap;                \
+      }                                                        \
+      _pairing_heap_sub->sibling = _pairing_heap_top->child;   \
+      if (_pairing_heap_top->child != NULL) {                  \
+        _pairing_heap_top->child->prev = _pairing_heap_sub;    \
+      }                                                        \
+      _pairing_heap_sub->prev = _pairing_heap_top;             \
+      _pairing_heap_top->child = _pairing_heap_sub;            \
+      _pairing_heap_top->sibling = NULL;                       \
+      _pairing_heap_top->prev = NULL;                          \
+    }                                                          \
+    (out) = _pairing_heap_top;)
+
+// Merges a sibling list, starting at first, into one heap written to out: pairs
+// are melded left to right, then the results right to left.
+#define PAIRING_HEAP_MERGE_PAIRS(first, less_fn, out) stmt(                                   \
+    type_of((first)) _pairing_heap_cursor = (first);                                          \
+    type_of((first)) _pairing_heap_pairs = NULL;                                              \
+    while (_pairing_heap_cursor != NULL) {                                                    \
+      type_of((first)) _pairing_heap_lhs = _pairing_heap_cursor;                              \
+      type_of((first)) _pairing_heap_rhs = _pairing_heap_lhs->sibling;                        \
+      type_of((first)) _pairing_heap_melded = NULL;                                           \
+      _pairing_heap_cursor = _pairing_heap_rhs != NULL ? _pairing_heap_rhs->sibling : NULL;   \
+      _pairing_heap_lhs->sibling = NULL;                                                      \
+      _pairing_heap_lhs->prev = NULL;                                                         \
+      if (_pairing_heap_rhs != NULL) {                                                        \
+        _pairing_heap_rhs->sibling = NULL;                                                    \
+        _pairing_heap_rhs->prev = NULL;                                                       \
+      }                                                                                       \
+      PAIRING_HEAP_MELD(_pairing_heap_lhs, _pairing_heap_rhs, less_fn, _pairing_heap_melded); \
+      /* Stack the results through sibling; popping them walks right to left. */              \
+      _pairing_heap_melded->sibling = _pairing_heap_pairs;                                    \
+      _pairing_heap_pairs = _pairing_heap_melded;                                             \
+    }                                                                                         \
+    (out) = NULL;                                                                             \
+    while (_pairing_heap_pairs != NULL) {                                                     \
+      type_of((first)) _pairing_heap_next = _pairing_heap_pairs->sibling;                     \
+      _pairing_heap_pairs->sibling = NULL;                                                    \
+      PAIRING_HEAP_MELD((out), _pairing_heap_pairs, less_fn, (out));                          \
+      _pairing_heap_pairs = _pairing_heap_next;                                               \
+    })
+
+// Unlinks node and its subtree from its parent's child list. No-op for a root.
+#define PAIRING_HEAP_DETACH(node) stmt(                                \
+    type_of((node)) _pairing_heap_cut = (node);                        \
+    if (_pairing_heap_cut->prev != NULL) {                             \
+      if (_pairing_heap_cut->prev->child == _pairing_heap_cut) {       \
+        _pairing_heap_cut->prev->child = _pairing_heap_cut->sibling;   \
+      } else {                                                         \
+        _pairing_heap_cut->prev->sibling = _pairing_heap_cut->sibling; \
+      }                                                                \
+      if (_pairing_heap_cut->sibling != NULL) {                        \
+        _pairing_heap_cut->sibling->prev = _pairing_heap_cut->prev;    \
+      }                                                                \
+      _pairing_heap_cut->prev = NULL;                                  \
+      _pairing_heap_cut->sibling = NULL;                               \
+    })
+
+// Queue operations. node's links are overwritten by PUSH and cleared by POP and REMOVE.
+#define PAIRING_HEAP_PUSH(root, node, less_fn) stmt( \
+    type_of((node)) _pairing_heap_new = (node);      \
+    _pairing_heap_new->child = NULL;                 \
+    _pairing_heap_new->sibling = NULL;               \
+    _pairing_heap_new->prev = NULL;                  \
+    PAIRING_HEAP_MELD((root), _pairing_heap_new, less_fn, (root));)
+
+#define PAIRING_HEAP_POP(root, less_fn, out) stmt(             \
+    (out) = (root);                                            \
+    if ((out) != NULL) {                                       \
+      PAIRING_HEAP_MERGE_PAIRS((out)->child, less_fn, (root)); \
+      (out)->child = NULL;                                     \
+    })
+
+// Call after node's key moved towards the front (it must not move back).
+#define PAIRING_HEAP_DECREASE(root, node, less_fn) stmt(               \
+    type_of((node)) _pairing_heap_moved = (node);                      \
+    if (_pairing_heap_moved != (root)) {                               \
+      PAIRING_HEAP_DETACH(_pairing_heap_moved);                        \
+      PAIRING_HEAP_MELD((root), _pairing_heap_moved, less_fn, (root)); \
+    })
+
+// Removes any node that is in the heap.
+#define PAIRING_HEAP_REMOVE(root, node, less_fn) stmt(                                  \
+    type_of((node)) _pairing_heap_gone = (node);                                        \
+    type_of((node)) _pairing_heap_rest = NULL;                                          \
+    if (_pairing_heap_gone == (root)) {                                                 \
+      PAIRING_HEAP_POP((root), less_fn, _pairing_heap_rest);                            \
+    } else {                                                                            \
+      PAIRING_HEAP_DETACH(_pairing_heap_gone);                                          \
+      PAIRING_HEAP_MERGE_PAIRS(_pairing_heap_gone->child, less_fn, _pairing_heap_rest); \
+      _pairing_heap_gone->child = NULL;                                                 \
+      PAIRING_HEAP_MELD((root), _pairing_heap_rest, less_fn, (root));                   \
+    })
+
+// =========================================================================
+c_end;
+// =========================================================================
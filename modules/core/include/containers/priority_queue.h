@@ -0,0 +1,124 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "containers/sort.h"
+#include "memory/allocator.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// Children per node used when priority_queue_create is given an arity of 0.
+// Four keeps a node's children within one or two cache lines for small
+// elements and halves the tree height compared to a binary heap.
+#define PRIORITY_QUEUE_DEFAULT_ARITY 4
+
+// Largest accepted arity.
+#define PRIORITY_QUEUE_MAX_ARITY 16
+
+// Capacity of the first allocation; growth doubles from here.
+#define PRIORITY_QUEUE_MIN_CAPACITY 8
+
+typedef struct priority_queue {
+  u8* data;
+  sz count;
+  sz cap;
+  sz elem_size;
+  u32 arity;
+  sort_compare_fn* compare;
+  void* user_data;
+  allocator alloc;
+} priority_queue;
+
+/*
+priority_queue is an array-backed d-ary heap of fixed-size elements. The
+element for which compare returns <0 against every other comes out first, so
+an ascending compare gives a min-heap and a descending one a max-heap. Push
+and pop are O(log n); priority_queue_push_many rebuilds the whole array
+bottom-up in O(n) when the batch is at least as large as the queue.
+
+For one element type, TYPED_HEAP_* in typed_heap.h inlines the comparison.
+When queued items must change priority in place, see pairing_heap.h.
+
+Example:
+
+  typedef struct timed_event {
+    u64 due_tick;
+    u32 event_idx;
+  } timed_event;
+
+  func i32 timed_event_compare(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    u64 lhs = ((timed_event const*)lhs_ptr)->due_tick;
+    u64 rhs = ((timed_event const*)rhs_ptr)->due_tick;
+    return lhs < rhs ? -1 : lhs > rhs;
+  }
+
+  priority_queue events =
+      priority_queue_create(size_of(timed_event), 0, timed_event_compare, NULL, 256, (allocator){0});
+  priority_queue_push(&events, &(timed_event){.due_tick = 42, .event_idx = 7});
+
+  timed_event next;
+  timed_event const* due = (timed_event const*)priority_queue_peek(&events);
+  safe_while (due != NULL && due->due_tick <= now) {
+    priority_queue_pop(&events, &next);
+    due = (timed_event const*)priority_queue_peek(&events);
+  }
+
+  priority_queue_destroy(&events);
+*/
+
+// Lifecycle.
+// arity is the number of children per node (2 for a binary heap); 0 picks
+// PRIORITY_QUEUE_DEFAULT_ARITY and larger values are clamped to
+// PRIORITY_QUEUE_MAX_ARITY.
+// A zeroed allocator falls back to the thread, then the global allocator.
+func priority_queue priority_queue_create(
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data,
+    sz cap,
+    allocator alloc);
+func void priority_queue_destroy(priority_queue* queue);
+func void priority_queue_clear(priority_queue* queue);
+
+// Occupancy.
+func sz priority_queue_count(priority_queue const* queue);
+func sz priority_queue_capacity(priority_queue const* queue);
+func b32 priority_queue_reserve(priority_queue* queue, sz min_count);
+
+// Queue operations.
+// pop copies the first element into out_elem (which may be NULL) and removes
+// it. peek returns it without removing, or NULL when empty.
+func b32 priority_queue_push(priority_queue* queue, const void* elem);
+func b32 priority_queue_push_many(priority_queue* queue, const void* elems, sz elem_count);
+func b32 priority_queue_pop(priority_queue* queue, void* out_elem);
+func const void* priority_queue_peek(priority_queue const* queue);
+
+// Rearranges a plain array into a d-ary heap in place, bottom-up in O(n).
+// Returns the number of elements, or 0 on invalid input.
+func sz priority_queue_heapify(
+    void* ptr,
+    sz elem_count,
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data);
+
+// Returns true when ptr satisfies the d-ary heap order.
+func b32 priority_queue_check(
+    const void* ptr,
+    sz elem_count,
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data);
+
+// =========================================================================
+c_end;
+// =========================================================================
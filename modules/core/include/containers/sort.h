@@ -32,6 +32,9 @@ Example:
 // and 0 when both elements compare equal.
 typedef i32 sort_compare_fn(const void* lhs_ptr, const void* rhs_ptr, void* user_data);
 
+// Swaps two elements of elem_size bytes. No-op when both pointers are equal.
+func void sort_swap_bytes(void* lhs_ptr, void* rhs_ptr, sz elem_size);
+
 // Checks if an array is sorted according to the provided comparison function.
 // Returns true if the array is sorted, false otherwise.
 func b32 sort_check(
@@ -52,10 +55,13 @@ func sz sort_bubble(
     sort_compare_fn* compare,
     void* user_data);
 
-// Sorts an array in-place using the quicksort algorithm.
+// Sorts an array in-place using pattern-defeating quicksort (introsort with
+// insertion sort for small ranges and a heapsort fallback). Not stable.
+// Needs no scratch memory; allocator is unused.
 // Returns the number of sorted elements.
-// Best - worst - average: O(n log n) - O(n^2) - O(n log n)
-// Faster for: large arrays and random data.
+// Best - worst - average: O(n) - O(n log n) - O(n log n)
+// Faster for: large arrays, random data, sorted or reversed runs and many duplicates.
+// For a fixed element type see typed_sort.h, which inlines the comparison.
 func sz sort_quick(
     void* ptr,
     sz elem_count,
@@ -64,10 +70,12 @@ func sz sort_quick(
     void* user_data,
     allocator allocator);
 
-// Sorts an array in-place using the merge sort algorithm.
+// Sorts an array in-place using the merge sort algorithm. Stable.
 // Returns the number of sorted elements.
 // Best - worst - average: O(n log n) - O(n log n) - O(n log n)
 // Faster for: large arrays and random data.
+// Scratch comes from the thread's temp arena, then from allocator; without
+// either the runs are merged in place, in O(n log^2 n).
 func sz sort_merge(
     void* ptr,
     sz elem_count,
@@ -100,16 +108,116 @@ func sz sort_insertion(
 
 // Sorts an array of 32-bit unsigned integers in-place using the radix sort algorithm.
 // Returns the number of sorted elements.
+// Uses the byte-wise LSD sort below with scratch from the thread's temp arena,
+// and falls back to an in-place bitwise radix sort when no temp arena is available.
 // Best - worst - average: O(n * k) - O(n * k) - O(n * k), where k is the number of digits in the largest number.
 // Faster for: large arrays of integers with a small range of values.
 func sz sort_radix32(u32* ptr, sz elem_count);
 
 // Sorts an array of 64-bit unsigned integers in-place using the radix sort algorithm.
 // Returns the number of sorted elements.
+// Scratch handling matches sort_radix32.
 // Best - worst - average: O(n * k) - O(n * k) - O(n * k), where k is the number of digits in the largest number.
 // Faster for: large arrays of integers with a small range of values.
 func sz sort_radix64(u64* ptr, sz elem_count);
 
+// =========================================================================
+// Byte-wise LSD Radix Sort
+// =========================================================================
+
+// Key types understood by the LSD radix sort. Signed and floating-point keys
+// are remapped to order-preserving unsigned bit patterns for the duration of
+// the sort; floats order as -inf < negatives < -0 < +0 < positives < +inf,
+// with NaNs at either end depending on their sign bit.
+typedef enum sort_key_type {
+  SORT_KEY_U32,
+  SORT_KEY_U64,
+  SORT_KEY_I32,
+  SORT_KEY_I64,
+  SORT_KEY_F32,
+  SORT_KEY_F64,
+} sort_key_type;
+
+// The sorts below are stable least-significant-digit radix sorts with 8-bit
+// digits. One read pass builds the histograms of every digit, then each digit
+// takes one scatter pass (4 for 32-bit keys, 8 for 64-bit keys). Digits that are
+// equal across the whole array are skipped, so narrow key ranges need fewer passes.
+// Scratch memory for one copy of the keys (and values) is taken from alloc;
+// a zeroed allocator falls back to the thread, then the global allocator.
+// Each returns the number of sorted elements, or 0 on invalid input or when
+// the scratch allocation fails.
+// Best - worst - average: O(n) - O(n) - O(n) for a fixed key width.
+// Faster for: large arrays of numeric keys.
+func sz sort_radix_u32(u32* keys, sz elem_count, allocator alloc);
+func sz sort_radix_u64(u64* keys, sz elem_count, allocator alloc);
+func sz sort_radix_i32(i32* keys, sz elem_count, allocator alloc);
+func sz sort_radix_i64(i64* keys, sz elem_count, allocator alloc);
+func sz sort_radix_f32(f32* keys, sz elem_count, allocator alloc);
+func sz sort_radix_f64(f64* keys, sz elem_count, allocator alloc);
+
+// Sorts keys in-place and applies the same permutation to values, an array of
+// elem_count records of value_size bytes each. Records with equal keys keep
+// their relative order. value_size 4 and 8 take a faster copy path.
+func sz sort_radix_pairs(
+    void* keys,
+    sort_key_type key_type,
+    void* values,
+    sz value_size,
+    sz elem_count,
+    allocator alloc);
+
+// Writes the stable sorted order of keys into out_indices without modifying keys:
+// keys[out_indices[0]] is the smallest key. elem_count must fit in a u32.
+func sz sort_radix_indices(
+    const void* keys,
+    sort_key_type key_type,
+    u32* out_indices,
+    sz elem_count,
+    allocator alloc);
+
+// =========================================================================
+// Parallel Sort
+// =========================================================================
+
+// Minimum number of elements each worker must receive. Smaller inputs (or a
+// thread_count of 1) are sorted on the calling thread by the serial path.
+#define SORT_PARALLEL_MIN_CHUNK 16384
+
+// The parallel sorts spawn a thread_group of up to thread_count workers (rounded
+// down to a power of two; 0 means one per logical core) for the duration of the
+// call; the calling thread waits for them. Scratch for one copy of the data comes from alloc; a zeroed
+// allocator falls back to the thread, then the global allocator. Both sorts
+// are stable, so they return exactly what their serial counterparts return.
+// Each returns the number of sorted elements, or 0 on invalid input or when
+// the scratch allocation fails.
+
+// Stable merge sort. Every worker sorts one chunk, then all workers take part
+// in each merge round by splitting the merged output evenly (merge path).
+// compare is called concurrently and must be thread-safe.
+// Serial path: sort_merge.
+func sz sort_parallel_merge(
+    void* ptr,
+    sz elem_count,
+    sz elem_size,
+    sort_compare_fn* compare,
+    void* user_data,
+    allocator alloc,
+    u32 thread_count);
+
+// LSD radix sort with per-worker digit histograms: every pass each worker
+// counts its own chunk, derives its private scatter offsets from all
+// histograms, and scatters its chunk without any shared counters.
+// values may be NULL with value_size 0.
+// Serial path: sort_radix_pairs.
+func sz sort_parallel_radix(
+    void* keys,
+    sort_key_type key_type,
+    void* values,
+    sz value_size,
+    sz elem_count,
+    allocator alloc,
+    u32 thread_count);
+
 // =========================================================================
 c_end;
 // =========================================================================
@@ -0,0 +1,87 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/safe.h"
+#include "basic/utility_defines.h"
+#include "memory/allocator.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+typedef struct swiss_map_slot {
+  u64 key;
+  void* value;
+} swiss_map_slot;
+
+typedef struct swiss_map {
+  u8* ctrl;               // One control byte per slot, followed by a cloned copy of the first group.
+  swiss_map_slot* slots;  // Key/value storage; shares one allocation with ctrl.
+  sz count;
+  sz tombstones;  // Slots marked deleted; they count against the load limit until the next rehash.
+  sz cap;
+  allocator alloc;
+} swiss_map;
+
+typedef sz swiss_map_iter;
+
+/*
+swiss_map stores opaque values behind u64 keys like hash_map, but uses the
+"Swiss table" layout: a separate array of one-byte control words holds 7 bits
+of every key's hash (or an empty/deleted marker), and lookups compare a whole
+group of control bytes against the hash at once with SSE2 or NEON. Only slots
+whose control byte matches are ever touched, so misses and long probe runs
+stay cheap even at a 7/8 load factor. Removal leaves a tombstone unless the
+slot can be proven to never have ended a probe run.
+
+Example:
+
+  swiss_map assets = swiss_map_create(16, (allocator){0});
+  swiss_map_set(&assets, 7, some_ptr);
+
+  SWISS_MAP_FOREACH(&assets, slot) {
+    // slot->key is the u64 key
+    // slot->value is the stored pointer
+  }
+
+  swiss_map_destroy(&assets);
+*/
+
+// Lifecycle.
+// cap is rounded up to a power of two (at least 16).
+// A zeroed allocator falls back to the thread, then the global allocator.
+func swiss_map swiss_map_create(sz cap, allocator alloc);
+func void swiss_map_destroy(swiss_map* map);
+func void swiss_map_clear(swiss_map* map);
+
+// Capacity and occupancy.
+func sz swiss_map_count(swiss_map const* map);
+func sz swiss_map_capacity(swiss_map const* map);
+func f32 swiss_map_load_factor(swiss_map const* map);
+
+// Capacity management.
+// swiss_map_rehash rebuilds the table with at least new_cap slots and drops all tombstones.
+// swiss_map_reserve makes room for min_count entries without further rehashing.
+func b32 swiss_map_rehash(swiss_map* map, sz new_cap);
+func b32 swiss_map_reserve(swiss_map* map, sz min_count);
+
+// Key/value operations.
+func b32 swiss_map_set(swiss_map* map, u64 key, void* value);
+func void* swiss_map_get(swiss_map* map, u64 key);
+func b32 swiss_map_has(swiss_map* map, u64 key);
+func b32 swiss_map_remove(swiss_map* map, u64 key);
+
+// Iteration over occupied slots.
+func swiss_map_slot* swiss_map_next(swiss_map* map, swiss_map_iter* iter);
+
+#define SWISS_MAP_FOREACH(map, it)                                                                                   \
+  for (swiss_map_iter cat_exp(_swiss_map_iter_, it) = 0; cat_exp(_swiss_map_iter_, it) < swiss_map_capacity((map));) \
+    for (swiss_map_slot*(it) = swiss_map_next((map), &cat_exp(_swiss_map_iter_, it)); (it) != NULL; (it) = NULL)
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,297 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/profiler.h"
+#include "basic/safe.h"
+#include "context/global_ctx.h"
+#include "context/thread_ctx.h"
+#include "memory/allocator.h"
+#include "memory/memops.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+TYPED_ARRAY_DECLARE / TYPED_ARRAY_IMPLEMENT generate a growable array of one
+element type, replacing the hand-rolled capacity doubling found around the
+code base. Elements live contiguously in arr.data and can be indexed directly.
+
+Growth doubles the capacity (starting at TYPED_ARRAY_MIN_CAPACITY) and goes
+through the allocator's realloc callback when it has one. Arena and heap
+allocators extend the block in place whenever the space behind it is free,
+so a growing array at the top of an arena never copies. Allocators without a
+realloc callback fall back to allocate, copy and free.
+
+Pointers into data stay valid until the next call that can grow or shrink
+the array (reserve, resize, push, push_many, insert, shrink_to_fit).
+
+TYPED_ARRAY_DECLARE goes wherever the type is needed (usually a header),
+TYPED_ARRAY_IMPLEMENT in exactly one translation unit.
+
+Example:
+
+  TYPED_ARRAY_DECLARE(vertex_array, vertex)
+  TYPED_ARRAY_IMPLEMENT(vertex_array, vertex)
+
+  vertex_array verts = vertex_array_create(0, (allocator){0});
+  vertex_array_push(&verts, (vertex){.x = 1.0F});
+  vertex_array_swap_remove(&verts, 0);
+
+  TYPED_ARRAY_FOREACH(&verts, vert) {
+    // vert points at each element in order.
+  }
+
+  vertex_array_destroy(&verts);
+
+Generated functions (for an array named name):
+
+  name  name_create(sz cap, allocator alloc);                 // Zeroed allocator: thread, then global allocator.
+  void  name_destroy(name* arr);
+  void  name_clear(name* arr);                                // Keeps the capacity.
+  sz    name_count(name const* arr);
+  sz    name_capacity(name const* arr);
+  b32   name_reserve(name* arr, sz min_count);
+  b32   name_resize(name* arr, sz count);                     // New elements are zeroed.
+  b32   name_shrink_to_fit(name* arr);
+  b32   name_push(name* arr, type value);                     // Amortized O(1).
+  b32   name_push_many(name* arr, type const* values, sz count);
+  b32   name_pop(name* arr, type* out_value);                 // out_value may be NULL.
+  b32   name_insert(name* arr, sz idx, type value);           // O(n); idx may equal count.
+  b32   name_remove(name* arr, sz idx);                       // O(n); keeps order.
+  b32   name_swap_remove(name* arr, sz idx);                  // O(1); moves the last element into idx.
+  type* name_at(name* arr, sz idx);                           // NULL when out of range.
+*/
+
+// Capacity of the first allocation.
+#define TYPED_ARRAY_MIN_CAPACITY 8
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Doubles cap (from TYPED_ARRAY_MIN_CAPACITY) until it reaches min_count.
+func sz typed_array_grow_capacity(sz cap, sz min_count);
+
+// Resizes a block holding old_size live bytes to new_size bytes. Uses the
+// allocator's realloc callback when present, otherwise allocates, copies and
+// frees. Returns NULL on failure and leaves the old block untouched.
+func void* typed_array_realloc(allocator alloc, void* data, sz old_size, sz new_size);
+
+// =========================================================================
+// Generator
+// =========================================================================
+
+#define TYPED_ARRAY_FOREACH(arr, it) \
+  for (type_of((arr)->data) it = (arr)->data; it < (arr)->data + (arr)->count; ++it)
+
+#define TYPED_ARRAY_DECLARE(name, type)                                \
+  typedef struct name {                                                \
+    type* data;                                                        \
+    sz count;                                                          \
+    sz cap;                                                            \
+    allocator alloc;                                                   \
+  } name;                                                              \
+  func name name##_create(sz cap, allocator alloc);                    \
+  func void name##_destroy(name* arr);                                 \
+  func void name##_clear(name* arr);                                   \
+  func sz name##_count(name const* arr);                               \
+  func sz name##_capacity(name const* arr);                            \
+  func b32 name##_reserve(name* arr, sz min_count);                    \
+  func b32 name##_resize(name* arr, sz count);                         \
+  func b32 name##_shrink_to_fit(name* arr);                            \
+  func b32 name##_push(name* arr, type value);                         \
+  func b32 name##_push_many(name* arr, type const* values, sz count);  \
+  func b32 name##_pop(name* arr, type* out_value);                     \
+  func b32 name##_insert(name* arr, sz idx, type value);               \
+  func b32 name##_remove(name* arr, sz idx);                           \
+  func b32 name##_swap_remove(name* arr, sz idx);                      \
+  func type* name##_at(name* arr, sz idx);
+
+#define TYPED_ARRAY_IMPLEMENT(name, type)                                                       \
+  func name name##_create(sz cap, allocator alloc) {                                            \
+    name arr;                                                                                   \
+    mem_zero(&arr, size_of(arr));                                                               \
+    arr.alloc = alloc;                                                                          \
+    if (arr.alloc.alloc_fn == NULL || arr.alloc.dealloc_fn == NULL) {                           \
+      arr.alloc = thread_get_allocator();                                                       \
+    }                                                                                           \
+    if (arr.alloc.alloc_fn == NULL || arr.alloc.dealloc_fn == NULL) {                           \
+      arr.alloc = global_get_allocator();                                                       \
+    }                                                                                           \
+    if (cap > 0 && arr.alloc.alloc_fn != NULL && arr.alloc.dealloc_fn != NULL) {                \
+      name##_reserve(&arr, cap);                                                                \
+    }                                                                                           \
+    return arr;                                                                                 \
+  }                                                                                             \
+                                                                                                \
+  func void name##_destroy(name* arr) {                                                         \
+    if (arr == NULL) {                                                                          \
+      return;                                                                                   \
+    }                                                                                           \
+    if (arr->data) {                                                                            \
+      allocator_dealloc(arr->alloc, arr->data);                                                 \
+    }                                                                                           \
+    arr->data = NULL;                                                                           \
+    arr->count = 0;                                                                             \
+    arr->cap = 0;                                                                               \
+  }                                                                                             \
+                                                                                                \
+  func void name##_clear(name* arr) {                                                           \
+    if (arr != NULL) {                                                                          \
+      arr->count = 0;                                                                           \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_count(name const* arr) {                                                       \
+    return arr != NULL ? arr->count : 0;                                                        \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_capacity(name const* arr) {                                                    \
+    return arr != NULL ? arr->cap : 0;                                                          \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_set_capacity(name* arr, sz new_cap) {                                         \
+    profile_func_begin;                                                                         \
+    if (new_cap > SZ_MAX / size_of(type)) {                                                     \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    type* data = (type*)typed_array_realloc(                                                    \
+        arr->alloc, arr->data, arr->count * size_of(type), new_cap * size_of(type));            \
+    if (data == NULL) {                                                                         \
+      thread_log_error("Failed to grow typed array to %zu elements", new_cap);                  \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    arr->data = data;                                                                           \
+    arr->cap = new_cap;                                                                         \
+    profile_func_end;                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_reserve(name* arr, sz min_count) {                                            \
+    if (arr == NULL || arr->alloc.alloc_fn == NULL) {                                           \
+      return false;                                                                             \
+    }                                                                                           \
+    if (arr->cap >= min_count) {                                                                \
+      return true;                                                                              \
+    }                                                                                           \
+    return name##_set_capacity(arr, typed_array_grow_capacity(arr->cap, min_count));            \
+  }                                                                                             \
+                                                                                                \
+  /* Grows or shrinks to count elements; new elements are zeroed. */                            \
+  func b32 name##_resize(name* arr, sz count) {                                                 \
+    if (!name##_reserve(arr, count)) {                                                          \
+      return false;                                                                             \
+    }                                                                                           \
+    if (count > arr->count) {                                                                   \
+      mem_zero(arr->data + arr->count, (count - arr->count) * size_of(type));                   \
+    }                                                                                           \
+    arr->count = count;                                                                         \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_shrink_to_fit(name* arr) {                                                    \
+    if (arr == NULL || arr->data == NULL || arr->count == arr->cap) {                           \
+      return arr != NULL;                                                                       \
+    }                                                                                           \
+    if (arr->count == 0) {                                                                      \
+      allocator_dealloc(arr->alloc, arr->data);                                                 \
+      arr->data = NULL;                                                                         \
+      arr->cap = 0;                                                                             \
+      return true;                                                                              \
+    }                                                                                           \
+    return name##_set_capacity(arr, arr->count);                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_push(name* arr, type value) {                                                 \
+    if (arr == NULL) {                                                                          \
+      return false;                                                                             \
+    }                                                                                           \
+    if (arr->count == arr->cap && !name##_reserve(arr, arr->count + 1)) {                       \
+      return false;                                                                             \
+    }                                                                                           \
+    arr->data[arr->count++] = value;                                                            \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_push_many(name* arr, type const* values, sz count) {                          \
+    if (arr == NULL || (values == NULL && count > 0) || count > SZ_MAX - arr->count) {          \
+      return false;                                                                             \
+    }                                                                                           \
+    if (!name##_reserve(arr, arr->count + count)) {                                             \
+      return false;                                                                             \
+    }                                                                                           \
+    if (count > 0) {                                                                            \
+      mem_cpy(arr->data + arr->count, values, count * size_of(type));                           \
+    }                                                                                           \
+    arr->count += count;                                                                        \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_pop(name* arr, type* out_value) {                                             \
+    if (arr == NULL || arr->count == 0) {                                                       \
+      return false;                                                                             \
+    }                                                                                           \
+    arr->count--;                                                                               \
+    if (out_value != NULL) {                                                                    \
+      *out_value = arr->data[arr->count];                                                       \
+    }                                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  /* Shifts the tail up by one; idx may equal count to append. */                               \
+  func b32 name##_insert(name* arr, sz idx, type value) {                                       \
+    if (arr == NULL || idx > arr->count) {                                                      \
+      return false;                                                                             \
+    }                                                                                           \
+    if (arr->count == arr->cap && !name##_reserve(arr, arr->count + 1)) {                       \
+      return false;                                                                             \
+    }                                                                                           \
+    if (idx < arr->count) {                                                                     \
+      mem_mv(arr->data + idx + 1, arr->data + idx, (arr->count - idx) * size_of(type));         \
+    }                                                                                           \
+    arr->data[idx] = value;                                                                     \
+    arr->count++;                                                                               \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  /* Keeps the order of the remaining elements. */                                              \
+  func b32 name##_remove(name* arr, sz idx) {                                                   \
+    if (arr == NULL || idx >= arr->count) {                                                     \
+      return false;                                                                             \
+    }                                                                                           \
+    if (idx + 1 < arr->count) {                                                                 \
+      mem_mv(arr->data + idx, arr->data + idx + 1, (arr->count - idx - 1) * size_of(type));     \
+    }                                                                                           \
+    arr->count--;                                                                               \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  /* O(1): moves the last element into the hole. */                                             \
+  func b32 name##_swap_remove(name* arr, sz idx) {                                              \
+    if (arr == NULL || idx >= arr->count) {                                                     \
+      return false;                                                                             \
+    }                                                                                           \
+    arr->count--;                                                                               \
+    if (idx != arr->count) {                                                                    \
+      arr->data[idx] = arr->data[arr->count];                                                   \
+    }                                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func type* name##_at(name* arr, sz idx) {                                                     \
+    if (arr == NULL || idx >= arr->count) {                                                     \
+      return NULL;                                                                              \
+    }                                                                                           \
+    return &arr->data[idx];                                                                     \
+  }
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,290 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/profiler.h"
+#include "context/global_ctx.h"
+#include "context/thread_ctx.h"
+#include "containers/typed_array.h"
+#include "memory/allocator.h"
+#include "memory/memops.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+TYPED_HEAP_DECLARE / TYPED_HEAP_IMPLEMENT generate an array-backed d-ary
+heap for one element type. It is the same queue as priority_queue.h, but the
+comparison is a direct call the compiler can inline and sifting moves whole
+values into a hole instead of swapping bytes.
+
+less_fn has the signature b32 less_fn(type const* lhs, type const* rhs) and
+returns nonzero when lhs must come out before rhs. For arithmetic types,
+TYPED_HEAP_LESS gives a min-heap and TYPED_HEAP_GREATER a max-heap. arity is
+the number of children per node and must be a constant of at least 2;
+TYPED_HEAP_DEFAULT_ARITY suits most uses. Storage grows like typed_array.
+
+TYPED_HEAP_DECLARE goes wherever the queue is needed (usually a header),
+TYPED_HEAP_IMPLEMENT in exactly one translation unit.
+
+Example:
+
+  typedef struct timed_event {
+    u64 due_tick;
+    u32 event_idx;
+  } timed_event;
+
+  func b32 timed_event_less(timed_event const* lhs, timed_event const* rhs) {
+    return lhs->due_tick < rhs->due_tick;
+  }
+
+  TYPED_HEAP_DECLARE(event_queue, timed_event)
+  TYPED_HEAP_IMPLEMENT(event_queue, timed_event, timed_event_less, TYPED_HEAP_DEFAULT_ARITY)
+
+  event_queue events = event_queue_create(256, (allocator){0});
+  event_queue_push(&events, (timed_event){.due_tick = 42, .event_idx = 7});
+
+  timed_event next;
+  safe_while (event_queue_count(&events) > 0 && event_queue_peek(&events)->due_tick <= now) {
+    event_queue_pop(&events, &next);
+  }
+
+  event_queue_destroy(&events);
+
+Generated functions (for a queue named name):
+
+  name  name_create(sz cap, allocator alloc);                 // Zeroed allocator: thread, then global allocator.
+  void  name_destroy(name* hp);
+  void  name_clear(name* hp);                                 // Keeps the capacity.
+  sz    name_count(name const* hp);
+  sz    name_capacity(name const* hp);
+  b32   name_reserve(name* hp, sz min_count);
+  b32   name_push(name* hp, type value);                      // O(log n).
+  b32   name_push_many(name* hp, type const* values, sz count);
+  b32   name_pop(name* hp, type* out_value);                  // O(log n); out_value may be NULL.
+  type* name_peek(name* hp);                                  // First element, or NULL when empty.
+  sz    name_heapify(type* ptr, sz elem_count);               // O(n) in-place build of a plain array.
+  b32   name_check(type const* ptr, sz elem_count);           // True when ptr is in heap order.
+*/
+
+// Children per node; see PRIORITY_QUEUE_DEFAULT_ARITY in priority_queue.h.
+#define TYPED_HEAP_DEFAULT_ARITY 4
+
+// less_fn for a min-heap and a max-heap of types with built-in comparisons.
+#define TYPED_HEAP_LESS(lhs, rhs)    (*(lhs) < *(rhs))
+#define TYPED_HEAP_GREATER(lhs, rhs) (*(lhs) > *(rhs))
+
+// Sift loops walk one root-to-leaf path and build loops whole arrays; neither is capped by safe_*.
+
+#define TYPED_HEAP_DECLARE(name, type)                                 \
+  typedef struct name {                                                \
+    type* data;                                                        \
+    sz count;                                                          \
+    sz cap;                                                            \
+    allocator alloc;                                                   \
+  } name;                                                              \
+  func name name##_create(sz cap, allocator alloc);                    \
+  func void name##_destroy(name* hp);                                  \
+  func void name##_clear(name* hp);                                    \
+  func sz name##_count(name const* hp);                                \
+  func sz name##_capacity(name const* hp);                             \
+  func b32 name##_reserve(name* hp, sz min_count);                     \
+  func b32 name##_push(name* hp, type value);                          \
+  func b32 name##_push_many(name* hp, type const* values, sz count);   \
+  func b32 name##_pop(name* hp, type* out_value);                      \
+  func type* name##_peek(name* hp);                                    \
+  func sz name##_heapify(type* ptr, sz elem_count);                    \
+  func b32 name##_check(type const* ptr, sz elem_count);
+
+#define TYPED_HEAP_IMPLEMENT(name, type, less_fn, arity)                                        \
+  /* Moves the element at idx up along its path, shifting parents down into the hole. */        \
+  func void name##_sift_up(type* data, sz idx) {                                                \
+    type value = data[idx];                                                                     \
+    while (idx > 0) {                                                                           \
+      sz parent = (idx - 1) / (arity);                                                          \
+      if (!less_fn(&value, &data[parent])) {                                                    \
+        break;                                                                                  \
+      }                                                                                         \
+      data[idx] = data[parent];                                                                 \
+      idx = parent;                                                                             \
+    }                                                                                           \
+    data[idx] = value;                                                                          \
+  }                                                                                             \
+                                                                                                \
+  /* Moves the element at idx down, pulling the best child up into the hole. */                 \
+  func void name##_sift_down(type* data, sz idx, sz count) {                                    \
+    type value = data[idx];                                                                     \
+    for (;;) {                                                                                  \
+      sz first_child = idx * (arity) + 1;                                                       \
+      if (first_child >= count) {                                                               \
+        break;                                                                                  \
+      }                                                                                         \
+      sz last_child = count - first_child > (arity) ? first_child + (arity) : count;            \
+      sz best = first_child;                                                                    \
+      for (sz child = first_child + 1; child < last_child; child++) {                           \
+        if (less_fn(&data[child], &data[best])) {                                               \
+          best = child;                                                                         \
+        }                                                                                       \
+      }                                                                                         \
+      if (!less_fn(&data[best], &value)) {                                                      \
+        break;                                                                                  \
+      }                                                                                         \
+      data[idx] = data[best];                                                                   \
+      idx = best;                                                                               \
+    }                                                                                           \
+    data[idx] = value;                                                                          \
+  }                                                                                             \
+                                                                                                \
+  func name name##_create(sz cap, allocator alloc) {                                            \
+    name hp;                                                                                    \
+    mem_zero(&hp, size_of(hp));                                                                 \
+    hp.alloc = alloc;                                                                           \
+    if (hp.alloc.alloc_fn == NULL || hp.alloc.dealloc_fn == NULL) {                             \
+      hp.alloc = thread_get_allocator();                                                        \
+    }                                                                                           \
+    if (hp.alloc.alloc_fn == NULL || hp.alloc.dealloc_fn == NULL) {                             \
+      hp.alloc = global_get_allocator();                                                        \
+    }                                                                                           \
+    if (cap > 0 && hp.alloc.alloc_fn != NULL && hp.alloc.dealloc_fn != NULL) {                  \
+      name##_reserve(&hp, cap);                                                                 \
+    }                                                                                           \
+    return hp;                                                                                  \
+  }                                                                                             \
+                                                                                                \
+  func void name##_destroy(name* hp) {                                                          \
+    if (hp == NULL) {                                                                           \
+      return;                                                                                   \
+    }                                                                                           \
+    if (hp->data) {                                                                             \
+      allocator_dealloc(hp->alloc, hp->data);                                                   \
+    }                                                                                           \
+    hp->data = NULL;                                                                            \
+    hp->count = 0;                                                                              \
+    hp->cap = 0;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func void name##_clear(name* hp) {                                                            \
+    if (hp != NULL) {                                                                           \
+      hp->count = 0;                                                                            \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_count(name const* hp) {                                                        \
+    return hp != NULL ? hp->count : 0;                                                          \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_capacity(name const* hp) {                                                     \
+    return hp != NULL ? hp->cap : 0;                                                            \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_reserve(name* hp, sz min_count) {                                             \
+    if (hp == NULL || hp->alloc.alloc_fn == NULL) {                                             \
+      return false;                                                                             \
+    }                                                                                           \
+    if (hp->cap >= min_count) {                                                                 \
+      return true;                                                                              \
+    }                                                                                           \
+    sz new_cap = typed_array_grow_capacity(hp->cap, min_count);                                 \
+    if (new_cap > SZ_MAX / size_of(type)) {                                                     \
+      return false;                                                                             \
+    }                                                                                           \
+    type* data = (type*)typed_array_realloc(                                                    \
+        hp->alloc, hp->data, hp->count * size_of(type), new_cap * size_of(type));               \
+    if (data == NULL) {                                                                         \
+      thread_log_error("Failed to grow typed heap to %zu elements", new_cap);                   \
+      return false;                                                                             \
+    }                                                                                           \
+    hp->data = data;                                                                            \
+    hp->cap = new_cap;                                                                          \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_push(name* hp, type value) {                                                  \
+    if (hp == NULL) {                                                                           \
+      return false;                                                                             \
+    }                                                                                           \
+    if (hp->count == hp->cap && !name##_reserve(hp, hp->count + 1)) {                           \
+      return false;                                                                             \
+    }                                                                                           \
+    hp->data[hp->count] = value;                                                                \
+    name##_sift_up(hp->data, hp->count);                                                        \
+    hp->count++;                                                                                \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  /* Batches at least as large as the heap are absorbed by one O(n) rebuild. */                 \
+  func b32 name##_push_many(name* hp, type const* values, sz count) {                           \
+    if (hp == NULL || (values == NULL && count > 0) || count > SZ_MAX - hp->count) {            \
+      return false;                                                                             \
+    }                                                                                           \
+    if (!name##_reserve(hp, hp->count + count)) {                                               \
+      return false;                                                                             \
+    }                                                                                           \
+    sz old_count = hp->count;                                                                   \
+    if (count > 0) {                                                                            \
+      mem_cpy(hp->data + old_count, values, count * size_of(type));                             \
+    }                                                                                           \
+    hp->count += count;                                                                         \
+    if (count >= old_count) {                                                                   \
+      name##_heapify(hp->data, hp->count);                                                      \
+    } else {                                                                                    \
+      for (sz idx = old_count; idx < hp->count; idx++) {                                        \
+        name##_sift_up(hp->data, idx);                                                          \
+      }                                                                                         \
+    }                                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_pop(name* hp, type* out_value) {                                              \
+    if (hp == NULL || hp->count == 0) {                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    if (out_value != NULL) {                                                                    \
+      *out_value = hp->data[0];                                                                 \
+    }                                                                                           \
+    hp->count--;                                                                                \
+    if (hp->count > 0) {                                                                        \
+      hp->data[0] = hp->data[hp->count];                                                        \
+      name##_sift_down(hp->data, 0, hp->count);                                                 \
+    }                                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func type* name##_peek(name* hp) {                                                            \
+    return hp != NULL && hp->count > 0 ? hp->data : NULL;                                       \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_heapify(type* ptr, sz elem_count) {                                            \
+    profile_func_begin;                                                                         \
+    if (ptr == NULL) {                                                                          \
+      profile_func_end;                                                                         \
+      return 0;                                                                                 \
+    }                                                                                           \
+    if (elem_count > 1) {                                                                       \
+      for (sz idx = (elem_count - 2) / (arity) + 1; idx-- > 0;) {                               \
+        name##_sift_down(ptr, idx, elem_count);                                                 \
+      }                                                                                         \
+    }                                                                                           \
+    profile_func_end;                                                                           \
+    return elem_count;                                                                          \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_check(type const* ptr, sz elem_count) {                                       \
+    if (ptr == NULL) {                                                                          \
+      return false;                                                                             \
+    }                                                                                           \
+    for (sz idx = 1; idx < elem_count; idx++) {                                                 \
+      if (less_fn(&ptr[idx], &ptr[(idx - 1) / (arity)])) {                                      \
+        return false;                                                                           \
+      }                                                                                         \
+    }                                                                                           \
+    return true;                                                                                \
+  }
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -0,0 +1,391 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/profiler.h"
+#include "basic/safe.h"
+#include "basic/utility_defines.h"
+#include "context/global_ctx.h"
+#include "context/thread_ctx.h"
+#include "memory/allocator.h"
+#include "memory/memops.h"
+#include "strings/cstrings.h"
+#include "strings/strings.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+TYPED_MAP_DECLARE / TYPED_MAP_IMPLEMENT generate a hash map with typed keys
+and values stored inline, instead of hash_map's u64 keys and void* values.
+Keys, values and per-slot hash tags live in three parallel arrays carved from
+one allocation, so probing only walks the dense tag array and a lookup hands
+back a pointer straight into the value array, with no extra indirection.
+
+The map uses Robin Hood probing with backward-shift deletion like hash_map.
+Each slot keeps 31 bits of the key's hash. Probes compare the tag before they
+call the equality function, and rehashing never calls the hash function
+again, which matters for string keys.
+
+hash_fn has the signature u64 hash_fn(key_type const* key); its low bits pick
+the home slot, so they must be well mixed. eq_fn has the signature
+b32 eq_fn(key_type const* lhs, key_type const* rhs). Ready-made pairs exist for
+integer, byte-wise POD and string keys below.
+
+TYPED_MAP_DECLARE goes wherever the type is needed (usually a header),
+TYPED_MAP_IMPLEMENT in exactly one translation unit.
+
+Example:
+
+  typedef struct mesh_info {
+    u32 vertex_count;
+    u32 index_count;
+  } mesh_info;
+
+  TYPED_MAP_DECLARE(mesh_map, cstr8, mesh_info)
+  TYPED_MAP_IMPLEMENT(mesh_map, cstr8, mesh_info, typed_map_hash_cstr8, typed_map_eq_cstr8)
+
+  mesh_map meshes = mesh_map_create(64, (allocator){0});
+  mesh_map_set(&meshes, "cube", (mesh_info){.vertex_count = 24, .index_count = 36});
+
+  mesh_info* cube = mesh_map_get(&meshes, "cube");
+
+  TYPED_MAP_FOREACH(mesh_map, &meshes, idx) {
+    // meshes.keys[idx] and meshes.values[idx]
+  }
+
+  mesh_map_destroy(&meshes);
+
+Generated functions (for a map named name):
+
+  name     name_create(sz cap, allocator alloc);
+  void     name_destroy(name* map);
+  void     name_clear(name* map);
+  sz       name_count(name const* map);
+  sz       name_capacity(name const* map);
+  b32      name_reserve(name* map, sz min_count);
+  b32      name_set(name* map, key_type key, value_type value);
+  value_type* name_get(name* map, key_type key);   // NULL when absent; valid until the next set/remove
+  b32      name_has(name* map, key_type key);
+  b32      name_remove(name* map, key_type key);
+  sz       name_next(name* map, sz* iter);          // SZ_MAX when exhausted
+*/
+
+// =========================================================================
+// Hash / Equality Helpers
+// =========================================================================
+
+// Hash tag stored for occupied slots; the top bit marks the slot as used.
+#define TYPED_MAP_TAG_USED 0x80000000U
+
+// Integer keys.
+func u64 typed_map_hash_u32(u32 const* key);
+func b32 typed_map_eq_u32(u32 const* lhs, u32 const* rhs);
+func u64 typed_map_hash_u64(u64 const* key);
+func b32 typed_map_eq_u64(u64 const* lhs, u64 const* rhs);
+
+// Null-terminated and str8 string keys, compared by content.
+func u64 typed_map_hash_cstr8(cstr8 const* key);
+func b32 typed_map_eq_cstr8(cstr8 const* lhs, cstr8 const* rhs);
+func u64 typed_map_hash_str8(str8 const* key);
+func b32 typed_map_eq_str8(str8 const* lhs, str8 const* rhs);
+
+// Building blocks for struct keys. typed_map_hash_bytes suits plain structs
+// without padding; otherwise hash each field and fold them with
+// typed_map_hash_combine.
+func u64 typed_map_hash_bytes(void const* data, sz size);
+func u64 typed_map_hash_combine(u64 seed, u64 value);
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Rounds a requested slot count up to a power of two (at least 16).
+func sz typed_map_normalize_capacity(sz min_cap);
+
+// Computes the byte layout of the tag/key/value arrays for cap slots and
+// returns the total allocation size.
+func sz typed_map_layout(
+    sz cap,
+    sz key_size,
+    sz key_align,
+    sz value_size,
+    sz value_align,
+    sz* out_keys_offset,
+    sz* out_values_offset);
+
+// =========================================================================
+// Generator
+// =========================================================================
+
+#define TYPED_MAP_FOREACH(name, map, idx)                             \
+  for (sz cat_exp(_typed_map_iter_, idx) = 0,                         \
+          (idx) = name##_next((map), &cat_exp(_typed_map_iter_, idx)); \
+       (idx) != SZ_MAX;                                               \
+       (idx) = name##_next((map), &cat_exp(_typed_map_iter_, idx)))
+
+#define TYPED_MAP_DECLARE(name, key_type, value_type)                  \
+  typedef struct name {                                                \
+    u32* tags;                                                         \
+    key_type* keys;                                                    \
+    value_type* values;                                                \
+    sz count;                                                          \
+    sz cap;                                                            \
+    allocator alloc;                                                   \
+  } name;                                                              \
+  func name name##_create(sz cap, allocator alloc);                    \
+  func void name##_destroy(name* map);                                 \
+  func void name##_clear(name* map);                                   \
+  func sz name##_count(name const* map);                               \
+  func sz name##_capacity(name const* map);                            \
+  func b32 name##_reserve(name* map, sz min_count);                    \
+  func b32 name##_set(name* map, key_type key, value_type value);      \
+  func value_type* name##_get(name* map, key_type key);                \
+  func b32 name##_has(name* map, key_type key);                        \
+  func b32 name##_remove(name* map, key_type key);                     \
+  func sz name##_next(name* map, sz* iter);
+
+#define TYPED_MAP_IMPLEMENT(name, key_type, value_type, hash_fn, eq_fn)                         \
+  func u32 name##_tag(key_type const* key) {                                                    \
+    return (u32)hash_fn(key) | TYPED_MAP_TAG_USED;                                              \
+  }                                                                                             \
+                                                                                                \
+  /* Returns the slot index holding key, or SZ_MAX when absent. */                              \
+  func sz name##_find(name* map, key_type const* key, u32 tag) {                                \
+    sz mask = map->cap - 1;                                                                     \
+    sz pos = (sz)tag & mask;                                                                    \
+    sz dist = 0;                                                                                \
+    safe_for (;;) {                                                                             \
+      u32 cur = map->tags[pos];                                                                 \
+      if (cur == 0 || ((pos - ((sz)cur & mask)) & mask) < dist) {                               \
+        return SZ_MAX;                                                                          \
+      }                                                                                         \
+      if (cur == tag && eq_fn(&map->keys[pos], key)) {                                          \
+        return pos;                                                                             \
+      }                                                                                         \
+      pos = (pos + 1) & mask;                                                                   \
+      dist++;                                                                                   \
+    }                                                                                           \
+    return SZ_MAX;                                                                              \
+  }                                                                                             \
+                                                                                                \
+  /* Robin Hood insert of a key known to be absent. */                                          \
+  func void name##_raw_insert(name* map, u32 tag, key_type key, value_type value) {             \
+    sz mask = map->cap - 1;                                                                     \
+    sz pos = (sz)tag & mask;                                                                    \
+    sz dist = 0;                                                                                \
+    safe_for (;;) {                                                                             \
+      u32 cur = map->tags[pos];                                                                 \
+      if (cur == 0) {                                                                           \
+        map->tags[pos] = tag;                                                                   \
+        map->keys[pos] = key;                                                                   \
+        map->values[pos] = value;                                                               \
+        return;                                                                                 \
+      }                                                                                         \
+      sz cur_dist = (pos - ((sz)cur & mask)) & mask;                                            \
+      if (cur_dist < dist) {                                                                    \
+        key_type tmp_key = map->keys[pos];                                                      \
+        value_type tmp_value = map->values[pos];                                                \
+        map->tags[pos] = tag;                                                                   \
+        map->keys[pos] = key;                                                                   \
+        map->values[pos] = value;                                                               \
+        tag = cur;                                                                              \
+        key = tmp_key;                                                                          \
+        value = tmp_value;                                                                      \
+        dist = cur_dist;                                                                        \
+      }                                                                                         \
+      pos = (pos + 1) & mask;                                                                   \
+      dist++;                                                                                   \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Moves every entry into a fresh allocation of target_cap slots. */                         \
+  func b32 name##_resize(name* map, sz target_cap) {                                            \
+    profile_func_begin;                                                                         \
+    sz keys_offset = 0;                                                                         \
+    sz values_offset = 0;                                                                       \
+    sz total = typed_map_layout(target_cap,                                                     \
+                                size_of(key_type),                                              \
+                                align_of(key_type),                                             \
+                                size_of(value_type),                                            \
+                                align_of(value_type),                                           \
+                                &keys_offset,                                                   \
+                                &values_offset);                                                \
+    u8* memory = (u8*)allocator_alloc(map->alloc, total);                                       \
+    if (memory == NULL) {                                                                       \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    name old = *map;                                                                            \
+    map->tags = (u32*)memory;                                                                   \
+    map->keys = (key_type*)(memory + keys_offset);                                              \
+    map->values = (value_type*)(memory + values_offset);                                        \
+    map->cap = target_cap;                                                                      \
+    mem_zero(map->tags, target_cap * size_of(u32));                                             \
+    for (sz idx = 0; idx < old.cap; idx++) {                                                    \
+      if (old.tags[idx] != 0) {                                                                 \
+        name##_raw_insert(map, old.tags[idx], old.keys[idx], old.values[idx]);                  \
+      }                                                                                         \
+    }                                                                                           \
+    if (old.tags) {                                                                             \
+      allocator_dealloc(map->alloc, old.tags);                                                  \
+    }                                                                                           \
+    profile_func_end;                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func name name##_create(sz cap, allocator alloc) {                                            \
+    name map;                                                                                   \
+    mem_zero(&map, size_of(map));                                                               \
+    map.alloc = alloc;                                                                          \
+    if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {                           \
+      map.alloc = thread_get_allocator();                                                       \
+    }                                                                                           \
+    if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {                           \
+      map.alloc = global_get_allocator();                                                       \
+    }                                                                                           \
+    if (map.alloc.alloc_fn != NULL && map.alloc.dealloc_fn != NULL) {                           \
+      name##_resize(&map, typed_map_normalize_capacity(cap));                                   \
+    }                                                                                           \
+    return map;                                                                                 \
+  }                                                                                             \
+                                                                                                \
+  func void name##_destroy(name* map) {                                                         \
+    if (map == NULL) {                                                                          \
+      return;                                                                                   \
+    }                                                                                           \
+    if (map->tags) {                                                                            \
+      allocator_dealloc(map->alloc, map->tags);                                                 \
+    }                                                                                           \
+    map->tags = NULL;                                                                           \
+    map->keys = NULL;                                                                           \
+    map->values = NULL;                                                                         \
+    map->count = 0;                                                                             \
+    map->cap = 0;                                                                               \
+  }                                                                                             \
+                                                                                                \
+  func void name##_clear(name* map) {                                                           \
+    if (map == NULL) {                                                                          \
+      return;                                                                                   \
+    }                                                                                           \
+    if (map->tags) {                                                                            \
+      mem_zero(map->tags, map->cap * size_of(u32));                                             \
+    }                                                                                           \
+    map->count = 0;                                                                             \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_count(name const* map) {                                                       \
+    return map != NULL ? map->count : 0;                                                        \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_capacity(name const* map) {                                                    \
+    return map != NULL ? map->cap : 0;                                                          \
+  }                                                                                             \
+                                                                                                \
+  /* Grows so that min_count entries fit below the 75% load limit. */                          \
+  func b32 name##_reserve(name* map, sz min_count) {                                            \
+    if (map == NULL || map->tags == NULL) {                                                     \
+      return false;                                                                             \
+    }                                                                                           \
+    sz target_cap = typed_map_normalize_capacity(min_count + min_count / 3 + 1);                \
+    if (target_cap <= map->cap) {                                                               \
+      return true;                                                                              \
+    }                                                                                           \
+    return name##_resize(map, target_cap);                                                      \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_set(name* map, key_type key, value_type value) {                              \
+    profile_func_begin;                                                                         \
+    if (map == NULL || map->tags == NULL) {                                                     \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    u32 tag = name##_tag(&key);                                                                 \
+    sz idx = name##_find(map, &key, tag);                                                       \
+    if (idx != SZ_MAX) {                                                                        \
+      map->values[idx] = value;                                                                 \
+      profile_func_end;                                                                         \
+      return true;                                                                              \
+    }                                                                                           \
+    /* Rehash before inserting once load reaches 75%. */                                       \
+    if (map->count >= map->cap - (map->cap / 4)) {                                              \
+      if (!name##_resize(map, map->cap * 2)) {                                                  \
+        profile_func_end;                                                                       \
+        return false;                                                                           \
+      }                                                                                         \
+    }                                                                                           \
+    name##_raw_insert(map, tag, key, value);                                                    \
+    map->count++;                                                                               \
+    profile_func_end;                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func value_type* name##_get(name* map, key_type key) {                                        \
+    profile_func_begin;                                                                         \
+    if (map == NULL || map->tags == NULL || map->count == 0) {                                  \
+      profile_func_end;                                                                         \
+      return NULL;                                                                              \
+    }                                                                                           \
+    sz idx = name##_find(map, &key, name##_tag(&key));                                          \
+    profile_func_end;                                                                           \
+    return idx != SZ_MAX ? &map->values[idx] : NULL;                                            \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_has(name* map, key_type key) {                                                \
+    if (map == NULL || map->tags == NULL || map->count == 0) {                                  \
+      return false;                                                                             \
+    }                                                                                           \
+    return name##_find(map, &key, name##_tag(&key)) != SZ_MAX;                                  \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_remove(name* map, key_type key) {                                             \
+    profile_func_begin;                                                                         \
+    if (map == NULL || map->tags == NULL || map->count == 0) {                                  \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    sz cur = name##_find(map, &key, name##_tag(&key));                                          \
+    if (cur == SZ_MAX) {                                                                        \
+      profile_func_end;                                                                         \
+      return false;                                                                             \
+    }                                                                                           \
+    /* Backward-shift deletion keeps the Robin Hood invariant without tombstones. */            \
+    sz mask = map->cap - 1;                                                                     \
+    safe_for (;;) {                                                                             \
+      sz nxt = (cur + 1) & mask;                                                                \
+      u32 next_tag = map->tags[nxt];                                                            \
+      if (next_tag == 0 || ((nxt - ((sz)next_tag & mask)) & mask) == 0) {                       \
+        map->tags[cur] = 0;                                                                     \
+        break;                                                                                  \
+      }                                                                                         \
+      map->tags[cur] = next_tag;                                                                \
+      map->keys[cur] = map->keys[nxt];                                                          \
+      map->values[cur] = map->values[nxt];                                                      \
+      cur = nxt;                                                                                \
+    }                                                                                           \
+    map->count--;                                                                               \
+    profile_func_end;                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_next(name* map, sz* iter) {                                                    \
+    if (map == NULL || iter == NULL || map->tags == NULL) {                                     \
+      return SZ_MAX;                                                                            \
+    }                                                                                           \
+    while (*iter < map->cap) {                                                                  \
+      sz idx = *iter;                                                                           \
+      (*iter)++;                                                                                \
+      if (map->tags[idx] != 0) {                                                                \
+        return idx;                                                                             \
+      }                                                                                         \
+    }                                                                                           \
+    return SZ_MAX;                                                                              \
+  }
+
+// =========================================================================
+c_end;
+// =========================================================================
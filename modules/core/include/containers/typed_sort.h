@@ -0,0 +1,424 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "basic/intrinsics.h"
+#include "basic/keyword_defines.h"
+#include "basic/primitive_types.h"
+#include "basic/profiler.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+TYPED_SORT_DECLARE / TYPED_SORT_IMPLEMENT generate an in-place sort for one
+element type. It is the same pattern-defeating quicksort as sort_quick, but
+the comparison is a direct call the compiler can inline, and elements move as
+whole values instead of byte-wise through sort_compare_fn and an element size.
+Partitioning follows BlockQuicksort: comparisons are recorded into small
+offset blocks without branching on their result, and the misplaced elements
+are then swapped in bulk, so random keys do not pay for branch mispredictions.
+
+less_fn has the signature b32 less_fn(type const* lhs, type const* rhs) and
+returns nonzero when lhs sorts strictly before rhs. It may also be a
+function-like macro, such as TYPED_SORT_LESS for arithmetic types. The sort
+is not stable and needs no scratch memory. The worst case is O(n log n)
+thanks to the heapsort fallback.
+
+TYPED_SORT_DECLARE goes wherever the sort is needed (usually a header),
+TYPED_SORT_IMPLEMENT in exactly one translation unit.
+
+Example:
+
+  typedef struct draw_item {
+    u64 sort_key;
+    u32 mesh_idx;
+    u32 material_idx;
+  } draw_item;
+
+  func b32 draw_item_less(draw_item const* lhs, draw_item const* rhs) {
+    return lhs->sort_key < rhs->sort_key;
+  }
+
+  TYPED_SORT_DECLARE(draw_items, draw_item)
+  TYPED_SORT_IMPLEMENT(draw_items, draw_item, draw_item_less)
+
+  TYPED_SORT_DECLARE(floats, f32)
+  TYPED_SORT_IMPLEMENT(floats, f32, TYPED_SORT_LESS)
+
+  draw_items_sort(items, item_count);
+
+Generated functions (for a sort named name):
+
+  sz  name_sort(type* ptr, sz elem_count);          // Returns elem_count, or 0 when ptr is NULL.
+  b32 name_check(type const* ptr, sz elem_count);   // True when ptr is sorted.
+*/
+
+// Ranges below this size are finished with insertion sort.
+#define TYPED_SORT_INSERTION_THRESHOLD 24
+
+// Ranges above this size pick the pivot as the median of three medians.
+#define TYPED_SORT_NINTHER_THRESHOLD 128
+
+// Elements an optimistic insertion sort may move before it gives up.
+#define TYPED_SORT_PARTIAL_INSERTION_MAX 8
+
+// Comparisons recorded per offset block; offsets are stored as u8.
+#define TYPED_SORT_BLOCK_SIZE 64
+
+// less_fn for types with a built-in < operator.
+#define TYPED_SORT_LESS(lhs, rhs) (*(lhs) < *(rhs))
+
+#define TYPED_SORT_DECLARE(name, type)                               \
+  func sz name##_sort(type* ptr, sz elem_count);                     \
+  func b32 name##_check(type const* ptr, sz elem_count);
+
+#define TYPED_SORT_IMPLEMENT(name, type, less_fn)                                               \
+  func void name##_swap(type* ptr, sz lhs_idx, sz rhs_idx) {                                    \
+    type tmp = ptr[lhs_idx];                                                                    \
+    ptr[lhs_idx] = ptr[rhs_idx];                                                                \
+    ptr[rhs_idx] = tmp;                                                                         \
+  }                                                                                             \
+                                                                                                \
+  func void name##_sort3(type* ptr, sz a_idx, sz b_idx, sz c_idx) {                             \
+    if (less_fn(&ptr[b_idx], &ptr[a_idx])) {                                                    \
+      name##_swap(ptr, a_idx, b_idx);                                                           \
+    }                                                                                           \
+    if (less_fn(&ptr[c_idx], &ptr[b_idx])) {                                                    \
+      name##_swap(ptr, b_idx, c_idx);                                                           \
+      if (less_fn(&ptr[b_idx], &ptr[a_idx])) {                                                  \
+        name##_swap(ptr, a_idx, b_idx);                                                         \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Insertion sort that shifts elements into a hole instead of swapping. */                    \
+  func void name##_insertion(type* ptr, sz beg_idx, sz end_idx) {                               \
+    for (sz cur_idx = beg_idx + 1; cur_idx < end_idx; ++cur_idx) {                              \
+      if (less_fn(&ptr[cur_idx], &ptr[cur_idx - 1])) {                                          \
+        type tmp = ptr[cur_idx];                                                                \
+        sz pos_idx = cur_idx;                                                                   \
+        do {                                                                                    \
+          ptr[pos_idx] = ptr[pos_idx - 1];                                                      \
+          --pos_idx;                                                                            \
+        } while (pos_idx > beg_idx && less_fn(&tmp, &ptr[pos_idx - 1]));                        \
+        ptr[pos_idx] = tmp;                                                                     \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Same without the lower bound check; ptr[beg_idx - 1] must not exceed any element. */       \
+  func void name##_unguarded_insertion(type* ptr, sz beg_idx, sz end_idx) {                     \
+    for (sz cur_idx = beg_idx + 1; cur_idx < end_idx; ++cur_idx) {                              \
+      if (less_fn(&ptr[cur_idx], &ptr[cur_idx - 1])) {                                          \
+        type tmp = ptr[cur_idx];                                                                \
+        sz pos_idx = cur_idx;                                                                   \
+        do {                                                                                    \
+          ptr[pos_idx] = ptr[pos_idx - 1];                                                      \
+          --pos_idx;                                                                            \
+        } while (less_fn(&tmp, &ptr[pos_idx - 1]));                                             \
+        ptr[pos_idx] = tmp;                                                                     \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Gives up after moving TYPED_SORT_PARTIAL_INSERTION_MAX elements. */                        \
+  func b32 name##_partial_insertion(type* ptr, sz beg_idx, sz end_idx) {                        \
+    sz moved = 0;                                                                               \
+    for (sz cur_idx = beg_idx + 1; cur_idx < end_idx; ++cur_idx) {                              \
+      if (less_fn(&ptr[cur_idx], &ptr[cur_idx - 1])) {                                          \
+        type tmp = ptr[cur_idx];                                                                \
+        sz pos_idx = cur_idx;                                                                   \
+        do {                                                                                    \
+          ptr[pos_idx] = ptr[pos_idx - 1];                                                      \
+          --pos_idx;                                                                            \
+        } while (pos_idx > beg_idx && less_fn(&tmp, &ptr[pos_idx - 1]));                        \
+        ptr[pos_idx] = tmp;                                                                     \
+        moved += cur_idx - pos_idx;                                                             \
+        if (moved > TYPED_SORT_PARTIAL_INSERTION_MAX) {                                         \
+          return false;                                                                         \
+        }                                                                                       \
+      }                                                                                         \
+    }                                                                                           \
+    return true;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func void name##_sift_down(type* ptr, sz beg_idx, sz root, sz count) {                        \
+    type tmp = ptr[beg_idx + root];                                                             \
+    for (;;) {                                                                                  \
+      sz child = (root * 2) + 1;                                                                \
+      if (child >= count) {                                                                     \
+        break;                                                                                  \
+      }                                                                                         \
+      if (child + 1 < count && less_fn(&ptr[beg_idx + child], &ptr[beg_idx + child + 1])) {     \
+        child++;                                                                                \
+      }                                                                                         \
+      if (!less_fn(&tmp, &ptr[beg_idx + child])) {                                              \
+        break;                                                                                  \
+      }                                                                                         \
+      ptr[beg_idx + root] = ptr[beg_idx + child];                                               \
+      root = child;                                                                             \
+    }                                                                                           \
+    ptr[beg_idx + root] = tmp;                                                                  \
+  }                                                                                             \
+                                                                                                \
+  func void name##_heap(type* ptr, sz beg_idx, sz end_idx) {                                    \
+    sz count = end_idx - beg_idx;                                                               \
+    for (sz root = count / 2; root > 0; --root) {                                               \
+      name##_sift_down(ptr, beg_idx, root - 1, count);                                          \
+    }                                                                                           \
+    for (sz last = count - 1; last > 0; --last) {                                               \
+      name##_swap(ptr, beg_idx, beg_idx + last);                                                \
+      name##_sift_down(ptr, beg_idx, 0, last);                                                  \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Moves the misplaced elements recorded by the partition blocks. Equal block */              \
+  /* counts need real swaps to keep descending input linear; otherwise one */                   \
+  /* rotating hole saves a third of the moves. */                                               \
+  func void name##_swap_offsets(                                                                \
+      type* ptr, sz l_base, sz r_base, u8 const* offsets_l, u8 const* offsets_r, sz num,        \
+      b32 use_swaps) {                                                                          \
+    if (use_swaps) {                                                                            \
+      for (sz idx = 0; idx < num; ++idx) {                                                      \
+        name##_swap(ptr, l_base + offsets_l[idx], r_base - offsets_r[idx]);                     \
+      }                                                                                         \
+    } else if (num > 0) {                                                                       \
+      sz l_idx = l_base + offsets_l[0];                                                         \
+      sz r_idx = r_base - offsets_r[0];                                                         \
+      type tmp = ptr[l_idx];                                                                    \
+      ptr[l_idx] = ptr[r_idx];                                                                  \
+      for (sz idx = 1; idx < num; ++idx) {                                                      \
+        l_idx = l_base + offsets_l[idx];                                                        \
+        ptr[r_idx] = ptr[l_idx];                                                                \
+        r_idx = r_base - offsets_r[idx];                                                        \
+        ptr[l_idx] = ptr[r_idx];                                                                \
+      }                                                                                         \
+      ptr[r_idx] = tmp;                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Partitions [beg, end) around ptr[beg_idx] into < pivot and >= pivot. */                    \
+  /* Comparisons fill blocks of offsets without branching on their result */                    \
+  /* (BlockQuicksort), then the recorded elements are swapped in bulk. */                       \
+  func sz name##_partition_right(type* ptr, sz beg_idx, sz end_idx, b32* out_already) {         \
+    type pivot = ptr[beg_idx];                                                                  \
+    sz first = beg_idx;                                                                         \
+    sz last = end_idx;                                                                          \
+    while (less_fn(&ptr[++first], &pivot)) {                                                    \
+    }                                                                                           \
+    if (first - 1 == beg_idx) {                                                                 \
+      while (first < last && !less_fn(&ptr[--last], &pivot)) {                                  \
+      }                                                                                         \
+    } else {                                                                                    \
+      while (!less_fn(&ptr[--last], &pivot)) {                                                  \
+      }                                                                                         \
+    }                                                                                           \
+                                                                                                \
+    *out_already = first >= last;                                                               \
+    if (!*out_already) {                                                                        \
+      name##_swap(ptr, first, last);                                                            \
+      ++first;                                                                                  \
+                                                                                                \
+      u8 offsets_l[TYPED_SORT_BLOCK_SIZE];                                                      \
+      u8 offsets_r[TYPED_SORT_BLOCK_SIZE];                                                      \
+      sz l_base = first;                                                                        \
+      sz r_base = last;                                                                         \
+      sz num_l = 0;                                                                             \
+      sz num_r = 0;                                                                             \
+      sz start_l = 0;                                                                           \
+      sz start_r = 0;                                                                           \
+      while (first < last) {                                                                    \
+        sz num_unknown = last - first;                                                          \
+        sz left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;          \
+        sz right_split = num_r == 0 ? (num_unknown - left_split) : 0;                           \
+        if (left_split > TYPED_SORT_BLOCK_SIZE) {                                               \
+          left_split = TYPED_SORT_BLOCK_SIZE;                                                   \
+        }                                                                                       \
+        if (right_split > TYPED_SORT_BLOCK_SIZE) {                                              \
+          right_split = TYPED_SORT_BLOCK_SIZE;                                                  \
+        }                                                                                       \
+        for (sz idx = 0; idx < left_split; ++idx) {                                             \
+          offsets_l[num_l] = (u8)idx;                                                           \
+          num_l += less_fn(&ptr[first], &pivot) == 0;                                           \
+          ++first;                                                                              \
+        }                                                                                       \
+        for (sz idx = 0; idx < right_split;) {                                                  \
+          offsets_r[num_r] = (u8)++idx;                                                         \
+          num_r += less_fn(&ptr[--last], &pivot) != 0;                                          \
+        }                                                                                       \
+                                                                                                \
+        sz num = num_l < num_r ? num_l : num_r;                                                 \
+        b32 use_swaps = num_l == num_r;                                                         \
+        name##_swap_offsets(                                                                    \
+            ptr, l_base, r_base, offsets_l + start_l, offsets_r + start_r, num, use_swaps);     \
+        num_l -= num;                                                                           \
+        num_r -= num;                                                                           \
+        start_l += num;                                                                         \
+        start_r += num;                                                                         \
+        if (num_l == 0) {                                                                       \
+          start_l = 0;                                                                          \
+          l_base = first;                                                                       \
+        }                                                                                       \
+        if (num_r == 0) {                                                                       \
+          start_r = 0;                                                                          \
+          r_base = last;                                                                        \
+        }                                                                                       \
+      }                                                                                         \
+                                                                                                \
+      /* One block may still hold misplaced elements; move them next to the split. */           \
+      if (num_l) {                                                                              \
+        while (num_l--) {                                                                       \
+          name##_swap(ptr, l_base + offsets_l[start_l + num_l], --last);                        \
+        }                                                                                       \
+        first = last;                                                                           \
+      }                                                                                         \
+      if (num_r) {                                                                              \
+        while (num_r--) {                                                                       \
+          name##_swap(ptr, r_base - offsets_r[start_r + num_r], first);                         \
+          ++first;                                                                              \
+        }                                                                                       \
+      }                                                                                         \
+    }                                                                                           \
+                                                                                                \
+    sz pivot_idx = first - 1;                                                                   \
+    ptr[beg_idx] = ptr[pivot_idx];                                                              \
+    ptr[pivot_idx] = pivot;                                                                     \
+    return pivot_idx;                                                                           \
+  }                                                                                             \
+                                                                                                \
+  /* Partitions [beg, end) into <= pivot and > pivot, for runs equal to the last pivot. */      \
+  func sz name##_partition_left(type* ptr, sz beg_idx, sz end_idx) {                            \
+    type pivot = ptr[beg_idx];                                                                  \
+    sz first = beg_idx;                                                                         \
+    sz last = end_idx;                                                                          \
+    while (less_fn(&pivot, &ptr[--last])) {                                                     \
+    }                                                                                           \
+    if (last + 1 == end_idx) {                                                                  \
+      while (first < last && !less_fn(&pivot, &ptr[++first])) {                                 \
+      }                                                                                         \
+    } else {                                                                                    \
+      while (!less_fn(&pivot, &ptr[++first])) {                                                 \
+      }                                                                                         \
+    }                                                                                           \
+    while (first < last) {                                                                      \
+      name##_swap(ptr, first, last);                                                            \
+      while (less_fn(&pivot, &ptr[--last])) {                                                   \
+      }                                                                                         \
+      while (!less_fn(&pivot, &ptr[++first])) {                                                 \
+      }                                                                                         \
+    }                                                                                           \
+    ptr[beg_idx] = ptr[last];                                                                   \
+    ptr[last] = pivot;                                                                          \
+    return last;                                                                                \
+  }                                                                                             \
+                                                                                                \
+  func void name##_break_patterns(                                                              \
+      type* ptr, sz pivot_idx, sz l_size, sz r_size, sz beg_idx, sz end_idx) {                  \
+    if (l_size >= TYPED_SORT_INSERTION_THRESHOLD) {                                             \
+      name##_swap(ptr, beg_idx, beg_idx + (l_size / 4));                                        \
+      name##_swap(ptr, pivot_idx - 1, pivot_idx - (l_size / 4));                                \
+      if (l_size > TYPED_SORT_NINTHER_THRESHOLD) {                                              \
+        name##_swap(ptr, beg_idx + 1, beg_idx + (l_size / 4 + 1));                              \
+        name##_swap(ptr, beg_idx + 2, beg_idx + (l_size / 4 + 2));                              \
+        name##_swap(ptr, pivot_idx - 2, pivot_idx - (l_size / 4 + 1));                          \
+        name##_swap(ptr, pivot_idx - 3, pivot_idx - (l_size / 4 + 2));                          \
+      }                                                                                         \
+    }                                                                                           \
+    if (r_size >= TYPED_SORT_INSERTION_THRESHOLD) {                                             \
+      name##_swap(ptr, pivot_idx + 1, pivot_idx + (1 + r_size / 4));                            \
+      name##_swap(ptr, end_idx - 1, end_idx - (r_size / 4));                                    \
+      if (r_size > TYPED_SORT_NINTHER_THRESHOLD) {                                              \
+        name##_swap(ptr, pivot_idx + 2, pivot_idx + (2 + r_size / 4));                          \
+        name##_swap(ptr, pivot_idx + 3, pivot_idx + (3 + r_size / 4));                          \
+        name##_swap(ptr, end_idx - 2, end_idx - (1 + r_size / 4));                              \
+        name##_swap(ptr, end_idx - 3, end_idx - (2 + r_size / 4));                              \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  func void name##_loop(type* ptr, sz beg_idx, sz end_idx, i32 bad_allowed, b32 leftmost) {     \
+    for (;;) {                                                                                  \
+      sz size = end_idx - beg_idx;                                                              \
+      if (size < TYPED_SORT_INSERTION_THRESHOLD) {                                              \
+        if (leftmost) {                                                                         \
+          name##_insertion(ptr, beg_idx, end_idx);                                              \
+        } else {                                                                                \
+          name##_unguarded_insertion(ptr, beg_idx, end_idx);                                    \
+        }                                                                                       \
+        return;                                                                                 \
+      }                                                                                         \
+                                                                                                \
+      sz half = size / 2;                                                                       \
+      if (size > TYPED_SORT_NINTHER_THRESHOLD) {                                                \
+        name##_sort3(ptr, beg_idx, beg_idx + half, end_idx - 1);                                \
+        name##_sort3(ptr, beg_idx + 1, beg_idx + (half - 1), end_idx - 2);                      \
+        name##_sort3(ptr, beg_idx + 2, beg_idx + (half + 1), end_idx - 3);                      \
+        name##_sort3(ptr, beg_idx + (half - 1), beg_idx + half, beg_idx + (half + 1));          \
+        name##_swap(ptr, beg_idx, beg_idx + half);                                              \
+      } else {                                                                                  \
+        name##_sort3(ptr, beg_idx + half, beg_idx, end_idx - 1);                                \
+      }                                                                                         \
+                                                                                                \
+      if (!leftmost && !less_fn(&ptr[beg_idx - 1], &ptr[beg_idx])) {                            \
+        beg_idx = name##_partition_left(ptr, beg_idx, end_idx) + 1;                             \
+        continue;                                                                               \
+      }                                                                                         \
+                                                                                                \
+      b32 already_partitioned = false;                                                          \
+      sz pivot_idx = name##_partition_right(ptr, beg_idx, end_idx, &already_partitioned);       \
+      sz l_size = pivot_idx - beg_idx;                                                          \
+      sz r_size = end_idx - (pivot_idx + 1);                                                    \
+                                                                                                \
+      if (l_size < size / 8 || r_size < size / 8) {                                             \
+        if (--bad_allowed == 0) {                                                               \
+          name##_heap(ptr, beg_idx, end_idx);                                                   \
+          return;                                                                               \
+        }                                                                                       \
+        name##_break_patterns(ptr, pivot_idx, l_size, r_size, beg_idx, end_idx);                \
+      } else if (already_partitioned &&                                                         \
+                 name##_partial_insertion(ptr, beg_idx, pivot_idx) &&                           \
+                 name##_partial_insertion(ptr, pivot_idx + 1, end_idx)) {                       \
+        return;                                                                                 \
+      }                                                                                         \
+                                                                                                \
+      if (l_size < r_size) {                                                                    \
+        name##_loop(ptr, beg_idx, pivot_idx, bad_allowed, leftmost);                            \
+        beg_idx = pivot_idx + 1;                                                                \
+        leftmost = false;                                                                       \
+      } else {                                                                                  \
+        name##_loop(ptr, pivot_idx + 1, end_idx, bad_allowed, false);                           \
+        end_idx = pivot_idx;                                                                    \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  func sz name##_sort(type* ptr, sz elem_count) {                                               \
+    profile_func_begin;                                                                         \
+    if (elem_count < 2) {                                                                       \
+      profile_func_end;                                                                         \
+      return elem_count;                                                                        \
+    }                                                                                           \
+    if (ptr == NULL) {                                                                          \
+      profile_func_end;                                                                         \
+      return 0;                                                                                 \
+    }                                                                                           \
+    name##_loop(ptr, 0, elem_count, bsr_u64((u64)elem_count), true);                            \
+    profile_func_end;                                                                           \
+    return elem_count;                                                                          \
+  }                                                                                             \
+                                                                                                \
+  func b32 name##_check(type const* ptr, sz elem_count) {                                       \
+    for (sz idx = 1; idx < elem_count; ++idx) {                                                 \
+      if (less_fn(&ptr[idx], &ptr[idx - 1])) {                                                  \
+        return false;                                                                           \
+      }                                                                                         \
+    }                                                                                           \
+    return true;                                                                                \
+  }
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -174,6 +174,7 @@ typedef enum msg_core_object_type {
   MSG_CORE_OBJECT_TYPE_FILEMAP = 16,
   MSG_CORE_OBJECT_TYPE_FILESTREAM = 17,
   MSG_CORE_OBJECT_TYPE_PIPE = 18,
+  MSG_CORE_OBJECT_TYPE_HEAP_CACHE = 19,
 } msg_core_object_type;
 
 typedef enum msg_core_thread_ctx_event_kind {
@@ -29,10 +29,20 @@ typedef struct arena_block {
 // Arena
 // =========================================================================
 
+// Virtual arenas commit address space in steps of at least this many bytes
+// (or one page, whichever is larger) so that steady growth does not issue a
+// commit call per allocation. The first step stays committed across arena_clear.
+#define ARENA_VMEM_COMMIT_GRANULE (64 * 1024)
+
 // A linear (bump-pointer) allocator. Allocations are O(1) and advance a cursor
 // within a chain of memory blocks. Individual frees are not supported; reclaim
 // all memory at once with arena_clear, or release everything with arena_destroy.
 //
+// A virtual arena (arena_create_virtual) instead reserves one contiguous address
+// range up front and lives in a single block at its base. Pages are committed on
+// demand as the cursor advances, so the top allocation can always grow in place
+// until the reservation is exhausted.
+//
 // Thread safety is optional: supply a valid mutex in opt_mutex to enable it,
 // or pass NULL to treat the arena as single-threaded.
 typedef struct arena {
@@ -41,6 +51,8 @@ typedef struct arena {
   allocator parent;     // Grows by allocating new blocks; zeroed means no parent.
   mutex opt_mutex;      // Thread-safety guard; NULL means no locking.
   sz default_block_sz;  // Byte size of blocks auto-allocated from parent.
+  u8* vmem_base;        // Base of the reserved range of a virtual arena; NULL otherwise.
+  sz vmem_reserved;     // Bytes of address space reserved at vmem_base.
   b8 mutex_owned;       // True when opt_mutex was created by arena_create_mutexed.
 } arena;
 
@@ -61,16 +73,33 @@ func arena _arena_create(
 // default_block_sz — same as arena_create.
 func arena _arena_create_mutexed(allocator parent_alloc, sz default_block_sz, callsite site);
 
+// Creates a virtual arena backed by a single vmem reservation.
+// reserve_size — bytes of address space to reserve, rounded up to the page size;
+//                this is the hard capacity of the arena.
+// opt_mutex    — mutex that guards every operation; pass NULL to disable locking.
+// Only the first commit step is backed by physical memory after creation.
+// Returns a zeroed arena if the reservation fails.
+func arena _arena_create_virtual(sz reserve_size, mutex opt_mutex, callsite site);
+
+// Creates a virtual arena and internally allocates a dedicated mutex.
+// The mutex is destroyed automatically by arena_destroy.
+func arena _arena_create_virtual_mutexed(sz reserve_size, callsite site);
+
 // Releases all blocks that were auto-allocated through the parent allocator and
 // resets the arena to its initial empty state. Manually added blocks are detached
-// but their memory is not freed. If the arena owns its mutex (created via
-// arena_create_mutexed), the mutex is also destroyed.
+// but their memory is not freed. The reservation of a virtual arena is released.
+// If the arena owns its mutex (created via arena_create_mutexed), the mutex is
+// also destroyed.
 func void _arena_destroy(arena* arn, callsite site);
 
 #define arena_create(parent_alloc, opt_mutex, default_block_sz) \
   _arena_create(parent_alloc, opt_mutex, default_block_sz, CALLSITE_HERE)
 #define arena_create_mutexed(parent_alloc, default_block_sz) \
   _arena_create_mutexed(parent_alloc, default_block_sz, CALLSITE_HERE)
+#define arena_create_virtual(reserve_size, opt_mutex) \
+  _arena_create_virtual(reserve_size, opt_mutex, CALLSITE_HERE)
+#define arena_create_virtual_mutexed(reserve_size) \
+  _arena_create_virtual_mutexed(reserve_size, CALLSITE_HERE)
 #define arena_destroy(arn) \
   _arena_destroy(arn, CALLSITE_HERE)
 
@@ -91,6 +120,7 @@ func void arena_add_block(arena* arn, void* ptr, sz size);
 
 // Detaches the manually-added block whose base address equals ptr.
 // Any memory previously allocated from that block is invalidated by this call.
+// The reserved block of a virtual arena cannot be removed.
 // Returns true if the block was found and removed, false otherwise.
 func b32 arena_remove_block(arena* arn, void* ptr);
 
@@ -101,12 +131,14 @@ func b32 arena_remove_block(arena* arn, void* ptr);
 // Allocates size bytes with the given power-of-two alignment from the arena.
 // Walks the block chain for a block with enough remaining space; when none exists,
 // tries to grow by allocating a new block from the parent allocator.
+// A virtual arena commits more of its reservation instead.
 // Returns NULL if the request cannot be satisfied.
 func void* _arena_alloc(arena* arn, sz size, sz align, callsite site);
 
 // Resizes a previous arena allocation.
 // When the allocation sits at the cursor of its block and there is room, it is
-// extended in place. Otherwise a fresh region is allocated and old_size bytes
+// extended in place. In a virtual arena the room includes every uncommitted byte
+// left in the reservation. Otherwise a fresh region is allocated and old_size bytes
 // are copied into it (the old region is not reclaimed).
 // Returns NULL if the new allocation cannot be satisfied.
 func void* _arena_realloc(
@@ -140,8 +172,13 @@ func void* _arena_realloc(
 
 // Resets the cursor of every block back to its post-header pos, making all
 // memory available for reuse. No blocks are released to the parent allocator.
+// A virtual arena decommits everything past its first commit step, so the
+// physical memory is returned to the OS while the address range stays reserved.
 func void arena_clear(arena* arn);
 
+// Returns true when arn was created by arena_create_virtual.
+func b32 arena_is_virtual(arena* arn);
+
 // Aggregate arena statistics.
 func sz arena_block_count(arena* arn);
 func sz arena_total_size(arena* arn);
@@ -18,10 +18,13 @@ c_begin;
 // Intrusive header placed immediately before every allocation within a heap block.
 // User-visible data starts at (u8*)(chunk + 1) + align_pad.
 // align_pad is stored here so heap_dealloc can recover the chunk pointer from
-// any arbitrarily aligned user pointer.
+// any arbitrarily aligned user pointer. prev_in_block acts as the boundary tag
+// that lets dealloc merge with the preceding neighbour without scanning the block.
 typedef struct heap_chunk {
   struct heap_chunk* next_in_block;  // Next chunk (free or used) in the same block.
-  struct heap_chunk* next_free;      // Next free chunk in the global free list (valid when is_free).
+  struct heap_chunk* prev_in_block;  // Previous chunk (free or used) in the same block.
+  struct heap_chunk* next_free;      // Next free chunk in the same size class (valid when is_free).
+  struct heap_chunk* prev_free;      // Previous free chunk in the same size class (valid when is_free).
   sz size;                           // Usable data bytes, excluding this header and align_pad.
   sz align_pad;                      // Padding bytes inserted between this header and user data.
   b8 is_free;
@@ -43,20 +46,34 @@ typedef struct heap_block {
 // Heap
 // =========================================================================
 
-// A general-purpose allocator that supports O(1)-amortised alloc, dealloc, and realloc.
-// Memory is carved from a chain of blocks; adjacent free chunks are coalesced on dealloc
-// to reduce fragmentation.
+// Free chunks are indexed with a two-level segregated fit (TLSF) scheme.
+// The first level splits sizes into power-of-two ranges, the second level
+// subdivides every range into HEAP_SL_COUNT linear classes.
+// Sizes beyond the last first-level range all share the top class.
+#define HEAP_SL_LOG2  3
+#define HEAP_SL_COUNT (1 << HEAP_SL_LOG2)
+#define HEAP_FL_COUNT 32
+
+// A general-purpose allocator that supports O(1) alloc, dealloc, and realloc.
+// Memory is carved from a chain of blocks; free chunks are coalesced with both
+// neighbours on dealloc to reduce fragmentation. Free chunks live in per-size-class doubly-linked lists and
+// two bitmaps locate the smallest non-empty class that fits a request in constant time,
+// so the cost of an operation does not grow with the number of live chunks.
 //
 // Thread safety is optional: supply a valid mutex in opt_mutex to enable it,
 // or pass NULL to treat the heap as single-threaded.
 typedef struct heap {
   heap_block* blocks_head;
   heap_block* blocks_tail;
-  heap_chunk* free_head;  // Head of the singly-linked free-chunk list.
-  allocator parent;       // Grows by allocating new blocks; zeroed means no parent.
-  mutex opt_mutex;        // Thread-safety guard; NULL means no locking.
-  sz default_block_sz;    // Byte size of blocks auto-allocated from parent.
-  b8 mutex_owned;         // True when opt_mutex was created by heap_create_mutexed.
+  u32 fl_bitmap;                                         // Bit f set when any list in row f is non-empty.
+  u32 sl_bitmap[HEAP_FL_COUNT];                          // Bit s of row f set when free_lists[f][s] is non-empty.
+  heap_chunk* free_lists[HEAP_FL_COUNT][HEAP_SL_COUNT];  // Heads of the per-class free-chunk lists.
+  allocator parent;                                      // Grows by allocating new blocks; zeroed means no parent.
+  mutex opt_mutex;                                       // Thread-safety guard; NULL means no locking.
+  sz default_block_sz;                                   // Byte size of blocks auto-allocated from parent.
+  sz free_size;                                          // Usable bytes currently held by free chunks.
+  sz trim_threshold;                                     // Free bytes kept before empty owned blocks are released; 0 disables.
+  b8 mutex_owned;                                        // True when opt_mutex was created by heap_create_mutexed.
 } heap;
 
 // Creates a new heap.
@@ -109,13 +126,16 @@ func b32 heap_remove_block(heap* hep, void* ptr);
 // =========================================================================
 
 // Allocates size bytes with the given power-of-two alignment.
-// Uses a first-fit free-list strategy; splits oversized free chunks to reduce waste.
+// Uses a good-fit segregated free-list strategy; splits oversized free chunks to reduce waste.
 // Grows via the parent allocator when no existing free chunk can satisfy the request.
 // Returns NULL if the request cannot be satisfied.
 func void* _heap_alloc(heap* hep, sz size, sz align, callsite site);
 
 // Returns a previously heap-allocated pointer to the free list.
-// Coalesces with adjacent free chunks to reduce fragmentation.
+// Coalesces with the previous and next chunks when they are free.
+// When a trim threshold is set and the merged chunk spans a whole owned block,
+// the block is handed back to the parent as long as the heap keeps at least
+// trim_threshold free bytes afterwards.
 // The chunk size is read from the embedded header; no size argument is required.
 func void _heap_dealloc(heap* hep, void* ptr, callsite site);
 
@@ -131,10 +151,28 @@ func void* _heap_realloc(
     sz align,
     callsite site);
 
+// Returns the usable byte size of a live allocation returned by heap_alloc/heap_realloc.
+// The result is at least the requested size and may be larger when the chunk absorbed
+// a remainder too small to split off. Does not lock: the caller owns ptr.
+func sz heap_usable_size(void* ptr);
+
+// Allocates up to count chunks of size bytes with the given alignment into out_ptrs
+// under a single lock acquisition. Returns the number of pointers written, which is
+// less than count only when the heap cannot grow any further.
+func sz _heap_alloc_batch(heap* hep, void** out_ptrs, sz count, sz size, sz align, callsite site);
+
+// Returns count allocations to the heap under a single lock acquisition.
+// NULL entries in ptrs are skipped.
+func void _heap_dealloc_batch(heap* hep, void** ptrs, sz count, callsite site);
+
 #define heap_alloc(hp, size, align) \
   _heap_alloc(hp, size, align, CALLSITE_HERE)
 #define heap_dealloc(hp, ptr) \
   _heap_dealloc(hp, ptr, CALLSITE_HERE)
+#define heap_alloc_batch(hp, out_ptrs, count, size, align) \
+  _heap_alloc_batch(hp, out_ptrs, count, size, align, CALLSITE_HERE)
+#define heap_dealloc_batch(hp, ptrs, count) \
+  _heap_dealloc_batch(hp, ptrs, count, CALLSITE_HERE)
 #define heap_realloc(hp, ptr, old_size, new_size, align) \
   _heap_realloc(hp, ptr, old_size, new_size, align, CALLSITE_HERE)
 
@@ -157,6 +195,14 @@ func void* _heap_realloc(
 // This effectively resets the heap to an empty state while keeping reserved memory.
 func void heap_clear(heap* hep);
 
+// Returns every owned block that holds no live allocation to the parent allocator.
+// Manually added blocks are never released. Returns the number of bytes released.
+func sz heap_trim(heap* hep);
+
+// Sets the automatic trim threshold used by heap_dealloc (see above).
+// Pass 0 to keep empty blocks until heap_trim or heap_destroy is called.
+func void heap_set_trim_threshold(heap* hep, sz threshold);
+
 // Aggregate heap statistics.
 func sz heap_block_count(heap* hep);
 func sz heap_total_size(heap* hep);
@@ -0,0 +1,108 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "../basic/codespace.h"
+#include "allocator.h"
+#include "heap.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// =========================================================================
+// Heap Cache
+// =========================================================================
+
+// Size classes served from the cache. Requests above HEAP_CACHE_MAX_SIZE, or with
+// an alignment stricter than HEAP_CACHE_ALIGN, bypass the cache entirely.
+#define HEAP_CACHE_CLASS_COUNT 12
+#define HEAP_CACHE_MAX_SIZE    1024
+#define HEAP_CACHE_ALIGN       16
+
+// Slots per size class. Refills and flushes move half a magazine at a time.
+#define HEAP_CACHE_BIN_CAP   32
+#define HEAP_CACHE_BIN_BATCH (HEAP_CACHE_BIN_CAP / 2)
+
+// A magazine of free chunks of one size class, used as a LIFO stack.
+typedef struct heap_cache_bin {
+  u32 count;
+  void* slots[HEAP_CACHE_BIN_CAP];
+} heap_cache_bin;
+
+// A single-threaded caching front-end for a shared (usually mutexed) heap.
+// Small allocations are served from per-class magazines without touching the
+// shared heap. An empty magazine is refilled, and a full one is flushed, in
+// batches under a single acquisition of the shared heap's mutex, so the lock is
+// taken roughly once per HEAP_CACHE_BIN_BATCH operations instead of every time.
+//
+// A cache must only be used by the thread that owns it; create one per worker
+// thread in front of the same shared heap (e.g. global_get_perm_heap()).
+// Pointers may be freed through any cache or directly through the shared heap,
+// because every cached chunk is an ordinary live allocation of that heap.
+typedef struct heap_cache {
+  heap* shared;                                 // Backing heap; never owned by the cache.
+  heap_cache_bin bins[HEAP_CACHE_CLASS_COUNT];  // One magazine per size class.
+  sz refill_count;                              // Number of batched refills from the shared heap.
+  sz flush_count;                               // Number of batched flushes to the shared heap.
+} heap_cache;
+
+// Creates a cache in front of shared. shared must outlive the cache.
+func heap_cache _heap_cache_create(heap* shared, callsite site);
+
+// Returns every cached chunk to the shared heap and zeroes the cache.
+func void _heap_cache_destroy(heap_cache* cache, callsite site);
+
+#define heap_cache_create(shared) \
+  _heap_cache_create(shared, CALLSITE_HERE)
+#define heap_cache_destroy(cache) \
+  _heap_cache_destroy(cache, CALLSITE_HERE)
+
+// Returns an allocator interface backed by cache.
+// The returned allocator stores a pointer to cache; it must only be used by the
+// thread that owns the cache, and the cache must outlive the allocator.
+func allocator heap_cache_get_allocator(heap_cache* cache);
+
+// =========================================================================
+// Allocation
+// =========================================================================
+
+// Allocates size bytes with the given power-of-two alignment.
+// Served from the matching magazine when possible; otherwise forwarded to the shared heap.
+func void* _heap_cache_alloc(heap_cache* cache, sz size, sz align, callsite site);
+
+// Returns ptr to the matching magazine, flushing half of it to the shared heap when full.
+// ptr must have been allocated from the shared heap (directly or through any cache).
+func void _heap_cache_dealloc(heap_cache* cache, void* ptr, callsite site);
+
+// Resizes a previous allocation. Stays in place when the usable size already fits;
+// otherwise allocates through the cache, copies, and frees the old pointer.
+func void* _heap_cache_realloc(
+    heap_cache* cache,
+    void* ptr,
+    sz old_size,
+    sz new_size,
+    sz align,
+    callsite site);
+
+#define heap_cache_alloc(cache, size, align) \
+  _heap_cache_alloc(cache, size, align, CALLSITE_HERE)
+#define heap_cache_dealloc(cache, ptr) \
+  _heap_cache_dealloc(cache, ptr, CALLSITE_HERE)
+#define heap_cache_realloc(cache, ptr, old_size, new_size, align) \
+  _heap_cache_realloc(cache, ptr, old_size, new_size, align, CALLSITE_HERE)
+
+// =========================================================================
+// Maintenance
+// =========================================================================
+
+// Returns every cached chunk to the shared heap, one batched call per size class.
+func void heap_cache_flush(heap_cache* cache);
+
+// Number of chunks currently held by the cache across all size classes.
+func sz heap_cache_cached_count(heap_cache* cache);
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../basic/codespace.h"
+#include "../threads/atomics.h"
 #include "../threads/mutex.h"
 #include "allocator.h"
 
@@ -33,17 +34,22 @@ typedef struct pool_block {
 // are supported; bulk reclaim is available via pool_clear.
 //
 // Thread safety is optional: supply a valid mutex in opt_mutex to enable it,
-// or pass NULL to treat the pool as single-threaded.
+// or pass NULL to treat the pool as single-threaded. Pools created with
+// pool_create_lockfree instead keep the free list in tagged_head and only take
+// opt_mutex to grow or for maintenance calls.
 typedef struct pool {
   pool_block* blocks_head;
   pool_block* blocks_tail;
-  void* free_head;      // Head of the intrusive free list (stored within free slots).
-  allocator parent;     // Grows by allocating new blocks; zeroed means no parent.
-  mutex opt_mutex;      // Thread-safety guard; NULL means no locking.
-  sz default_block_sz;  // Byte size of blocks auto-allocated from parent.
-  sz object_size;       // Fixed allocation size for every slot.
-  sz object_align;      // Required alignment for every slot; must be a power of two.
-  b8 mutex_owned;       // True when opt_mutex was created by pool_create_mutexed.
+  void* free_head;         // Head of the intrusive free list (stored within free slots).
+  atomic_u64 tagged_head;  // Lock-free mode: free-list head packed with an ABA tag.
+  atomic_i64 free_slots;   // Lock-free mode: slots on the tagged free list; may briefly lag behind it.
+  allocator parent;        // Grows by allocating new blocks; zeroed means no parent.
+  mutex opt_mutex;         // Thread-safety guard; NULL means no locking.
+  sz default_block_sz;     // Byte size of blocks auto-allocated from parent.
+  sz object_size;          // Fixed allocation size for every slot.
+  sz object_align;         // Required alignment for every slot; must be a power of two.
+  b8 mutex_owned;          // True when opt_mutex was created by pool_create_mutexed.
+  b8 lockfree;             // True when created by pool_create_lockfree.
 } pool;
 
 // Creates a new pool.
@@ -74,6 +80,25 @@ func pool _pool_create_mutexed(
     sz object_align,
     callsite site);
 
+// Creates a pool whose alloc and dealloc never block. The free list is a Treiber
+// stack whose head carries a modification tag next to the slot pointer, so a slot
+// that is popped and pushed back between another thread's read and compare-and-swap
+// cannot corrupt the list (ABA). A dedicated mutex is created and only taken when the
+// free list runs dry and a new block has to be chained, and by the block management,
+// clear, and statistics calls. Blocks are only released by pool_destroy, which keeps
+// every slot address valid for concurrent readers.
+// pool_clear and pool_remove_block must not race with alloc or dealloc.
+// parent_alloc     — same as pool_create.
+// default_block_sz — same as pool_create.
+// object_size      — same as pool_create.
+// object_align     — same as pool_create.
+func pool _pool_create_lockfree(
+    allocator parent_alloc,
+    sz default_block_sz,
+    sz object_size,
+    sz object_align,
+    callsite site);
+
 // Releases all blocks that were auto-allocated through the parent allocator and
 // resets the pool to its initial empty state. Manually added blocks are detached
 // but their memory is not freed. If the pool owns its mutex (created via
@@ -84,6 +109,8 @@ func void _pool_destroy(pool* pol, callsite site);
   _pool_create(parent_alloc, opt_mutex, default_block_sz, object_size, object_align, CALLSITE_HERE)
 #define pool_create_mutexed(parent_alloc, default_block_sz, object_size, object_align) \
   _pool_create_mutexed(parent_alloc, default_block_sz, object_size, object_align, CALLSITE_HERE)
+#define pool_create_lockfree(parent_alloc, default_block_sz, object_size, object_align) \
+  _pool_create_lockfree(parent_alloc, default_block_sz, object_size, object_align, CALLSITE_HERE)
 #define pool_destroy(pol) \
   _pool_destroy(pol, CALLSITE_HERE)
 
@@ -120,11 +147,27 @@ func void* _pool_alloc(pool* pol, callsite site);
 // same pool. No-op if ptr is NULL.
 func void _pool_dealloc(pool* pol, void* ptr, callsite site);
 
+// Pops up to count slots into out_ptrs, growing through the parent allocator as
+// needed. A locked pool holds opt_mutex for the whole batch; a lock-free pool pops
+// slot by slot and blocks concurrent callers no more than pool_alloc does.
+// Returns the number of slots written, which is less than count only when the
+// pool cannot grow any further.
+func sz _pool_alloc_batch(pool* pol, void** out_ptrs, sz count, callsite site);
+
+// Returns count slots to the free list. The slots are linked into one run before
+// the lock is taken and spliced onto the free list in a single step.
+// NULL entries in ptrs are skipped.
+func void _pool_dealloc_batch(pool* pol, void** ptrs, sz count, callsite site);
+
 // Convenience macros that automatically capture the callsite for better diagnostics.
 #define pool_alloc(pol) \
   _pool_alloc(pol, CALLSITE_HERE)
 #define pool_dealloc(pol, ptr) \
   _pool_dealloc(pol, ptr, CALLSITE_HERE)
+#define pool_alloc_batch(pol, out_ptrs, count) \
+  _pool_alloc_batch(pol, out_ptrs, count, CALLSITE_HERE)
+#define pool_dealloc_batch(pol, ptrs, count) \
+  _pool_dealloc_batch(pol, ptrs, count, CALLSITE_HERE)
 
 // Typed helpers — no size or alignment needed; they are baked into the pool.
 // pool_alloc_type  allocates one slot and casts to the requested pointer type.
@@ -145,6 +188,10 @@ func void pool_clear(pool* pol);
 // Aggregate pool statistics.
 func sz pool_block_count(pool* pol);
 func sz pool_slot_size(pool* pol);
+
+// Returns the number of free slots. For lock-free pools this reads a counter
+// that is updated on every push and pop, so it is a momentary estimate while
+// other threads allocate and exact once they are idle.
 func sz pool_free_count(pool* pol);
 
 // =========================================================================
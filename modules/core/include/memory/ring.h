@@ -4,6 +4,8 @@
 #pragma once
 
 #include "../basic/codespace.h"
+#include "../basic/env_defines.h"
+#include "../threads/atomics.h"
 #include "../threads/mutex.h"
 #include "allocator.h"
 
@@ -24,6 +26,16 @@ c_begin;
 //
 // Thread safety is optional: supply a valid mutex in opt_mutex to enable it,
 // or pass NULL to treat the ring as single-threaded.
+//
+// A ring created with ring_create_spsc is safe for exactly one producer thread
+// and one consumer thread without any lock. The producer may call ring_write,
+// ring_reserve_write and ring_commit_write; the consumer may call ring_read,
+// ring_peek, ring_skip, ring_reserve_read and ring_commit_read. Each side owns
+// a byte counter on its own cache line and publishes it with release ordering.
+//
+// A mirrored ring (ring_create_mirrored) maps its buffer twice back to back, so
+// ring_reserve_write and ring_reserve_read always return the whole free or used
+// span as one contiguous block, even across the wrap point.
 typedef struct ring {
   u8* ptr;           // Base pointer to the backing buffer.
   sz capacity;       // Total byte capacity of the backing buffer.
@@ -34,6 +46,16 @@ typedef struct ring {
   mutex opt_mutex;   // Thread-safety guard; NULL means no locking.
   b8 buf_owned;      // True when ptr was allocated through parent.
   b8 mutex_owned;    // True when opt_mutex was created by ring_create_mutexed.
+  b8 spsc;           // True when created by ring_create_spsc; the fields below replace the cursors.
+  b8 mirrored;       // True when ptr maps the buffer twice back to back (see vmem_alloc_mirrored).
+
+  u8 spsc_pad_front[ARCH_CACHE_LINE_SIZE];
+  atomic_u64 spsc_written;  // Producer-owned: total bytes ever committed.
+  u64 spsc_read_cache;      // Producer's last observed value of spsc_read.
+  u8 spsc_pad_mid[ARCH_CACHE_LINE_SIZE];
+  atomic_u64 spsc_read;     // Consumer-owned: total bytes ever consumed.
+  u64 spsc_written_cache;   // Consumer's last observed value of spsc_written.
+  u8 spsc_pad_back[ARCH_CACHE_LINE_SIZE];
 } ring;
 
 // Creates a ring backed by an existing caller-owned buffer.
@@ -55,6 +77,23 @@ func ring _ring_create_alloc(allocator parent_alloc, sz capacity, mutex opt_mute
 // a dedicated mutex. Both are destroyed automatically by ring_destroy.
 func ring _ring_create_alloc_mutexed(allocator parent_alloc, sz capacity, callsite site);
 
+// Creates a lock-free single-producer/single-consumer ring backed by an existing
+// caller-owned buffer. See the ring description for which calls belong to which side.
+func ring _ring_create_spsc(void* ptr, sz capacity, callsite site);
+
+// Creates a lock-free single-producer/single-consumer ring and allocates its
+// backing buffer from parent_alloc.
+func ring _ring_create_alloc_spsc(allocator parent_alloc, sz capacity, callsite site);
+
+// Creates a mirrored ring whose buffer is mapped twice through vmem_alloc_mirrored.
+// capacity  — rounded up to a multiple of vmem_page_size().
+// opt_mutex — mutex that guards every operation; pass NULL to disable locking.
+// The returned ring has a NULL ptr when the platform cannot mirror memory.
+func ring _ring_create_mirrored(sz capacity, mutex opt_mutex, callsite site);
+
+// Creates a mirrored ring in lock-free single-producer/single-consumer mode.
+func ring _ring_create_mirrored_spsc(sz capacity, callsite site);
+
 // Releases the backing buffer if it was auto-allocated and destroys the mutex
 // if it was owned. Resets the ring to a zeroed state.
 func void _ring_destroy(ring* rng, callsite site);
@@ -67,6 +106,14 @@ func void _ring_destroy(ring* rng, callsite site);
   _ring_create_alloc(parent_alloc, capacity, opt_mutex, CALLSITE_HERE)
 #define ring_create_alloc_mutexed(parent_alloc, capacity) \
   _ring_create_alloc_mutexed(parent_alloc, capacity, CALLSITE_HERE)
+#define ring_create_spsc(ptr, capacity) \
+  _ring_create_spsc(ptr, capacity, CALLSITE_HERE)
+#define ring_create_alloc_spsc(parent_alloc, capacity) \
+  _ring_create_alloc_spsc(parent_alloc, capacity, CALLSITE_HERE)
+#define ring_create_mirrored(capacity, opt_mutex) \
+  _ring_create_mirrored(capacity, opt_mutex, CALLSITE_HERE)
+#define ring_create_mirrored_spsc(capacity) \
+  _ring_create_mirrored_spsc(capacity, CALLSITE_HERE)
 #define ring_destroy(rng) \
   _ring_destroy(rng, CALLSITE_HERE)
 
@@ -75,6 +122,7 @@ func void _ring_destroy(ring* rng, callsite site);
 // =========================================================================
 
 // Returns the number of bytes currently available to read.
+// For an SPSC ring the result is a snapshot that the other side may change at any time.
 func sz ring_size(ring* rng);
 
 // Returns the number of bytes that can be written before the ring is full.
@@ -106,11 +154,13 @@ func sz ring_peek(ring* rng, void* out, sz size);
 func sz ring_skip(ring* rng, sz size);
 
 // Reserves a contiguous writable span and returns its pointer/size.
+// Unless the ring is mirrored, the span stops at the end of the buffer.
 func void* ring_reserve_write(ring* rng, sz* out_size);
 // Commits bytes previously reserved by ring_reserve_write.
 func b32 ring_commit_write(ring* rng, sz size);
 
 // Reserves a contiguous readable span and returns its pointer/size.
+// Unless the ring is mirrored, the span stops at the end of the buffer.
 func const void* ring_reserve_read(ring* rng, sz* out_size);
 // Commits bytes previously reserved by ring_reserve_read.
 func b32 ring_commit_read(ring* rng, sz size);
@@ -120,7 +170,8 @@ func b32 ring_commit_read(ring* rng, sz size);
 // =========================================================================
 
 // Resets both cursors and the byte count to zero, making the ring appear empty.
-// Does not release the backing buffer.
+// Does not release the backing buffer. For an SPSC ring neither side may be
+// running concurrently.
 func void ring_clear(ring* rng);
 
 // =========================================================================
@@ -23,6 +23,18 @@ c_begin;
 // reserve/commit/decommit are collapsed into a single allocation and the
 // distinction between reserved and committed memory does not exist.
 
+// Options accepted by vmem_reserve_ex and vmem_commit_ex.
+// VMEM_FLAG_HUGE_PAGES asks the OS to back the range with transparent huge pages.
+// It is a hint: the range still works when the kernel hands out regular pages.
+// VMEM_FLAG_PREFAULT backs every page of a committed range with physical memory
+// right away instead of on first touch.
+typedef enum vmem_flag {
+  VMEM_FLAG_NONE = 0,
+  VMEM_FLAG_HUGE_PAGES = (1U << 0),
+  VMEM_FLAG_PREFAULT = (1U << 1),
+} vmem_flag;
+typedef u32 vmem_flags;
+
 typedef struct vmem_stats {
   sz page_size;
 
@@ -46,22 +58,49 @@ typedef struct vmem_stats {
   sz peak_live_allocated_bytes;
   sz total_allocated_bytes;
   sz total_freed_bytes;
+
+  sz huge_page_size;      // Transparent huge page size; 0 when unavailable.
+  sz huge_advised_bytes;  // Bytes reserved or committed with VMEM_FLAG_HUGE_PAGES.
+  sz huge_backed_bytes;   // Process memory the OS actually backed with huge pages; see vmem_get_stats_ex.
+  sz prefaulted_bytes;    // Bytes committed with VMEM_FLAG_PREFAULT.
 } vmem_stats;
 
 // Returns the OS memory page size in bytes.
 func sz vmem_page_size(void);
 
+// Returns the transparent huge page size in bytes, or 0 when the platform or
+// the kernel configuration does not provide transparent huge pages.
+func sz vmem_huge_page_size(void);
+
+// Returns the anonymous memory of the whole process currently backed by
+// transparent huge pages, including memory vmem did not reserve. On Linux this
+// parses /proc/self/smaps_rollup, which makes the kernel walk every mapping of
+// the process under its memory-map lock, so keep it out of per-frame paths.
+// Returns 0 on platforms without transparent huge pages.
+func sz vmem_query_process_huge_bytes(void);
+
 // Reserves a contiguous virtual address range of at least size bytes without
 // committing physical memory. Accessing the reserved pages before committing
 // them is undefined behaviour (likely a hardware fault).
 // Returns NULL on failure.
 func void* vmem_reserve(sz size);
 
+// Like vmem_reserve, with options.
+// VMEM_FLAG_HUGE_PAGES aligns the range to the huge page size so that whole
+// huge pages fit inside it, and marks it as eligible for huge pages.
+// VMEM_FLAG_PREFAULT is ignored here; pass it to vmem_commit_ex instead.
+func void* vmem_reserve_ex(sz size, vmem_flags flags);
+
 // Commits physical memory for the range [ptr, ptr + size).
 // The range must lie entirely within a previously reserved region.
 // Returns non-zero on success, zero on failure.
 func b32 vmem_commit(void* ptr, sz size);
 
+// Like vmem_commit, with options.
+// VMEM_FLAG_HUGE_PAGES marks the committed range as eligible for huge pages.
+// VMEM_FLAG_PREFAULT populates the range before returning.
+func b32 vmem_commit_ex(void* ptr, sz size, vmem_flags flags);
+
 // Returns the physical memory backing [ptr, ptr + size) to the OS while keeping
 // the virtual address reservation intact. The pages may be re-committed later
 // with vmem_commit.
@@ -96,15 +135,32 @@ func void* vmem_realloc(void* ptr, sz old_size, sz new_size);
 // Returns non-zero on success, zero on failure.
 func b32 vmem_free(void* ptr, sz size);
 
+// Maps size bytes of committed memory twice, back to back, so that the byte at
+// ptr + i and the byte at ptr + size + i are the same memory. Reads and writes
+// that run past ptr + size therefore wrap around to the start of the buffer.
+// size must be a non-zero multiple of vmem_page_size().
+// Only supported on Linux (memfd); returns NULL on failure or on other platforms.
+func void* vmem_alloc_mirrored(sz size);
+
+// Unmaps a region returned by vmem_alloc_mirrored. size is the value passed to
+// vmem_alloc_mirrored, not the doubled mapping size.
+// Returns non-zero on success, zero on failure.
+func b32 vmem_free_mirrored(void* ptr, sz size);
+
 // Returns an allocator backed by vmem_alloc/vmem_free/vmem_realloc.
 // The returned allocator has no user data and is valid for the lifetime of the
 // program.
 func allocator vmem_get_allocator(void);
 
 // Returns best-effort process-local virtual-memory counters tracked by this
-// module.
+// module. huge_backed_bytes is left at 0.
 func vmem_stats vmem_get_stats(void);
 
+// Same as vmem_get_stats. With query_huge_backing it also fills
+// huge_backed_bytes from vmem_query_process_huge_bytes, which carries the cost
+// described there.
+func vmem_stats vmem_get_stats_ex(b32 query_huge_backing);
+
 // =========================================================================
 c_end;
 // =========================================================================
@@ -0,0 +1,125 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "../basic/codespace.h"
+#include "atomics.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+/*
+futex.h provides blocking primitives that live inline in the memory of their
+owner. They need no create/destroy call, never allocate, and a zeroed value is
+ready to use, so they can be embedded in other structs or arrays directly.
+
+futex_mutex takes one compare-and-swap to lock and one exchange to unlock
+while uncontended. Under contention it spins for a bounded number of tries
+that adapts to how long the lock was recently held, then sleeps in the
+kernel until the owner wakes it. futex_condvar pairs with futex_mutex.
+
+Threads sleep through futex(2) on Linux and WaitOnAddress on Windows. Other
+platforms poll with short sleeps, so there the primitives stay correct but
+wake with millisecond latency.
+
+Unlike mutex these primitives are not recursive and post no lifecycle
+messages.
+
+Example:
+
+  typedef struct work_queue {
+    futex_mutex lock;
+    futex_condvar not_empty;
+    u32 count;
+  } work_queue;
+
+  work_queue queue = {0};
+
+  // Consumer
+  futex_mutex_lock(&queue.lock);
+  safe_while (queue.count == 0) {
+    futex_condvar_wait(&queue.not_empty, &queue.lock);
+  }
+  queue.count -= 1;
+  futex_mutex_unlock(&queue.lock);
+
+  // Producer
+  futex_mutex_lock(&queue.lock);
+  queue.count += 1;
+  futex_mutex_unlock(&queue.lock);
+  futex_condvar_signal(&queue.not_empty);
+*/
+
+// Timeout value for futex_wait and futex_condvar_wait_timeout that never expires.
+#define FUTEX_WAIT_INFINITE U32_MAX
+
+// Upper bound for the adaptive spin of a contended futex_mutex_lock.
+#define FUTEX_MUTEX_MAX_SPINS 128
+
+// Spins a contended futex_mutex_lock always tries before it may sleep.
+#define FUTEX_MUTEX_MIN_SPINS 16
+
+// =========================================================================
+// Futex Word
+// =========================================================================
+
+// Blocks while *word equals expected, for at most millis milliseconds.
+// Returns false only when the timeout elapsed. Like every futex, it may also
+// return spuriously, so callers re-check their condition in a loop.
+func b32 futex_wait(atomic_u32* word, u32 expected, u32 millis);
+
+// Wakes one thread blocked in futex_wait on word.
+func void futex_wake_one(atomic_u32* word);
+
+// Wakes every thread blocked in futex_wait on word.
+func void futex_wake_all(atomic_u32* word);
+
+// =========================================================================
+// Futex Mutex
+// =========================================================================
+
+// Zero-initialize before use. All fields must be accessed exclusively through the functions below.
+typedef struct futex_mutex {
+  atomic_u32 state;          // 0 unlocked, 1 locked, 2 locked with possible sleepers.
+  atomic_u32 spin_estimate;  // Recent spins a successful contended lock needed.
+} futex_mutex;
+
+// Locks mtx, spinning briefly and then sleeping until it becomes available.
+func void futex_mutex_lock(futex_mutex* mtx);
+
+// Locks mtx if it is free. Returns true if the lock was acquired.
+func b32 futex_mutex_try_lock(futex_mutex* mtx);
+
+// Unlocks mtx, waking one sleeping thread if there is one.
+// mtx must be locked by the calling thread.
+func void futex_mutex_unlock(futex_mutex* mtx);
+
+// =========================================================================
+// Futex Condition Variable
+// =========================================================================
+
+// Zero-initialize before use. All fields must be accessed exclusively through the functions below.
+typedef struct futex_condvar {
+  atomic_u32 seq;           // Bumped by every signal and broadcast.
+  atomic_u32 waiter_count;  // Lets signal and broadcast skip the kernel when nobody waits.
+} futex_condvar;
+
+// Atomically releases mtx and blocks until cond is signalled.
+// mtx must be locked by the calling thread; it is re-acquired before returning.
+// Wake-ups may be spurious, so wait in a loop that re-checks the predicate.
+func void futex_condvar_wait(futex_condvar* cond, futex_mutex* mtx);
+
+// Like futex_condvar_wait but returns false if millis milliseconds elapse first.
+func b32 futex_condvar_wait_timeout(futex_condvar* cond, futex_mutex* mtx, u32 millis);
+
+// Wakes one thread waiting on cond.
+func void futex_condvar_signal(futex_condvar* cond);
+
+// Wakes all threads waiting on cond.
+func void futex_condvar_broadcast(futex_condvar* cond);
+
+// =========================================================================
+c_end;
+// =========================================================================
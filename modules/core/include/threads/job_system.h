@@ -0,0 +1,142 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "../basic/codespace.h"
+#include "../context/ctx.h"
+#include "atomics.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// =========================================================================
+// Job System
+// =========================================================================
+
+/*
+job_system keeps a fixed set of worker threads alive for its whole lifetime
+and feeds them small jobs. Each worker owns a Chase-Lev deque: it pushes and
+pops its own jobs at the bottom without locking, and idle workers steal from
+the top of other workers' deques. Jobs submitted from threads that are not
+workers of the system go through one shared, mutex-protected queue.
+
+A job_counter tracks a batch of jobs. Zero-initialize it, pass it to every
+job of the batch, then either wait on it or make further jobs depend on it.
+job_system_wait does not block while work is queued: the waiting thread runs
+queued jobs itself until the counter drops to zero, so jobs may submit and
+wait on nested batches without starving the pool.
+
+Workers are built on thread_group and each one initializes its own thread_ctx
+from the setup passed at creation, so jobs may use thread_get_allocator, the
+temp arenas and thread_log_* like any other thread.
+
+Example:
+
+  func void blur_rows_job(void* arg) {
+    blur_rows((blur_slice*)arg);
+  }
+
+  func void upload_job(void* arg) {
+    upload_image((image*)arg);
+  }
+
+  job_system jobs = job_system_create(0, thread_get_setup());
+
+  job_counter blurred = {0};
+  safe_for (u32 idx = 0; idx < slice_count; idx += 1) {
+    job_system_run(jobs, blur_rows_job, &slices[idx], &blurred);
+  }
+
+  job_counter uploaded = {0};
+  job_system_run_after(jobs, &blurred, upload_job, &img, &uploaded);
+  job_system_wait(jobs, &uploaded);
+
+  job_system_destroy(jobs);
+*/
+
+// Jobs each worker deque and the shared submission queue can hold at once.
+// Must be a power of two. A submission that finds its queue full runs the job
+// inline on the submitting thread instead of failing.
+#define JOB_SYSTEM_QUEUE_CAPACITY 4096
+
+// Failed attempts to find work before an idle worker goes to sleep.
+#define JOB_SYSTEM_IDLE_SPIN_COUNT 256
+
+// Opaque handle to a persistent pool of job workers.
+typedef void* job_system;
+
+// Entry-point of a job. arg is the pointer given at submission.
+typedef void (*job_func)(void* arg);
+
+// One job of a batch submitted through job_system_run_many.
+typedef struct job_decl {
+  job_func entry;
+  void* arg;
+} job_decl;
+
+// Counts the unfinished jobs of a batch. Zero-initialize before first use.
+// A counter may be reused once it has dropped to zero and every job that
+// depends on it has been released.
+// All fields must be accessed exclusively through the functions below.
+typedef struct job_counter {
+  atomic_u32 pending;
+  atomic_ptr waiters;
+} job_counter;
+
+// Creates a job system with worker_count workers; 0 starts one worker per
+// logical core minus one, leaving a core for the thread that waits on jobs.
+// setup is forwarded to each worker's thread_ctx_init path.
+// Returns a valid handle on success, or NULL on failure.
+func job_system _job_system_create(u32 worker_count, ctx_setup setup, callsite site);
+
+// Stops and joins every worker, then releases the system.
+// Wait on all outstanding counters first; jobs still queued are discarded.
+// Passing NULL is safe and does nothing.
+func b32 _job_system_destroy(job_system sys, callsite site);
+
+// Convenience macros that automatically capture the callsite information for debugging purposes.
+#define job_system_create(worker_count, setup) _job_system_create(worker_count, setup, CALLSITE_HERE)
+#define job_system_destroy(sys)                _job_system_destroy(sys, CALLSITE_HERE)
+
+// Returns true if the job system handle is valid, false otherwise.
+func b32 job_system_is_valid(job_system sys);
+
+// Returns the number of worker threads in the system.
+func u32 job_system_get_worker_count(job_system sys);
+
+// Returns the calling thread's one-based worker idx within sys,
+// or 0 when the caller is not one of its workers.
+func u32 job_system_get_worker_idx(job_system sys);
+
+// Queues entry(arg). When counter is non-NULL it is incremented now and
+// decremented once the job has returned.
+// Workers push to their own deque; every other thread uses the shared queue.
+func void job_system_run(job_system sys, job_func entry, void* arg, job_counter* counter);
+
+// Queues count jobs at once, taking the shared queue lock and waking idle
+// workers only once for the whole batch.
+func void job_system_run_many(job_system sys, job_decl const* jobs, u32 count, job_counter* counter);
+
+// Queues entry(arg) once dependency has dropped to zero. counter is
+// incremented now, so waiting on it also covers the deferred job.
+// A NULL dependency behaves like job_system_run.
+// Returns false when the deferred job could not be recorded.
+func b32 job_system_run_after(
+    job_system sys,
+    job_counter* dependency,
+    job_func entry,
+    void* arg,
+    job_counter* counter);
+
+// Runs queued jobs on the calling thread until counter drops to zero.
+// Only yields the CPU once no job can be found anywhere in the system.
+func void job_system_wait(job_system sys, job_counter* counter);
+
+// Returns true once every job counted by counter has finished.
+func b32 job_counter_is_done(job_counter* counter);
+
+// =========================================================================
+c_end;
+// =========================================================================
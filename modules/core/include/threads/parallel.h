@@ -0,0 +1,95 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#pragma once
+
+#include "../basic/codespace.h"
+#include "job_system.h"
+
+// =========================================================================
+c_begin;
+// =========================================================================
+
+// =========================================================================
+// Parallel Loops
+// =========================================================================
+
+/*
+parallel_for and parallel_reduce split an index range across the workers of a
+job_system plus the calling thread, then return once every index has been
+processed. Chunks are handed out with guided self-scheduling: each claim takes
+a share of the indices still left, so early chunks are large and cheap to
+schedule and the last ones shrink down to grain to even out the tail. The
+calling thread processes chunks too and helps with other jobs while waiting,
+so both calls may be nested inside jobs.
+
+grain is the smallest number of indices a chunk may hold. Pick it so one chunk
+costs at least a few microseconds; 0 derives one from the range size and the
+worker count. A NULL job system runs the whole range on the calling thread.
+
+Example:
+
+  func void scale_range(u64 begin, u64 end, void* arg) {
+    f32* values = (f32*)arg;
+    for (u64 idx = begin; idx < end; idx += 1) {
+      values[idx] *= 2.0f;
+    }
+  }
+
+  func void sum_range(u64 begin, u64 end, void* partial, void* arg) {
+    f32 const* values = (f32 const*)arg;
+    f64* sum = (f64*)partial;
+    for (u64 idx = begin; idx < end; idx += 1) {
+      *sum += values[idx];
+    }
+  }
+
+  func void sum_combine(void* into, void const* from, void* arg) {
+    *(f64*)into += *(f64 const*)from;
+  }
+
+  parallel_for(jobs, 0, value_count, 0, scale_range, values);
+
+  f64 total = 0.0;
+  parallel_reduce(jobs, 0, value_count, 0, &total, size_of(total), sum_range, sum_combine, values);
+*/
+
+// Most chunk-processing jobs one call submits, including the calling thread.
+// Larger job systems still split every loop across this many participants.
+#define PARALLEL_MAX_TASKS 64
+
+// Chunks per participant that an automatic grain aims for.
+#define PARALLEL_AUTO_CHUNKS_PER_TASK 8
+
+// Processes the indices in [begin, end).
+typedef void (*parallel_for_func)(u64 begin, u64 end, void* arg);
+
+// Folds the indices in [begin, end) into partial, one participant's private result.
+typedef void (*parallel_reduce_func)(u64 begin, u64 end, void* partial, void* arg);
+
+// Folds the partial result from into into.
+typedef void (*parallel_combine_func)(void* into, void const* from, void* arg);
+
+// Calls body over disjoint chunks that together cover [begin, end).
+func void parallel_for(job_system sys, u64 begin, u64 end, u64 grain, parallel_for_func body, void* arg);
+
+// Reduces [begin, end) into result. result must hold the identity of combine
+// on entry; every participant starts from a copy of it, and the partials are
+// combined into result on the calling thread once the loop is done.
+// combine must be associative and commutative: which chunks end up in which
+// partial depends on scheduling.
+// Returns false, leaving result untouched, when the partials cannot be allocated.
+func b32 parallel_reduce(
+    job_system sys,
+    u64 begin,
+    u64 end,
+    u64 grain,
+    void* result,
+    sz result_size,
+    parallel_reduce_func body,
+    parallel_combine_func combine,
+    void* arg);
+
+// =========================================================================
+c_end;
+// =========================================================================
@@ -4,6 +4,9 @@
 #pragma once
 
 #include "../basic/codespace.h"
+#include "../basic/env_defines.h"
+#include "atomics.h"
+#include "futex.h"
 
 // =========================================================================
 c_begin;
@@ -56,6 +59,127 @@ func b32 rwlock_timed_read_lock(rwlock rw, i32 timeout_ms);
 // Tries to acquire a write lock until timeout_ms expires.
 func b32 rwlock_timed_write_lock(rwlock rw, i32 timeout_ms);
 
+// =========================================================================
+// Sharded Reader-Writer Lock
+// =========================================================================
+
+/*
+rwlock_sharded is a reader-biased "big reader" lock for read-mostly data. Each
+thread is assigned one of RWLOCK_SHARDED_SLOT_COUNT reader slots, each on its
+own cache line, so a read lock only writes the caller's slot and reads a flag
+that stays shared in every core's cache until a writer shows up. Read
+throughput therefore grows with the number of reader cores, whereas
+rwlock_read_lock makes every reader write the same counter.
+
+Writers pay for it: a write lock raises the writer flag and then waits until
+every slot has drained, and readers arriving meanwhile sleep until the write
+unlock. Writers may starve readers but not the other way round. The struct is
+several kilobytes, so keep one per table, not one per entry.
+
+It is zero-initializable and needs no create/destroy call. Neither side is
+recursive, and a thread must not take the write lock while holding a read lock.
+
+Example:
+
+  global_var rwlock_sharded asset_table_lock;
+
+  rwlock_sharded_read_lock(&asset_table_lock);
+  asset* found = asset_table_find(&assets, asset_id);
+  rwlock_sharded_read_unlock(&asset_table_lock);
+
+  rwlock_sharded_write_lock(&asset_table_lock);
+  asset_table_insert(&assets, asset_id, loaded);
+  rwlock_sharded_write_unlock(&asset_table_lock);
+*/
+
+// Reader slots per lock. Threads beyond this count share slots, which stays
+// correct and only brings back some cache-line sharing between them.
+#define RWLOCK_SHARDED_SLOT_COUNT 64
+
+// Read locks currently held by the threads mapped to one slot.
+typedef struct rwlock_sharded_slot {
+  align_as(ARCH_CACHE_LINE_SIZE) atomic_u32 reader_count;
+} rwlock_sharded_slot;
+
+// Zero-initialize before use. All fields must be accessed exclusively through the functions below.
+typedef struct rwlock_sharded {
+  rwlock_sharded_slot slots[RWLOCK_SHARDED_SLOT_COUNT];
+  align_as(ARCH_CACHE_LINE_SIZE) atomic_u32 writer_active;  // Non-zero while a writer holds or waits for the lock.
+  futex_mutex writer_mutex;                                  // Serializes writers.
+} rwlock_sharded;
+
+func void rwlock_sharded_read_lock(rwlock_sharded* rw);
+func b32 rwlock_sharded_try_read_lock(rwlock_sharded* rw);
+func void rwlock_sharded_read_unlock(rwlock_sharded* rw);
+
+func void rwlock_sharded_write_lock(rwlock_sharded* rw);
+func void rwlock_sharded_write_unlock(rwlock_sharded* rw);
+
+// =========================================================================
+// Sequence Lock
+// =========================================================================
+
+/*
+seqlock protects small plain-old-data values, such as a transform or a set of
+statistics, that are read far more often than written. Readers never write
+shared memory at all: they copy the data and retry if a writer was active
+during the copy. Writers are serialized by an inline futex_mutex and never
+wait for readers.
+
+The protected data must be safe to copy while it is being written, so no
+pointers that readers follow and nothing larger than a few cache lines.
+seqlock_read and seqlock_write wrap the copy loop for the common case.
+
+Example:
+
+  typedef struct camera_state {
+    f32 position[3];
+    f32 rotation[4];
+  } camera_state;
+
+  global_var seqlock camera_lock;
+  global_var camera_state camera_shared;
+
+  // Render thread
+  camera_state camera;
+  seqlock_read(&camera_lock, &camera, &camera_shared, size_of(camera));
+
+  // Simulation thread
+  seqlock_write(&camera_lock, &camera_shared, &updated, size_of(updated));
+
+  // Manual form, reading fields in place
+  u32 seq;
+  do {
+    seq = seqlock_read_begin(&camera_lock);
+    position_x = camera_shared.position[0];
+  } while (seqlock_read_retry(&camera_lock, seq));
+*/
+
+// Zero-initialize before use. All fields must be accessed exclusively through the functions below.
+typedef struct seqlock {
+  atomic_u32 seq;            // Odd while a write is in progress.
+  futex_mutex writer_mutex;  // Serializes writers.
+} seqlock;
+
+// Starts a read section and returns the sequence to pass to seqlock_read_retry.
+// Waits while a write is in progress.
+func u32 seqlock_read_begin(seqlock* lock);
+
+// Returns true if a write overlapped the read section started at seq, in
+// which case everything read since must be discarded and read again.
+func b32 seqlock_read_retry(seqlock* lock, u32 seq);
+
+// Exclusive write section. Readers that overlap it retry.
+func void seqlock_write_lock(seqlock* lock);
+func void seqlock_write_unlock(seqlock* lock);
+
+// Copies size bytes from src to dst as one consistent snapshot, retrying
+// until no write overlapped the copy.
+func void seqlock_read(seqlock* lock, void* dst, void const* src, sz size);
+
+// Copies size bytes from src to dst inside a write section.
+func void seqlock_write(seqlock* lock, void* dst, void const* src, sz size);
+
 // =========================================================================
 c_end;
 // =========================================================================
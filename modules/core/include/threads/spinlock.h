@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../basic/codespace.h"
+#include "atomics.h"
 
 // =========================================================================
 c_begin;
@@ -38,6 +39,74 @@ func void spinlock_unlock(spinlock sl);
 // Returns true if the lock was acquired, false if it is already held.
 func b32 spinlock_try_lock(spinlock sl);
 
+// =========================================================================
+// Queue Spinlocks
+// =========================================================================
+
+/*
+spinlock_ticket and spinlock_mcs are fair alternatives to spinlock: threads get
+the lock in the order they asked for it, so nobody starves under contention.
+Both are plain structs that work when zeroed and need no create/destroy call,
+so they can be embedded in the data they protect.
+
+spinlock_ticket is two counters. Every waiter polls the same word, so each
+unlock still touches every waiting core, but waiters back off in proportion to
+their place in line. It is the better pick for a handful of threads.
+
+spinlock_mcs queues waiters in a linked list of nodes supplied by the callers.
+Each waiter spins on its own node, so an unlock touches only the next waiter's
+cache line and cost stays flat as cores are added. The node must stay valid
+from lock until unlock returns, which makes a local variable the usual choice.
+
+Waiters back off exponentially with atomic_pause and, once the backoff is
+maxed out, yield the CPU so an oversubscribed machine still hands the lock on.
+
+Example:
+
+  spinlock_ticket stats_lock = {0};
+  spinlock_ticket_lock(&stats_lock);
+  stats.hits += 1;
+  spinlock_ticket_unlock(&stats_lock);
+
+  spinlock_mcs table_lock = {0};
+  spinlock_mcs_node node;
+  spinlock_mcs_lock(&table_lock, &node);
+  table_insert(&table, key, value);
+  spinlock_mcs_unlock(&table_lock, &node);
+*/
+
+// First and largest number of atomic_pause calls between two polls of a contended lock.
+#define SPINLOCK_BACKOFF_MIN_PAUSES 1
+#define SPINLOCK_BACKOFF_MAX_PAUSES 64
+
+// Fair FIFO spinlock. Zero-initialize before use.
+// All fields must be accessed exclusively through the functions below.
+typedef struct spinlock_ticket {
+  atomic_u32 next;     // Next ticket to hand out.
+  atomic_u32 serving;  // Ticket that currently owns the lock.
+} spinlock_ticket;
+
+func void spinlock_ticket_lock(spinlock_ticket* lock);
+func b32 spinlock_ticket_try_lock(spinlock_ticket* lock);
+func void spinlock_ticket_unlock(spinlock_ticket* lock);
+
+// Per-acquisition queue entry of a spinlock_mcs, owned by the locking thread.
+typedef struct spinlock_mcs_node {
+  atomic_ptr next;
+  atomic_u32 is_waiting;
+} spinlock_mcs_node;
+
+// Fair FIFO queue spinlock. Zero-initialize before use.
+// All fields must be accessed exclusively through the functions below.
+typedef struct spinlock_mcs {
+  atomic_ptr tail;  // Last queued node, or NULL when the lock is free.
+} spinlock_mcs;
+
+// node is initialized by the call; pass the same node to spinlock_mcs_unlock.
+func void spinlock_mcs_lock(spinlock_mcs* lock, spinlock_mcs_node* node);
+func b32 spinlock_mcs_try_lock(spinlock_mcs* lock, spinlock_mcs_node* node);
+func void spinlock_mcs_unlock(spinlock_mcs* lock, spinlock_mcs_node* node);
+
 // =========================================================================
 c_end;
 // =========================================================================
@@ -0,0 +1,683 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/btree_map.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+
+// Byte size of every pool block requested from the parent allocator.
+#define BTREE_MAP_BLOCK_SIZE (64 * 1024)
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+func btree_map_node* btree_map_node_alloc(btree_map* map, b32 is_leaf) {
+  btree_map_node* node = pool_alloc_type(&map->nodes, btree_map_node);
+  if (node != NULL) {
+    node->count = 0;
+    node->is_leaf = is_leaf ? 1 : 0;
+    node->reserved = 0;
+    node->next = NULL;
+  }
+  return node;
+}
+
+func void btree_map_node_free(btree_map* map, btree_map_node* node) {
+  pool_dealloc_type(&map->nodes, node);
+}
+
+// First index whose key is >= key, or count when every key is smaller.
+func u32 btree_map_node_lower(btree_map_node const* node, u64 key) {
+  u32 low = 0;
+  u32 high = node->count;
+  safe_while (low < high) {
+    u32 mid = (low + high) / 2;
+    if (node->keys[mid] < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// Child of an internal node to descend into. Separators are the smallest key of
+// their right subtree, so a key equal to a separator goes right.
+func u32 btree_map_node_child(btree_map_node const* node, u64 key) {
+  u32 low = 0;
+  u32 high = node->count;
+  safe_while (low < high) {
+    u32 mid = (low + high) / 2;
+    if (node->keys[mid] <= key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+func btree_map_node* btree_map_find_leaf(btree_map* map, u64 key) {
+  btree_map_node* node = map->root;
+  safe_while (node != NULL && !node->is_leaf) {
+    node = (btree_map_node*)node->slots[btree_map_node_child(node, key)];
+  }
+  return node;
+}
+
+func u64 btree_map_subtree_min(btree_map_node const* node) {
+  safe_while (!node->is_leaf) {
+    node = (btree_map_node const*)node->slots[0];
+  }
+  return node->keys[0];
+}
+
+func void btree_map_leaf_insert_at(btree_map_node* leaf, u32 pos, u64 key, void* value) {
+  u32 tail = leaf->count - pos;
+  mem_mv(&leaf->keys[pos + 1], &leaf->keys[pos], tail * size_of(u64));
+  mem_mv(&leaf->slots[pos + 1], &leaf->slots[pos], tail * size_of(void*));
+  leaf->keys[pos] = key;
+  leaf->slots[pos] = value;
+  leaf->count++;
+}
+
+func void btree_map_leaf_remove_at(btree_map_node* leaf, u32 pos) {
+  u32 tail = leaf->count - pos - 1;
+  mem_mv(&leaf->keys[pos], &leaf->keys[pos + 1], tail * size_of(u64));
+  mem_mv(&leaf->slots[pos], &leaf->slots[pos + 1], tail * size_of(void*));
+  leaf->count--;
+}
+
+// Inserts separator key with child as its right-hand neighbour, just after
+// the child at index pos.
+func void btree_map_internal_insert_at(btree_map_node* node, u32 pos, u64 key, btree_map_node* child) {
+  u32 tail = node->count - pos;
+  mem_mv(&node->keys[pos + 1], &node->keys[pos], tail * size_of(u64));
+  mem_mv(&node->slots[pos + 2], &node->slots[pos + 1], tail * size_of(void*));
+  node->keys[pos] = key;
+  node->slots[pos + 1] = child;
+  node->count++;
+}
+
+// Removes separator pos together with the child to its right.
+func void btree_map_internal_remove_at(btree_map_node* node, u32 pos) {
+  u32 tail = node->count - pos - 1;
+  mem_mv(&node->keys[pos], &node->keys[pos + 1], tail * size_of(u64));
+  mem_mv(&node->slots[pos + 1], &node->slots[pos + 2], tail * size_of(void*));
+  node->count--;
+}
+
+// Splits a full leaf while inserting key at pos. The upper half moves to right;
+// returns the separator for the parent.
+func u64 btree_map_leaf_split(btree_map_node* leaf, btree_map_node* right, u32 pos, u64 key, void* value) {
+  u64 keys[BTREE_MAP_NODE_KEYS + 1];
+  void* values[BTREE_MAP_NODE_KEYS + 1];
+  u32 total = BTREE_MAP_NODE_KEYS + 1;
+  mem_cpy(keys, leaf->keys, pos * size_of(u64));
+  mem_cpy(values, leaf->slots, pos * size_of(void*));
+  keys[pos] = key;
+  values[pos] = value;
+  mem_cpy(&keys[pos + 1], &leaf->keys[pos], (BTREE_MAP_NODE_KEYS - pos) * size_of(u64));
+  mem_cpy(&values[pos + 1], &leaf->slots[pos], (BTREE_MAP_NODE_KEYS - pos) * size_of(void*));
+
+  u32 left_count = total / 2;
+  u32 right_count = total - left_count;
+  mem_cpy(leaf->keys, keys, left_count * size_of(u64));
+  mem_cpy(leaf->slots, values, left_count * size_of(void*));
+  mem_cpy(right->keys, &keys[left_count], right_count * size_of(u64));
+  mem_cpy(right->slots, &values[left_count], right_count * size_of(void*));
+  leaf->count = (u16)left_count;
+  right->count = (u16)right_count;
+
+  right->next = leaf->next;
+  leaf->next = right;
+  return right->keys[0];
+}
+
+// Splits a full internal node while inserting separator key and child after the
+// child at pos. The middle separator moves up and is returned.
+func u64 btree_map_internal_split(
+    btree_map_node* node,
+    btree_map_node* right,
+    u32 pos,
+    u64 key,
+    btree_map_node* child) {
+  u64 keys[BTREE_MAP_NODE_KEYS + 1];
+  void* children[BTREE_MAP_NODE_KEYS + 2];
+  u32 total = BTREE_MAP_NODE_KEYS + 1;
+  mem_cpy(keys, node->keys, pos * size_of(u64));
+  keys[pos] = key;
+  mem_cpy(&keys[pos + 1], &node->keys[pos], (BTREE_MAP_NODE_KEYS - pos) * size_of(u64));
+  mem_cpy(children, node->slots, (pos + 1) * size_of(void*));
+  children[pos + 1] = child;
+  mem_cpy(&children[pos + 2], &node->slots[pos + 1], (BTREE_MAP_NODE_KEYS - pos) * size_of(void*));
+
+  u32 mid = total / 2;
+  u32 right_count = total - mid - 1;
+  mem_cpy(node->keys, keys, mid * size_of(u64));
+  mem_cpy(node->slots, children, (mid + 1) * size_of(void*));
+  mem_cpy(right->keys, &keys[mid + 1], right_count * size_of(u64));
+  mem_cpy(right->slots, &children[mid + 1], (right_count + 1) * size_of(void*));
+  node->count = (u16)mid;
+  right->count = (u16)right_count;
+  return keys[mid];
+}
+
+// Restores the minimum fill of node, the child at child_idx of parent, by
+// borrowing one entry from a sibling or merging with one. Returns true when a
+// merge removed a separator from parent, which may leave parent underfull.
+func b32 btree_map_rebalance(btree_map* map, btree_map_node* parent, u32 child_idx, btree_map_node* node) {
+  btree_map_node* left = child_idx > 0 ? (btree_map_node*)parent->slots[child_idx - 1] : NULL;
+  btree_map_node* right = child_idx < parent->count ? (btree_map_node*)parent->slots[child_idx + 1] : NULL;
+
+  if (node->is_leaf) {
+    if (left != NULL && left->count > BTREE_MAP_LEAF_MIN_KEYS) {
+      btree_map_leaf_insert_at(node, 0, left->keys[left->count - 1], left->slots[left->count - 1]);
+      left->count--;
+      parent->keys[child_idx - 1] = node->keys[0];
+      return false;
+    }
+    if (right != NULL && right->count > BTREE_MAP_LEAF_MIN_KEYS) {
+      node->keys[node->count] = right->keys[0];
+      node->slots[node->count] = right->slots[0];
+      node->count++;
+      btree_map_leaf_remove_at(right, 0);
+      parent->keys[child_idx] = right->keys[0];
+      return false;
+    }
+    // Merge the right one of the pair into the left one.
+    btree_map_node* dst = left != NULL ? left : node;
+    btree_map_node* src = left != NULL ? node : right;
+    u32 sep_idx = left != NULL ? child_idx - 1 : child_idx;
+    mem_cpy(&dst->keys[dst->count], src->keys, src->count * size_of(u64));
+    mem_cpy(&dst->slots[dst->count], src->slots, src->count * size_of(void*));
+    dst->count += src->count;
+    dst->next = src->next;
+    btree_map_node_free(map, src);
+    btree_map_internal_remove_at(parent, sep_idx);
+    return true;
+  }
+
+  if (left != NULL && left->count > BTREE_MAP_INTERNAL_MIN_KEYS) {
+    // Rotate right through the parent separator.
+    mem_mv(&node->keys[1], &node->keys[0], node->count * size_of(u64));
+    mem_mv(&node->slots[1], &node->slots[0], (node->count + 1) * size_of(void*));
+    node->keys[0] = parent->keys[child_idx - 1];
+    node->slots[0] = left->slots[left->count];
+    node->count++;
+    parent->keys[child_idx - 1] = left->keys[left->count - 1];
+    left->count--;
+    return false;
+  }
+  if (right != NULL && right->count > BTREE_MAP_INTERNAL_MIN_KEYS) {
+    // Rotate left through the parent separator.
+    node->keys[node->count] = parent->keys[child_idx];
+    node->slots[node->count + 1] = right->slots[0];
+    node->count++;
+    parent->keys[child_idx] = right->keys[0];
+    mem_mv(&right->keys[0], &right->keys[1], (right->count - 1) * size_of(u64));
+    mem_mv(&right->slots[0], &right->slots[1], right->count * size_of(void*));
+    right->count--;
+    return false;
+  }
+  // Merge, pulling the separator down between the two halves.
+  btree_map_node* dst = left != NULL ? left : node;
+  btree_map_node* src = left != NULL ? node : right;
+  u32 sep_idx = left != NULL ? child_idx - 1 : child_idx;
+  dst->keys[dst->count] = parent->keys[sep_idx];
+  mem_cpy(&dst->keys[dst->count + 1], src->keys, src->count * size_of(u64));
+  mem_cpy(&dst->slots[dst->count + 1], src->slots, (src->count + 1) * size_of(void*));
+  dst->count += src->count + 1;
+  btree_map_node_free(map, src);
+  btree_map_internal_remove_at(parent, sep_idx);
+  return true;
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func btree_map btree_map_create(allocator alloc) {
+  profile_func_begin;
+  btree_map map;
+  mem_zero(&map, size_of(map));
+  if (alloc.alloc_fn == NULL || alloc.dealloc_fn == NULL) {
+    alloc = thread_get_allocator();
+  }
+  if (alloc.alloc_fn == NULL || alloc.dealloc_fn == NULL) {
+    alloc = global_get_allocator();
+  }
+  if (alloc.alloc_fn == NULL || alloc.dealloc_fn == NULL) {
+    thread_log_error("Cannot create btree map without an allocator");
+    profile_func_end;
+    return map;
+  }
+  map.nodes = pool_create(alloc, NULL, BTREE_MAP_BLOCK_SIZE, size_of(btree_map_node), ARCH_CACHE_LINE_SIZE);
+  profile_func_end;
+  return map;
+}
+
+func void btree_map_destroy(btree_map* map) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return;
+  }
+  pool_destroy(&map->nodes);
+  mem_zero(map, size_of(*map));
+  profile_func_end;
+}
+
+func void btree_map_clear(btree_map* map) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return;
+  }
+  pool_clear(&map->nodes);
+  map->root = NULL;
+  map->first_leaf = NULL;
+  map->count = 0;
+  map->height = 0;
+  profile_func_end;
+}
+
+// =========================================================================
+// Occupancy
+// =========================================================================
+
+func sz btree_map_count(btree_map const* map) {
+  return map != NULL ? map->count : 0;
+}
+
+func u32 btree_map_height(btree_map const* map) {
+  return map != NULL ? map->height : 0;
+}
+
+// =========================================================================
+// Key/Value Operations
+// =========================================================================
+
+func b32 btree_map_set(btree_map* map, u64 key, void* value) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return false;
+  }
+  if (map->root == NULL) {
+    btree_map_node* leaf = btree_map_node_alloc(map, true);
+    if (leaf == NULL) {
+      thread_log_error("Failed to allocate btree map node");
+      profile_func_end;
+      return false;
+    }
+    map->root = leaf;
+    map->first_leaf = leaf;
+    map->height = 1;
+  }
+
+  btree_map_node* path[BTREE_MAP_MAX_HEIGHT];
+  u32 path_idx[BTREE_MAP_MAX_HEIGHT];
+  u32 depth = 0;
+  btree_map_node* leaf = map->root;
+  safe_while (!leaf->is_leaf) {
+    u32 idx = btree_map_node_child(leaf, key);
+    path[depth] = leaf;
+    path_idx[depth] = idx;
+    depth++;
+    leaf = (btree_map_node*)leaf->slots[idx];
+  }
+
+  u32 pos = btree_map_node_lower(leaf, key);
+  if (pos < leaf->count && leaf->keys[pos] == key) {
+    leaf->slots[pos] = value;
+    profile_func_end;
+    return true;
+  }
+  if (leaf->count < BTREE_MAP_NODE_KEYS) {
+    btree_map_leaf_insert_at(leaf, pos, key, value);
+    map->count++;
+    profile_func_end;
+    return true;
+  }
+
+  // The leaf splits, and so does every full ancestor above it. Take all new
+  // nodes up front so a failed allocation leaves the tree untouched.
+  u32 split_count = 1;
+  u32 level = depth;
+  safe_while (level > 0 && path[level - 1]->count == BTREE_MAP_NODE_KEYS) {
+    split_count++;
+    level--;
+  }
+  b32 grows = level == 0;
+  if (grows && map->height >= BTREE_MAP_MAX_HEIGHT) {
+    thread_log_error("Btree map exceeded its maximum height of %u", BTREE_MAP_MAX_HEIGHT);
+    profile_func_end;
+    return false;
+  }
+  btree_map_node* spare[BTREE_MAP_MAX_HEIGHT + 1];
+  u32 spare_count = split_count + (grows ? 1 : 0);
+  safe_for (u32 idx = 0; idx < spare_count; idx++) {
+    spare[idx] = btree_map_node_alloc(map, idx == 0);
+    if (spare[idx] == NULL) {
+      safe_for (u32 undo = 0; undo < idx; undo++) {
+        btree_map_node_free(map, spare[undo]);
+      }
+      thread_log_error("Failed to allocate btree map node");
+      profile_func_end;
+      return false;
+    }
+  }
+
+  btree_map_node* child = spare[0];
+  u64 sep = btree_map_leaf_split(leaf, child, pos, key, value);
+  u32 used = 1;
+  safe_while (depth > 0) {
+    depth--;
+    btree_map_node* parent = path[depth];
+    u32 child_idx = path_idx[depth];
+    if (parent->count < BTREE_MAP_NODE_KEYS) {
+      btree_map_internal_insert_at(parent, child_idx, sep, child);
+      child = NULL;
+      break;
+    }
+    btree_map_node* right = spare[used++];
+    sep = btree_map_internal_split(parent, right, child_idx, sep, child);
+    child = right;
+  }
+  if (child != NULL) {
+    btree_map_node* root = spare[used++];
+    root->keys[0] = sep;
+    root->slots[0] = map->root;
+    root->slots[1] = child;
+    root->count = 1;
+    map->root = root;
+    map->height++;
+  }
+  map->count++;
+  profile_func_end;
+  return true;
+}
+
+func void* btree_map_get(btree_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || map->root == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  btree_map_node* leaf = btree_map_find_leaf(map, key);
+  u32 pos = btree_map_node_lower(leaf, key);
+  void* value = (pos < leaf->count && leaf->keys[pos] == key) ? leaf->slots[pos] : NULL;
+  profile_func_end;
+  return value;
+}
+
+func b32 btree_map_has(btree_map* map, u64 key) {
+  if (map == NULL || map->root == NULL) {
+    return false;
+  }
+  btree_map_node* leaf = btree_map_find_leaf(map, key);
+  u32 pos = btree_map_node_lower(leaf, key);
+  return pos < leaf->count && leaf->keys[pos] == key;
+}
+
+func b32 btree_map_remove(btree_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || map->root == NULL) {
+    profile_func_end;
+    return false;
+  }
+
+  btree_map_node* path[BTREE_MAP_MAX_HEIGHT];
+  u32 path_idx[BTREE_MAP_MAX_HEIGHT];
+  u32 depth = 0;
+  btree_map_node* node = map->root;
+  safe_while (!node->is_leaf) {
+    u32 idx = btree_map_node_child(node, key);
+    path[depth] = node;
+    path_idx[depth] = idx;
+    depth++;
+    node = (btree_map_node*)node->slots[idx];
+  }
+
+  u32 pos = btree_map_node_lower(node, key);
+  if (pos >= node->count || node->keys[pos] != key) {
+    profile_func_end;
+    return false;
+  }
+  btree_map_leaf_remove_at(node, pos);
+  map->count--;
+
+  // Separators equal to the removed key may stay behind; they still split
+  // their subtrees correctly.
+  safe_while (depth > 0) {
+    u32 min_keys = node->is_leaf ? BTREE_MAP_LEAF_MIN_KEYS : BTREE_MAP_INTERNAL_MIN_KEYS;
+    if (node->count >= min_keys) {
+      break;
+    }
+    depth--;
+    if (!btree_map_rebalance(map, path[depth], path_idx[depth], node)) {
+      break;
+    }
+    node = path[depth];
+  }
+
+  btree_map_node* root = map->root;
+  if (!root->is_leaf && root->count == 0) {
+    map->root = (btree_map_node*)root->slots[0];
+    map->height--;
+    btree_map_node_free(map, root);
+  } else if (root->is_leaf && root->count == 0) {
+    btree_map_node_free(map, root);
+    map->root = NULL;
+    map->first_leaf = NULL;
+    map->height = 0;
+  }
+  profile_func_end;
+  return true;
+}
+
+func b32 btree_map_bulk_load(btree_map* map, u64 const* keys, void* const* values, sz count) {
+  profile_func_begin;
+  if (map == NULL || map->root != NULL || (keys == NULL && count > 0)) {
+    profile_func_end;
+    return false;
+  }
+  for (sz idx = 1; idx < count; idx++) {
+    if (keys[idx - 1] >= keys[idx]) {
+      thread_log_error("Btree map bulk load needs strictly ascending keys (index %zu)", idx);
+      profile_func_end;
+      return false;
+    }
+  }
+  if (count == 0) {
+    profile_func_end;
+    return true;
+  }
+
+  // Spread the entries evenly so that every leaf, and below every internal
+  // node, is at least half full.
+  sz leaf_count = (count + BTREE_MAP_NODE_KEYS - 1) / BTREE_MAP_NODE_KEYS;
+  sz per_leaf = count / leaf_count;
+  sz extra = count % leaf_count;
+  btree_map_node* head = NULL;
+  btree_map_node* prev = NULL;
+  sz src = 0;
+  for (sz leaf_idx = 0; leaf_idx < leaf_count; leaf_idx++) {
+    btree_map_node* leaf = btree_map_node_alloc(map, true);
+    if (leaf == NULL) {
+      thread_log_error("Failed to allocate btree map node");
+      btree_map_clear(map);
+      profile_func_end;
+      return false;
+    }
+    u32 fill = (u32)(per_leaf + (leaf_idx < extra ? 1 : 0));
+    mem_cpy(leaf->keys, &keys[src], fill * size_of(u64));
+    if (values != NULL) {
+      mem_cpy(leaf->slots, &values[src], fill * size_of(void*));
+    } else {
+      mem_zero(leaf->slots, fill * size_of(void*));
+    }
+    leaf->count = (u16)fill;
+    src += fill;
+    if (prev != NULL) {
+      prev->next = leaf;
+    } else {
+      head = leaf;
+    }
+    prev = leaf;
+  }
+  map->first_leaf = head;
+  map->height = 1;
+
+  // Each level is chained through next while it is built; internal nodes drop
+  // the link once they have been attached to their parent.
+  sz level_count = leaf_count;
+  while (level_count > 1) {
+    sz parent_count = (level_count + BTREE_MAP_NODE_KEYS) / (BTREE_MAP_NODE_KEYS + 1);
+    sz per_parent = level_count / parent_count;
+    sz parent_extra = level_count % parent_count;
+    btree_map_node* child = head;
+    head = NULL;
+    prev = NULL;
+    for (sz parent_idx = 0; parent_idx < parent_count; parent_idx++) {
+      btree_map_node* parent = btree_map_node_alloc(map, false);
+      if (parent == NULL) {
+        thread_log_error("Failed to allocate btree map node");
+        btree_map_clear(map);
+        profile_func_end;
+        return false;
+      }
+      u32 fill = (u32)(per_parent + (parent_idx < parent_extra ? 1 : 0));
+      safe_for (u32 slot = 0; slot < fill; slot++) {
+        parent->slots[slot] = child;
+        if (slot > 0) {
+          parent->keys[slot - 1] = btree_map_subtree_min(child);
+        }
+        btree_map_node* next = child->next;
+        if (!child->is_leaf) {
+          child->next = NULL;
+        }
+        child = next;
+      }
+      parent->count = (u16)(fill - 1);
+      if (prev != NULL) {
+        prev->next = parent;
+      } else {
+        head = parent;
+      }
+      prev = parent;
+    }
+    level_count = parent_count;
+    map->height++;
+  }
+  if (!head->is_leaf) {
+    head->next = NULL;
+  }
+  map->root = head;
+  map->count = count;
+  profile_func_end;
+  return true;
+}
+
+// =========================================================================
+// Ordered Access
+// =========================================================================
+
+func btree_map_iter btree_map_first(btree_map* map) {
+  btree_map_iter it = {0};
+  if (map != NULL) {
+    it.leaf = map->first_leaf;
+  }
+  return it;
+}
+
+func btree_map_iter btree_map_lower_bound(btree_map* map, u64 key) {
+  profile_func_begin;
+  btree_map_iter it = {0};
+  if (map == NULL || map->root == NULL) {
+    profile_func_end;
+    return it;
+  }
+  btree_map_node* leaf = btree_map_find_leaf(map, key);
+  u32 pos = btree_map_node_lower(leaf, key);
+  if (pos == leaf->count) {
+    leaf = leaf->next;
+    pos = 0;
+  }
+  it.leaf = leaf;
+  it.idx = pos;
+  profile_func_end;
+  return it;
+}
+
+func btree_map_iter btree_map_upper_bound(btree_map* map, u64 key) {
+  btree_map_iter it = btree_map_lower_bound(map, key);
+  if (btree_map_iter_valid(it) && btree_map_iter_key(it) == key) {
+    btree_map_iter_next(&it);
+  }
+  return it;
+}
+
+func b32 btree_map_iter_valid(btree_map_iter it) {
+  return it.leaf != NULL;
+}
+
+func u64 btree_map_iter_key(btree_map_iter it) {
+  assert(it.leaf != NULL && it.idx < it.leaf->count);
+  return it.leaf->keys[it.idx];
+}
+
+func void* btree_map_iter_value(btree_map_iter it) {
+  assert(it.leaf != NULL && it.idx < it.leaf->count);
+  return it.leaf->slots[it.idx];
+}
+
+func b32 btree_map_iter_next(btree_map_iter* it) {
+  if (it == NULL || it->leaf == NULL) {
+    return false;
+  }
+  it->idx++;
+  if (it->idx >= it->leaf->count) {
+    it->leaf = it->leaf->next;
+    it->idx = 0;
+  }
+  return it->leaf != NULL;
+}
+
+func sz btree_map_range(
+    btree_map* map,
+    u64 min_key,
+    u64 max_key,
+    btree_map_visit_fn* visit,
+    void* user_data) {
+  profile_func_begin;
+  if (map == NULL || visit == NULL || min_key > max_key) {
+    profile_func_end;
+    return 0;
+  }
+  btree_map_iter it = btree_map_lower_bound(map, min_key);
+  btree_map_node* leaf = it.leaf;
+  u32 idx = it.idx;
+  sz visited = 0;
+  while (leaf != NULL) {
+    for (; idx < leaf->count; idx++) {
+      if (leaf->keys[idx] > max_key) {
+        profile_func_end;
+        return visited;
+      }
+      visited++;
+      if (!visit(leaf->keys[idx], leaf->slots[idx], user_data)) {
+        profile_func_end;
+        return visited;
+      }
+    }
+    leaf = leaf->next;
+    idx = 0;
+  }
+  profile_func_end;
+  return visited;
+}
@@ -0,0 +1,352 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/concurrent_map.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+#include <string.h>
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Shard counts must stay power-of-two so the shard index is a plain shift.
+func u32 concurrent_map_normalize_shards(sz shard_count, u32* out_bits) {
+  if (shard_count == 0) {
+    shard_count = CONCURRENT_MAP_DEFAULT_SHARDS;
+  }
+  u32 count = 1;
+  u32 bits = 0;
+  safe_while (count < shard_count && bits < 16) {
+    count *= 2;
+    bits++;
+  }
+  *out_bits = bits;
+  return count;
+}
+
+// Picks the shard from the top hash bits; hash_map probes with the low bits.
+func concurrent_map_shard* concurrent_map_shard_for(concurrent_map* map, u64 key) {
+  if (map->shard_bits == 0) {
+    return &map->shards[0];
+  }
+  u64 idx = hash_u64(key) >> (64 - map->shard_bits);
+  return &map->shards[idx];
+}
+
+// Slots needed per shard so that total entries spread evenly fit without rehashing.
+// hash_map grows at 75% load, so 4/3 would be exact; 3/2 leaves room for uneven spread.
+func sz concurrent_map_shard_capacity(concurrent_map const* map, sz total) {
+  sz per_shard = total / map->shard_count + 1;
+  return per_shard + per_shard / 2;
+}
+
+// The try-lock first lets the shard count how often it was actually contended.
+// Uncontended reads write nothing shared besides the lock itself.
+func void concurrent_map_read_lock(concurrent_map_shard* shard) {
+  if (!rwlock_try_read_lock(shard->lock)) {
+    atomic_u64_add(&shard->contended, 1);
+    rwlock_read_lock(shard->lock);
+  }
+}
+
+func void concurrent_map_write_lock(concurrent_map_shard* shard) {
+  if (!rwlock_try_write_lock(shard->lock)) {
+    atomic_u64_add(&shard->contended, 1);
+    rwlock_write_lock(shard->lock);
+  }
+  // Writers are exclusive, so a plain load/store pair is enough.
+  u64 writes = atomic_u64_get_explicit(&shard->writes, ATOMIC_MEMORY_ORDER_RELAXED);
+  atomic_u64_set_explicit(&shard->writes, writes + 1, ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func concurrent_map concurrent_map_create(sz shard_count, sz cap, allocator alloc) {
+  profile_func_begin;
+  concurrent_map map;
+  mem_zero(&map, size_of(map));
+  map.alloc = alloc;
+  if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {
+    map.alloc = global_get_allocator();
+  }
+  if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {
+    thread_log_error("Cannot create concurrent map without an allocator");
+    profile_func_end;
+    return map;
+  }
+
+  u32 bits = 0;
+  u32 count = concurrent_map_normalize_shards(shard_count, &bits);
+  map.shards = (concurrent_map_shard*)allocator_calloc(map.alloc, count, size_of(concurrent_map_shard));
+  if (map.shards == NULL) {
+    thread_log_error("Failed to allocate %u concurrent map shards", count);
+    profile_func_end;
+    return map;
+  }
+  map.shard_count = count;
+  map.shard_bits = bits;
+
+  sz shard_cap = concurrent_map_shard_capacity(&map, cap);
+  safe_for (u32 idx = 0; idx < count; idx++) {
+    concurrent_map_shard* shard = &map.shards[idx];
+    shard->map = hash_map_create(shard_cap, map.alloc);
+    shard->lock = rwlock_create();
+    if (shard->map.slots == NULL || shard->lock == NULL) {
+      thread_log_error("Failed to create concurrent map shard %u", idx);
+      concurrent_map_destroy(&map);
+      profile_func_end;
+      return map;
+    }
+  }
+  profile_func_end;
+  return map;
+}
+
+func void concurrent_map_destroy(concurrent_map* map) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return;
+  }
+  if (map->shards) {
+    safe_for (u32 idx = 0; idx < map->shard_count; idx++) {
+      concurrent_map_shard* shard = &map->shards[idx];
+      hash_map_destroy(&shard->map);
+      if (shard->lock) {
+        rwlock_destroy(shard->lock);
+      }
+    }
+    allocator_dealloc(map->alloc, map->shards);
+  }
+  mem_zero(map, size_of(*map));
+  profile_func_end;
+}
+
+func void concurrent_map_clear(concurrent_map* map) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return;
+  }
+  safe_for (u32 idx = 0; idx < map->shard_count; idx++) {
+    concurrent_map_shard* shard = &map->shards[idx];
+    concurrent_map_write_lock(shard);
+    hash_map_clear(&shard->map);
+    rwlock_write_unlock(shard->lock);
+  }
+  profile_func_end;
+}
+
+// =========================================================================
+// Capacity and Occupancy
+// =========================================================================
+
+func sz concurrent_map_count(concurrent_map* map) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return 0;
+  }
+  sz total = 0;
+  safe_for (u32 idx = 0; idx < map->shard_count; idx++) {
+    concurrent_map_shard* shard = &map->shards[idx];
+    rwlock_read_lock(shard->lock);
+    total += hash_map_count(&shard->map);
+    rwlock_read_unlock(shard->lock);
+  }
+  profile_func_end;
+  return total;
+}
+
+func u32 concurrent_map_shard_count(concurrent_map const* map) {
+  return map != NULL ? map->shard_count : 0;
+}
+
+func b32 concurrent_map_reserve(concurrent_map* map, sz min_count) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return false;
+  }
+  sz shard_cap = concurrent_map_shard_capacity(map, min_count);
+  b32 result = true;
+  safe_for (u32 idx = 0; idx < map->shard_count; idx++) {
+    concurrent_map_shard* shard = &map->shards[idx];
+    rwlock_write_lock(shard->lock);
+    if (!hash_map_reserve(&shard->map, shard_cap)) {
+      result = false;
+    }
+    rwlock_write_unlock(shard->lock);
+  }
+  profile_func_end;
+  return result;
+}
+
+// =========================================================================
+// Key/Value Operations
+// =========================================================================
+
+func b32 concurrent_map_set(concurrent_map* map, u64 key, void* value) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return false;
+  }
+  concurrent_map_shard* shard = concurrent_map_shard_for(map, key);
+  concurrent_map_write_lock(shard);
+  b32 result = hash_map_set(&shard->map, key, value);
+  rwlock_write_unlock(shard->lock);
+  profile_func_end;
+  return result;
+}
+
+func void* concurrent_map_get(concurrent_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  concurrent_map_shard* shard = concurrent_map_shard_for(map, key);
+  concurrent_map_read_lock(shard);
+  void* value = hash_map_get(&shard->map, key);
+  rwlock_read_unlock(shard->lock);
+  profile_func_end;
+  return value;
+}
+
+func b32 concurrent_map_has(concurrent_map* map, u64 key) {
+  if (map == NULL || map->shards == NULL) {
+    return false;
+  }
+  concurrent_map_shard* shard = concurrent_map_shard_for(map, key);
+  concurrent_map_read_lock(shard);
+  b32 result = hash_map_has(&shard->map, key);
+  rwlock_read_unlock(shard->lock);
+  return result;
+}
+
+func b32 concurrent_map_remove(concurrent_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return false;
+  }
+  concurrent_map_shard* shard = concurrent_map_shard_for(map, key);
+  concurrent_map_write_lock(shard);
+  b32 result = hash_map_remove(&shard->map, key);
+  rwlock_write_unlock(shard->lock);
+  profile_func_end;
+  return result;
+}
+
+func void* concurrent_map_get_or_set(concurrent_map* map, u64 key, void* value) {
+  profile_func_begin;
+  if (map == NULL || map->shards == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  concurrent_map_shard* shard = concurrent_map_shard_for(map, key);
+  concurrent_map_write_lock(shard);
+  if (hash_map_has(&shard->map, key)) {
+    value = hash_map_get(&shard->map, key);
+  } else if (!hash_map_set(&shard->map, key, value)) {
+    value = NULL;
+  }
+  rwlock_write_unlock(shard->lock);
+  profile_func_end;
+  return value;
+}
+
+// =========================================================================
+// Snapshots and Statistics
+// =========================================================================
+
+// Grows entries to hold at least min_count entries. Goes through allocate,
+// copy and free so that allocators without a realloc callback work too.
+func b32 concurrent_map_entries_reserve(concurrent_map_entries* entries, sz min_count) {
+  if (min_count <= entries->cap) {
+    return true;
+  }
+  sz cap = entries->cap * 2 > min_count ? entries->cap * 2 : min_count;
+  concurrent_map_entry* data =
+      (concurrent_map_entry*)allocator_alloc(entries->alloc, cap * size_of(concurrent_map_entry));
+  if (data == NULL) {
+    return false;
+  }
+  if (entries->data) {
+    mem_cpy(data, entries->data, entries->count * size_of(concurrent_map_entry));
+    allocator_dealloc(entries->alloc, entries->data);
+  }
+  entries->data = data;
+  entries->cap = cap;
+  return true;
+}
+
+func concurrent_map_entries concurrent_map_snapshot(concurrent_map* map, allocator alloc) {
+  profile_func_begin;
+  concurrent_map_entries snapshot;
+  mem_zero(&snapshot, size_of(snapshot));
+  snapshot.alloc = alloc;
+  if (snapshot.alloc.alloc_fn == NULL || snapshot.alloc.dealloc_fn == NULL) {
+    snapshot.alloc = thread_get_allocator();
+  }
+  if (snapshot.alloc.alloc_fn == NULL || snapshot.alloc.dealloc_fn == NULL) {
+    snapshot.alloc = global_get_allocator();
+  }
+  if (map == NULL || map->shards == NULL || snapshot.alloc.alloc_fn == NULL) {
+    profile_func_end;
+    return snapshot;
+  }
+
+  // Size once up front from a racy count; shards that grew meanwhile are
+  // caught by the exact per-shard reserve below.
+  concurrent_map_entries_reserve(&snapshot, concurrent_map_count(map));
+
+  safe_for (u32 idx = 0; idx < map->shard_count; idx++) {
+    concurrent_map_shard* shard = &map->shards[idx];
+    rwlock_read_lock(shard->lock);
+    if (!concurrent_map_entries_reserve(&snapshot, snapshot.count + hash_map_count(&shard->map))) {
+      rwlock_read_unlock(shard->lock);
+      thread_log_error("Failed to grow concurrent map snapshot count=%zu", (size_t)snapshot.count);
+      break;
+    }
+    hash_map_slot const* slots = shard->map.slots;
+    for (sz slot_idx = 0; slot_idx < shard->map.cap; slot_idx++) {
+      if (slots[slot_idx].occupied) {
+        snapshot.data[snapshot.count++] = (concurrent_map_entry){slots[slot_idx].key, slots[slot_idx].value};
+      }
+    }
+    rwlock_read_unlock(shard->lock);
+  }
+  profile_func_end;
+  return snapshot;
+}
+
+func void concurrent_map_entries_destroy(concurrent_map_entries* entries) {
+  if (entries == NULL) {
+    return;
+  }
+  if (entries->data) {
+    allocator_dealloc(entries->alloc, entries->data);
+  }
+  mem_zero(entries, size_of(*entries));
+}
+
+func b32 concurrent_map_get_shard_stats(concurrent_map* map, u32 shard_idx, concurrent_map_shard_stats* out_stats) {
+  if (map == NULL || map->shards == NULL || out_stats == NULL || shard_idx >= map->shard_count) {
+    return false;
+  }
+  concurrent_map_shard* shard = &map->shards[shard_idx];
+  rwlock_read_lock(shard->lock);
+  out_stats->count = hash_map_count(&shard->map);
+  out_stats->capacity = hash_map_capacity(&shard->map);
+  rwlock_read_unlock(shard->lock);
+  out_stats->writes = atomic_u64_get(&shard->writes);
+  out_stats->contended = atomic_u64_get(&shard->contended);
+  return true;
+}
@@ -105,7 +105,7 @@ func b32 hash_map_rehash(hash_map* map, sz new_cap) {
     return false;
   }
 
-  safe_for (sz idx = 0; idx < map->cap; idx++) {
+  for (sz idx = 0; idx < map->cap; idx++) {
     hash_map_slot* slot = &map->slots[idx];
     if (slot->occupied) {
       hash_map_raw_insert(new_slots, target_cap, slot->key, slot->value);
@@ -342,7 +342,7 @@ func hash_map_slot* hash_map_next(hash_map* map, hash_map_iter* iter) {
     profile_func_end;
     return NULL;
   }
-  safe_while (*iter < map->cap) {
+  while (*iter < map->cap) {
     hash_map_slot* slot = &map->slots[*iter];
     (*iter)++;
     if (slot->occupied) {
@@ -0,0 +1,312 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/mpmc_queue.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+#include "../sdl3_include.h"
+#include <string.h>
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Capacities must stay power-of-two because cell lookup masks with (cap - 1).
+func sz mpmc_queue_normalize_capacity(sz min_cap) {
+  sz target_cap = 2;
+  safe_while (target_cap < min_cap) {
+    target_cap *= 2;
+  }
+  return target_cap;
+}
+
+// Releases sem for up to count threads registered in waiters.
+// The fence pairs with the one in mpmc_queue_push_wait/mpmc_queue_pop_wait:
+// either the waiter's retry sees the cells published before this call, or this
+// call sees the waiter's registration and wakes it.
+func void mpmc_queue_wake(atomic_u32* waiters, semaphore sem, sz count) {
+  atomic_fence();
+  u32 blocked = atomic_u32_get(waiters);
+  sz wake = blocked < count ? blocked : count;
+  for (sz idx = 0; idx < wake; idx++) {
+    semaphore_release(sem);
+  }
+}
+
+// Claims up to count consecutive cells starting at the shared position pos_atom.
+// A cell is ready when its sequence equals its position plus lap_offset
+// (0 for producers, 1 for consumers). Returns the number of cells claimed and
+// writes the first claimed position into out_pos.
+func sz mpmc_queue_claim(mpmc_queue* que, atomic_u64* pos_atom, u64 lap_offset, sz count, u64* out_pos) {
+  profile_func_begin;
+  u64 mask = (u64)que->cap - 1;
+  u64 pos = atomic_u64_get_explicit(pos_atom, ATOMIC_MEMORY_ORDER_RELAXED);
+
+  safe_for (;;) {
+    sz ready = 0;
+
+    while (ready < count) {
+      mpmc_queue_cell* cell = &que->cells[(pos + ready) & mask];
+      u64 seq = atomic_u64_get_explicit(&cell->sequence, ATOMIC_MEMORY_ORDER_ACQUIRE);
+      if (seq != pos + ready + lap_offset) {
+        break;
+      }
+      ready++;
+    }
+
+    if (ready == 0) {
+      mpmc_queue_cell* cell = &que->cells[pos & mask];
+      u64 seq = atomic_u64_get_explicit(&cell->sequence, ATOMIC_MEMORY_ORDER_ACQUIRE);
+      // Behind our position means the previous lap is still in the cell: full or empty.
+      if ((i64)(seq - (pos + lap_offset)) < 0) {
+        profile_func_end;
+        return 0;
+      }
+      // Another thread claimed this position already; catch up and retry.
+      pos = atomic_u64_get_explicit(pos_atom, ATOMIC_MEMORY_ORDER_RELAXED);
+      continue;
+    }
+
+    // On failure pos is refreshed with the current position.
+    if (atomic_u64_cmpex(pos_atom, &pos, pos + ready)) {
+      *out_pos = pos;
+      profile_func_end;
+      return ready;
+    }
+  }
+
+  profile_func_end;
+  return 0;
+}
+
+func sz mpmc_queue_push_claimed(mpmc_queue* que, void* const* values, sz count) {
+  profile_func_begin;
+  u64 pos = 0;
+  sz claimed = mpmc_queue_claim(que, &que->enqueue_pos, 0, count, &pos);
+  u64 mask = (u64)que->cap - 1;
+  for (sz idx = 0; idx < claimed; idx++) {
+    mpmc_queue_cell* cell = &que->cells[(pos + idx) & mask];
+    cell->value = values[idx];
+    atomic_u64_set_explicit(&cell->sequence, pos + idx + 1, ATOMIC_MEMORY_ORDER_RELEASE);
+  }
+  if (claimed > 0) {
+    mpmc_queue_wake(&que->pop_waiters, que->items_sem, claimed);
+  }
+  profile_func_end;
+  return claimed;
+}
+
+func sz mpmc_queue_pop_claimed(mpmc_queue* que, void** out_values, sz count) {
+  profile_func_begin;
+  u64 pos = 0;
+  sz claimed = mpmc_queue_claim(que, &que->dequeue_pos, 1, count, &pos);
+  u64 mask = (u64)que->cap - 1;
+  for (sz idx = 0; idx < claimed; idx++) {
+    mpmc_queue_cell* cell = &que->cells[(pos + idx) & mask];
+    out_values[idx] = cell->value;
+    // Hands the cell to the producer of the next lap.
+    atomic_u64_set_explicit(&cell->sequence, pos + idx + que->cap, ATOMIC_MEMORY_ORDER_RELEASE);
+  }
+  if (claimed > 0) {
+    mpmc_queue_wake(&que->push_waiters, que->slots_sem, claimed);
+  }
+  profile_func_end;
+  return claimed;
+}
+
+// Blocking push. Registers as a waiter before the final retry so that a
+// concurrent pop either leaves a free cell for the retry or wakes the sleeper.
+func b32 mpmc_queue_push_wait(mpmc_queue* que, void* value, b32 timed, u32 millis) {
+  profile_func_begin;
+  u64 deadline = timed ? SDL_GetTicks() + millis : 0;
+  while (!mpmc_queue_try_push(que, value)) {
+    atomic_u32_add(&que->push_waiters, 1);
+    atomic_fence();
+    if (mpmc_queue_try_push(que, value)) {
+      atomic_u32_sub(&que->push_waiters, 1);
+      break;
+    }
+    b32 woken = true;
+    if (timed) {
+      // Wait only for what is left, so wakes that lose the race do not extend the timeout.
+      u64 now = SDL_GetTicks();
+      woken = semaphore_acquire_timeout(que->slots_sem, now < deadline ? (u32)(deadline - now) : 0);
+    } else {
+      semaphore_acquire(que->slots_sem);
+    }
+    atomic_u32_sub(&que->push_waiters, 1);
+    if (!woken) {
+      b32 pushed = mpmc_queue_try_push(que, value);
+      profile_func_end;
+      return pushed;
+    }
+  }
+  profile_func_end;
+  return true;
+}
+
+// Blocking pop; mirror image of mpmc_queue_push_wait.
+func b32 mpmc_queue_pop_wait(mpmc_queue* que, void** out_value, b32 timed, u32 millis) {
+  profile_func_begin;
+  u64 deadline = timed ? SDL_GetTicks() + millis : 0;
+  while (!mpmc_queue_try_pop(que, out_value)) {
+    atomic_u32_add(&que->pop_waiters, 1);
+    atomic_fence();
+    if (mpmc_queue_try_pop(que, out_value)) {
+      atomic_u32_sub(&que->pop_waiters, 1);
+      break;
+    }
+    b32 woken = true;
+    if (timed) {
+      u64 now = SDL_GetTicks();
+      woken = semaphore_acquire_timeout(que->items_sem, now < deadline ? (u32)(deadline - now) : 0);
+    } else {
+      semaphore_acquire(que->items_sem);
+    }
+    atomic_u32_sub(&que->pop_waiters, 1);
+    if (!woken) {
+      b32 popped = mpmc_queue_try_pop(que, out_value);
+      profile_func_end;
+      return popped;
+    }
+  }
+  profile_func_end;
+  return true;
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func mpmc_queue mpmc_queue_create(sz cap, allocator alloc) {
+  profile_func_begin;
+  mpmc_queue que;
+  mem_zero(&que, size_of(que));
+  que.alloc = alloc;
+  if (que.alloc.alloc_fn == NULL || que.alloc.dealloc_fn == NULL) {
+    que.alloc = thread_get_allocator();
+  }
+  if (que.alloc.alloc_fn == NULL || que.alloc.dealloc_fn == NULL) {
+    que.alloc = global_get_allocator();
+  }
+
+  sz actual = mpmc_queue_normalize_capacity(cap);
+  if (que.alloc.alloc_fn != NULL && que.alloc.dealloc_fn != NULL) {
+    que.cells = (mpmc_queue_cell*)allocator_alloc(que.alloc, actual * size_of(mpmc_queue_cell));
+  }
+  if (que.cells == NULL) {
+    profile_func_end;
+    return que;
+  }
+
+  que.cap = actual;
+
+  for (sz idx = 0; idx < actual; idx++) {
+    atomic_u64_set_explicit(&que.cells[idx].sequence, (u64)idx, ATOMIC_MEMORY_ORDER_RELAXED);
+    que.cells[idx].value = NULL;
+  }
+  que.items_sem = semaphore_create(0);
+  que.slots_sem = semaphore_create(0);
+  profile_func_end;
+  return que;
+}
+
+func void mpmc_queue_destroy(mpmc_queue* que) {
+  profile_func_begin;
+  if (que == NULL) {
+    profile_func_end;
+    return;
+  }
+  if (que->cells) {
+    allocator_dealloc(que->alloc, que->cells);
+  }
+  if (que->items_sem) {
+    semaphore_destroy(que->items_sem);
+  }
+  if (que->slots_sem) {
+    semaphore_destroy(que->slots_sem);
+  }
+  mem_zero(que, size_of(*que));
+  profile_func_end;
+}
+
+// =========================================================================
+// Capacity and Occupancy
+// =========================================================================
+
+func sz mpmc_queue_capacity(mpmc_queue const* que) {
+  return que != NULL ? que->cap : 0;
+}
+
+func sz mpmc_queue_count(mpmc_queue* que) {
+  if (que == NULL || que->cells == NULL) {
+    return 0;
+  }
+  // Load the consumer side first so the difference cannot underflow.
+  u64 head = atomic_u64_get_explicit(&que->dequeue_pos, ATOMIC_MEMORY_ORDER_ACQUIRE);
+  u64 tail = atomic_u64_get_explicit(&que->enqueue_pos, ATOMIC_MEMORY_ORDER_ACQUIRE);
+  u64 count = tail - head;
+  return count < (u64)que->cap ? (sz)count : que->cap;
+}
+
+// =========================================================================
+// Push / Pop
+// =========================================================================
+
+func b32 mpmc_queue_try_push(mpmc_queue* que, void* value) {
+  if (que == NULL || que->cells == NULL) {
+    return false;
+  }
+  return mpmc_queue_push_claimed(que, &value, 1) == 1;
+}
+
+func b32 mpmc_queue_try_pop(mpmc_queue* que, void** out_value) {
+  if (que == NULL || que->cells == NULL || out_value == NULL) {
+    return false;
+  }
+  return mpmc_queue_pop_claimed(que, out_value, 1) == 1;
+}
+
+func sz mpmc_queue_try_push_batch(mpmc_queue* que, void* const* values, sz count) {
+  if (que == NULL || que->cells == NULL || values == NULL || count == 0) {
+    return 0;
+  }
+  return mpmc_queue_push_claimed(que, values, count);
+}
+
+func sz mpmc_queue_try_pop_batch(mpmc_queue* que, void** out_values, sz count) {
+  if (que == NULL || que->cells == NULL || out_values == NULL || count == 0) {
+    return 0;
+  }
+  return mpmc_queue_pop_claimed(que, out_values, count);
+}
+
+func void mpmc_queue_push(mpmc_queue* que, void* value) {
+  if (que == NULL || que->cells == NULL) {
+    return;
+  }
+  mpmc_queue_push_wait(que, value, false, 0);
+}
+
+func void mpmc_queue_pop(mpmc_queue* que, void** out_value) {
+  if (que == NULL || que->cells == NULL || out_value == NULL) {
+    return;
+  }
+  mpmc_queue_pop_wait(que, out_value, false, 0);
+}
+
+func b32 mpmc_queue_push_timeout(mpmc_queue* que, void* value, u32 millis) {
+  if (que == NULL || que->cells == NULL) {
+    return false;
+  }
+  return mpmc_queue_push_wait(que, value, true, millis);
+}
+
+func b32 mpmc_queue_pop_timeout(mpmc_queue* que, void** out_value, u32 millis) {
+  if (que == NULL || que->cells == NULL || out_value == NULL) {
+    return false;
+  }
+  return mpmc_queue_pop_wait(que, out_value, true, millis);
+}
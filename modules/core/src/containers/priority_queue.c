@@ -0,0 +1,315 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/priority_queue.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+func u32 priority_queue_normalize_arity(u32 arity) {
+  if (arity == 0) {
+    return PRIORITY_QUEUE_DEFAULT_ARITY;
+  }
+  if (arity < 2) {
+    return 2;
+  }
+  return arity > PRIORITY_QUEUE_MAX_ARITY ? PRIORITY_QUEUE_MAX_ARITY : arity;
+}
+
+func void priority_queue_sift_up(u8* data, sz idx, sz elem_size, u32 arity, sort_compare_fn* compare, void* user_data) {
+  safe_while (idx > 0) {
+    sz parent = (idx - 1) / arity;
+    u8* elem = data + idx * elem_size;
+    u8* above = data + parent * elem_size;
+    if (compare(elem, above, user_data) >= 0) {
+      break;
+    }
+    sort_swap_bytes(elem, above, elem_size);
+    idx = parent;
+  }
+}
+
+func void priority_queue_sift_down(
+    u8* data,
+    sz idx,
+    sz count,
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data) {
+  safe_while (idx < count) {
+    sz first_child = idx * arity + 1;
+    if (first_child >= count || first_child < idx) {
+      break;
+    }
+    sz last_child = first_child + arity;
+    if (last_child > count) {
+      last_child = count;
+    }
+    sz best = first_child;
+    safe_for (sz child = first_child + 1; child < last_child; child++) {
+      if (compare(data + child * elem_size, data + best * elem_size, user_data) < 0) {
+        best = child;
+      }
+    }
+    u8* elem = data + idx * elem_size;
+    u8* below = data + best * elem_size;
+    if (compare(below, elem, user_data) >= 0) {
+      break;
+    }
+    sort_swap_bytes(elem, below, elem_size);
+    idx = best;
+  }
+}
+
+// Floyd's bottom-up build: sift every internal node down, deepest first.
+func void priority_queue_build(u8* data, sz count, sz elem_size, u32 arity, sort_compare_fn* compare, void* user_data) {
+  if (count < 2) {
+    return;
+  }
+  for (sz idx = (count - 2) / arity + 1; idx-- > 0;) {
+    priority_queue_sift_down(data, idx, count, elem_size, arity, compare, user_data);
+  }
+}
+
+func b32 priority_queue_set_capacity(priority_queue* queue, sz new_cap) {
+  if (new_cap > SZ_MAX / queue->elem_size) {
+    return false;
+  }
+  u8* data = NULL;
+  if (queue->data != NULL && queue->alloc.realloc_fn != NULL) {
+    data = (u8*)allocator_realloc(queue->alloc, queue->data, new_cap * queue->elem_size);
+  } else {
+    data = (u8*)allocator_alloc(queue->alloc, new_cap * queue->elem_size);
+    if (data != NULL && queue->data != NULL) {
+      mem_cpy(data, queue->data, queue->count * queue->elem_size);
+      allocator_dealloc(queue->alloc, queue->data);
+    }
+  }
+  if (data == NULL) {
+    thread_log_error("Failed to grow priority_queue to %zu elements", new_cap);
+    return false;
+  }
+  queue->data = data;
+  queue->cap = new_cap;
+  return true;
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func priority_queue priority_queue_create(
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data,
+    sz cap,
+    allocator alloc) {
+  profile_func_begin;
+  priority_queue queue;
+  mem_zero(&queue, size_of(queue));
+  if (elem_size == 0 || compare == NULL) {
+    thread_log_error("Cannot create priority_queue without an element size and compare function");
+    profile_func_end;
+    return queue;
+  }
+  queue.elem_size = elem_size;
+  queue.arity = priority_queue_normalize_arity(arity);
+  queue.compare = compare;
+  queue.user_data = user_data;
+  queue.alloc = alloc;
+  if (queue.alloc.alloc_fn == NULL || queue.alloc.dealloc_fn == NULL) {
+    queue.alloc = thread_get_allocator();
+  }
+  if (queue.alloc.alloc_fn == NULL || queue.alloc.dealloc_fn == NULL) {
+    queue.alloc = global_get_allocator();
+  }
+  if (cap > 0) {
+    priority_queue_reserve(&queue, cap);
+  }
+  profile_func_end;
+  return queue;
+}
+
+func void priority_queue_destroy(priority_queue* queue) {
+  profile_func_begin;
+  if (queue == NULL) {
+    profile_func_end;
+    return;
+  }
+  if (queue->data) {
+    allocator_dealloc(queue->alloc, queue->data);
+  }
+  queue->data = NULL;
+  queue->count = 0;
+  queue->cap = 0;
+  profile_func_end;
+}
+
+func void priority_queue_clear(priority_queue* queue) {
+  if (queue != NULL) {
+    queue->count = 0;
+  }
+}
+
+// =========================================================================
+// Occupancy
+// =========================================================================
+
+func sz priority_queue_count(priority_queue const* queue) {
+  return queue != NULL ? queue->count : 0;
+}
+
+func sz priority_queue_capacity(priority_queue const* queue) {
+  return queue != NULL ? queue->cap : 0;
+}
+
+func b32 priority_queue_reserve(priority_queue* queue, sz min_count) {
+  profile_func_begin;
+  if (queue == NULL || queue->compare == NULL || queue->alloc.alloc_fn == NULL) {
+    profile_func_end;
+    return false;
+  }
+  if (queue->cap >= min_count) {
+    profile_func_end;
+    return true;
+  }
+  sz new_cap = queue->cap < PRIORITY_QUEUE_MIN_CAPACITY ? PRIORITY_QUEUE_MIN_CAPACITY : queue->cap;
+  safe_while (new_cap < min_count) {
+    if (new_cap > SZ_MAX / 2) {
+      new_cap = min_count;
+      break;
+    }
+    new_cap *= 2;
+  }
+  b32 result = priority_queue_set_capacity(queue, new_cap);
+  profile_func_end;
+  return result;
+}
+
+// =========================================================================
+// Queue Operations
+// =========================================================================
+
+func b32 priority_queue_push(priority_queue* queue, const void* elem) {
+  profile_func_begin;
+  if (queue == NULL || elem == NULL) {
+    profile_func_end;
+    return false;
+  }
+  if (queue->count == queue->cap && !priority_queue_reserve(queue, queue->count + 1)) {
+    profile_func_end;
+    return false;
+  }
+  mem_cpy(queue->data + queue->count * queue->elem_size, elem, queue->elem_size);
+  queue->count++;
+  priority_queue_sift_up(queue->data, queue->count - 1, queue->elem_size, queue->arity, queue->compare, queue->user_data);
+  profile_func_end;
+  return true;
+}
+
+func b32 priority_queue_push_many(priority_queue* queue, const void* elems, sz elem_count) {
+  profile_func_begin;
+  if (queue == NULL || (elems == NULL && elem_count > 0) || elem_count > SZ_MAX - queue->count) {
+    profile_func_end;
+    return false;
+  }
+  if (!priority_queue_reserve(queue, queue->count + elem_count)) {
+    profile_func_end;
+    return false;
+  }
+  sz old_count = queue->count;
+  if (elem_count > 0) {
+    mem_cpy(queue->data + old_count * queue->elem_size, elems, elem_count * queue->elem_size);
+  }
+  queue->count += elem_count;
+
+  // A batch at least as large as the queue is cheaper to absorb with one O(n)
+  // rebuild than with one O(log n) sift per element.
+  if (elem_count >= old_count) {
+    priority_queue_build(queue->data, queue->count, queue->elem_size, queue->arity, queue->compare, queue->user_data);
+  } else {
+    for (sz idx = old_count; idx < queue->count; idx++) {
+      priority_queue_sift_up(queue->data, idx, queue->elem_size, queue->arity, queue->compare, queue->user_data);
+    }
+  }
+  profile_func_end;
+  return true;
+}
+
+func b32 priority_queue_pop(priority_queue* queue, void* out_elem) {
+  profile_func_begin;
+  if (queue == NULL || queue->count == 0) {
+    profile_func_end;
+    return false;
+  }
+  if (out_elem != NULL) {
+    mem_cpy(out_elem, queue->data, queue->elem_size);
+  }
+  queue->count--;
+  if (queue->count > 0) {
+    mem_cpy(queue->data, queue->data + queue->count * queue->elem_size, queue->elem_size);
+    priority_queue_sift_down(queue->data, 0, queue->count, queue->elem_size, queue->arity, queue->compare, queue->user_data);
+  }
+  profile_func_end;
+  return true;
+}
+
+func const void* priority_queue_peek(priority_queue const* queue) {
+  if (queue == NULL || queue->count == 0) {
+    return NULL;
+  }
+  return queue->data;
+}
+
+// =========================================================================
+// Array Helpers
+// =========================================================================
+
+func sz priority_queue_heapify(
+    void* ptr,
+    sz elem_count,
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data) {
+  profile_func_begin;
+  if (ptr == NULL || elem_size == 0 || compare == NULL) {
+    profile_func_end;
+    return 0;
+  }
+  priority_queue_build((u8*)ptr, elem_count, elem_size, priority_queue_normalize_arity(arity), compare, user_data);
+  profile_func_end;
+  return elem_count;
+}
+
+func b32 priority_queue_check(
+    const void* ptr,
+    sz elem_count,
+    sz elem_size,
+    u32 arity,
+    sort_compare_fn* compare,
+    void* user_data) {
+  profile_func_begin;
+  if (ptr == NULL || elem_size == 0 || compare == NULL) {
+    profile_func_end;
+    return false;
+  }
+  u8 const* data = (u8 const*)ptr;
+  arity = priority_queue_normalize_arity(arity);
+  for (sz idx = 1; idx < elem_count; idx++) {
+    sz parent = (idx - 1) / arity;
+    if (compare(data + idx * elem_size, data + parent * elem_size, user_data) < 0) {
+      profile_func_end;
+      return false;
+    }
+  }
+  profile_func_end;
+  return true;
+}
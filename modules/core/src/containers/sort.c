@@ -3,18 +3,19 @@
 
 #include "containers/sort.h"
 #include "basic/assert.h"
+#include "basic/intrinsics.h"
+#include "context/global_ctx.h"
 #include "context/thread_ctx.h"
 #include "memory/scratch.h"
 #include "basic/profiler.h"
 #include "memory/memops.h"
+#include "system/cpu_info.h"
+#include "threads/condvar.h"
+#include "threads/mutex.h"
+#include "threads/thread_group.h"
 #include <string.h>
 #include "basic/safe.h"
 
-typedef struct sort_range {
-  sz beg_idx;
-  sz end_idx;
-} sort_range;
-
 func void* sort_elem_ptr(u8* base_ptr, sz idx, sz elem_size) {
   return base_ptr + (idx * elem_size);
 }
@@ -23,22 +24,28 @@ func const void* sort_elem_ptr_const(const u8* base_ptr, sz idx, sz elem_size) {
   return base_ptr + (idx * elem_size);
 }
 
+// Swaps whole 8-byte words first; memcpy keeps unaligned element sizes legal.
 func void sort_swap_bytes(void* lhs_ptr, void* rhs_ptr, sz elem_size) {
-  profile_func_begin;
   if (lhs_ptr == rhs_ptr) {
-    profile_func_end;
     return;
   }
 
   u8* lhs_bytes = (u8*)lhs_ptr;
   u8* rhs_bytes = (u8*)rhs_ptr;
-
-  safe_for (sz byte_idx = 0; byte_idx < elem_size; ++byte_idx) {
+  sz byte_idx = 0;
+  for (; byte_idx + size_of(u64) <= elem_size; byte_idx += size_of(u64)) {
+    u64 lhs_word;
+    u64 rhs_word;
+    memcpy(&lhs_word, lhs_bytes + byte_idx, size_of(u64));
+    memcpy(&rhs_word, rhs_bytes + byte_idx, size_of(u64));
+    memcpy(lhs_bytes + byte_idx, &rhs_word, size_of(u64));
+    memcpy(rhs_bytes + byte_idx, &lhs_word, size_of(u64));
+  }
+  for (; byte_idx < elem_size; ++byte_idx) {
     u8 tmp_byte = lhs_bytes[byte_idx];
     lhs_bytes[byte_idx] = rhs_bytes[byte_idx];
     rhs_bytes[byte_idx] = tmp_byte;
   }
-  profile_func_end;
 }
 
 func b32 sort_is_invalid_input(
@@ -64,60 +71,255 @@ func b32 sort_is_invalid_input(
   return false;
 }
 
-func sz sort_partition(
-    u8* base_ptr,
-    sz beg_idx,
-    sz end_idx,
-    sz elem_size,
-    sort_compare_fn* compare,
-    void* user_data) {
-  profile_func_begin;
-  sz piv_idx = beg_idx + ((end_idx - beg_idx) / 2);
-  sz lst_idx = end_idx - 1;
+// =========================================================================
+// Pattern-Defeating Quicksort
+// =========================================================================
+
+/*
+sort_quick is a pattern-defeating quicksort (pdqsort, Orson Peters): an
+introsort that partitions around a median-of-3 (ninther above
+SORT_PDQ_NINTHER_THRESHOLD) pivot, finishes small ranges with insertion sort
+and switches to heapsort once too many partitions came out badly unbalanced,
+so the worst case stays O(n log n). On top of introsort it
+  - shuffles a few elements after an unbalanced partition to break up
+    patterns that defeat the pivot choice,
+  - checks whether a partition swapped nothing and then tries to finish both
+    halves with a bounded insertion sort (sorted and reversed runs are O(n)),
+  - groups elements equal to the previous pivot in one linear pass, so many
+    duplicates cost O(n) instead of O(n log n).
+The larger side is looped on and only the smaller one recursed into, which
+bounds the stack to O(log n) frames without scratch memory.
+*/
+
+#define SORT_PDQ_INSERTION_THRESHOLD   24
+#define SORT_PDQ_NINTHER_THRESHOLD     128
+#define SORT_PDQ_PARTIAL_INSERTION_MAX 8
+
+typedef struct sort_pdq_ctx {
+  u8* base_ptr;
+  sz elem_size;
+  sort_compare_fn* compare;
+  void* user_data;
+} sort_pdq_ctx;
+
+func b32 sort_pdq_less(sort_pdq_ctx* ctx, sz lhs_idx, sz rhs_idx) {
+  return ctx->compare(
+             sort_elem_ptr_const(ctx->base_ptr, lhs_idx, ctx->elem_size),
+             sort_elem_ptr_const(ctx->base_ptr, rhs_idx, ctx->elem_size),
+             ctx->user_data) < 0;
+}
+
+func void sort_pdq_swap(sort_pdq_ctx* ctx, sz lhs_idx, sz rhs_idx) {
   sort_swap_bytes(
-      sort_elem_ptr(base_ptr, piv_idx, elem_size),
-      sort_elem_ptr(base_ptr, lst_idx, elem_size),
-      elem_size);
-
-  sz stw_idx = beg_idx;
-  safe_for (sz cmp_idx = beg_idx; cmp_idx < lst_idx; ++cmp_idx) {
-    void* cmp_ptr = sort_elem_ptr(base_ptr, cmp_idx, elem_size);
-    void* piv_ptr = sort_elem_ptr(base_ptr, lst_idx, elem_size);
-    if (compare(cmp_ptr, piv_ptr, user_data) < 0) {
-      sort_swap_bytes(
-          sort_elem_ptr(base_ptr, stw_idx, elem_size),
-          sort_elem_ptr(base_ptr, cmp_idx, elem_size),
-          elem_size);
-      ++stw_idx;
+      sort_elem_ptr(ctx->base_ptr, lhs_idx, ctx->elem_size),
+      sort_elem_ptr(ctx->base_ptr, rhs_idx, ctx->elem_size),
+      ctx->elem_size);
+}
+
+// Sorts the elements at a, b and c so that a <= b <= c.
+func void sort_pdq_sort3(sort_pdq_ctx* ctx, sz a_idx, sz b_idx, sz c_idx) {
+  if (sort_pdq_less(ctx, b_idx, a_idx)) {
+    sort_pdq_swap(ctx, a_idx, b_idx);
+  }
+  if (sort_pdq_less(ctx, c_idx, b_idx)) {
+    sort_pdq_swap(ctx, b_idx, c_idx);
+    if (sort_pdq_less(ctx, b_idx, a_idx)) {
+      sort_pdq_swap(ctx, a_idx, b_idx);
     }
   }
+}
 
-  sort_swap_bytes(
-      sort_elem_ptr(base_ptr, stw_idx, elem_size),
-      sort_elem_ptr(base_ptr, lst_idx, elem_size),
-      elem_size);
-  profile_func_end;
-  return stw_idx;
+func void sort_pdq_insertion(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx) {
+  for (sz cur_idx = beg_idx + 1; cur_idx < end_idx; ++cur_idx) {
+    for (sz pos_idx = cur_idx; pos_idx > beg_idx && sort_pdq_less(ctx, pos_idx, pos_idx - 1); --pos_idx) {
+      sort_pdq_swap(ctx, pos_idx, pos_idx - 1);
+    }
+  }
 }
 
-func void sort_quick_recursive(
-    u8* base_ptr,
-    sz beg_idx,
-    sz end_idx,
-    sz elem_size,
-    sort_compare_fn* compare,
-    void* user_data) {
-  profile_func_begin;
-  if ((end_idx - beg_idx) < 2) {
-    profile_func_end;
-    return;
+// Insertion sort that gives up once it has moved SORT_PDQ_PARTIAL_INSERTION_MAX
+// elements. Returns true when the range ended up sorted.
+func b32 sort_pdq_partial_insertion(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx) {
+  sz moved = 0;
+  for (sz cur_idx = beg_idx + 1; cur_idx < end_idx; ++cur_idx) {
+    sz pos_idx = cur_idx;
+    for (; pos_idx > beg_idx && sort_pdq_less(ctx, pos_idx, pos_idx - 1); --pos_idx) {
+      sort_pdq_swap(ctx, pos_idx, pos_idx - 1);
+    }
+    moved += cur_idx - pos_idx;
+    if (moved > SORT_PDQ_PARTIAL_INSERTION_MAX) {
+      return false;
+    }
   }
+  return true;
+}
 
-  sz piv_idx = sort_partition(base_ptr, beg_idx, end_idx, elem_size, compare, user_data);
+func void sort_pdq_sift_down(sort_pdq_ctx* ctx, sz beg_idx, sz root, sz count) {
+  for (;;) {
+    sz child = (root * 2) + 1;
+    if (child >= count) {
+      return;
+    }
+    if (child + 1 < count && sort_pdq_less(ctx, beg_idx + child, beg_idx + child + 1)) {
+      child++;
+    }
+    if (!sort_pdq_less(ctx, beg_idx + root, beg_idx + child)) {
+      return;
+    }
+    sort_pdq_swap(ctx, beg_idx + root, beg_idx + child);
+    root = child;
+  }
+}
 
-  sort_quick_recursive(base_ptr, beg_idx, piv_idx, elem_size, compare, user_data);
-  sort_quick_recursive(base_ptr, piv_idx + 1, end_idx, elem_size, compare, user_data);
-  profile_func_end;
+// Fallback that keeps the worst case at O(n log n).
+func void sort_pdq_heap(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx) {
+  sz count = end_idx - beg_idx;
+  for (sz root = count / 2; root > 0; --root) {
+    sort_pdq_sift_down(ctx, beg_idx, root - 1, count);
+  }
+  for (sz last = count - 1; last > 0; --last) {
+    sort_pdq_swap(ctx, beg_idx, beg_idx + last);
+    sort_pdq_sift_down(ctx, beg_idx, 0, last);
+  }
+}
+
+// Partitions [beg, end) around the pivot at beg into < pivot and >= pivot.
+// Returns the final pivot position; *out_already is set when no element moved.
+// The median-of-3 selection guarantees an element >= pivot to the right.
+func sz sort_pdq_partition_right(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx, b32* out_already) {
+  sz first = beg_idx;
+  sz last = end_idx;
+  while (sort_pdq_less(ctx, ++first, beg_idx)) {
+  }
+  if (first - 1 == beg_idx) {
+    while (first < last && !sort_pdq_less(ctx, --last, beg_idx)) {
+    }
+  } else {
+    while (!sort_pdq_less(ctx, --last, beg_idx)) {
+    }
+  }
+
+  *out_already = first >= last;
+  while (first < last) {
+    sort_pdq_swap(ctx, first, last);
+    while (sort_pdq_less(ctx, ++first, beg_idx)) {
+    }
+    while (!sort_pdq_less(ctx, --last, beg_idx)) {
+    }
+  }
+
+  sz pivot_idx = first - 1;
+  sort_pdq_swap(ctx, beg_idx, pivot_idx);
+  return pivot_idx;
+}
+
+// Partitions [beg, end) around the pivot at beg into <= pivot and > pivot.
+// Used when the pivot equals the previous one, so the left side is all equal.
+func sz sort_pdq_partition_left(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx) {
+  sz first = beg_idx;
+  sz last = end_idx;
+  while (sort_pdq_less(ctx, beg_idx, --last)) {
+  }
+  if (last + 1 == end_idx) {
+    while (first < last && !sort_pdq_less(ctx, beg_idx, ++first)) {
+    }
+  } else {
+    while (!sort_pdq_less(ctx, beg_idx, ++first)) {
+    }
+  }
+
+  while (first < last) {
+    sort_pdq_swap(ctx, first, last);
+    while (sort_pdq_less(ctx, beg_idx, --last)) {
+    }
+    while (!sort_pdq_less(ctx, beg_idx, ++first)) {
+    }
+  }
+
+  sort_pdq_swap(ctx, beg_idx, last);
+  return last;
+}
+
+// Swaps a few elements around after an unbalanced partition to break up the
+// pattern that produced it.
+func void sort_pdq_break_patterns(sort_pdq_ctx* ctx, sz pivot_idx, sz l_size, sz r_size, sz beg_idx, sz end_idx) {
+  if (l_size >= SORT_PDQ_INSERTION_THRESHOLD) {
+    sort_pdq_swap(ctx, beg_idx, beg_idx + (l_size / 4));
+    sort_pdq_swap(ctx, pivot_idx - 1, pivot_idx - (l_size / 4));
+    if (l_size > SORT_PDQ_NINTHER_THRESHOLD) {
+      sort_pdq_swap(ctx, beg_idx + 1, beg_idx + (l_size / 4 + 1));
+      sort_pdq_swap(ctx, beg_idx + 2, beg_idx + (l_size / 4 + 2));
+      sort_pdq_swap(ctx, pivot_idx - 2, pivot_idx - (l_size / 4 + 1));
+      sort_pdq_swap(ctx, pivot_idx - 3, pivot_idx - (l_size / 4 + 2));
+    }
+  }
+  if (r_size >= SORT_PDQ_INSERTION_THRESHOLD) {
+    sort_pdq_swap(ctx, pivot_idx + 1, pivot_idx + (1 + r_size / 4));
+    sort_pdq_swap(ctx, end_idx - 1, end_idx - (r_size / 4));
+    if (r_size > SORT_PDQ_NINTHER_THRESHOLD) {
+      sort_pdq_swap(ctx, pivot_idx + 2, pivot_idx + (2 + r_size / 4));
+      sort_pdq_swap(ctx, pivot_idx + 3, pivot_idx + (3 + r_size / 4));
+      sort_pdq_swap(ctx, end_idx - 2, end_idx - (1 + r_size / 4));
+      sort_pdq_swap(ctx, end_idx - 3, end_idx - (2 + r_size / 4));
+    }
+  }
+}
+
+// bad_allowed is the number of unbalanced partitions left before heapsort takes over.
+// leftmost is false when the element before beg is a previous pivot, i.e. <= every element of the range.
+func void sort_pdq_loop(sort_pdq_ctx* ctx, sz beg_idx, sz end_idx, i32 bad_allowed, b32 leftmost) {
+  for (;;) {
+    sz size = end_idx - beg_idx;
+    if (size < SORT_PDQ_INSERTION_THRESHOLD) {
+      sort_pdq_insertion(ctx, beg_idx, end_idx);
+      return;
+    }
+
+    // Move the pivot to beg.
+    sz half = size / 2;
+    if (size > SORT_PDQ_NINTHER_THRESHOLD) {
+      sort_pdq_sort3(ctx, beg_idx, beg_idx + half, end_idx - 1);
+      sort_pdq_sort3(ctx, beg_idx + 1, beg_idx + (half - 1), end_idx - 2);
+      sort_pdq_sort3(ctx, beg_idx + 2, beg_idx + (half + 1), end_idx - 3);
+      sort_pdq_sort3(ctx, beg_idx + (half - 1), beg_idx + half, beg_idx + (half + 1));
+      sort_pdq_swap(ctx, beg_idx, beg_idx + half);
+    } else {
+      sort_pdq_sort3(ctx, beg_idx + half, beg_idx, end_idx - 1);
+    }
+
+    // A pivot equal to the previous one means the range starts with a run of
+    // equal elements; put them all on the left and skip them.
+    if (!leftmost && !sort_pdq_less(ctx, beg_idx - 1, beg_idx)) {
+      beg_idx = sort_pdq_partition_left(ctx, beg_idx, end_idx) + 1;
+      continue;
+    }
+
+    b32 already_partitioned = false;
+    sz pivot_idx = sort_pdq_partition_right(ctx, beg_idx, end_idx, &already_partitioned);
+    sz l_size = pivot_idx - beg_idx;
+    sz r_size = end_idx - (pivot_idx + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        sort_pdq_heap(ctx, beg_idx, end_idx);
+        return;
+      }
+      sort_pdq_break_patterns(ctx, pivot_idx, l_size, r_size, beg_idx, end_idx);
+    } else if (already_partitioned &&
+               sort_pdq_partial_insertion(ctx, beg_idx, pivot_idx) &&
+               sort_pdq_partial_insertion(ctx, pivot_idx + 1, end_idx)) {
+      return;
+    }
+
+    if (l_size < r_size) {
+      sort_pdq_loop(ctx, beg_idx, pivot_idx, bad_allowed, leftmost);
+      beg_idx = pivot_idx + 1;
+      leftmost = false;
+    } else {
+      sort_pdq_loop(ctx, pivot_idx + 1, end_idx, bad_allowed, false);
+      end_idx = pivot_idx;
+    }
+  }
 }
 
 func void sort_merge_ranges(
@@ -134,7 +336,7 @@ func void sort_merge_ranges(
   sz rhs_idx = mid_idx;
   sz out_idx = left_idx;
 
-  safe_while (lhs_idx < mid_idx && rhs_idx < right_idx) {
+  while (lhs_idx < mid_idx && rhs_idx < right_idx) {
     const void* lhs_ptr = sort_elem_ptr_const(base_ptr, lhs_idx, elem_size);
     const void* rhs_ptr = sort_elem_ptr_const(base_ptr, rhs_idx, elem_size);
     if (compare(lhs_ptr, rhs_ptr, user_data) <= 0) {
@@ -147,7 +349,7 @@ func void sort_merge_ranges(
     ++out_idx;
   }
 
-  safe_while (lhs_idx < mid_idx) {
+  while (lhs_idx < mid_idx) {
     mem_cpy(
         sort_elem_ptr(tmp_ptr, out_idx, elem_size),
         sort_elem_ptr(base_ptr, lhs_idx, elem_size),
@@ -156,7 +358,7 @@ func void sort_merge_ranges(
     ++out_idx;
   }
 
-  safe_while (rhs_idx < right_idx) {
+  while (rhs_idx < right_idx) {
     mem_cpy(
         sort_elem_ptr(tmp_ptr, out_idx, elem_size),
         sort_elem_ptr(base_ptr, rhs_idx, elem_size),
@@ -172,6 +374,86 @@ func void sort_merge_ranges(
   profile_func_end;
 }
 
+// Reverses base_ptr[beg_idx, end_idx) in place.
+func void sort_reverse_range(u8* base_ptr, sz beg_idx, sz end_idx, sz elem_size) {
+  while (beg_idx + 1 < end_idx) {
+    --end_idx;
+    sort_swap_bytes(sort_elem_ptr(base_ptr, beg_idx, elem_size), sort_elem_ptr(base_ptr, end_idx, elem_size), elem_size);
+    ++beg_idx;
+  }
+}
+
+// Stable merge of base_ptr[left_idx, mid_idx) and base_ptr[mid_idx, right_idx)
+// without scratch memory: split the longer run in half, find the matching cut
+// in the other run by binary search, rotate the two middle pieces into place
+// and recurse on both halves. O(n log n) moves per merge; only used when no
+// scratch buffer can be had.
+func void sort_merge_in_place(
+    u8* base_ptr,
+    sz left_idx,
+    sz mid_idx,
+    sz right_idx,
+    sz elem_size,
+    sort_compare_fn* compare,
+    void* user_data) {
+  sz lhs_count = mid_idx - left_idx;
+  sz rhs_count = right_idx - mid_idx;
+  if (lhs_count == 0 || rhs_count == 0) {
+    return;
+  }
+  if (lhs_count == 1 && rhs_count == 1) {
+    void* lhs_ptr = sort_elem_ptr(base_ptr, left_idx, elem_size);
+    void* rhs_ptr = sort_elem_ptr(base_ptr, mid_idx, elem_size);
+    if (compare(rhs_ptr, lhs_ptr, user_data) < 0) {
+      sort_swap_bytes(lhs_ptr, rhs_ptr, elem_size);
+    }
+    return;
+  }
+
+  sz lhs_cut = 0;
+  sz rhs_cut = 0;
+  if (lhs_count > rhs_count) {
+    // Right elements equal to the pivot stay behind it.
+    lhs_cut = left_idx + lhs_count / 2;
+    const void* pivot_ptr = sort_elem_ptr_const(base_ptr, lhs_cut, elem_size);
+    sz lo = mid_idx;
+    sz hi = right_idx;
+    while (lo < hi) {
+      sz probe = lo + (hi - lo) / 2;
+      if (compare(sort_elem_ptr_const(base_ptr, probe, elem_size), pivot_ptr, user_data) < 0) {
+        lo = probe + 1;
+      } else {
+        hi = probe;
+      }
+    }
+    rhs_cut = lo;
+  } else {
+    // Left elements equal to the pivot stay ahead of it.
+    rhs_cut = mid_idx + rhs_count / 2;
+    const void* pivot_ptr = sort_elem_ptr_const(base_ptr, rhs_cut, elem_size);
+    sz lo = left_idx;
+    sz hi = mid_idx;
+    while (lo < hi) {
+      sz probe = lo + (hi - lo) / 2;
+      if (compare(pivot_ptr, sort_elem_ptr_const(base_ptr, probe, elem_size), user_data) >= 0) {
+        lo = probe + 1;
+      } else {
+        hi = probe;
+      }
+    }
+    lhs_cut = lo;
+  }
+
+  // Rotate [lhs_cut, mid_idx) behind [mid_idx, rhs_cut).
+  sort_reverse_range(base_ptr, lhs_cut, mid_idx, elem_size);
+  sort_reverse_range(base_ptr, mid_idx, rhs_cut, elem_size);
+  sort_reverse_range(base_ptr, lhs_cut, rhs_cut, elem_size);
+
+  sz new_mid = lhs_cut + (rhs_cut - mid_idx);
+  sort_merge_in_place(base_ptr, left_idx, lhs_cut, new_mid, elem_size, compare, user_data);
+  sort_merge_in_place(base_ptr, new_mid, rhs_cut, right_idx, elem_size, compare, user_data);
+}
+
 func sz sort_radix32_partition(u32* ptr, sz beg_idx, sz end_idx, u32 bit_mask) {
   profile_func_begin;
   if ((end_idx - beg_idx) < 2) {
@@ -270,6 +552,254 @@ func void sort_radix64_recursive(u64* ptr, sz beg_idx, sz end_idx, i32 bit_idx)
   profile_func_end;
 }
 
+// Byte-wise LSD radix sort helpers.
+#define SORT_RADIX_BUCKETS 256
+
+func sz sort_radix_key_width(sort_key_type key_type) {
+  switch (key_type) {
+    case SORT_KEY_U32:
+    case SORT_KEY_I32:
+    case SORT_KEY_F32:
+      return size_of(u32);
+    case SORT_KEY_U64:
+    case SORT_KEY_I64:
+    case SORT_KEY_F64:
+      return size_of(u64);
+  }
+  return 0;
+}
+
+// Maps keys in-place to unsigned bit patterns that sort in the same order.
+// Signed integers flip the sign bit; floats flip the sign bit when positive
+// and every bit when negative.
+func void sort_radix_encode(void* keys, sz elem_count, sort_key_type key_type) {
+  profile_func_begin;
+  if (key_type == SORT_KEY_I32 || key_type == SORT_KEY_F32) {
+    u32* bits = (u32*)keys;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u32 val = bits[idx];
+      u32 mask = key_type == SORT_KEY_F32 ? ((u32)0 - (val >> 31)) | 0x80000000U : 0x80000000U;
+      bits[idx] = val ^ mask;
+    }
+  } else if (key_type == SORT_KEY_I64 || key_type == SORT_KEY_F64) {
+    u64* bits = (u64*)keys;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u64 val = bits[idx];
+      u64 mask = key_type == SORT_KEY_F64 ? ((u64)0 - (val >> 63)) | 0x8000000000000000ULL : 0x8000000000000000ULL;
+      bits[idx] = val ^ mask;
+    }
+  }
+  profile_func_end;
+}
+
+// Inverse of sort_radix_encode.
+func void sort_radix_decode(void* keys, sz elem_count, sort_key_type key_type) {
+  profile_func_begin;
+  if (key_type == SORT_KEY_I32 || key_type == SORT_KEY_F32) {
+    u32* bits = (u32*)keys;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u32 val = bits[idx];
+      u32 mask = key_type == SORT_KEY_F32 ? ((val >> 31) - 1) | 0x80000000U : 0x80000000U;
+      bits[idx] = val ^ mask;
+    }
+  } else if (key_type == SORT_KEY_I64 || key_type == SORT_KEY_F64) {
+    u64* bits = (u64*)keys;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u64 val = bits[idx];
+      u64 mask = key_type == SORT_KEY_F64 ? ((val >> 63) - 1) | 0x8000000000000000ULL : 0x8000000000000000ULL;
+      bits[idx] = val ^ mask;
+    }
+  }
+  profile_func_end;
+}
+
+// Constant-size copies compile down to single moves for the common payloads.
+func void sort_radix_move_value(u8* dst_ptr, sz dst_idx, const u8* src_ptr, sz src_idx, sz value_size) {
+  switch (value_size) {
+    case 4:
+      memcpy(dst_ptr + (dst_idx * 4), src_ptr + (src_idx * 4), 4);
+      break;
+    case 8:
+      memcpy(dst_ptr + (dst_idx * 8), src_ptr + (src_idx * 8), 8);
+      break;
+    default:
+      memcpy(dst_ptr + (dst_idx * value_size), src_ptr + (src_idx * value_size), value_size);
+      break;
+  }
+}
+
+// Turns a digit histogram into exclusive start offsets.
+// Returns false when every key shares one digit value, so the pass can be skipped.
+func b32 sort_radix_prefix_sum(sz* counts, sz elem_count) {
+  sz sum = 0;
+  safe_for (sz bucket = 0; bucket < SORT_RADIX_BUCKETS; ++bucket) {
+    sz cnt = counts[bucket];
+    if (cnt == elem_count) {
+      return false;
+    }
+    counts[bucket] = sum;
+    sum += cnt;
+  }
+  return true;
+}
+
+// LSD sort of 32-bit keys. tmp_keys/tmp_values must hold elem_count entries
+// and hist 4 * SORT_RADIX_BUCKETS counters. values may be NULL when value_size is 0.
+func void sort_radix_lsd32(
+    u32* keys,
+    u32* tmp_keys,
+    u8* values,
+    u8* tmp_values,
+    sz value_size,
+    sz elem_count,
+    sz* hist) {
+  profile_func_begin;
+  mem_zero(hist, 4 * SORT_RADIX_BUCKETS * size_of(sz));
+  for (sz idx = 0; idx < elem_count; ++idx) {
+    u32 key = keys[idx];
+    hist[(0 * SORT_RADIX_BUCKETS) + (key & 0xFF)]++;
+    hist[(1 * SORT_RADIX_BUCKETS) + ((key >> 8) & 0xFF)]++;
+    hist[(2 * SORT_RADIX_BUCKETS) + ((key >> 16) & 0xFF)]++;
+    hist[(3 * SORT_RADIX_BUCKETS) + (key >> 24)]++;
+  }
+
+  u32* src_keys = keys;
+  u32* dst_keys = tmp_keys;
+  u8* src_values = values;
+  u8* dst_values = tmp_values;
+  safe_for (u32 digit = 0; digit < 4; ++digit) {
+    sz* offsets = hist + (digit * SORT_RADIX_BUCKETS);
+    if (!sort_radix_prefix_sum(offsets, elem_count)) {
+      continue;
+    }
+    u32 shift = digit * 8;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u32 key = src_keys[idx];
+      sz dst_idx = offsets[(key >> shift) & 0xFF]++;
+      dst_keys[dst_idx] = key;
+      if (value_size) {
+        sort_radix_move_value(dst_values, dst_idx, src_values, idx, value_size);
+      }
+    }
+    u32* swap_keys = src_keys;
+    src_keys = dst_keys;
+    dst_keys = swap_keys;
+    u8* swap_values = src_values;
+    src_values = dst_values;
+    dst_values = swap_values;
+  }
+
+  // An odd number of scatter passes leaves the result in scratch.
+  if (src_keys != keys) {
+    memcpy(keys, src_keys, elem_count * size_of(u32));
+    if (value_size) {
+      memcpy(values, src_values, elem_count * value_size);
+    }
+  }
+  profile_func_end;
+}
+
+// 64-bit counterpart of sort_radix_lsd32; hist holds 8 * SORT_RADIX_BUCKETS counters.
+func void sort_radix_lsd64(
+    u64* keys,
+    u64* tmp_keys,
+    u8* values,
+    u8* tmp_values,
+    sz value_size,
+    sz elem_count,
+    sz* hist) {
+  profile_func_begin;
+  mem_zero(hist, 8 * SORT_RADIX_BUCKETS * size_of(sz));
+  for (sz idx = 0; idx < elem_count; ++idx) {
+    u64 key = keys[idx];
+    hist[(0 * SORT_RADIX_BUCKETS) + (key & 0xFF)]++;
+    hist[(1 * SORT_RADIX_BUCKETS) + ((key >> 8) & 0xFF)]++;
+    hist[(2 * SORT_RADIX_BUCKETS) + ((key >> 16) & 0xFF)]++;
+    hist[(3 * SORT_RADIX_BUCKETS) + ((key >> 24) & 0xFF)]++;
+    hist[(4 * SORT_RADIX_BUCKETS) + ((key >> 32) & 0xFF)]++;
+    hist[(5 * SORT_RADIX_BUCKETS) + ((key >> 40) & 0xFF)]++;
+    hist[(6 * SORT_RADIX_BUCKETS) + ((key >> 48) & 0xFF)]++;
+    hist[(7 * SORT_RADIX_BUCKETS) + (key >> 56)]++;
+  }
+
+  u64* src_keys = keys;
+  u64* dst_keys = tmp_keys;
+  u8* src_values = values;
+  u8* dst_values = tmp_values;
+  safe_for (u32 digit = 0; digit < 8; ++digit) {
+    sz* offsets = hist + (digit * SORT_RADIX_BUCKETS);
+    if (!sort_radix_prefix_sum(offsets, elem_count)) {
+      continue;
+    }
+    u32 shift = digit * 8;
+    for (sz idx = 0; idx < elem_count; ++idx) {
+      u64 key = src_keys[idx];
+      sz dst_idx = offsets[(key >> shift) & 0xFF]++;
+      dst_keys[dst_idx] = key;
+      if (value_size) {
+        sort_radix_move_value(dst_values, dst_idx, src_values, idx, value_size);
+      }
+    }
+    u64* swap_keys = src_keys;
+    src_keys = dst_keys;
+    dst_keys = swap_keys;
+    u8* swap_values = src_values;
+    src_values = dst_values;
+    dst_values = swap_values;
+  }
+
+  if (src_keys != keys) {
+    memcpy(keys, src_keys, elem_count * size_of(u64));
+    if (value_size) {
+      memcpy(values, src_values, elem_count * value_size);
+    }
+  }
+  profile_func_end;
+}
+
+func allocator sort_resolve_allocator(allocator alloc) {
+  if (alloc.alloc_fn == NULL || alloc.dealloc_fn == NULL) {
+    alloc = thread_get_allocator();
+  }
+  if (alloc.alloc_fn == NULL || alloc.dealloc_fn == NULL) {
+    alloc = global_get_allocator();
+  }
+  return alloc;
+}
+
+// Byte size of the LSD scratch block: key copy, value copy, then the histograms.
+func sz sort_radix_scratch_size(sz key_width, sz value_size, sz elem_count, sz* out_hist_offset) {
+  sz hist_offset = align_up(elem_count * (key_width + value_size), align_of(sz));
+  *out_hist_offset = hist_offset;
+  return hist_offset + (key_width * SORT_RADIX_BUCKETS * size_of(sz));
+}
+
+// Runs the LSD sort on keys/values using a caller-provided scratch block of
+// sort_radix_scratch_size bytes.
+func void sort_radix_run(
+    void* keys,
+    sort_key_type key_type,
+    void* values,
+    sz value_size,
+    sz elem_count,
+    u8* scratch_ptr) {
+  profile_func_begin;
+  sz key_width = sort_radix_key_width(key_type);
+  sz hist_offset = 0;
+  sort_radix_scratch_size(key_width, value_size, elem_count, &hist_offset);
+  u8* tmp_values = scratch_ptr + (elem_count * key_width);
+  sz* hist = (sz*)(scratch_ptr + hist_offset);
+
+  sort_radix_encode(keys, elem_count, key_type);
+  if (key_width == size_of(u32)) {
+    sort_radix_lsd32((u32*)keys, (u32*)scratch_ptr, (u8*)values, tmp_values, value_size, elem_count, hist);
+  } else {
+    sort_radix_lsd64((u64*)keys, (u64*)scratch_ptr, (u8*)values, tmp_values, value_size, elem_count, hist);
+  }
+  sort_radix_decode(keys, elem_count, key_type);
+  profile_func_end;
+}
+
 func b32 sort_check(
     const void* ptr,
     sz elem_count,
@@ -359,73 +889,12 @@ func sz sort_quick(
     return 0;
   }
 
-  u8* base_ptr = (u8*)ptr;
-  arena* temp_arena = thread_get_temp_arena();
-  if (temp_arena == NULL) {
-    sort_quick_recursive(base_ptr, 0, elem_count, elem_size, compare, user_data);
-    profile_func_end;
-    return elem_count;
-  }
-
-  if (elem_count > (((sz)-1) / size_of(sort_range))) {
-    sort_quick_recursive(base_ptr, 0, elem_count, elem_size, compare, user_data);
-    profile_func_end;
-    return elem_count;
-  }
-
-  scratch temp_scope = scratch_begin(temp_arena);
-  sort_range* stack_ptr = arena_alloc_array(temp_arena, sort_range, elem_count);
-  if (!stack_ptr) {
-    scratch_end(&temp_scope);
-    sort_quick_recursive(base_ptr, 0, elem_count, elem_size, compare, user_data);
-    profile_func_end;
-    return elem_count;
-  }
-
-  sz top_idx = 0;
-  stack_ptr[top_idx].beg_idx = 0;
-  stack_ptr[top_idx].end_idx = elem_count;
-  ++top_idx;
-
-  safe_while (top_idx) {
-    --top_idx;
-    sort_range cur_rng = stack_ptr[top_idx];
-    if ((cur_rng.end_idx - cur_rng.beg_idx) < 2) {
-      continue;
-    }
-
-    sz piv_idx =
-        sort_partition(base_ptr, cur_rng.beg_idx, cur_rng.end_idx, elem_size, compare, user_data);
-
-    sz left_count = piv_idx - cur_rng.beg_idx;
-    sz right_count = cur_rng.end_idx - (piv_idx + 1);
-
-    if (left_count > right_count) {
-      if (left_count > 1) {
-        stack_ptr[top_idx].beg_idx = cur_rng.beg_idx;
-        stack_ptr[top_idx].end_idx = piv_idx;
-        ++top_idx;
-      }
-      if (right_count > 1) {
-        stack_ptr[top_idx].beg_idx = piv_idx + 1;
-        stack_ptr[top_idx].end_idx = cur_rng.end_idx;
-        ++top_idx;
-      }
-    } else {
-      if (right_count > 1) {
-        stack_ptr[top_idx].beg_idx = piv_idx + 1;
-        stack_ptr[top_idx].end_idx = cur_rng.end_idx;
-        ++top_idx;
-      }
-      if (left_count > 1) {
-        stack_ptr[top_idx].beg_idx = cur_rng.beg_idx;
-        stack_ptr[top_idx].end_idx = piv_idx;
-        ++top_idx;
-      }
-    }
-  }
-
-  scratch_end(&temp_scope);
+  sort_pdq_ctx ctx;
+  ctx.base_ptr = (u8*)ptr;
+  ctx.elem_size = elem_size;
+  ctx.compare = compare;
+  ctx.user_data = user_data;
+  sort_pdq_loop(&ctx, 0, elem_count, bsr_u64((u64)elem_count), true);
   profile_func_end;
   return elem_count;
 }
@@ -436,9 +905,8 @@ func sz sort_merge(
     sz elem_size,
     sort_compare_fn* compare,
     void* user_data,
-    allocator allocator) {
+    allocator alloc) {
   profile_func_begin;
-  (void)allocator;
   if (elem_count < 2) {
     profile_func_end;
     return elem_count;
@@ -450,29 +918,29 @@ func sz sort_merge(
   }
 
   arena* temp_arena = thread_get_temp_arena();
-  if (temp_arena == NULL) {
-    profile_func_end;
-    return sort_quick(ptr, elem_count, elem_size, compare, user_data, allocator);
-  }
-
-  if (elem_count > (((sz)-1) / elem_size)) {
-    profile_func_end;
-    return sort_quick(ptr, elem_count, elem_size, compare, user_data, allocator);
-  }
-
-  sz temp_size = elem_count * elem_size;
-  scratch temp_scope = scratch_begin(temp_arena);
-  u8* tmp_ptr = (u8*)arena_alloc(temp_arena, temp_size, align_of(u8));
-  if (!tmp_ptr) {
-    scratch_end(&temp_scope);
-    profile_func_end;
-    return sort_quick(ptr, elem_count, elem_size, compare, user_data, allocator);
+  scratch temp_scope = {0};
+  allocator scratch_alloc = {0};
+  u8* tmp_ptr = NULL;
+  if (elem_count <= (((sz)-1) / elem_size)) {
+    sz temp_size = elem_count * elem_size;
+    if (temp_arena != NULL) {
+      temp_scope = scratch_begin(temp_arena);
+      tmp_ptr = (u8*)arena_alloc(temp_arena, temp_size, align_of(u8));
+      if (!tmp_ptr) {
+        scratch_end(&temp_scope);
+        temp_arena = NULL;
+      }
+    }
+    if (!tmp_ptr) {
+      scratch_alloc = sort_resolve_allocator(alloc);
+      tmp_ptr = scratch_alloc.alloc_fn ? (u8*)allocator_alloc(scratch_alloc, temp_size) : NULL;
+    }
   }
 
   u8* base_ptr = (u8*)ptr;
   safe_for (sz run_size = 1; run_size < elem_count;) {
     sz left_idx = 0;
-    safe_while (left_idx < elem_count) {
+    while (left_idx < elem_count) {
       sz mid_idx = elem_count;
       if ((elem_count - left_idx) > run_size) {
         mid_idx = left_idx + run_size;
@@ -484,15 +952,19 @@ func sz sort_merge(
       }
 
       if (mid_idx < right_idx) {
-        sort_merge_ranges(
-            base_ptr,
-            tmp_ptr,
-            left_idx,
-            mid_idx,
-            right_idx,
-            elem_size,
-            compare,
-            user_data);
+        if (tmp_ptr) {
+          sort_merge_ranges(
+              base_ptr,
+              tmp_ptr,
+              left_idx,
+              mid_idx,
+              right_idx,
+              elem_size,
+              compare,
+              user_data);
+        } else {
+          sort_merge_in_place(base_ptr, left_idx, mid_idx, right_idx, elem_size, compare, user_data);
+        }
       }
 
       sz rem_count = elem_count - left_idx;
@@ -512,7 +984,11 @@ func sz sort_merge(
     run_size *= 2;
   }
 
-  scratch_end(&temp_scope);
+  if (temp_arena != NULL && tmp_ptr) {
+    scratch_end(&temp_scope);
+  } else if (tmp_ptr) {
+    allocator_dealloc(scratch_alloc, tmp_ptr);
+  }
   profile_func_end;
   return elem_count;
 }
@@ -593,6 +1069,32 @@ func sz sort_insertion(
   return elem_count;
 }
 
+// Sorts with the LSD radix sort using scratch from the thread's temp arena.
+// Returns false when no scratch is available and nothing was sorted.
+func b32 sort_radix_with_temp_arena(void* keys, sort_key_type key_type, sz elem_count) {
+  profile_func_begin;
+  arena* temp_arena = thread_get_temp_arena();
+  if (temp_arena == NULL) {
+    profile_func_end;
+    return false;
+  }
+
+  sz hist_offset = 0;
+  sz scratch_size = sort_radix_scratch_size(sort_radix_key_width(key_type), 0, elem_count, &hist_offset);
+  scratch temp_scope = scratch_begin(temp_arena);
+  u8* scratch_ptr = (u8*)arena_alloc(temp_arena, scratch_size, align_of(u64));
+  if (!scratch_ptr) {
+    scratch_end(&temp_scope);
+    profile_func_end;
+    return false;
+  }
+
+  sort_radix_run(keys, key_type, NULL, 0, elem_count, scratch_ptr);
+  scratch_end(&temp_scope);
+  profile_func_end;
+  return true;
+}
+
 func sz sort_radix32(u32* ptr, sz elem_count) {
   profile_func_begin;
   if (elem_count < 2) {
@@ -605,7 +1107,9 @@ func sz sort_radix32(u32* ptr, sz elem_count) {
     return 0;
   }
 
-  sort_radix32_recursive(ptr, 0, elem_count, 31);
+  if (!sort_radix_with_temp_arena(ptr, SORT_KEY_U32, elem_count)) {
+    sort_radix32_recursive(ptr, 0, elem_count, 31);
+  }
   profile_func_end;
   return elem_count;
 }
@@ -622,7 +1126,687 @@ func sz sort_radix64(u64* ptr, sz elem_count) {
     return 0;
   }
 
-  sort_radix64_recursive(ptr, 0, elem_count, 63);
+  if (!sort_radix_with_temp_arena(ptr, SORT_KEY_U64, elem_count)) {
+    sort_radix64_recursive(ptr, 0, elem_count, 63);
+  }
+  profile_func_end;
+  return elem_count;
+}
+
+func sz sort_radix_pairs(
+    void* keys,
+    sort_key_type key_type,
+    void* values,
+    sz value_size,
+    sz elem_count,
+    allocator alloc) {
+  profile_func_begin;
+  if (elem_count < 2) {
+    profile_func_end;
+    return elem_count;
+  }
+
+  sz key_width = sort_radix_key_width(key_type);
+  if (!keys || key_width == 0 || (value_size != 0 && !values)) {
+    profile_func_end;
+    return 0;
+  }
+  if (!values) {
+    value_size = 0;
+  }
+
+  if (elem_count > (((sz)-1) / 2 / (key_width + value_size))) {
+    profile_func_end;
+    return 0;
+  }
+
+  alloc = sort_resolve_allocator(alloc);
+  sz hist_offset = 0;
+  sz scratch_size = sort_radix_scratch_size(key_width, value_size, elem_count, &hist_offset);
+  u8* scratch_ptr = (u8*)allocator_alloc(alloc, scratch_size);
+  if (!scratch_ptr) {
+    thread_log_error("Failed to allocate %zu bytes of radix sort scratch", scratch_size);
+    profile_func_end;
+    return 0;
+  }
+
+  sort_radix_run(keys, key_type, values, value_size, elem_count, scratch_ptr);
+  allocator_dealloc(alloc, scratch_ptr);
+  profile_func_end;
+  return elem_count;
+}
+
+func sz sort_radix_u32(u32* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_U32, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_u64(u64* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_U64, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_i32(i32* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_I32, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_i64(i64* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_I64, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_f32(f32* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_F32, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_f64(f64* keys, sz elem_count, allocator alloc) {
+  return sort_radix_pairs(keys, SORT_KEY_F64, NULL, 0, elem_count, alloc);
+}
+
+func sz sort_radix_indices(
+    const void* keys,
+    sort_key_type key_type,
+    u32* out_indices,
+    sz elem_count,
+    allocator alloc) {
+  profile_func_begin;
+  sz key_width = sort_radix_key_width(key_type);
+  if (!keys || !out_indices || key_width == 0 || elem_count > (sz)U32_MAX) {
+    profile_func_end;
+    return 0;
+  }
+
+  for (sz idx = 0; idx < elem_count; ++idx) {
+    out_indices[idx] = (u32)idx;
+  }
+  if (elem_count < 2) {
+    profile_func_end;
+    return elem_count;
+  }
+
+  // Sort a private copy of the keys with the indices as payload.
+  alloc = sort_resolve_allocator(alloc);
+  void* key_copy = allocator_alloc(alloc, elem_count * key_width);
+  if (!key_copy) {
+    thread_log_error("Failed to allocate radix sort key copy");
+    profile_func_end;
+    return 0;
+  }
+  memcpy(key_copy, keys, elem_count * key_width);
+  sz result = sort_radix_pairs(key_copy, key_type, out_indices, size_of(u32), elem_count, alloc);
+  allocator_dealloc(alloc, key_copy);
+  profile_func_end;
+  return result;
+}
+
+// =========================================================================
+// Parallel Sort
+// =========================================================================
+
+// Upper bound on workers; keeps the per-worker histograms small.
+#define SORT_PARALLEL_MAX_WORKERS 64
+
+// Length of the insertion-sorted runs each worker starts its chunk with.
+#define SORT_PARALLEL_RUN 32
+
+// Reusable barrier for the fixed set of workers of one parallel sort.
+typedef struct sort_barrier {
+  mutex mtx;
+  condvar cond;
+  u32 count;
+  u32 waiting;
+  u32 generation;
+} sort_barrier;
+
+func b32 sort_barrier_create(sort_barrier* barrier, u32 count) {
+  mem_zero(barrier, size_of(*barrier));
+  barrier->count = count;
+  barrier->mtx = mutex_create();
+  barrier->cond = condvar_create();
+  return barrier->mtx != NULL && barrier->cond != NULL;
+}
+
+func void sort_barrier_destroy(sort_barrier* barrier) {
+  if (barrier->cond) {
+    condvar_destroy(barrier->cond);
+  }
+  if (barrier->mtx) {
+    mutex_destroy(barrier->mtx);
+  }
+  mem_zero(barrier, size_of(*barrier));
+}
+
+func void sort_barrier_wait(sort_barrier* barrier) {
+  mutex_lock(barrier->mtx);
+  u32 generation = barrier->generation;
+  barrier->waiting++;
+  if (barrier->waiting == barrier->count) {
+    barrier->waiting = 0;
+    barrier->generation++;
+    condvar_broadcast(barrier->cond);
+  } else {
+    safe_while (generation == barrier->generation) {
+      condvar_wait(barrier->cond, barrier->mtx);
+    }
+  }
+  mutex_unlock(barrier->mtx);
+}
+
+// Number of workers for elem_count elements: at most thread_count, at least
+// SORT_PARALLEL_MIN_CHUNK elements each, rounded down to a power of two so the
+// merge rounds pair up evenly. Below 2 the caller takes the serial path.
+// A thread_count of 0 uses every logical core.
+func u32 sort_parallel_worker_count(sz elem_count, u32 thread_count) {
+  if (thread_count == 0) {
+    cpu_info info = {0};
+    thread_count = cpu_info_query(&info) ? info.logical_core_count : 1;
+  }
+  sz limit = elem_count / SORT_PARALLEL_MIN_CHUNK;
+  if (limit > thread_count) {
+    limit = thread_count;
+  }
+  if (limit > SORT_PARALLEL_MAX_WORKERS) {
+    limit = SORT_PARALLEL_MAX_WORKERS;
+  }
+  u32 count = 1;
+  safe_while ((sz)count * 2 <= limit) {
+    count *= 2;
+  }
+  return count;
+}
+
+// First element of part part_idx when elem_count elements are split into part_count parts.
+func sz sort_parallel_bound(sz elem_count, u32 part_count, u32 part_idx) {
+  return (sz)(((u64)elem_count * part_idx) / part_count);
+}
+
+typedef struct sort_parallel_merge_job {
+  sort_barrier barrier;
+  u32 worker_count;
+  u8* base_ptr;
+  u8* tmp_ptr;
+  sz elem_count;
+  sz elem_size;
+  sort_compare_fn* compare;
+  void* user_data;
+} sort_parallel_merge_job;
+
+// Stable merge of src[lhs_beg, lhs_end) and src[rhs_beg, rhs_end) into dst starting at out_idx.
+// Ties take the left element.
+func void sort_merge_runs(
+    const u8* src_ptr,
+    sz lhs_beg,
+    sz lhs_end,
+    sz rhs_beg,
+    sz rhs_end,
+    u8* dst_ptr,
+    sz out_idx,
+    sz elem_size,
+    sort_compare_fn* compare,
+    void* user_data) {
+  while (lhs_beg < lhs_end && rhs_beg < rhs_end) {
+    const void* lhs_ptr = sort_elem_ptr_const(src_ptr, lhs_beg, elem_size);
+    const void* rhs_ptr = sort_elem_ptr_const(src_ptr, rhs_beg, elem_size);
+    if (compare(lhs_ptr, rhs_ptr, user_data) <= 0) {
+      memcpy(sort_elem_ptr(dst_ptr, out_idx, elem_size), lhs_ptr, elem_size);
+      ++lhs_beg;
+    } else {
+      memcpy(sort_elem_ptr(dst_ptr, out_idx, elem_size), rhs_ptr, elem_size);
+      ++rhs_beg;
+    }
+    ++out_idx;
+  }
+  if (lhs_beg < lhs_end) {
+    memcpy(
+        sort_elem_ptr(dst_ptr, out_idx, elem_size),
+        sort_elem_ptr_const(src_ptr, lhs_beg, elem_size),
+        (lhs_end - lhs_beg) * elem_size);
+    out_idx += lhs_end - lhs_beg;
+  }
+  if (rhs_beg < rhs_end) {
+    memcpy(
+        sort_elem_ptr(dst_ptr, out_idx, elem_size),
+        sort_elem_ptr_const(src_ptr, rhs_beg, elem_size),
+        (rhs_end - rhs_beg) * elem_size);
+  }
+}
+
+// Merge path co-rank: how many of the first out_count merged elements come
+// from the left run src[lhs_beg, rhs_beg), given the right run src[rhs_beg, rhs_end).
+// Uses the same tie rule as sort_merge_runs, so split merges stay stable.
+func sz sort_merge_corank(
+    const u8* src_ptr,
+    sz lhs_beg,
+    sz rhs_beg,
+    sz rhs_end,
+    sz out_count,
+    sz elem_size,
+    sort_compare_fn* compare,
+    void* user_data) {
+  sz lhs_count = rhs_beg - lhs_beg;
+  sz rhs_count = rhs_end - rhs_beg;
+  sz lo = out_count > rhs_count ? out_count - rhs_count : 0;
+  sz hi = out_count < lhs_count ? out_count : lhs_count;
+  safe_while (lo < hi) {
+    sz lhs_idx = lo + ((hi - lo) / 2);
+    sz rhs_idx = out_count - lhs_idx;
+    // Left element lhs_idx would be emitted before right element rhs_idx - 1,
+    // so more than lhs_idx left elements are part of the prefix.
+    if (rhs_idx > 0 &&
+        compare(
+            sort_elem_ptr_const(src_ptr, lhs_beg + lhs_idx, elem_size),
+            sort_elem_ptr_const(src_ptr, rhs_beg + rhs_idx - 1, elem_size),
+            user_data) <= 0) {
+      lo = lhs_idx + 1;
+    } else {
+      hi = lhs_idx;
+    }
+  }
+  return lo;
+}
+
+// Sorts base[beg_idx, end_idx) with insertion-sorted runs and bottom-up merges
+// through the matching slice of tmp. The result always ends in base.
+func void sort_parallel_merge_chunk(sort_parallel_merge_job* job, sz beg_idx, sz end_idx) {
+  profile_func_begin;
+  sz elem_size = job->elem_size;
+  for (sz run_beg = beg_idx; run_beg < end_idx; run_beg += SORT_PARALLEL_RUN) {
+    sz run_count = end_idx - run_beg < SORT_PARALLEL_RUN ? end_idx - run_beg : SORT_PARALLEL_RUN;
+    sort_insertion(
+        sort_elem_ptr(job->base_ptr, run_beg, elem_size),
+        run_count,
+        elem_size,
+        job->compare,
+        job->user_data);
+  }
+
+  u8* src_ptr = job->base_ptr;
+  u8* dst_ptr = job->tmp_ptr;
+  safe_for (sz width = SORT_PARALLEL_RUN; width < end_idx - beg_idx; width *= 2) {
+    for (sz lo = beg_idx; lo < end_idx; lo += 2 * width) {
+      sz mid = end_idx - lo > width ? lo + width : end_idx;
+      sz hi = end_idx - mid > width ? mid + width : end_idx;
+      sort_merge_runs(src_ptr, lo, mid, mid, hi, dst_ptr, lo, elem_size, job->compare, job->user_data);
+    }
+    u8* swap_ptr = src_ptr;
+    src_ptr = dst_ptr;
+    dst_ptr = swap_ptr;
+  }
+  if (src_ptr != job->base_ptr) {
+    memcpy(
+        sort_elem_ptr(job->base_ptr, beg_idx, elem_size),
+        sort_elem_ptr(src_ptr, beg_idx, elem_size),
+        (end_idx - beg_idx) * elem_size);
+  }
+  profile_func_end;
+}
+
+func i32 sort_parallel_merge_worker(u32 worker_idx, void* arg) {
+  profile_func_begin;
+  sort_parallel_merge_job* job = (sort_parallel_merge_job*)arg;
+  u32 worker_count = job->worker_count;
+  sz elem_count = job->elem_count;
+  sz elem_size = job->elem_size;
+
+  sort_parallel_merge_chunk(
+      job,
+      sort_parallel_bound(elem_count, worker_count, worker_idx),
+      sort_parallel_bound(elem_count, worker_count, worker_idx + 1));
+  sort_barrier_wait(&job->barrier);
+
+  // Each round merges pairs of sorted spans; all workers of a span share its
+  // merge by taking an equal slice of the output and co-ranking its inputs.
+  u8* src_ptr = job->base_ptr;
+  u8* dst_ptr = job->tmp_ptr;
+  safe_for (u32 span = 2; span <= worker_count; span *= 2) {
+    u32 first_worker = worker_idx - (worker_idx % span);
+    u32 part_idx = worker_idx - first_worker;
+    sz lo = sort_parallel_bound(elem_count, worker_count, first_worker);
+    sz mid = sort_parallel_bound(elem_count, worker_count, first_worker + (span / 2));
+    sz hi = sort_parallel_bound(elem_count, worker_count, first_worker + span);
+    sz out_beg = sort_parallel_bound(hi - lo, span, part_idx);
+    sz out_end = sort_parallel_bound(hi - lo, span, part_idx + 1);
+    sz lhs_beg = sort_merge_corank(src_ptr, lo, mid, hi, out_beg, elem_size, job->compare, job->user_data);
+    sz lhs_end = sort_merge_corank(src_ptr, lo, mid, hi, out_end, elem_size, job->compare, job->user_data);
+    sort_merge_runs(
+        src_ptr,
+        lo + lhs_beg,
+        lo + lhs_end,
+        mid + (out_beg - lhs_beg),
+        mid + (out_end - lhs_end),
+        dst_ptr,
+        lo + out_beg,
+        elem_size,
+        job->compare,
+        job->user_data);
+    sort_barrier_wait(&job->barrier);
+    u8* swap_ptr = src_ptr;
+    src_ptr = dst_ptr;
+    dst_ptr = swap_ptr;
+  }
+
+  // The last round's output slice of each worker is its own chunk range.
+  if (src_ptr != job->base_ptr) {
+    sz beg_idx = sort_parallel_bound(elem_count, worker_count, worker_idx);
+    sz end_idx = sort_parallel_bound(elem_count, worker_count, worker_idx + 1);
+    memcpy(
+        sort_elem_ptr(job->base_ptr, beg_idx, elem_size),
+        sort_elem_ptr(src_ptr, beg_idx, elem_size),
+        (end_idx - beg_idx) * elem_size);
+  }
+  profile_func_end;
+  return 0;
+}
+
+typedef struct sort_parallel_radix_job {
+  sort_barrier barrier;
+  u32 worker_count;
+  sort_key_type key_type;
+  sz key_width;
+  u8* keys;
+  u8* tmp_keys;
+  u8* values;
+  u8* tmp_values;
+  sz value_size;
+  sz elem_count;
+  sz* digit_hist;  // worker_count * key_width * SORT_RADIX_BUCKETS, counted once up front.
+  sz* pass_hist;   // worker_count * SORT_RADIX_BUCKETS, recounted by later passes.
+} sort_parallel_radix_job;
+
+// Counts every digit of keys[beg_idx, end_idx) into key_width consecutive histograms.
+func void sort_parallel_radix_count_all(sort_parallel_radix_job* job, sz beg_idx, sz end_idx, sz* hist) {
+  mem_zero(hist, job->key_width * SORT_RADIX_BUCKETS * size_of(sz));
+  if (job->key_width == size_of(u32)) {
+    u32 const* keys = (u32 const*)job->keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      u32 key = keys[idx];
+      hist[(0 * SORT_RADIX_BUCKETS) + (key & 0xFF)]++;
+      hist[(1 * SORT_RADIX_BUCKETS) + ((key >> 8) & 0xFF)]++;
+      hist[(2 * SORT_RADIX_BUCKETS) + ((key >> 16) & 0xFF)]++;
+      hist[(3 * SORT_RADIX_BUCKETS) + (key >> 24)]++;
+    }
+  } else {
+    u64 const* keys = (u64 const*)job->keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      u64 key = keys[idx];
+      safe_for (u32 digit = 0; digit < 8; ++digit) {
+        hist[(digit * SORT_RADIX_BUCKETS) + ((key >> (digit * 8)) & 0xFF)]++;
+      }
+    }
+  }
+}
+
+// Counts one digit of src_keys[beg_idx, end_idx).
+func void sort_parallel_radix_count_digit(
+    sort_parallel_radix_job* job,
+    const u8* src_keys,
+    sz beg_idx,
+    sz end_idx,
+    u32 shift,
+    sz* hist) {
+  mem_zero(hist, SORT_RADIX_BUCKETS * size_of(sz));
+  if (job->key_width == size_of(u32)) {
+    u32 const* keys = (u32 const*)src_keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      hist[(keys[idx] >> shift) & 0xFF]++;
+    }
+  } else {
+    u64 const* keys = (u64 const*)src_keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      hist[(keys[idx] >> shift) & 0xFF]++;
+    }
+  }
+}
+
+// Moves src[beg_idx, end_idx) to the positions given by offsets, which the
+// worker owns exclusively for this pass.
+func void sort_parallel_radix_scatter(
+    sort_parallel_radix_job* job,
+    const u8* src_keys,
+    u8* dst_keys,
+    const u8* src_values,
+    u8* dst_values,
+    sz beg_idx,
+    sz end_idx,
+    u32 shift,
+    sz* offsets) {
+  sz value_size = job->value_size;
+  if (job->key_width == size_of(u32)) {
+    u32 const* src = (u32 const*)src_keys;
+    u32* dst = (u32*)dst_keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      u32 key = src[idx];
+      sz dst_idx = offsets[(key >> shift) & 0xFF]++;
+      dst[dst_idx] = key;
+      if (value_size) {
+        sort_radix_move_value(dst_values, dst_idx, src_values, idx, value_size);
+      }
+    }
+  } else {
+    u64 const* src = (u64 const*)src_keys;
+    u64* dst = (u64*)dst_keys;
+    for (sz idx = beg_idx; idx < end_idx; ++idx) {
+      u64 key = src[idx];
+      sz dst_idx = offsets[(key >> shift) & 0xFF]++;
+      dst[dst_idx] = key;
+      if (value_size) {
+        sort_radix_move_value(dst_values, dst_idx, src_values, idx, value_size);
+      }
+    }
+  }
+}
+
+func i32 sort_parallel_radix_worker(u32 worker_idx, void* arg) {
+  profile_func_begin;
+  sort_parallel_radix_job* job = (sort_parallel_radix_job*)arg;
+  u32 worker_count = job->worker_count;
+  sz key_width = job->key_width;
+  sz value_size = job->value_size;
+  sz beg_idx = sort_parallel_bound(job->elem_count, worker_count, worker_idx);
+  sz end_idx = sort_parallel_bound(job->elem_count, worker_count, worker_idx + 1);
+
+  sort_radix_encode(job->keys + (beg_idx * key_width), end_idx - beg_idx, job->key_type);
+  sort_parallel_radix_count_all(job, beg_idx, end_idx, job->digit_hist + (worker_idx * key_width * SORT_RADIX_BUCKETS));
+  sort_barrier_wait(&job->barrier);
+
+  u8* src_keys = job->keys;
+  u8* dst_keys = job->tmp_keys;
+  u8* src_values = job->values;
+  u8* dst_values = job->tmp_values;
+  b32 layout_changed = false;
+  safe_for (u32 digit = 0; digit < key_width; ++digit) {
+    // Digit totals do not depend on the layout, so every worker reaches the
+    // same skip decision from the up-front histograms without talking.
+    sz totals[SORT_RADIX_BUCKETS];
+    b32 constant = false;
+    safe_for (sz bucket = 0; bucket < SORT_RADIX_BUCKETS; ++bucket) {
+      sz total = 0;
+      safe_for (u32 other = 0; other < worker_count; ++other) {
+        total += job->digit_hist[(((other * key_width) + digit) * SORT_RADIX_BUCKETS) + bucket];
+      }
+      totals[bucket] = total;
+      if (total == job->elem_count) {
+        constant = true;
+      }
+    }
+    if (constant) {
+      continue;
+    }
+
+    // Per-worker counts from the up-front pass only hold until the first scatter.
+    u32 shift = digit * 8;
+    sz* counts = job->digit_hist + (digit * SORT_RADIX_BUCKETS);
+    sz counts_stride = key_width * SORT_RADIX_BUCKETS;
+    if (layout_changed) {
+      counts = job->pass_hist;
+      counts_stride = SORT_RADIX_BUCKETS;
+      sort_parallel_radix_count_digit(job, src_keys, beg_idx, end_idx, shift, counts + (worker_idx * counts_stride));
+      sort_barrier_wait(&job->barrier);
+    }
+
+    // Bucket b of this worker starts after every smaller bucket and after
+    // bucket b of every earlier worker, which keeps the pass stable.
+    sz offsets[SORT_RADIX_BUCKETS];
+    sz bucket_beg = 0;
+    safe_for (sz bucket = 0; bucket < SORT_RADIX_BUCKETS; ++bucket) {
+      sz offset = bucket_beg;
+      safe_for (u32 other = 0; other < worker_idx; ++other) {
+        offset += counts[(other * counts_stride) + bucket];
+      }
+      offsets[bucket] = offset;
+      bucket_beg += totals[bucket];
+    }
+
+    sort_parallel_radix_scatter(job, src_keys, dst_keys, src_values, dst_values, beg_idx, end_idx, shift, offsets);
+    sort_barrier_wait(&job->barrier);
+
+    u8* swap_keys = src_keys;
+    src_keys = dst_keys;
+    dst_keys = swap_keys;
+    u8* swap_values = src_values;
+    src_values = dst_values;
+    dst_values = swap_values;
+    layout_changed = true;
+  }
+
+  if (src_keys != job->keys) {
+    memcpy(job->keys + (beg_idx * key_width), src_keys + (beg_idx * key_width), (end_idx - beg_idx) * key_width);
+    if (value_size) {
+      memcpy(job->values + (beg_idx * value_size), src_values + (beg_idx * value_size), (end_idx - beg_idx) * value_size);
+    }
+  }
+  sort_radix_decode(job->keys + (beg_idx * key_width), end_idx - beg_idx, job->key_type);
+  profile_func_end;
+  return 0;
+}
+
+// Runs entry on worker_count threads sharing barrier. Returns false when the
+// threads could not be started; no worker has run in that case.
+func b32 sort_parallel_run(u32 worker_count, thread_group_func entry, void* job, sort_barrier* barrier) {
+  if (!sort_barrier_create(barrier, worker_count)) {
+    sort_barrier_destroy(barrier);
+    thread_log_error("Failed to create parallel sort barrier");
+    return false;
+  }
+  thread_group group = thread_group_create_named(worker_count, entry, job, thread_get_setup(), "sort");
+  if (!group) {
+    sort_barrier_destroy(barrier);
+    thread_log_error("Failed to start %u parallel sort workers", worker_count);
+    return false;
+  }
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  sort_barrier_destroy(barrier);
+  return true;
+}
+
+func sz sort_parallel_merge(
+    void* ptr,
+    sz elem_count,
+    sz elem_size,
+    sort_compare_fn* compare,
+    void* user_data,
+    allocator alloc,
+    u32 thread_count) {
+  profile_func_begin;
+  if (elem_count < 2) {
+    profile_func_end;
+    return elem_count;
+  }
+  if (sort_is_invalid_input(ptr, elem_count, elem_size, compare)) {
+    profile_func_end;
+    return 0;
+  }
+
+  u32 worker_count = sort_parallel_worker_count(elem_count, thread_count);
+  if (worker_count < 2 || elem_count > (((sz)-1) / elem_size)) {
+    profile_func_end;
+    return sort_merge(ptr, elem_count, elem_size, compare, user_data, alloc);
+  }
+
+  alloc = sort_resolve_allocator(alloc);
+  u8* tmp_ptr = (u8*)allocator_alloc(alloc, elem_count * elem_size);
+  if (!tmp_ptr) {
+    thread_log_error("Failed to allocate %zu bytes of parallel merge sort scratch", elem_count * elem_size);
+    profile_func_end;
+    return 0;
+  }
+
+  sort_parallel_merge_job job;
+  mem_zero(&job, size_of(job));
+  job.worker_count = worker_count;
+  job.base_ptr = (u8*)ptr;
+  job.tmp_ptr = tmp_ptr;
+  job.elem_count = elem_count;
+  job.elem_size = elem_size;
+  job.compare = compare;
+  job.user_data = user_data;
+  b32 ran = sort_parallel_run(worker_count, sort_parallel_merge_worker, &job, &job.barrier);
+  allocator_dealloc(alloc, tmp_ptr);
+  profile_func_end;
+  if (!ran) {
+    return sort_merge(ptr, elem_count, elem_size, compare, user_data, alloc);
+  }
+  return elem_count;
+}
+
+func sz sort_parallel_radix(
+    void* keys,
+    sort_key_type key_type,
+    void* values,
+    sz value_size,
+    sz elem_count,
+    allocator alloc,
+    u32 thread_count) {
+  profile_func_begin;
+  if (elem_count < 2) {
+    profile_func_end;
+    return elem_count;
+  }
+
+  sz key_width = sort_radix_key_width(key_type);
+  if (!keys || key_width == 0 || (value_size != 0 && !values)) {
+    profile_func_end;
+    return 0;
+  }
+  if (!values) {
+    value_size = 0;
+  }
+
+  u32 worker_count = sort_parallel_worker_count(elem_count, thread_count);
+  if (worker_count < 2 || elem_count > (((sz)-1) / 2 / (key_width + value_size))) {
+    profile_func_end;
+    return sort_radix_pairs(keys, key_type, values, value_size, elem_count, alloc);
+  }
+
+  // Key copy, value copy, then both histogram tables.
+  alloc = sort_resolve_allocator(alloc);
+  sz hist_offset = align_up(elem_count * (key_width + value_size), align_of(sz));
+  sz digit_hist_count = (sz)worker_count * key_width * SORT_RADIX_BUCKETS;
+  sz pass_hist_count = (sz)worker_count * SORT_RADIX_BUCKETS;
+  sz scratch_size = hist_offset + ((digit_hist_count + pass_hist_count) * size_of(sz));
+  u8* scratch_ptr = (u8*)allocator_alloc(alloc, scratch_size);
+  if (!scratch_ptr) {
+    thread_log_error("Failed to allocate %zu bytes of parallel radix sort scratch", scratch_size);
+    profile_func_end;
+    return 0;
+  }
+
+  sort_parallel_radix_job job;
+  mem_zero(&job, size_of(job));
+  job.worker_count = worker_count;
+  job.key_type = key_type;
+  job.key_width = key_width;
+  job.keys = (u8*)keys;
+  job.tmp_keys = scratch_ptr;
+  job.values = (u8*)values;
+  job.tmp_values = scratch_ptr + (elem_count * key_width);
+  job.value_size = value_size;
+  job.elem_count = elem_count;
+  job.digit_hist = (sz*)(scratch_ptr + hist_offset);
+  job.pass_hist = job.digit_hist + digit_hist_count;
+  b32 ran = sort_parallel_run(worker_count, sort_parallel_radix_worker, &job, &job.barrier);
+  if (!ran) {
+    sort_radix_run(keys, key_type, values, value_size, elem_count, scratch_ptr);
+  }
+  allocator_dealloc(alloc, scratch_ptr);
   profile_func_end;
   return elem_count;
 }
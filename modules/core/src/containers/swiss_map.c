@@ -0,0 +1,506 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/swiss_map.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/intrinsics.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+#include <string.h>
+
+#if defined(ARCH_X86_64) || defined(ARCH_X86)
+#  include <emmintrin.h>
+#  define SWISS_MAP_SSE2
+#elif defined(ARCH_ARM64)
+#  include <arm_neon.h>
+#  define SWISS_MAP_NEON
+#endif
+
+// =========================================================================
+// Control Bytes
+// =========================================================================
+
+// Full slots store the low 7 bits of the key hash, so the high bit alone
+// separates full slots from the two markers.
+#define SWISS_MAP_CTRL_EMPTY   ((u8)0x80)
+#define SWISS_MAP_CTRL_DELETED ((u8)0xFE)
+
+// =========================================================================
+// Group Matching
+// =========================================================================
+
+// A group is SWISS_MAP_GROUP_WIDTH consecutive control bytes loaded at once.
+// Matches come back as a mask with one set bit per matching lane; the lane
+// index of a bit is its position shifted right by SWISS_MAP_LANE_SHIFT.
+typedef u64 swiss_map_mask;
+
+#if defined(SWISS_MAP_SSE2)
+
+#  define SWISS_MAP_GROUP_WIDTH 16
+#  define SWISS_MAP_LANE_SHIFT  0
+
+func swiss_map_mask swiss_map_group_match(u8 const* ctrl, u8 h2) {
+  __m128i group = _mm_loadu_si128((__m128i const*)ctrl);
+  return (swiss_map_mask)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+func swiss_map_mask swiss_map_group_match_empty(u8 const* ctrl) {
+  return swiss_map_group_match(ctrl, SWISS_MAP_CTRL_EMPTY);
+}
+
+func swiss_map_mask swiss_map_group_match_free(u8 const* ctrl) {
+  // Empty and deleted are the only control bytes with the high bit set.
+  __m128i group = _mm_loadu_si128((__m128i const*)ctrl);
+  return (swiss_map_mask)(u32)_mm_movemask_epi8(group);
+}
+
+#elif defined(SWISS_MAP_NEON)
+
+#  define SWISS_MAP_GROUP_WIDTH 16
+#  define SWISS_MAP_LANE_SHIFT  2
+
+// NEON has no movemask; narrowing every 16-bit pair by 4 leaves one nibble per
+// lane, and keeping the top bit of each nibble gives a sparse lane mask.
+func swiss_map_mask swiss_map_neon_mask(uint8x16_t cmp) {
+  uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+  return (swiss_map_mask)vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+}
+
+func swiss_map_mask swiss_map_group_match(u8 const* ctrl, u8 h2) {
+  return swiss_map_neon_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)));
+}
+
+func swiss_map_mask swiss_map_group_match_empty(u8 const* ctrl) {
+  return swiss_map_group_match(ctrl, SWISS_MAP_CTRL_EMPTY);
+}
+
+func swiss_map_mask swiss_map_group_match_free(u8 const* ctrl) {
+  return swiss_map_neon_mask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0)));
+}
+
+#else
+
+// Portable fallback: eight control bytes packed into a u64 and matched with
+// SWAR bit tricks. The match can report a false positive next to a true one,
+// which is harmless because every candidate key is compared anyway.
+#  define SWISS_MAP_GROUP_WIDTH 8
+#  define SWISS_MAP_LANE_SHIFT  3
+#  define SWISS_MAP_SWAR_LSBS   0x0101010101010101ULL
+#  define SWISS_MAP_SWAR_MSBS   0x8080808080808080ULL
+
+func u64 swiss_map_swar_load(u8 const* ctrl) {
+  u64 word = 0;
+  safe_for (sz idx = 0; idx < SWISS_MAP_GROUP_WIDTH; idx++) {
+    word |= (u64)ctrl[idx] << (idx * 8);
+  }
+  return word;
+}
+
+func swiss_map_mask swiss_map_group_match(u8 const* ctrl, u8 h2) {
+  u64 word = swiss_map_swar_load(ctrl) ^ (SWISS_MAP_SWAR_LSBS * h2);
+  return (word - SWISS_MAP_SWAR_LSBS) & ~word & SWISS_MAP_SWAR_MSBS;
+}
+
+func swiss_map_mask swiss_map_group_match_empty(u8 const* ctrl) {
+  // Empty is the only control byte with the high bit set and bit 1 clear.
+  u64 word = swiss_map_swar_load(ctrl);
+  return word & ~(word << 6) & SWISS_MAP_SWAR_MSBS;
+}
+
+func swiss_map_mask swiss_map_group_match_free(u8 const* ctrl) {
+  return swiss_map_swar_load(ctrl) & SWISS_MAP_SWAR_MSBS;
+}
+
+#endif
+
+func sz swiss_map_mask_lane(swiss_map_mask mask) {
+  return (sz)ctz_u64(mask) >> SWISS_MAP_LANE_SHIFT;
+}
+
+// Number of lanes before the first set lane, or the group width when none is set.
+func sz swiss_map_mask_leading_lanes(swiss_map_mask mask) {
+  return mask != 0 ? swiss_map_mask_lane(mask) : SWISS_MAP_GROUP_WIDTH;
+}
+
+// Number of lanes after the last set lane, or the group width when none is set.
+func sz swiss_map_mask_trailing_lanes(swiss_map_mask mask) {
+  if (mask == 0) {
+    return SWISS_MAP_GROUP_WIDTH;
+  }
+  sz top_bit = ((sz)SWISS_MAP_GROUP_WIDTH << SWISS_MAP_LANE_SHIFT) - 1;
+  return (top_bit - (sz)bsr_u64(mask)) >> SWISS_MAP_LANE_SHIFT;
+}
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Capacities must stay power-of-two because probing masks with (cap - 1),
+// and at least one group wide so the cloned control tail never overlaps itself.
+func sz swiss_map_normalize_capacity(sz min_cap) {
+  if (min_cap <= 16) {
+    return 16;
+  }
+
+  sz target_cap = 16;
+  safe_while (target_cap < min_cap) {
+    target_cap *= 2;
+  }
+
+  return target_cap;
+}
+
+// Entries (plus tombstones) a table of cap slots holds before it must grow: 7/8.
+func sz swiss_map_growth_limit(sz cap) {
+  return cap - cap / 8;
+}
+
+func u64 swiss_map_hash(u64 key) {
+  return hash_u64(key);
+}
+
+func u8 swiss_map_h2(u64 hash) {
+  return (u8)(hash & 0x7F);
+}
+
+// Writes a control byte and keeps the cloned copy of the first group in sync.
+// For idx < SWISS_MAP_GROUP_WIDTH the second store lands at cap + idx;
+// otherwise it rewrites idx itself.
+func void swiss_map_set_ctrl(swiss_map* map, sz idx, u8 ctrl) {
+  sz mask = map->cap - 1;
+  map->ctrl[idx] = ctrl;
+  map->ctrl[((idx - SWISS_MAP_GROUP_WIDTH) & mask) + SWISS_MAP_GROUP_WIDTH] = ctrl;
+}
+
+// Finds the first empty or deleted slot on the probe sequence of hash.
+// Groups are visited at triangular offsets, which reach every group of a
+// power-of-two table before repeating. The load limit guarantees a free slot.
+func sz swiss_map_find_free(swiss_map* map, u64 hash) {
+  profile_func_begin;
+  sz mask = map->cap - 1;
+  sz pos = (sz)(hash >> 7) & mask;
+  sz stride = 0;
+
+  safe_for (;;) {
+    swiss_map_mask avail = swiss_map_group_match_free(map->ctrl + pos);
+    if (avail != 0) {
+      profile_func_end;
+      return (pos + swiss_map_mask_lane(avail)) & mask;
+    }
+    stride += SWISS_MAP_GROUP_WIDTH;
+    pos = (pos + stride) & mask;
+  }
+
+  profile_func_end;
+  return 0;
+}
+
+// Find the slot index holding key; returns SZ_MAX when the key is absent.
+func sz swiss_map_find_index(swiss_map* map, u64 key, u64 hash) {
+  profile_func_begin;
+  sz mask = map->cap - 1;
+  sz pos = (sz)(hash >> 7) & mask;
+  sz stride = 0;
+  u8 h2 = swiss_map_h2(hash);
+
+  safe_for (;;) {
+    u8 const* group = map->ctrl + pos;
+    swiss_map_mask match = swiss_map_group_match(group, h2);
+    safe_while (match != 0) {
+      sz idx = (pos + swiss_map_mask_lane(match)) & mask;
+      if (map->slots[idx].key == key) {
+        profile_func_end;
+        return idx;
+      }
+      match &= match - 1;
+    }
+    // An empty byte ends every probe run that passed through this group.
+    if (swiss_map_group_match_empty(group) != 0) {
+      profile_func_end;
+      return SZ_MAX;
+    }
+    stride += SWISS_MAP_GROUP_WIDTH;
+    pos = (pos + stride) & mask;
+  }
+
+  profile_func_end;
+  return SZ_MAX;
+}
+
+// Rebuilds the table into a fresh allocation of target_cap slots.
+// Returns 1 on success, 0 on allocation failure (the old table is kept).
+func b32 swiss_map_resize(swiss_map* map, sz target_cap) {
+  profile_func_begin;
+  sz ctrl_size = target_cap + SWISS_MAP_GROUP_WIDTH;
+  u8* memory = (u8*)allocator_alloc(map->alloc, target_cap * size_of(swiss_map_slot) + ctrl_size);
+  if (memory == NULL) {
+    profile_func_end;
+    return false;
+  }
+
+  // Slots come first so they inherit the allocation's alignment.
+  swiss_map old = *map;
+  map->slots = (swiss_map_slot*)memory;
+  map->ctrl = memory + target_cap * size_of(swiss_map_slot);
+  map->cap = target_cap;
+  map->tombstones = 0;
+  memset(map->ctrl, SWISS_MAP_CTRL_EMPTY, ctrl_size);
+
+  for (sz idx = 0; idx < old.cap; idx++) {
+    if (old.ctrl[idx] & 0x80) {
+      continue;
+    }
+    u64 hash = swiss_map_hash(old.slots[idx].key);
+    sz dst = swiss_map_find_free(map, hash);
+    swiss_map_set_ctrl(map, dst, swiss_map_h2(hash));
+    map->slots[dst] = old.slots[idx];
+  }
+
+  if (old.slots) {
+    allocator_dealloc(map->alloc, old.slots);
+  }
+  profile_func_end;
+  return true;
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func swiss_map swiss_map_create(sz cap, allocator alloc) {
+  profile_func_begin;
+  swiss_map map;
+  mem_zero(&map, size_of(map));
+  map.alloc = alloc;
+  if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {
+    map.alloc = thread_get_allocator();
+  }
+  if (map.alloc.alloc_fn == NULL || map.alloc.dealloc_fn == NULL) {
+    map.alloc = global_get_allocator();
+  }
+
+  if (map.alloc.alloc_fn != NULL && map.alloc.dealloc_fn != NULL) {
+    swiss_map_resize(&map, swiss_map_normalize_capacity(cap));
+  }
+  profile_func_end;
+  return map;
+}
+
+func void swiss_map_destroy(swiss_map* map) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return;
+  }
+  if (map->slots) {
+    allocator_dealloc(map->alloc, map->slots);
+    map->slots = NULL;
+    map->ctrl = NULL;
+  }
+  map->count = 0;
+  map->tombstones = 0;
+  map->cap = 0;
+  profile_func_end;
+}
+
+func void swiss_map_clear(swiss_map* map) {
+  profile_func_begin;
+  if (map == NULL) {
+    profile_func_end;
+    return;
+  }
+  if (map->ctrl) {
+    memset(map->ctrl, SWISS_MAP_CTRL_EMPTY, map->cap + SWISS_MAP_GROUP_WIDTH);
+  }
+  map->count = 0;
+  map->tombstones = 0;
+  profile_func_end;
+}
+
+// =========================================================================
+// Capacity and Occupancy
+// =========================================================================
+
+func sz swiss_map_count(swiss_map const* map) {
+  if (map == NULL) {
+    return 0;
+  }
+  return map->count;
+}
+
+func sz swiss_map_capacity(swiss_map const* map) {
+  if (map == NULL) {
+    return 0;
+  }
+  return map->cap;
+}
+
+func f32 swiss_map_load_factor(swiss_map const* map) {
+  if (map == NULL || map->cap == 0) {
+    return 0.0F;
+  }
+  f32 result = (f32)map->count / (f32)map->cap;
+  return result;
+}
+
+// =========================================================================
+// Capacity Management
+// =========================================================================
+
+func b32 swiss_map_rehash(swiss_map* map, sz new_cap) {
+  profile_func_begin;
+  if (map == NULL || map->slots == NULL) {
+    profile_func_end;
+    return false;
+  }
+
+  // Never shrink below what the current entries need.
+  sz min_cap = new_cap;
+  sz needed = map->count + map->count / 7 + 1;
+  if (min_cap < needed) {
+    min_cap = needed;
+  }
+
+  sz target_cap = swiss_map_normalize_capacity(min_cap);
+  if (map->cap == target_cap && map->tombstones == 0) {
+    profile_func_end;
+    return true;
+  }
+
+  b32 result = swiss_map_resize(map, target_cap);
+  profile_func_end;
+  return result;
+}
+
+func b32 swiss_map_reserve(swiss_map* map, sz min_count) {
+  profile_func_begin;
+  if (map == NULL || map->slots == NULL) {
+    profile_func_end;
+    return false;
+  }
+
+  if (min_count < swiss_map_growth_limit(map->cap) - map->tombstones) {
+    profile_func_end;
+    return true;
+  }
+
+  b32 result = swiss_map_rehash(map, min_count + min_count / 7 + 1);
+  profile_func_end;
+  return result;
+}
+
+// =========================================================================
+// Key/Value Operations
+// =========================================================================
+
+func b32 swiss_map_set(swiss_map* map, u64 key, void* value) {
+  profile_func_begin;
+  if (map == NULL || !map->slots) {
+    profile_func_end;
+    return false;
+  }
+  assert(map->cap > 0);
+
+  u64 hash = swiss_map_hash(key);
+  sz idx = swiss_map_find_index(map, key, hash);
+  if (idx != SZ_MAX) {
+    map->slots[idx].value = value;
+    profile_func_end;
+    return true;
+  }
+
+  idx = swiss_map_find_free(map, hash);
+  // Reusing a tombstone never lengthens a probe run; claiming an empty slot
+  // may, so that is when the 7/8 limit is enforced.
+  if (map->ctrl[idx] == SWISS_MAP_CTRL_EMPTY && map->count + map->tombstones + 1 > swiss_map_growth_limit(map->cap)) {
+    // Mostly tombstones: rebuild at the same size. Otherwise double.
+    sz target_cap = map->count + 1 > map->cap / 2 ? map->cap * 2 : map->cap;
+    if (!swiss_map_resize(map, target_cap)) {
+      profile_func_end;
+      return false;
+    }
+    idx = swiss_map_find_free(map, hash);
+  }
+
+  if (map->ctrl[idx] == SWISS_MAP_CTRL_DELETED) {
+    map->tombstones--;
+  }
+  swiss_map_set_ctrl(map, idx, swiss_map_h2(hash));
+  map->slots[idx].key = key;
+  map->slots[idx].value = value;
+  map->count++;
+  profile_func_end;
+  return true;
+}
+
+func void* swiss_map_get(swiss_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || !map->slots || map->count == 0) {
+    profile_func_end;
+    return NULL;
+  }
+  sz idx = swiss_map_find_index(map, key, swiss_map_hash(key));
+  profile_func_end;
+  return idx != SZ_MAX ? map->slots[idx].value : NULL;
+}
+
+func b32 swiss_map_has(swiss_map* map, u64 key) {
+  if (map == NULL || !map->slots || map->count == 0) {
+    return false;
+  }
+  return swiss_map_find_index(map, key, swiss_map_hash(key)) != SZ_MAX;
+}
+
+func b32 swiss_map_remove(swiss_map* map, u64 key) {
+  profile_func_begin;
+  if (map == NULL || !map->slots || map->count == 0) {
+    profile_func_end;
+    return false;
+  }
+
+  sz idx = swiss_map_find_index(map, key, swiss_map_hash(key));
+  if (idx == SZ_MAX) {
+    profile_func_end;
+    return false;
+  }
+
+  // A probe only skips past idx when it saw a full group containing it. If the
+  // run of full bytes around idx is shorter than a group, no lookup can have
+  // passed over this slot and it can go straight back to empty.
+  sz mask = map->cap - 1;
+  sz before = (idx - SWISS_MAP_GROUP_WIDTH) & mask;
+  swiss_map_mask empty_before = swiss_map_group_match_empty(map->ctrl + before);
+  swiss_map_mask empty_after = swiss_map_group_match_empty(map->ctrl + idx);
+  b32 was_never_full = empty_before != 0 && empty_after != 0 &&
+                       swiss_map_mask_trailing_lanes(empty_before) + swiss_map_mask_leading_lanes(empty_after) <
+                           SWISS_MAP_GROUP_WIDTH;
+
+  if (was_never_full) {
+    swiss_map_set_ctrl(map, idx, SWISS_MAP_CTRL_EMPTY);
+  } else {
+    swiss_map_set_ctrl(map, idx, SWISS_MAP_CTRL_DELETED);
+    map->tombstones++;
+  }
+  map->count--;
+  profile_func_end;
+  return true;
+}
+
+func swiss_map_slot* swiss_map_next(swiss_map* map, swiss_map_iter* iter) {
+  profile_func_begin;
+  if (map == NULL || iter == NULL || !map->slots) {
+    profile_func_end;
+    return NULL;
+  }
+  while (*iter < map->cap) {
+    sz idx = *iter;
+    (*iter)++;
+    if ((map->ctrl[idx] & 0x80) == 0) {
+      profile_func_end;
+      return &map->slots[idx];
+    }
+  }
+  profile_func_end;
+  return NULL;
+}
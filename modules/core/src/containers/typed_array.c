@@ -0,0 +1,48 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/typed_array.h"
+#include "basic/assert.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+func sz typed_array_grow_capacity(sz cap, sz min_count) {
+  sz new_cap = cap < TYPED_ARRAY_MIN_CAPACITY ? TYPED_ARRAY_MIN_CAPACITY : cap;
+  safe_while (new_cap < min_count) {
+    if (new_cap > SZ_MAX / 2) {
+      return min_count;
+    }
+    new_cap *= 2;
+  }
+  return new_cap;
+}
+
+func void* typed_array_realloc(allocator alloc, void* data, sz old_size, sz new_size) {
+  profile_func_begin;
+  if (data == NULL) {
+    void* result = allocator_alloc(alloc, new_size);
+    profile_func_end;
+    return result;
+  }
+
+  // Arena and heap callbacks extend in place when the neighbouring space is free.
+  if (alloc.realloc_fn != NULL) {
+    void* result = allocator_realloc(alloc, data, new_size);
+    profile_func_end;
+    return result;
+  }
+
+  void* result = allocator_alloc(alloc, new_size);
+  if (result == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  mem_cpy(result, data, old_size < new_size ? old_size : new_size);
+  allocator_dealloc(alloc, data);
+  profile_func_end;
+  return result;
+}
@@ -0,0 +1,98 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "containers/typed_map.h"
+#include "basic/assert.h"
+#include "based_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+#include <string.h>
+
+// =========================================================================
+// Hash / Equality Helpers
+// =========================================================================
+
+func u64 typed_map_hash_u32(u32 const* key) {
+  return hash_u64((u64)*key);
+}
+
+func b32 typed_map_eq_u32(u32 const* lhs, u32 const* rhs) {
+  return *lhs == *rhs;
+}
+
+func u64 typed_map_hash_u64(u64 const* key) {
+  return hash_u64(*key);
+}
+
+func b32 typed_map_eq_u64(u64 const* lhs, u64 const* rhs) {
+  return *lhs == *rhs;
+}
+
+// FNV-1a leaves the low bits weakly mixed for short strings; the map picks
+// the home slot from them, so run the result through a finalizer.
+func u64 typed_map_hash_cstr8(cstr8 const* key) {
+  return hash_u64(cstr8_hash64(*key));
+}
+
+func b32 typed_map_eq_cstr8(cstr8 const* lhs, cstr8 const* rhs) {
+  return cstr8_cmp(*lhs, *rhs);
+}
+
+func u64 typed_map_hash_str8(str8 const* key) {
+  return typed_map_hash_bytes(key->ptr, key->size);
+}
+
+func b32 typed_map_eq_str8(str8 const* lhs, str8 const* rhs) {
+  return lhs->size == rhs->size && mem_cmp(lhs->ptr, rhs->ptr, lhs->size);
+}
+
+func u64 typed_map_hash_bytes(void const* data, sz size) {
+  profile_func_begin;
+  u8 const* bytes = (u8 const*)data;
+  u64 hash = 0xcbf29ce484222325ULL;
+  for (sz idx = 0; idx < size; idx++) {
+    hash ^= bytes[idx];
+    hash *= 0x100000001b3ULL;
+  }
+  profile_func_end;
+  return hash_u64(hash);
+}
+
+func u64 typed_map_hash_combine(u64 seed, u64 value) {
+  return hash_u64(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Capacities must stay power-of-two because probing masks with (cap - 1).
+func sz typed_map_normalize_capacity(sz min_cap) {
+  if (min_cap <= 16) {
+    return 16;
+  }
+
+  sz target_cap = 16;
+  safe_while (target_cap < min_cap) {
+    target_cap *= 2;
+  }
+
+  return target_cap;
+}
+
+func sz typed_map_layout(
+    sz cap,
+    sz key_size,
+    sz key_align,
+    sz value_size,
+    sz value_align,
+    sz* out_keys_offset,
+    sz* out_values_offset) {
+  assert(is_pow2(key_align));
+  assert(is_pow2(value_align));
+  sz keys_offset = align_up(cap * size_of(u32), key_align);
+  sz values_offset = align_up(keys_offset + cap * key_size, value_align);
+  *out_keys_offset = keys_offset;
+  *out_values_offset = values_offset;
+  return values_offset + cap * value_size;
+}
@@ -11,6 +11,7 @@
 #include "basic/utility_defines.h"
 #include "basic/profiler.h"
 #include "memory/memops.h"
+#include "memory/vmem.h"
 #include <string.h>
 #include "basic/safe.h"
 
@@ -50,6 +51,71 @@ func void* arena_block_alloc(arena_block* blk, sz size, sz align) {
   return aligned;
 }
 
+// Returns the commit step used by virtual arenas.
+func sz arena_vmem_granule(void) {
+  sz page = vmem_page_size();
+  return page > ARENA_VMEM_COMMIT_GRANULE ? page : ARENA_VMEM_COMMIT_GRANULE;
+}
+
+// Returns the number of bytes a virtual arena keeps committed at all times.
+func sz arena_vmem_keep(arena* arn) {
+  sz granule = arena_vmem_granule();
+  return granule < arn->vmem_reserved ? granule : arn->vmem_reserved;
+}
+
+func b32 arena_is_vmem_block(arena* arn, arena_block* blk) {
+  return arn->vmem_base != NULL && (u8*)blk == arn->vmem_base;
+}
+
+// Commits enough of the reservation that the first end bytes of the virtual block
+// are usable. blk->size tracks the committed byte count of the block.
+// Returns false when end exceeds the reservation or the OS refuses the commit.
+func b32 arena_vmem_grow(arena* arn, arena_block* blk, sz end) {
+  profile_func_begin;
+  if (end <= blk->size) {
+    profile_func_end;
+    return true;
+  }
+  if (end > arn->vmem_reserved) {
+    profile_func_end;
+    return false;
+  }
+  sz target = align_up(end, arena_vmem_granule());
+  if (target > arn->vmem_reserved) {
+    target = arn->vmem_reserved;
+  }
+  if (!vmem_commit((u8*)blk + blk->size, target - blk->size)) {
+    thread_log_error("Failed to commit virtual arena bytes=%zu", (size_t)target);
+    profile_func_end;
+    return false;
+  }
+  thread_log_verbose("Committed virtual arena bytes=%zu reserved=%zu", (size_t)target, (size_t)arn->vmem_reserved);
+  blk->size = target;
+  profile_func_end;
+  return true;
+}
+
+// Like arena_block_alloc, but commits more of the reservation when the committed
+// part of the virtual block has no room left.
+func void* arena_vmem_block_alloc(arena* arn, arena_block* blk, sz size, sz align) {
+  profile_func_begin;
+  void* result = arena_block_alloc(blk, size, align);
+  if (result != NULL) {
+    profile_func_end;
+    return result;
+  }
+  u8* base = (u8*)blk + blk->used;
+  sz pad = (sz)((u8*)mem_align_forward(base, align) - base);
+  sz avail = arn->vmem_reserved - blk->used;
+  if (pad > avail || size > avail - pad || !arena_vmem_grow(arn, blk, blk->used + pad + size)) {
+    profile_func_end;
+    return NULL;
+  }
+  result = arena_block_alloc(blk, size, align);
+  profile_func_end;
+  return result;
+}
+
 // =========================================================================
 // Allocator Callbacks
 // =========================================================================
@@ -149,6 +215,76 @@ func arena _arena_create_mutexed(
   return arn;
 }
 
+func arena _arena_create_virtual(sz reserve_size, mutex opt_mutex, callsite site) {
+  profile_func_begin;
+  arena arn;
+  mem_zero(&arn, size_of(arn));
+  arn.opt_mutex = opt_mutex;
+
+  sz page = vmem_page_size();
+  sz reserved = align_up(reserve_size > size_of(arena_block) ? reserve_size : size_of(arena_block), page);
+  u8* base = (u8*)vmem_reserve(reserved);
+  if (base == NULL) {
+    thread_log_error("Failed to reserve virtual arena size=%zu", (size_t)reserved);
+    mem_zero(&arn, size_of(arn));
+    profile_func_end;
+    return arn;
+  }
+  arn.vmem_base = base;
+  arn.vmem_reserved = reserved;
+
+  sz keep = arena_vmem_keep(&arn);
+  if (!vmem_commit(base, keep)) {
+    thread_log_error("Failed to commit virtual arena bytes=%zu", (size_t)keep);
+    vmem_release(base, reserved);
+    mem_zero(&arn, size_of(arn));
+    profile_func_end;
+    return arn;
+  }
+
+  arena_block* blk = (arena_block*)base;
+  arena_block_setup(blk, keep, 0);
+  arena_chain_block(&arn, blk);
+
+  msg_core_object_lifecycle_data msg_data = {
+      .event_kind = MSG_CORE_OBJECT_EVENT_CREATE,
+      .object_type = MSG_CORE_OBJECT_TYPE_ARENA,
+      .object_ptr = &arn,
+      .site = site,
+  };
+
+  msg lifecycle_msg = {0};
+  msg_core_fill_object_lifecycle(&lifecycle_msg, &msg_data);
+  if (!msg_post(&lifecycle_msg)) {
+    vmem_release(base, reserved);
+    mem_zero(&arn, size_of(arn));
+    thread_log_trace("Arena creation was suspended");
+    profile_func_end;
+    return arn;
+  }
+
+  thread_log_trace("Created virtual arena reserved=%zu committed=%zu", (size_t)reserved, (size_t)keep);
+  profile_func_end;
+  return arn;
+}
+
+func arena _arena_create_virtual_mutexed(sz reserve_size, callsite site) {
+  profile_func_begin;
+  mutex mtx = mutex_create();
+  arena arn = _arena_create_virtual(reserve_size, mtx, site);
+  if (arn.vmem_base == NULL) {
+    // Creation failed and returned a zeroed arena, so nothing owns the mutex.
+    if (mtx) {
+      mutex_destroy(mtx);
+    }
+    profile_func_end;
+    return arn;
+  }
+  arn.mutex_owned = 1;
+  profile_func_end;
+  return arn;
+}
+
 func void _arena_destroy(arena* arn, callsite site) {
   profile_func_begin;
   if (arn == NULL) {
@@ -176,7 +312,8 @@ func void _arena_destroy(arena* arn, callsite site) {
     mutex_lock(arn->opt_mutex);
   }
 
-  SINGLY_LIST_FOREACH(arn->blocks_head, arn->blocks_tail, blk) {
+  arena_block* blk = arn->blocks_head;
+  safe_while (blk) {
     arena_block* nxt = blk->next;
     if (blk->owned && arn->parent.alloc_fn) {
       _allocator_dealloc(arn->parent, blk, CALLSITE_HERE);
@@ -184,8 +321,14 @@ func void _arena_destroy(arena* arn, callsite site) {
     blk = nxt;
   }
 
+  if (arn->vmem_base) {
+    vmem_release(arn->vmem_base, arn->vmem_reserved);
+  }
+
   arn->blocks_head = NULL;
   arn->blocks_tail = NULL;
+  arn->vmem_base = NULL;
+  arn->vmem_reserved = 0;
 
   mutex mtx_owned = arn->mutex_owned ? arn->opt_mutex : NULL;
 
@@ -238,7 +381,7 @@ func void arena_add_block(arena* arn, void* ptr, sz size) {
 
 func b32 arena_remove_block(arena* arn, void* ptr) {
   profile_func_begin;
-  if (arn == NULL || ptr == NULL) {
+  if (arn == NULL || ptr == NULL || (u8*)ptr == arn->vmem_base) {
     profile_func_end;
     return false;
   }
@@ -293,7 +436,11 @@ func void* _arena_alloc(arena* arn, sz size, sz align, callsite site) {
   void* result = NULL;
 
   SINGLY_LIST_FOREACH(arn->blocks_head, arn->blocks_tail, blk) {
-    result = arena_block_alloc(blk, size, align);
+    if (arena_is_vmem_block(arn, blk)) {
+      result = arena_vmem_block_alloc(arn, blk, size, align);
+    } else {
+      result = arena_block_alloc(blk, size, align);
+    }
     if (result != NULL) {
       break;
     }
@@ -354,6 +501,10 @@ func void* _arena_realloc(
         if (extra <= avail) {
           blk->used += extra;
           done = 1;
+        } else if (arena_is_vmem_block(arn, blk) && extra <= arn->vmem_reserved - blk->used &&
+                   arena_vmem_grow(arn, blk, blk->used + extra)) {
+          blk->used += extra;
+          done = 1;
         }
       }
     }
@@ -396,6 +547,12 @@ func void arena_clear(arena* arn) {
   SINGLY_LIST_FOREACH(arn->blocks_head, arn->blocks_tail, blk) {
     blk->used = size_of(arena_block);
     cleared_blocks += 1;
+    if (arena_is_vmem_block(arn, blk)) {
+      sz keep = arena_vmem_keep(arn);
+      if (blk->size > keep && vmem_decommit((u8*)blk + keep, blk->size - keep)) {
+        blk->size = keep;
+      }
+    }
   }
 
   if (arn->opt_mutex) {
@@ -405,6 +562,10 @@ func void arena_clear(arena* arn) {
   profile_func_end;
 }
 
+func b32 arena_is_virtual(arena* arn) {
+  return arn != NULL && arn->vmem_base != NULL;
+}
+
 func sz arena_block_count(arena* arn) {
   if (arn == NULL) {
     return 0;
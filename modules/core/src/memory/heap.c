@@ -10,6 +10,7 @@
 #include "input/msg_core.h"
 #include "basic/utility_defines.h"
 #include "basic/profiler.h"
+#include "basic/intrinsics.h"
 #include "memory/memops.h"
 #include <string.h>
 #include "basic/safe.h"
@@ -48,27 +49,108 @@ func heap_chunk* heap_read_back_ref(void* user_ptr) {
   return ref.ptr;
 }
 
-// Removes chunk from the free list. Returns 1 if found and removed, 0 otherwise.
-func b32 heap_free_list_remove(heap* hep, heap_chunk* chunk) {
-  profile_func_begin;
-  heap_chunk* prev = NULL;
-  heap_chunk* cur = hep->free_head;
-  safe_while (cur) {
-    if (cur == chunk) {
-      if (prev) {
-        prev->next_free = cur->next_free;
-      } else {
-        hep->free_head = cur->next_free;
+// Chunk sizes handed out by a split are rounded to this granule so the header
+// of the split-off remainder stays naturally aligned.
+static const sz HEAP_CHUNK_GRANULE = align_of(heap_chunk);
+
+// Maximum number of candidates inspected per class when falling back to a
+// good-fit scan. Keeps the slow path bounded regardless of list length.
+static const sz HEAP_FIT_SCAN_MAX = 16;
+
+// Maps a chunk size to its (first-level, second-level) size class.
+// Sizes below HEAP_SL_COUNT map linearly into row 0; larger sizes use the
+// position of their highest set bit for the row and the next HEAP_SL_LOG2 bits
+// for the column. Sizes beyond the last row are clamped into the top class.
+func void heap_mapping(sz size, u32* out_fl, u32* out_sl) {
+  u32 fl = 0;
+  u32 sl = (u32)size;
+  if (size >= HEAP_SL_COUNT) {
+    u32 msb = (u32)bsr_u64((u64)size);
+    fl = msb - HEAP_SL_LOG2 + 1;
+    sl = (u32)(size >> (msb - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+  }
+  if (fl >= HEAP_FL_COUNT) {
+    fl = HEAP_FL_COUNT - 1;
+    sl = HEAP_SL_COUNT - 1;
+  }
+  *out_fl = fl;
+  *out_sl = sl;
+}
+
+// Rounds size up to the next class boundary so that every chunk stored in the
+// resulting class (or any class above it) is at least size bytes large.
+func sz heap_mapping_round_up(sz size) {
+  if (size >= HEAP_SL_COUNT) {
+    u32 msb = (u32)bsr_u64((u64)size);
+    sz step = ((sz)1 << (msb - HEAP_SL_LOG2)) - 1;
+    size = size <= SZ_MAX - step ? size + step : SZ_MAX;
+  }
+  return size;
+}
+
+// Finds the first non-empty class at or above (*fl, *sl) using the bitmaps.
+// Updates fl/sl in place and returns true on success.
+func b32 heap_find_class(heap* hep, u32* fl, u32* sl) {
+  u32 sl_map = hep->sl_bitmap[*fl] & (~0U << *sl);
+  if (!sl_map) {
+    u32 fl_map = *fl + 1 < HEAP_FL_COUNT ? hep->fl_bitmap & (~0U << (*fl + 1)) : 0;
+    if (!fl_map) {
+      return false;
+    }
+    *fl = (u32)ctz_u32(fl_map);
+    sl_map = hep->sl_bitmap[*fl];
+  }
+  *sl = (u32)ctz_u32(sl_map);
+  return true;
+}
+
+// Pushes a free chunk onto the head of its size-class list.
+// chunk->size must not change while the chunk is linked.
+func void heap_free_list_insert(heap* hep, heap_chunk* chunk) {
+  u32 fl, sl;
+  heap_mapping(chunk->size, &fl, &sl);
+  heap_chunk* head = hep->free_lists[fl][sl];
+  chunk->next_free = head;
+  chunk->prev_free = NULL;
+  if (head) {
+    head->prev_free = chunk;
+  }
+  hep->free_lists[fl][sl] = chunk;
+  hep->fl_bitmap |= 1U << fl;
+  hep->sl_bitmap[fl] |= 1U << sl;
+  hep->free_size += chunk->size;
+}
+
+// Unlinks a free chunk from its size-class list in constant time.
+func void heap_free_list_remove(heap* hep, heap_chunk* chunk) {
+  u32 fl, sl;
+  heap_mapping(chunk->size, &fl, &sl);
+  if (chunk->prev_free) {
+    chunk->prev_free->next_free = chunk->next_free;
+  } else {
+    assert(hep->free_lists[fl][sl] == chunk);
+    hep->free_lists[fl][sl] = chunk->next_free;
+    if (!chunk->next_free) {
+      hep->sl_bitmap[fl] &= ~(1U << sl);
+      if (!hep->sl_bitmap[fl]) {
+        hep->fl_bitmap &= ~(1U << fl);
       }
-      cur->next_free = NULL;
-      profile_func_end;
-      return true;
     }
-    prev = cur;
-    cur = cur->next_free;
   }
-  profile_func_end;
-  return false;
+  if (chunk->next_free) {
+    chunk->next_free->prev_free = chunk->prev_free;
+  }
+  chunk->next_free = NULL;
+  chunk->prev_free = NULL;
+  hep->free_size -= chunk->size;
+}
+
+// Drops every free list and clears both bitmaps.
+func void heap_free_index_reset(heap* hep) {
+  hep->free_size = 0;
+  hep->fl_bitmap = 0;
+  mem_zero(hep->sl_bitmap, size_of(hep->sl_bitmap));
+  mem_zero(hep->free_lists, size_of(hep->free_lists));
 }
 
 // Initializes a block header and carves its remaining space into a single free chunk.
@@ -86,11 +168,11 @@ func void heap_block_setup(heap* hep, heap_block* blk, sz size, b8 owned) {
 
   heap_chunk* chunk = (heap_chunk*)(blk + 1);
   chunk->next_in_block = NULL;
-  chunk->next_free = hep->free_head;
+  chunk->prev_in_block = NULL;
   chunk->size = body - size_of(heap_chunk);
   chunk->align_pad = 0;
   chunk->is_free = 1;
-  hep->free_head = chunk;
+  heap_free_list_insert(hep, chunk);
   profile_func_end;
 }
 
@@ -101,60 +183,211 @@ func void heap_chain_block(heap* hep, heap_block* blk) {
   profile_func_end;
 }
 
-// First-fit allocation from the current free list.
+// Unlinks blk from the block chain given its predecessor (NULL for the head).
+func void heap_unlink_block(heap* hep, heap_block* blk, heap_block* prev) {
+  if (prev) {
+    prev->next = blk->next;
+  } else {
+    hep->blocks_head = blk->next;
+  }
+  if (hep->blocks_tail == blk) {
+    hep->blocks_tail = prev;
+  }
+  blk->next = NULL;
+}
+
+// Returns the block that owns chunk when chunk covers the block's whole body, NULL otherwise.
+// Such a chunk is always the first chunk of its block, directly after the header.
+func heap_block* heap_chunk_sole_block(heap_chunk* chunk) {
+  if (chunk->prev_in_block || chunk->next_in_block) {
+    return NULL;
+  }
+  return (heap_block*)chunk - 1;
+}
+
+// Releases an owned, fully free block back to the parent allocator.
+// The block's chunk must already be detached from the free index.
+func sz heap_release_block(heap* hep, heap_block* blk) {
+  heap_block* prev = NULL;
+  safe_for (heap_block* it = hep->blocks_head; it != NULL && it != blk; it = it->next) {
+    prev = it;
+  }
+  heap_unlink_block(hep, blk, prev);
+  sz released = blk->size;
+  _allocator_dealloc(hep->parent, blk, CALLSITE_HERE);
+  thread_log_verbose("Released heap block size=%zu", (size_t)released);
+  return released;
+}
+
+// Returns the aligned user pointer if size bytes fit inside chunk, NULL otherwise.
+func u8* heap_chunk_fit(heap_chunk* chunk, sz size, sz eff_align) {
+  u8* raw = (u8*)(chunk + 1);
+  // Advance past the back-reference slot, then align up.
+  u8* usr = (u8*)mem_align_forward(raw + HEAP_BACK_REF_SZ, eff_align);
+  sz pad = (sz)(usr - raw);
+  sz avail = chunk->size;
+  if (pad <= avail && size <= avail - pad) {
+    return usr;
+  }
+  return NULL;
+}
+
+// Scans at most HEAP_FIT_SCAN_MAX chunks of one class for a fit.
+func heap_chunk* heap_class_find_fit(heap* hep, u32 fl, u32 sl, sz size, sz eff_align, u8** out_usr) {
+  sz scanned = 0;
+  safe_for (heap_chunk* chunk = hep->free_lists[fl][sl]; chunk != NULL && scanned < HEAP_FIT_SCAN_MAX; chunk = chunk->next_free) {
+    u8* usr = heap_chunk_fit(chunk, size, eff_align);
+    if (usr) {
+      *out_usr = usr;
+      return chunk;
+    }
+    scanned += 1;
+  }
+  return NULL;
+}
+
+// Segregated-fit allocation from the free index.
 // eff_align must be >= HEAP_BACK_REF_SZ so the back-pointer always fits.
 // Returns the user pointer on success, NULL on failure.
 func void* heap_try_alloc(heap* hep, sz size, sz eff_align) {
   profile_func_begin;
-  heap_chunk* prev = NULL;
-  heap_chunk* chunk = hep->free_head;
-
-  safe_while (chunk) {
-    u8* raw = (u8*)(chunk + 1);
-    // Advance past the back-reference slot, then align up.
-    u8* usr = (u8*)mem_align_forward(raw + HEAP_BACK_REF_SZ, eff_align);
-    sz pad = (sz)(usr - raw);
-    sz avail = chunk->size;
-
-    if (pad <= avail && size <= avail - pad) {
-      // Remove chunk from free list.
-      if (prev) {
-        prev->next_free = chunk->next_free;
-      } else {
-        hep->free_head = chunk->next_free;
+  if (size > SZ_MAX - eff_align - HEAP_CHUNK_GRANULE) {
+    profile_func_end;
+    return NULL;
+  }
+  size = align_up(size, HEAP_CHUNK_GRANULE);
+
+  heap_chunk* chunk = NULL;
+  u8* usr = NULL;
+
+  // Fast path: every chunk in a class at or above the rounded-up worst case
+  // (size plus maximum alignment padding) fits, so the list head is taken as-is.
+  // Only the clamped top class can hold chunks that still need checking.
+  u32 fl, sl;
+  heap_mapping(heap_mapping_round_up(size + eff_align), &fl, &sl);
+  u32 search_fl = fl;
+  u32 search_sl = sl;
+  if (heap_find_class(hep, &fl, &sl)) {
+    chunk = heap_class_find_fit(hep, fl, sl, size, eff_align, &usr);
+  }
+
+  // Slow path: the rounding above skips classes whose chunks may still fit
+  // the exact request. Scan them in ascending order with a bounded walk.
+  if (!chunk) {
+    heap_mapping(size + HEAP_BACK_REF_SZ, &fl, &sl);
+    safe_while (!chunk && heap_find_class(hep, &fl, &sl)) {
+      if (fl > search_fl || (fl == search_fl && sl >= search_sl)) {
+        break;
       }
-
-      sz remaining = avail - pad - size;
-      // Split if the remainder can hold at least one minimal future allocation.
-      sz split_min = size_of(heap_chunk) + HEAP_BACK_REF_SZ;
-      if (remaining >= split_min) {
-        heap_chunk* split = (heap_chunk*)(usr + size);
-        split->next_in_block = chunk->next_in_block;
-        split->next_free = hep->free_head;
-        split->size = remaining - size_of(heap_chunk);
-        split->align_pad = 0;
-        split->is_free = 1;
-        hep->free_head = split;
-        chunk->next_in_block = split;
-        chunk->size = size;
-      } else {
-        // Absorb the leftover into this chunk to avoid a tiny unusable fragment.
-        chunk->size = avail - pad;
+      chunk = heap_class_find_fit(hep, fl, sl, size, eff_align, &usr);
+      if (++sl == HEAP_SL_COUNT) {
+        sl = 0;
+        if (++fl == HEAP_FL_COUNT) {
+          break;
+        }
       }
-
-      chunk->align_pad = pad;
-      chunk->is_free = 0;
-      chunk->next_free = NULL;
-      heap_write_back_ref(usr, chunk);
-      profile_func_end;
-      return usr;
     }
+  }
 
-    prev = chunk;
-    chunk = chunk->next_free;
+  if (!chunk) {
+    profile_func_end;
+    return NULL;
   }
+
+  heap_free_list_remove(hep, chunk);
+
+  sz pad = (sz)(usr - (u8*)(chunk + 1));
+  sz avail = chunk->size;
+  sz remaining = avail - pad - size;
+  // Split if the remainder can hold at least one minimal future allocation.
+  sz split_min = size_of(heap_chunk) + HEAP_BACK_REF_SZ;
+  if (remaining >= split_min) {
+    heap_chunk* split = (heap_chunk*)(usr + size);
+    split->next_in_block = chunk->next_in_block;
+    split->prev_in_block = chunk;
+    if (split->next_in_block) {
+      split->next_in_block->prev_in_block = split;
+    }
+    split->size = remaining - size_of(heap_chunk);
+    split->align_pad = 0;
+    split->is_free = 1;
+    heap_free_list_insert(hep, split);
+    chunk->next_in_block = split;
+    chunk->size = size;
+  } else {
+    // Absorb the leftover into this chunk to avoid a tiny unusable fragment.
+    chunk->size = avail - pad;
+  }
+
+  chunk->align_pad = pad;
+  chunk->is_free = 0;
+  heap_write_back_ref(usr, chunk);
   profile_func_end;
-  return NULL;
+  return usr;
+}
+
+// Allocation body shared by heap_alloc and heap_alloc_batch. Caller holds opt_mutex.
+func void* heap_alloc_locked(heap* hep, sz size, sz eff_align, callsite site) {
+  void* result = heap_try_alloc(hep, size, eff_align);
+
+  if (!result && hep->parent.alloc_fn) {
+    // Reserve room for the worst-case alignment padding so the fresh chunk always fits.
+    sz overhead = size_of(heap_block) + size_of(heap_chunk) + HEAP_CHUNK_GRANULE + eff_align;
+    sz needed = overhead + size;
+    sz block_sz = hep->default_block_sz > needed ? hep->default_block_sz : needed;
+    heap_block* new_blk = (heap_block*)_allocator_alloc(hep->parent, block_sz, site);
+    if (new_blk) {
+      heap_block_setup(hep, new_blk, block_sz, 1);
+      heap_chain_block(hep, new_blk);
+      thread_log_verbose("Added heap block size=%zu request=%zu", (size_t)block_sz, (size_t)size);
+      result = heap_try_alloc(hep, size, eff_align);
+    } else {
+      thread_log_error("Failed to allocate heap block size=%zu request=%zu", (size_t)block_sz, (size_t)size);
+    }
+  }
+
+  return result;
+}
+
+// Dealloc body shared by heap_dealloc and heap_dealloc_batch. Caller holds opt_mutex.
+func void heap_dealloc_locked(heap* hep, void* ptr) {
+  heap_chunk* chunk = heap_read_back_ref(ptr);
+
+  // Reclaim alignment padding into the chunk's usable size.
+  chunk->size = chunk->align_pad + chunk->size;
+  chunk->align_pad = 0;
+  chunk->is_free = 1;
+
+  // Forward coalesce: absorb the next chunk if it is also free.
+  heap_chunk* nxt = chunk->next_in_block;
+  if (nxt && nxt->is_free) {
+    heap_free_list_remove(hep, nxt);
+    chunk->size += size_of(heap_chunk) + nxt->size;
+    chunk->next_in_block = nxt->next_in_block;
+    if (chunk->next_in_block) {
+      chunk->next_in_block->prev_in_block = chunk;
+    }
+  }
+
+  // Backward coalesce: fold this chunk into the previous one if it is free.
+  heap_chunk* prv = chunk->prev_in_block;
+  if (prv && prv->is_free) {
+    heap_free_list_remove(hep, prv);
+    prv->size += size_of(heap_chunk) + chunk->size;
+    prv->next_in_block = chunk->next_in_block;
+    if (prv->next_in_block) {
+      prv->next_in_block->prev_in_block = prv;
+    }
+    chunk = prv;
+  }
+
+  // Auto-trim: hand a now-empty owned block back once enough slack remains elsewhere.
+  heap_block* empty_blk = hep->trim_threshold ? heap_chunk_sole_block(chunk) : NULL;
+  if (empty_blk && empty_blk->owned && hep->parent.dealloc_fn && hep->free_size >= hep->trim_threshold) {
+    heap_release_block(hep, empty_blk);
+  } else {
+    heap_free_list_insert(hep, chunk);
+  }
 }
 
 // =========================================================================
@@ -257,7 +490,8 @@ func void _heap_destroy(heap* hep, callsite site) {
     mutex_lock(hep->opt_mutex);
   }
 
-  SINGLY_LIST_FOREACH(hep->blocks_head, hep->blocks_tail, blk) {
+  heap_block* blk = hep->blocks_head;
+  safe_while (blk) {
     heap_block* nxt = blk->next;
     if (blk->owned && hep->parent.alloc_fn) {
       _allocator_dealloc(hep->parent, blk, CALLSITE_HERE);
@@ -267,7 +501,7 @@ func void _heap_destroy(heap* hep, callsite site) {
 
   hep->blocks_head = NULL;
   hep->blocks_tail = NULL;
-  hep->free_head = NULL;
+  heap_free_index_reset(hep);
 
   mutex mtx_owned = hep->mutex_owned ? hep->opt_mutex : NULL;
 
@@ -333,7 +567,7 @@ func b32 heap_remove_block(heap* hep, void* ptr) {
 
   safe_while (blk) {
     if ((void*)blk == ptr) {
-      // Purge this block's free chunks from the global free list.
+      // Purge this block's free chunks from the size-class lists.
       heap_chunk* chunk = (heap_chunk*)(blk + 1);
       safe_while (chunk) {
         if (chunk->is_free) {
@@ -342,14 +576,7 @@ func b32 heap_remove_block(heap* hep, void* ptr) {
         chunk = chunk->next_in_block;
       }
 
-      if (prev) {
-        prev->next = blk->next;
-      } else {
-        hep->blocks_head = blk->next;
-      }
-      if (hep->blocks_tail == blk) {
-        hep->blocks_tail = prev;
-      }
+      heap_unlink_block(hep, blk, prev);
       found = true;
       break;
     }
@@ -382,22 +609,7 @@ func void* _heap_alloc(heap* hep, sz size, sz align, callsite site) {
     mutex_lock(hep->opt_mutex);
   }
 
-  void* result = heap_try_alloc(hep, size, eff_align);
-
-  if (!result && hep->parent.alloc_fn) {
-    sz overhead = size_of(heap_block) + size_of(heap_chunk) + HEAP_BACK_REF_SZ;
-    sz needed = overhead + size;
-    sz block_sz = hep->default_block_sz > needed ? hep->default_block_sz : needed;
-    heap_block* new_blk = (heap_block*)_allocator_alloc(hep->parent, block_sz, site);
-    if (new_blk) {
-      heap_block_setup(hep, new_blk, block_sz, 1);
-      heap_chain_block(hep, new_blk);
-      thread_log_verbose("Added heap block size=%zu request=%zu", (size_t)block_sz, (size_t)size);
-      result = heap_try_alloc(hep, size, eff_align);
-    } else {
-      thread_log_error("Failed to allocate heap block size=%zu request=%zu", (size_t)block_sz, (size_t)size);
-    }
-  }
+  void* result = heap_alloc_locked(hep, size, eff_align, site);
 
   if (hep->opt_mutex) {
     mutex_unlock(hep->opt_mutex);
@@ -419,23 +631,60 @@ func void _heap_dealloc(heap* hep, void* ptr, callsite site) {
     mutex_lock(hep->opt_mutex);
   }
 
-  heap_chunk* chunk = heap_read_back_ref(ptr);
+  heap_dealloc_locked(hep, ptr);
 
-  // Reclaim alignment padding into the chunk's usable size.
-  chunk->size = chunk->align_pad + chunk->size;
-  chunk->align_pad = 0;
-  chunk->is_free = 1;
+  if (hep->opt_mutex) {
+    mutex_unlock(hep->opt_mutex);
+  }
+  profile_func_end;
+}
 
-  // Forward coalesce: absorb the next chunk if it is also free.
-  heap_chunk* nxt = chunk->next_in_block;
-  if (nxt && nxt->is_free) {
-    heap_free_list_remove(hep, nxt);
-    chunk->size += size_of(heap_chunk) + nxt->size;
-    chunk->next_in_block = nxt->next_in_block;
+func sz _heap_alloc_batch(heap* hep, void** out_ptrs, sz count, sz size, sz align, callsite site) {
+  profile_func_begin;
+  if (hep == NULL || out_ptrs == NULL || count == 0 || size == 0 || align == 0) {
+    profile_func_end;
+    return 0;
+  }
+  sz eff_align = align < HEAP_BACK_REF_SZ ? HEAP_BACK_REF_SZ : align;
+
+  if (hep->opt_mutex) {
+    mutex_lock(hep->opt_mutex);
+  }
+
+  sz got = 0;
+  while (got < count) {
+    void* ptr = heap_alloc_locked(hep, size, eff_align, site);
+    if (!ptr) {
+      break;
+    }
+    out_ptrs[got++] = ptr;
+  }
+
+  if (hep->opt_mutex) {
+    mutex_unlock(hep->opt_mutex);
+  }
+
+  profile_func_end;
+  return got;
+}
+
+func void _heap_dealloc_batch(heap* hep, void** ptrs, sz count, callsite site) {
+  profile_func_begin;
+  (void)site;
+  if (hep == NULL || ptrs == NULL || count == 0) {
+    profile_func_end;
+    return;
   }
 
-  chunk->next_free = hep->free_head;
-  hep->free_head = chunk;
+  if (hep->opt_mutex) {
+    mutex_lock(hep->opt_mutex);
+  }
+
+  for (sz i = 0; i < count; i += 1) {
+    if (ptrs[i]) {
+      heap_dealloc_locked(hep, ptrs[i]);
+    }
+  }
 
   if (hep->opt_mutex) {
     mutex_unlock(hep->opt_mutex);
@@ -475,6 +724,9 @@ func void* _heap_realloc(
         heap_free_list_remove(hep, nxt);
         chunk->size = combined;
         chunk->next_in_block = nxt->next_in_block;
+        if (chunk->next_in_block) {
+          chunk->next_in_block->prev_in_block = chunk;
+        }
         result = ptr;
       }
     }
@@ -498,6 +750,14 @@ func void* _heap_realloc(
   return result;
 }
 
+func sz heap_usable_size(void* ptr) {
+  if (!ptr) {
+    return 0;
+  }
+  heap_chunk* chunk = heap_read_back_ref(ptr);
+  return chunk->size;
+}
+
 // =========================================================================
 // Lifecycle
 // =========================================================================
@@ -512,7 +772,7 @@ func void heap_clear(heap* hep) {
     mutex_lock(hep->opt_mutex);
   }
 
-  hep->free_head = NULL;
+  heap_free_index_reset(hep);
 
   sz rebuilt_blocks = 0;
   SINGLY_LIST_FOREACH(hep->blocks_head, hep->blocks_tail, blk) {
@@ -520,11 +780,11 @@ func void heap_clear(heap* hep) {
     if (body > size_of(heap_chunk)) {
       heap_chunk* chunk = (heap_chunk*)(blk + 1);
       chunk->next_in_block = NULL;
-      chunk->next_free = hep->free_head;
+      chunk->prev_in_block = NULL;
       chunk->size = body - size_of(heap_chunk);
       chunk->align_pad = 0;
       chunk->is_free = 1;
-      hep->free_head = chunk;
+      heap_free_list_insert(hep, chunk);
     }
     rebuilt_blocks += 1;
   }
@@ -536,6 +796,57 @@ func void heap_clear(heap* hep) {
   profile_func_end;
 }
 
+func sz heap_trim(heap* hep) {
+  profile_func_begin;
+  if (hep == NULL) {
+    profile_func_end;
+    return 0;
+  }
+  if (hep->opt_mutex) {
+    mutex_lock(hep->opt_mutex);
+  }
+
+  sz released = 0;
+  if (hep->parent.dealloc_fn) {
+    heap_block* prev = NULL;
+    heap_block* blk = hep->blocks_head;
+    safe_while (blk) {
+      heap_block* nxt = blk->next;
+      sz body = blk->size - size_of(heap_block);
+      heap_chunk* chunk = (heap_chunk*)(blk + 1);
+      if (blk->owned && body > size_of(heap_chunk) && chunk->is_free && !chunk->next_in_block) {
+        heap_free_list_remove(hep, chunk);
+        heap_unlink_block(hep, blk, prev);
+        released += blk->size;
+        _allocator_dealloc(hep->parent, blk, CALLSITE_HERE);
+      } else {
+        prev = blk;
+      }
+      blk = nxt;
+    }
+  }
+
+  if (hep->opt_mutex) {
+    mutex_unlock(hep->opt_mutex);
+  }
+  thread_log_verbose("Trimmed heap released=%zu", (size_t)released);
+  profile_func_end;
+  return released;
+}
+
+func void heap_set_trim_threshold(heap* hep, sz threshold) {
+  if (hep == NULL) {
+    return;
+  }
+  if (hep->opt_mutex) {
+    mutex_lock(hep->opt_mutex);
+  }
+  hep->trim_threshold = threshold;
+  if (hep->opt_mutex) {
+    mutex_unlock(hep->opt_mutex);
+  }
+}
+
 func sz heap_block_count(heap* hep) {
   if (hep == NULL) {
     return 0;
@@ -579,10 +890,7 @@ func sz heap_total_free(heap* hep) {
   if (hep->opt_mutex) {
     mutex_lock(hep->opt_mutex);
   }
-  sz total = 0;
-  safe_for (heap_chunk* chunk = hep->free_head; chunk != NULL; chunk = chunk->next_free) {
-    total += chunk->size;
-  }
+  sz total = hep->free_size;
   if (hep->opt_mutex) {
     mutex_unlock(hep->opt_mutex);
   }
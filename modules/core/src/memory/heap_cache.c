@@ -0,0 +1,278 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "memory/heap_cache.h"
+#include "basic/assert.h"
+#include "context/thread_ctx.h"
+#include "input/msg.h"
+#include "input/msg_core.h"
+#include "basic/profiler.h"
+#include "memory/memops.h"
+#include "basic/safe.h"
+
+// =========================================================================
+// Internal Helpers
+// =========================================================================
+
+// Byte size handed out for each class. Spacing grows by roughly 1.5x so the
+// worst-case internal waste stays bounded while the table stays small.
+static const sz HEAP_CACHE_CLASS_SIZES[HEAP_CACHE_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, HEAP_CACHE_MAX_SIZE};
+
+// Smallest class whose size is >= size. size must be <= HEAP_CACHE_MAX_SIZE.
+func u32 heap_cache_class_ceil(sz size) {
+  u32 cls = 0;
+  safe_while (HEAP_CACHE_CLASS_SIZES[cls] < size) {
+    cls += 1;
+  }
+  return cls;
+}
+
+// Largest class whose size is <= size, or HEAP_CACHE_CLASS_COUNT when size is
+// too small or too large to be worth caching.
+func u32 heap_cache_class_floor(sz size) {
+  if (size < HEAP_CACHE_CLASS_SIZES[0] || size >= HEAP_CACHE_MAX_SIZE * 2) {
+    return HEAP_CACHE_CLASS_COUNT;
+  }
+  u32 cls = HEAP_CACHE_CLASS_COUNT - 1;
+  safe_while (HEAP_CACHE_CLASS_SIZES[cls] > size) {
+    cls -= 1;
+  }
+  return cls;
+}
+
+// Pulls chunks of the class size from the shared heap until the magazine holds
+// HEAP_CACHE_BIN_BATCH of them, using one batched call on the shared heap.
+func void heap_cache_refill(heap_cache* cache, u32 cls, callsite site) {
+  profile_func_begin;
+  heap_cache_bin* bin = &cache->bins[cls];
+  sz wanted = HEAP_CACHE_BIN_BATCH - bin->count;
+  sz got = _heap_alloc_batch(cache->shared, bin->slots + bin->count, wanted, HEAP_CACHE_CLASS_SIZES[cls], HEAP_CACHE_ALIGN, site);
+  bin->count += (u32)got;
+  cache->refill_count += 1;
+  profile_func_end;
+}
+
+// Returns the HEAP_CACHE_BIN_BATCH oldest chunks of a full magazine to the shared heap.
+func void heap_cache_flush_bin(heap_cache* cache, u32 cls, callsite site) {
+  profile_func_begin;
+  heap_cache_bin* bin = &cache->bins[cls];
+  sz moved = bin->count < HEAP_CACHE_BIN_BATCH ? bin->count : HEAP_CACHE_BIN_BATCH;
+  _heap_dealloc_batch(cache->shared, bin->slots, moved, site);
+  // Keep the most recently freed (cache-hot) chunks.
+  mem_mv(bin->slots, bin->slots + moved, (bin->count - moved) * size_of(void*));
+  bin->count -= (u32)moved;
+  cache->flush_count += 1;
+  profile_func_end;
+}
+
+// =========================================================================
+// Allocator Callbacks
+// =========================================================================
+
+func void* heap_cache_alloc_callback(void* user_data, callsite site, sz size) {
+  profile_func_begin;
+  heap_cache* cache = (heap_cache*)user_data;
+  profile_func_end;
+  return _heap_cache_alloc(cache, size, size_of(void*), site);
+}
+
+func void heap_cache_dealloc_callback(void* user_data, callsite site, void* ptr) {
+  profile_func_begin;
+  heap_cache* cache = (heap_cache*)user_data;
+  _heap_cache_dealloc(cache, ptr, site);
+  profile_func_end;
+}
+
+func void* heap_cache_realloc_callback(
+    void* user_data,
+    callsite site,
+    void* ptr,
+    sz new_size) {
+  profile_func_begin;
+  heap_cache* cache = (heap_cache*)user_data;
+  sz old_size = heap_usable_size(ptr);
+  profile_func_end;
+  return _heap_cache_realloc(cache, ptr, old_size, new_size, size_of(void*), site);
+}
+
+// =========================================================================
+// Create / Destroy
+// =========================================================================
+
+func heap_cache _heap_cache_create(heap* shared, callsite site) {
+  profile_func_begin;
+  heap_cache cache;
+  mem_zero(&cache, size_of(cache));
+  cache.shared = shared;
+  msg_core_object_lifecycle_data msg_data = {
+      .event_kind = MSG_CORE_OBJECT_EVENT_CREATE,
+      .object_type = MSG_CORE_OBJECT_TYPE_HEAP_CACHE,
+      .object_ptr = &cache,
+      .site = site,
+  };
+
+  msg lifecycle_msg = {0};
+  msg_core_fill_object_lifecycle(&lifecycle_msg, &msg_data);
+  if (!msg_post(&lifecycle_msg)) {
+    mem_zero(&cache, size_of(cache));
+    thread_log_trace("Heap cache creation was suspended");
+    profile_func_end;
+    return cache;
+  }
+  thread_log_trace("Created heap cache shared=%p", (void*)shared);
+  profile_func_end;
+  return cache;
+}
+
+func void _heap_cache_destroy(heap_cache* cache, callsite site) {
+  profile_func_begin;
+  if (cache == NULL) {
+    profile_func_end;
+    return;
+  }
+
+  msg_core_object_lifecycle_data msg_data = {
+      .event_kind = MSG_CORE_OBJECT_EVENT_DESTROY,
+      .object_type = MSG_CORE_OBJECT_TYPE_HEAP_CACHE,
+      .object_ptr = cache,
+      .site = site,
+  };
+
+  msg lifecycle_msg = {0};
+  msg_core_fill_object_lifecycle(&lifecycle_msg, &msg_data);
+  if (!msg_post(&lifecycle_msg)) {
+    thread_log_trace("Heap cache destruction was suspended handle=%p", (void*)cache);
+    profile_func_end;
+    return;
+  }
+
+  heap_cache_flush(cache);
+  mem_zero(cache, size_of(*cache));
+  thread_log_trace("Destroyed heap cache handle=%p", (void*)cache);
+  profile_func_end;
+}
+
+func allocator heap_cache_get_allocator(heap_cache* cache) {
+  allocator alloc;
+  alloc.user_data = cache;
+  alloc.alloc_fn = heap_cache_alloc_callback;
+  alloc.dealloc_fn = heap_cache_dealloc_callback;
+  alloc.realloc_fn = heap_cache_realloc_callback;
+  return alloc;
+}
+
+// =========================================================================
+// Allocation
+// =========================================================================
+
+func void* _heap_cache_alloc(heap_cache* cache, sz size, sz align, callsite site) {
+  profile_func_begin;
+  if (cache == NULL || cache->shared == NULL || size == 0 || align == 0) {
+    profile_func_end;
+    return NULL;
+  }
+  if (size > HEAP_CACHE_MAX_SIZE || align > HEAP_CACHE_ALIGN) {
+    profile_func_end;
+    return _heap_alloc(cache->shared, size, align, site);
+  }
+
+  u32 cls = heap_cache_class_ceil(size);
+  heap_cache_bin* bin = &cache->bins[cls];
+  if (bin->count == 0) {
+    heap_cache_refill(cache, cls, site);
+    if (bin->count == 0) {
+      thread_log_error("Failed to refill heap cache class=%zu", (size_t)HEAP_CACHE_CLASS_SIZES[cls]);
+      profile_func_end;
+      return NULL;
+    }
+  }
+  void* result = bin->slots[--bin->count];
+  profile_func_end;
+  return result;
+}
+
+func void _heap_cache_dealloc(heap_cache* cache, void* ptr, callsite site) {
+  profile_func_begin;
+  if (cache == NULL || cache->shared == NULL || ptr == NULL) {
+    profile_func_end;
+    return;
+  }
+
+  u32 cls = heap_cache_class_floor(heap_usable_size(ptr));
+  if (cls == HEAP_CACHE_CLASS_COUNT || ((up)ptr & (HEAP_CACHE_ALIGN - 1)) != 0) {
+    _heap_dealloc(cache->shared, ptr, site);
+    profile_func_end;
+    return;
+  }
+
+  heap_cache_bin* bin = &cache->bins[cls];
+  if (bin->count == HEAP_CACHE_BIN_CAP) {
+    heap_cache_flush_bin(cache, cls, site);
+  }
+  bin->slots[bin->count++] = ptr;
+  profile_func_end;
+}
+
+func void* _heap_cache_realloc(
+    heap_cache* cache,
+    void* ptr,
+    sz old_size,
+    sz new_size,
+    sz align,
+    callsite site) {
+  profile_func_begin;
+  if (!ptr) {
+    profile_func_end;
+    return _heap_cache_alloc(cache, new_size, align, site);
+  }
+  if (cache == NULL || cache->shared == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  if (new_size <= heap_usable_size(ptr) && ((up)ptr & (align - 1)) == 0) {
+    profile_func_end;
+    return ptr;
+  }
+
+  void* result = _heap_cache_alloc(cache, new_size, align, site);
+  if (result) {
+    sz cpy_sz = old_size < new_size ? old_size : new_size;
+    mem_cpy(result, ptr, cpy_sz);
+    _heap_cache_dealloc(cache, ptr, site);
+  }
+  profile_func_end;
+  return result;
+}
+
+// =========================================================================
+// Maintenance
+// =========================================================================
+
+func void heap_cache_flush(heap_cache* cache) {
+  profile_func_begin;
+  if (cache == NULL || cache->shared == NULL) {
+    profile_func_end;
+    return;
+  }
+  sz released = 0;
+  safe_for (u32 cls = 0; cls < HEAP_CACHE_CLASS_COUNT; cls += 1) {
+    heap_cache_bin* bin = &cache->bins[cls];
+    _heap_dealloc_batch(cache->shared, bin->slots, bin->count, CALLSITE_HERE);
+    released += bin->count;
+    bin->count = 0;
+  }
+  thread_log_verbose("Flushed heap cache chunks=%zu", (size_t)released);
+  profile_func_end;
+}
+
+func sz heap_cache_cached_count(heap_cache* cache) {
+  if (cache == NULL) {
+    return 0;
+  }
+  sz count = 0;
+  safe_for (u32 cls = 0; cls < HEAP_CACHE_CLASS_COUNT; cls += 1) {
+    count += cache->bins[cls].count;
+  }
+  return count;
+}
@@ -53,8 +53,11 @@ func sz pool_slot_stride(pool* pol) {
 }
 
 // Carves all usable space in blk into free slots and prepends them to the
-// pool's free list. Called both from pool_add_block and pool_clear.
-func void pool_block_carve(pool* pol, pool_block* blk) {
+// list starting at *head. Returns the last slot of the new run (whose next link
+// is the previous *head), or NULL when no slot fit. Adds the number of carved
+// slots to *out_count when it is not NULL.
+// Called from pool_add_block, pool_clear, and block growth.
+func void* pool_block_carve(pool* pol, pool_block* blk, void** head, sz* out_count) {
   profile_func_begin;
   sz stride = pool_slot_stride(pol);
   // Ensure each slot is aligned for both the object type and the free-list pointer.
@@ -64,14 +67,130 @@ func void pool_block_carve(pool* pol, pool_block* blk) {
   sz pad = (sz)(slot - base);
   sz header_used = size_of(pool_block) + pad;
   sz avail = blk->size > header_used ? blk->size - header_used : 0;
+  void* last = NULL;
+  sz carved = 0;
 
-  safe_while (avail >= stride) {
-    pool_slot_write_next(slot, pol->free_head);
-    pol->free_head = slot;
+  while (avail >= stride) {
+    pool_slot_write_next(slot, *head);
+    if (!last) {
+      last = slot;
+    }
+    *head = slot;
     slot += stride;
     avail -= stride;
+    carved += 1;
+  }
+  if (out_count) {
+    *out_count += carved;
   }
   profile_func_end;
+  return last;
+}
+
+// =========================================================================
+// Lock-Free Free List
+// =========================================================================
+
+// The tagged head packs a slot pointer into the low bits and a modification
+// counter into the high bits of one 64-bit word. User-space addresses fit in
+// 48 bits on every supported 64-bit target, leaving a 16-bit tag.
+#if defined(ARCH_64)
+#  define POOL_TAG_SHIFT 48
+#else
+#  define POOL_TAG_SHIFT 32
+#endif
+static const u64 POOL_TAG_PTR_MASK = ((u64)1 << POOL_TAG_SHIFT) - 1;
+
+func u64 pool_tag_pack(void* ptr, u64 tag) {
+  assert(((u64)(up)ptr & ~POOL_TAG_PTR_MASK) == 0);
+  return ((u64)(up)ptr & POOL_TAG_PTR_MASK) | (tag << POOL_TAG_SHIFT);
+}
+
+func void* pool_tag_ptr(u64 tagged) {
+  return (void*)(up)(tagged & POOL_TAG_PTR_MASK);
+}
+
+func u64 pool_tag_next(u64 tagged) {
+  return (tagged >> POOL_TAG_SHIFT) + 1;
+}
+
+// Pops one slot from the tagged free list, or returns NULL when it is empty.
+// Reading the popped slot's next link may race with its new owner writing to it;
+// the tag change makes the following compare-and-swap fail in that case.
+func void* pool_lockfree_pop(pool* pol) {
+  u64 head = atomic_u64_get(&pol->tagged_head);
+  void* top = pool_tag_ptr(head);
+  safe_while (top) {
+    void* nxt = pool_slot_read_next(top);
+    if (atomic_u64_cmpex(&pol->tagged_head, &head, pool_tag_pack(nxt, pool_tag_next(head)))) {
+      atomic_i64_sub(&pol->free_slots, 1);
+      return top;
+    }
+    atomic_pause();
+    top = pool_tag_ptr(head);
+  }
+  return NULL;
+}
+
+// Pushes the pre-linked run first..last of count slots onto the tagged free
+// list with one splice.
+func void pool_lockfree_push(pool* pol, void* first, void* last, sz count) {
+  u64 head = atomic_u64_get(&pol->tagged_head);
+  pool_slot_write_next(last, pool_tag_ptr(head));
+  safe_while (!atomic_u64_cmpex(&pol->tagged_head, &head, pool_tag_pack(first, pool_tag_next(head)))) {
+    atomic_pause();
+    pool_slot_write_next(last, pool_tag_ptr(head));
+  }
+  atomic_i64_add(&pol->free_slots, (i64)count);
+}
+
+// Detaches the whole tagged free list with one exchange and returns its first
+// slot. The caller owns the detached slots and must account for them in free_slots.
+func void* pool_lockfree_detach(pool* pol) {
+  u64 head = atomic_u64_get(&pol->tagged_head);
+  safe_while (!atomic_u64_cmpex(&pol->tagged_head, &head, pool_tag_pack(NULL, pool_tag_next(head)))) {
+    atomic_pause();
+  }
+  return pool_tag_ptr(head);
+}
+
+// Returns the last slot of the private list starting at first and stores its
+// length in *out_count.
+func void* pool_list_tail(void* first, sz* out_count) {
+  void* last = first;
+  sz count = 1;
+
+  for (void* nxt = pool_slot_read_next(last); nxt != NULL; nxt = pool_slot_read_next(last)) {
+    last = nxt;
+    count += 1;
+  }
+  *out_count = count;
+  return last;
+}
+
+// Moves the tagged free list into free_head so maintenance code can treat a
+// lock-free pool like a locked one. Caller holds opt_mutex.
+func void pool_lockfree_take(pool* pol) {
+  if (!pol->lockfree) {
+    return;
+  }
+  pol->free_head = pool_lockfree_detach(pol);
+  if (pol->free_head) {
+    sz count = 0;
+    pool_list_tail(pol->free_head, &count);
+    atomic_i64_sub(&pol->free_slots, (i64)count);
+  }
+}
+
+// Publishes free_head back to the tagged free list. Counterpart of pool_lockfree_take.
+func void pool_lockfree_publish(pool* pol) {
+  if (!pol->lockfree || !pol->free_head) {
+    return;
+  }
+  sz count = 0;
+  void* last = pool_list_tail(pol->free_head, &count);
+  pool_lockfree_push(pol, pol->free_head, last, count);
+  pol->free_head = NULL;
 }
 
 // Appends blk to the pool's block chain.
@@ -170,6 +289,21 @@ func pool _pool_create_mutexed(
   return pol;
 }
 
+func pool _pool_create_lockfree(
+    allocator parent_alloc,
+    sz default_block_sz,
+    sz object_size,
+    sz object_align,
+    callsite site) {
+  profile_func_begin;
+  pool pol =
+      _pool_create(parent_alloc, mutex_create(), default_block_sz, object_size, object_align, site);
+  pol.mutex_owned = 1;
+  pol.lockfree = 1;
+  profile_func_end;
+  return pol;
+}
+
 func void _pool_destroy(pool* pol, callsite site) {
   profile_func_begin;
   if (pol == NULL) {
@@ -197,7 +331,8 @@ func void _pool_destroy(pool* pol, callsite site) {
     mutex_lock(pol->opt_mutex);
   }
 
-  SINGLY_LIST_FOREACH(pol->blocks_head, pol->blocks_tail, blk) {
+  pool_block* blk = pol->blocks_head;
+  safe_while (blk) {
     pool_block* nxt = blk->next;
     if (blk->owned && pol->parent.alloc_fn) {
       _allocator_dealloc(pol->parent, blk, CALLSITE_HERE);
@@ -208,6 +343,9 @@ func void _pool_destroy(pool* pol, callsite site) {
   pol->blocks_head = NULL;
   pol->blocks_tail = NULL;
   pol->free_head = NULL;
+  atomic_u64_set(&pol->tagged_head, 0);
+  atomic_i64_set(&pol->free_slots, 0);
+  pol->lockfree = 0;
 
   mutex mtx_owned = pol->mutex_owned ? pol->opt_mutex : NULL;
 
@@ -252,7 +390,16 @@ func void pool_add_block(pool* pol, void* ptr, sz size) {
   blk->size = size;
   blk->owned = 0;
   pool_chain_block(pol, blk);
-  pool_block_carve(pol, blk);
+  if (pol->lockfree) {
+    void* run = NULL;
+    sz carved = 0;
+    void* last = pool_block_carve(pol, blk, &run, &carved);
+    if (last) {
+      pool_lockfree_push(pol, run, last, carved);
+    }
+  } else {
+    pool_block_carve(pol, blk, &pol->free_head, NULL);
+  }
 
   if (pol->opt_mutex) {
     mutex_unlock(pol->opt_mutex);
@@ -292,13 +439,14 @@ func b32 pool_remove_block(pool* pol, void* ptr) {
   }
 
   if (found) {
+    pool_lockfree_take(pol);
     // Purge any free slots belonging to the removed block from the free list.
     u8* blk_start = (u8*)ptr;
     u8* blk_end = blk_start + ((pool_block*)ptr)->size;
     void* prev_slot = NULL;
     void* slot = pol->free_head;
 
-    safe_while (slot) {
+    while (slot) {
       void* nxt = pool_slot_read_next(slot);
       u8* slot_bytes = (u8*)slot;
 
@@ -313,6 +461,7 @@ func b32 pool_remove_block(pool* pol, void* ptr) {
       }
       slot = nxt;
     }
+    pool_lockfree_publish(pol);
   }
 
   if (pol->opt_mutex) {
@@ -327,42 +476,119 @@ func b32 pool_remove_block(pool* pol, void* ptr) {
 // Allocation
 // =========================================================================
 
-func void* _pool_alloc(pool* pol, callsite site) {
+// Allocates a new block from the parent and appends it to the block chain.
+// Returns NULL when the pool has no parent or the parent is exhausted.
+func pool_block* pool_grow_block(pool* pol, callsite site) {
   profile_func_begin;
-  if (pol == NULL) {
+  if (!pol->parent.alloc_fn) {
     profile_func_end;
     return NULL;
   }
-  if (pol->opt_mutex) {
-    mutex_lock(pol->opt_mutex);
+  sz stride = pool_slot_stride(pol);
+  sz overhead = size_of(pool_block) + pol->object_align;
+  sz needed = overhead + stride;
+  sz block_sz = pol->default_block_sz > needed ? pol->default_block_sz : needed;
+  pool_block* new_blk = (pool_block*)_allocator_alloc(pol->parent, block_sz, site);
+  if (new_blk) {
+    new_blk->next = NULL;
+    new_blk->size = block_sz;
+    new_blk->owned = true;
+    pool_chain_block(pol, new_blk);
+    thread_log_verbose("Added pool block size=%zu object_size=%zu", (size_t)block_sz, (size_t)pol->object_size);
+  } else {
+    thread_log_error("Failed to allocate pool block size=%zu object_size=%zu", (size_t)block_sz, (size_t)pol->object_size);
+  }
+  profile_func_end;
+  return new_blk;
+}
+
+// Slow path of a lock-free alloc: chains a new block under opt_mutex and
+// publishes all but one of its slots with a single splice.
+func void* pool_lockfree_grow(pool* pol, callsite site) {
+  profile_func_begin;
+  mutex_lock(pol->opt_mutex);
+
+  // Another thread may have grown the pool while this one waited for the lock.
+  void* result = pool_lockfree_pop(pol);
+  if (!result) {
+    pool_block* new_blk = pool_grow_block(pol, site);
+    void* run = NULL;
+    sz carved = 0;
+    void* last = new_blk ? pool_block_carve(pol, new_blk, &run, &carved) : NULL;
+    if (run) {
+      result = run;
+      if (run != last) {
+        pool_lockfree_push(pol, pool_slot_read_next(run), last, carved - 1);
+      }
+    }
   }
 
-  void* result = NULL;
+  mutex_unlock(pol->opt_mutex);
+  profile_func_end;
+  return result;
+}
 
-  if (pol->free_head) {
-    result = pol->free_head;
+// Pops one slot from a locked (or single-threaded) pool, growing when empty.
+// Caller holds opt_mutex.
+func void* pool_locked_pop(pool* pol, callsite site) {
+  if (!pol->free_head) {
+    pool_block* new_blk = pool_grow_block(pol, site);
+    if (!new_blk) {
+      return NULL;
+    }
+    pool_block_carve(pol, new_blk, &pol->free_head, NULL);
+  }
+  void* result = pol->free_head;
+  if (result) {
     pol->free_head = pool_slot_read_next(result);
-  } else if (pol->parent.alloc_fn) {
-    sz stride = pool_slot_stride(pol);
-    sz overhead = size_of(pool_block) + pol->object_align;
-    sz needed = overhead + stride;
-    sz block_sz = pol->default_block_sz > needed ? pol->default_block_sz : needed;
-    pool_block* new_blk = (pool_block*)_allocator_alloc(pol->parent, block_sz, site);
-    if (new_blk) {
-      new_blk->next = NULL;
-      new_blk->size = block_sz;
-      new_blk->owned = true;
-      pool_chain_block(pol, new_blk);
-      pool_block_carve(pol, new_blk);
-      thread_log_verbose("Added pool block size=%zu object_size=%zu", (size_t)block_sz, (size_t)pol->object_size);
-      if (pol->free_head) {
-        result = pol->free_head;
-        pol->free_head = pool_slot_read_next(result);
-      }
+  }
+  return result;
+}
+
+// Links the non-NULL entries of ptrs into one run through their free-list links.
+// Returns the first slot of the run and stores the last in *out_last and the
+// number of linked slots in *out_linked.
+func void* pool_link_run(void** ptrs, sz count, void** out_last, sz* out_linked) {
+  void* first = NULL;
+  void* last = NULL;
+  sz linked = 0;
+
+  for (sz i = 0; i < count; i += 1) {
+    if (!ptrs[i]) {
+      continue;
+    }
+    if (last) {
+      pool_slot_write_next(last, ptrs[i]);
     } else {
-      thread_log_error("Failed to allocate pool block size=%zu object_size=%zu", (size_t)block_sz, (size_t)pol->object_size);
+      first = ptrs[i];
     }
+    last = ptrs[i];
+    linked += 1;
   }
+  *out_last = last;
+  *out_linked = linked;
+  return first;
+}
+
+func void* _pool_alloc(pool* pol, callsite site) {
+  profile_func_begin;
+  if (pol == NULL) {
+    profile_func_end;
+    return NULL;
+  }
+  if (pol->lockfree) {
+    void* slot = pool_lockfree_pop(pol);
+    if (!slot) {
+      slot = pool_lockfree_grow(pol, site);
+    }
+    profile_func_end;
+    return slot;
+  }
+  if (pol->opt_mutex) {
+    mutex_lock(pol->opt_mutex);
+  }
+
+  void* result = pool_locked_pop(pol, site);
 
   if (pol->opt_mutex) {
     mutex_unlock(pol->opt_mutex);
@@ -379,6 +605,11 @@ func void _pool_dealloc(pool* pol, void* ptr, callsite site) {
     profile_func_end;
     return;
   }
+  if (pol->lockfree) {
+    pool_lockfree_push(pol, ptr, ptr, 1);
+    profile_func_end;
+    return;
+  }
 
   if (pol->opt_mutex) {
     mutex_lock(pol->opt_mutex);
@@ -393,6 +624,84 @@ func void _pool_dealloc(pool* pol, void* ptr, callsite site) {
   profile_func_end;
 }
 
+func sz _pool_alloc_batch(pool* pol, void** out_ptrs, sz count, callsite site) {
+  profile_func_begin;
+  if (pol == NULL || out_ptrs == NULL || count == 0) {
+    profile_func_end;
+    return 0;
+  }
+
+  sz got = 0;
+  if (pol->lockfree) {
+    // Each slot is its own compare-and-swap, exactly like pool_alloc, so a
+    // batch never holds up concurrent callers; opt_mutex is only taken to grow.
+    while (got < count) {
+      void* slot = pool_lockfree_pop(pol);
+      if (!slot) {
+        slot = pool_lockfree_grow(pol, site);
+        if (!slot) {
+          break;
+        }
+      }
+      out_ptrs[got++] = slot;
+    }
+    profile_func_end;
+    return got;
+  }
+
+  if (pol->opt_mutex) {
+    mutex_lock(pol->opt_mutex);
+  }
+
+  while (got < count) {
+    void* slot = pool_locked_pop(pol, site);
+    if (!slot) {
+      break;
+    }
+    out_ptrs[got++] = slot;
+  }
+  if (pol->opt_mutex) {
+    mutex_unlock(pol->opt_mutex);
+  }
+
+  profile_func_end;
+  return got;
+}
+
+func void _pool_dealloc_batch(pool* pol, void** ptrs, sz count, callsite site) {
+  profile_func_begin;
+  (void)site;
+  if (pol == NULL || ptrs == NULL || count == 0) {
+    profile_func_end;
+    return;
+  }
+
+  // Link the run before taking any lock so the critical section is one splice.
+  void* last = NULL;
+  sz linked = 0;
+  void* first = pool_link_run(ptrs, count, &last, &linked);
+  if (!first) {
+    profile_func_end;
+    return;
+  }
+
+  if (pol->lockfree) {
+    pool_lockfree_push(pol, first, last, linked);
+    profile_func_end;
+    return;
+  }
+
+  if (pol->opt_mutex) {
+    mutex_lock(pol->opt_mutex);
+  }
+  pool_slot_write_next(last, pol->free_head);
+  pol->free_head = first;
+  if (pol->opt_mutex) {
+    mutex_unlock(pol->opt_mutex);
+  }
+  profile_func_end;
+}
+
 // =========================================================================
 // Lifecycle
 // =========================================================================
@@ -407,12 +716,14 @@ func void pool_clear(pool* pol) {
     mutex_lock(pol->opt_mutex);
   }
 
+  pool_lockfree_take(pol);
   pol->free_head = NULL;
   sz rebuilt_blocks = 0;
   SINGLY_LIST_FOREACH(pol->blocks_head, pol->blocks_tail, blk) {
-    pool_block_carve(pol, blk);
+    pool_block_carve(pol, blk, &pol->free_head, NULL);
     rebuilt_blocks += 1;
   }
+  pool_lockfree_publish(pol);
 
   if (pol->opt_mutex) {
     mutex_unlock(pol->opt_mutex);
@@ -450,11 +761,19 @@ func sz pool_free_count(pool* pol) {
   if (pol == NULL) {
     return 0;
   }
+  // Other threads pop and overwrite lock-free slots at any time, so their links
+  // must not be walked here. The counter can dip below zero while a pop of a
+  // freshly pushed slot is accounted before the push.
+  if (pol->lockfree) {
+    i64 free_slots = atomic_i64_get(&pol->free_slots);
+    return free_slots > 0 ? (sz)free_slots : 0;
+  }
   if (pol->opt_mutex) {
     mutex_lock(pol->opt_mutex);
   }
   sz count = 0;
-  safe_for (void* slot = pol->free_head; slot != NULL; slot = pool_slot_read_next(slot)) {
+
+  for (void* slot = pol->free_head; slot != NULL; slot = pool_slot_read_next(slot)) {
     count += 1;
   }
   if (pol->opt_mutex) {
@@ -8,6 +8,7 @@
 #include "input/msg_core.h"
 #include "basic/profiler.h"
 #include "memory/memops.h"
+#include "memory/vmem.h"
 #include <string.h>
 
 // =========================================================================
@@ -94,6 +95,64 @@ func ring _ring_create_alloc_mutexed(allocator parent_alloc, sz capacity, callsi
   return rng;
 }
 
+func ring _ring_create_spsc(void* ptr, sz capacity, callsite site) {
+  profile_func_begin;
+  ring rng = _ring_create(ptr, capacity, NULL, site);
+  rng.spsc = 1;
+  profile_func_end;
+  return rng;
+}
+
+func ring _ring_create_alloc_spsc(allocator parent_alloc, sz capacity, callsite site) {
+  profile_func_begin;
+  ring rng = _ring_create_alloc(parent_alloc, capacity, NULL, site);
+  rng.spsc = 1;
+  profile_func_end;
+  return rng;
+}
+
+func ring _ring_create_mirrored(sz capacity, mutex opt_mutex, callsite site) {
+  profile_func_begin;
+  ring rng;
+  mem_zero(&rng, size_of(rng));
+  rng.capacity = align_up(capacity, vmem_page_size());
+  rng.opt_mutex = opt_mutex;
+  rng.ptr = rng.capacity > 0 ? (u8*)vmem_alloc_mirrored(rng.capacity) : NULL;
+  rng.mirrored = rng.ptr != NULL ? true : false;
+  if (rng.ptr == NULL) {
+    thread_log_error("Failed to map mirrored ring buffer capacity=%zu", (size_t)rng.capacity);
+  }
+  msg_core_object_lifecycle_data msg_data = {
+      .event_kind = MSG_CORE_OBJECT_EVENT_CREATE,
+      .object_type = MSG_CORE_OBJECT_TYPE_RING,
+      .object_ptr = &rng,
+      .site = site,
+  };
+
+  msg lifecycle_msg = {0};
+  msg_core_fill_object_lifecycle(&lifecycle_msg, &msg_data);
+  if (!msg_post(&lifecycle_msg)) {
+    if (rng.mirrored) {
+      vmem_free_mirrored(rng.ptr, rng.capacity);
+    }
+    rng = (ring) {0};
+    thread_log_trace("Mirrored ring creation was suspended");
+    profile_func_end;
+    return rng;
+  }
+  thread_log_trace("Created mirrored ring capacity=%zu", (size_t)rng.capacity);
+  profile_func_end;
+  return rng;
+}
+
+func ring _ring_create_mirrored_spsc(sz capacity, callsite site) {
+  profile_func_begin;
+  ring rng = _ring_create_mirrored(capacity, NULL, site);
+  rng.spsc = 1;
+  profile_func_end;
+  return rng;
+}
+
 func void _ring_destroy(ring* rng, callsite site) {
   profile_func_begin;
   if (rng == NULL) {
@@ -126,6 +185,11 @@ func void _ring_destroy(ring* rng, callsite site) {
     rng->ptr = NULL;
     rng->buf_owned = 0;
   }
+  if (rng->mirrored) {
+    vmem_free_mirrored(rng->ptr, rng->capacity);
+    rng->ptr = NULL;
+    rng->mirrored = 0;
+  }
 
   mutex mtx_owned = rng->mutex_owned ? rng->opt_mutex : NULL;
 
@@ -142,6 +206,172 @@ func void _ring_destroy(ring* rng, callsite site) {
   profile_func_end;
 }
 
+// =========================================================================
+// Internal Copy Helper
+// =========================================================================
+
+// Copies byte_count bytes starting at ring_offset (wrapping at rng->capacity)
+// into dst. Does not update any ring state.
+func void ring_cpy_out(ring* rng, sz ring_offset, void* dst, sz byte_count) {
+  profile_func_begin;
+  sz to_end = rng->capacity - ring_offset;
+  u8* out_bytes = (u8*)dst;
+  if (byte_count <= to_end || rng->mirrored) {
+    mem_cpy(out_bytes, rng->ptr + ring_offset, byte_count);
+  } else {
+    mem_cpy(out_bytes, rng->ptr + ring_offset, to_end);
+    mem_cpy(out_bytes + to_end, rng->ptr, byte_count - to_end);
+  }
+  profile_func_end;
+}
+
+// Copies byte_count bytes from src into the ring starting at ring_offset
+// (wrapping at rng->capacity). Does not update any ring state.
+func void ring_cpy_in(ring* rng, sz ring_offset, void* src, sz byte_count) {
+  profile_func_begin;
+  sz to_end = rng->capacity - ring_offset;
+  u8* src_bytes = (u8*)src;
+  if (byte_count <= to_end || rng->mirrored) {
+    mem_cpy(rng->ptr + ring_offset, src_bytes, byte_count);
+  } else {
+    mem_cpy(rng->ptr + ring_offset, src_bytes, to_end);
+    mem_cpy(rng->ptr, src_bytes + to_end, byte_count - to_end);
+  }
+  profile_func_end;
+}
+
+// =========================================================================
+// SPSC Helpers
+// =========================================================================
+
+// The producer only writes spsc_written and the consumer only writes spsc_read.
+// Both are free-running byte counters; the buffer offset is counter % capacity
+// and the stored byte count is spsc_written - spsc_read. Each side keeps a
+// private copy of the other side's counter and reloads it (acquire) only when
+// the copy does not allow the requested operation, so the shared cache line is
+// touched once per refill instead of once per call.
+
+// Producer side. Returns the free byte count, refreshing the cached consumer
+// counter when the cached view has fewer than want bytes free.
+func sz ring_spsc_free(ring* rng, u64 written, sz want) {
+  sz space = rng->capacity - (sz)(written - rng->spsc_read_cache);
+  if (space < want) {
+    rng->spsc_read_cache = atomic_u64_get_explicit(&rng->spsc_read, ATOMIC_MEMORY_ORDER_ACQUIRE);
+    space = rng->capacity - (sz)(written - rng->spsc_read_cache);
+  }
+  return space;
+}
+
+// Consumer side. Returns the stored byte count, refreshing the cached producer
+// counter when the cached view has fewer than want bytes stored.
+func sz ring_spsc_used(ring* rng, u64 read, sz want) {
+  sz used = (sz)(rng->spsc_written_cache - read);
+  if (used < want) {
+    rng->spsc_written_cache = atomic_u64_get_explicit(&rng->spsc_written, ATOMIC_MEMORY_ORDER_ACQUIRE);
+    used = (sz)(rng->spsc_written_cache - read);
+  }
+  return used;
+}
+
+func sz ring_spsc_write(ring* rng, void* data, sz size) {
+  profile_func_begin;
+  u64 written = atomic_u64_get_explicit(&rng->spsc_written, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz space = ring_spsc_free(rng, written, size);
+  sz write_sz = size < space ? size : space;
+  if (write_sz > 0) {
+    ring_cpy_in(rng, (sz)(written % rng->capacity), data, write_sz);
+    atomic_u64_set_explicit(&rng->spsc_written, written + write_sz, ATOMIC_MEMORY_ORDER_RELEASE);
+  }
+  profile_func_end;
+  return write_sz;
+}
+
+// Copies up to size bytes out of an SPSC ring. out may be NULL to only skip.
+// The bytes are consumed when consume is true.
+func sz ring_spsc_read(ring* rng, void* out, sz size, b32 consume) {
+  profile_func_begin;
+  u64 read = atomic_u64_get_explicit(&rng->spsc_read, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz used = ring_spsc_used(rng, read, size);
+  sz read_sz = size < used ? size : used;
+  if (read_sz > 0) {
+    if (out != NULL) {
+      ring_cpy_out(rng, (sz)(read % rng->capacity), out, read_sz);
+    }
+    if (consume) {
+      atomic_u64_set_explicit(&rng->spsc_read, read + read_sz, ATOMIC_MEMORY_ORDER_RELEASE);
+    }
+  }
+  profile_func_end;
+  return read_sz;
+}
+
+func void* ring_spsc_reserve_write(ring* rng, sz* out_size) {
+  profile_func_begin;
+  u64 written = atomic_u64_get_explicit(&rng->spsc_written, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz offset = (sz)(written % rng->capacity);
+  sz to_end = rng->mirrored ? rng->capacity : rng->capacity - offset;
+  sz space = ring_spsc_free(rng, written, to_end);
+  sz contiguous = space < to_end ? space : to_end;
+  *out_size = contiguous;
+  profile_func_end;
+  return contiguous > 0 ? rng->ptr + offset : NULL;
+}
+
+func b32 ring_spsc_commit_write(ring* rng, sz size) {
+  profile_func_begin;
+  u64 written = atomic_u64_get_explicit(&rng->spsc_written, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz space = ring_spsc_free(rng, written, size);
+  if (size > space) {
+    thread_log_warn("Rejected ring commit write for insufficient space requested=%zu available=%zu",
+                    (size_t)size,
+                    (size_t)space);
+    profile_func_end;
+    return false;
+  }
+  atomic_u64_set_explicit(&rng->spsc_written, written + size, ATOMIC_MEMORY_ORDER_RELEASE);
+  profile_func_end;
+  return true;
+}
+
+func const void* ring_spsc_reserve_read(ring* rng, sz* out_size) {
+  profile_func_begin;
+  u64 read = atomic_u64_get_explicit(&rng->spsc_read, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz offset = (sz)(read % rng->capacity);
+  sz to_end = rng->mirrored ? rng->capacity : rng->capacity - offset;
+  sz used = ring_spsc_used(rng, read, to_end);
+  sz contiguous = used < to_end ? used : to_end;
+  *out_size = contiguous;
+  profile_func_end;
+  return contiguous > 0 ? rng->ptr + offset : NULL;
+}
+
+func b32 ring_spsc_commit_read(ring* rng, sz size) {
+  profile_func_begin;
+  u64 read = atomic_u64_get_explicit(&rng->spsc_read, ATOMIC_MEMORY_ORDER_RELAXED);
+  sz used = ring_spsc_used(rng, read, size);
+  if (size > used) {
+    thread_log_warn("Rejected ring commit read for insufficient data requested=%zu available=%zu",
+                    (size_t)size,
+                    (size_t)used);
+    profile_func_end;
+    return false;
+  }
+  atomic_u64_set_explicit(&rng->spsc_read, read + size, ATOMIC_MEMORY_ORDER_RELEASE);
+  profile_func_end;
+  return true;
+}
+
+// Snapshot of the stored byte count. The consumer counter is loaded first so
+// the difference never underflows even while both sides are running.
+// Observer-side size. Both sides may move between the two loads, so the
+// difference can briefly exceed capacity; it is clamped for the callers.
+func sz ring_spsc_size(ring* rng) {
+  u64 read = atomic_u64_get_explicit(&rng->spsc_read, ATOMIC_MEMORY_ORDER_ACQUIRE);
+  u64 written = atomic_u64_get_explicit(&rng->spsc_written, ATOMIC_MEMORY_ORDER_ACQUIRE);
+  sz size = (sz)(written - read);
+  return size > rng->capacity ? rng->capacity : size;
+}
+
 // =========================================================================
 // Capacity Queries
 // =========================================================================
@@ -150,6 +380,9 @@ func sz ring_size(ring* rng) {
   if (rng == NULL) {
     return 0;
   }
+  if (rng->spsc) {
+    return ring_spsc_size(rng);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -164,6 +397,10 @@ func sz ring_space(ring* rng) {
   if (rng == NULL) {
     return 0;
   }
+  if (rng->spsc) {
+    sz size = ring_spsc_size(rng);
+    return size >= rng->capacity ? 0 : rng->capacity - size;
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -188,40 +425,6 @@ func sz ring_capacity(ring* rng) {
   return result;
 }
 
-// =========================================================================
-// Internal Copy Helper
-// =========================================================================
-
-// Copies byte_count bytes starting at ring_offset (wrapping at rng->capacity)
-// into dst. Does not update any ring state.
-func void ring_cpy_out(ring* rng, sz ring_offset, void* dst, sz byte_count) {
-  profile_func_begin;
-  sz to_end = rng->capacity - ring_offset;
-  u8* out_bytes = (u8*)dst;
-  if (byte_count <= to_end) {
-    mem_cpy(out_bytes, rng->ptr + ring_offset, byte_count);
-  } else {
-    mem_cpy(out_bytes, rng->ptr + ring_offset, to_end);
-    mem_cpy(out_bytes + to_end, rng->ptr, byte_count - to_end);
-  }
-  profile_func_end;
-}
-
-// Copies byte_count bytes from src into the ring starting at ring_offset
-// (wrapping at rng->capacity). Does not update any ring state.
-func void ring_cpy_in(ring* rng, sz ring_offset, void* src, sz byte_count) {
-  profile_func_begin;
-  sz to_end = rng->capacity - ring_offset;
-  u8* src_bytes = (u8*)src;
-  if (byte_count <= to_end) {
-    mem_cpy(rng->ptr + ring_offset, src_bytes, byte_count);
-  } else {
-    mem_cpy(rng->ptr + ring_offset, src_bytes, to_end);
-    mem_cpy(rng->ptr, src_bytes + to_end, byte_count - to_end);
-  }
-  profile_func_end;
-}
-
 // =========================================================================
 // I/O
 // =========================================================================
@@ -232,6 +435,10 @@ func sz ring_write(ring* rng, void* data, sz size) {
     profile_func_end;
     return 0;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_write(rng, data, size);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -256,6 +463,10 @@ func sz ring_read(ring* rng, void* out, sz size) {
     profile_func_end;
     return 0;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_read(rng, out, size, true);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -280,6 +491,10 @@ func sz ring_peek(ring* rng, void* out, sz size) {
     profile_func_end;
     return 0;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_read(rng, out, size, false);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -302,6 +517,10 @@ func sz ring_skip(ring* rng, sz size) {
     profile_func_end;
     return 0;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_read(rng, NULL, size, true);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -328,6 +547,10 @@ func void* ring_reserve_write(ring* rng, sz* out_size) {
     profile_func_end;
     return NULL;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_reserve_write(rng, out_size);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -335,7 +558,9 @@ func void* ring_reserve_write(ring* rng, sz* out_size) {
   sz space = rng->capacity - rng->count;
   sz contiguous = 0;
   if (space > 0) {
-    if (rng->write_pos >= rng->read_pos) {
+    if (rng->mirrored) {
+      contiguous = space;
+    } else if (rng->write_pos >= rng->read_pos) {
       contiguous = rng->capacity - rng->write_pos;
     } else {
       contiguous = rng->read_pos - rng->write_pos;
@@ -362,6 +587,10 @@ func b32 ring_commit_write(ring* rng, sz size) {
     profile_func_end;
     return false;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_commit_write(rng, size);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -392,16 +621,20 @@ func const void* ring_reserve_read(ring* rng, sz* out_size) {
   if (out_size != NULL) {
     *out_size = 0;
   }
-  if (rng == NULL || out_size == NULL || rng->ptr == NULL || rng->count == 0) {
+  if (rng == NULL || out_size == NULL || rng->ptr == NULL || rng->capacity == 0) {
     profile_func_end;
     return NULL;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_reserve_read(rng, out_size);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
 
   sz contiguous = rng->count;
-  if (rng->read_pos + contiguous > rng->capacity) {
+  if (!rng->mirrored && rng->read_pos + contiguous > rng->capacity) {
     contiguous = rng->capacity - rng->read_pos;
   }
   *out_size = contiguous;
@@ -421,6 +654,10 @@ func b32 ring_commit_read(ring* rng, sz size) {
     profile_func_end;
     return false;
   }
+  if (rng->spsc) {
+    profile_func_end;
+    return ring_spsc_commit_read(rng, size);
+  }
   if (rng->opt_mutex) {
     mutex_lock(rng->opt_mutex);
   }
@@ -462,6 +699,10 @@ func void ring_clear(ring* rng) {
   rng->read_pos = 0;
   rng->write_pos = 0;
   rng->count = 0;
+  atomic_u64_set(&rng->spsc_written, 0);
+  atomic_u64_set(&rng->spsc_read, 0);
+  rng->spsc_read_cache = 0;
+  rng->spsc_written_cache = 0;
 
   if (rng->opt_mutex) {
     mutex_unlock(rng->opt_mutex);
@@ -8,6 +8,8 @@
 #include "basic/profiler.h"
 #include "memory/memops.h"
 #include "platform_includes.h"
+#include "threads/atomics.h"
+#include <stdlib.h>
 #include <string.h>
 
 typedef struct vmem_stats_state {
@@ -31,6 +33,9 @@ typedef struct vmem_stats_state {
   sz peak_live_allocated_bytes;
   sz total_allocated_bytes;
   sz total_freed_bytes;
+
+  sz huge_advised_bytes;
+  sz prefaulted_bytes;
 } vmem_stats_state;
 
 global_var vmem_stats_state g_vmem_stats;
@@ -43,6 +48,18 @@ func void vmem_update_peak_allocated_bytes(void) {
   profile_func_end;
 }
 
+// Touches one byte per page so that the whole range is backed right away.
+// The byte is written back unchanged, which keeps this safe on live data.
+func void vmem_touch_pages(void* ptr, sz size) {
+  profile_func_begin;
+  sz page = vmem_page_size();
+  volatile u8* cur = (volatile u8*)ptr;
+  for (sz off = 0; off < size; off += page) {
+    cur[off] = cur[off];
+  }
+  profile_func_end;
+}
+
 // =========================================================================
 // Platform Implementations
 // =========================================================================
@@ -56,8 +73,19 @@ func sz vmem_page_size(void) {
   return (sz)info.dwPageSize;
 }
 
-func void* vmem_reserve(sz size) {
+// Large pages on Windows need SeLockMemoryPrivilege and must be committed at
+// reserve time, which defeats reserve/commit; huge page requests are ignored.
+func sz vmem_huge_page_size(void) {
+  return 0;
+}
+
+func sz vmem_query_process_huge_bytes(void) {
+  return 0;
+}
+
+func void* vmem_reserve_ex(sz size, vmem_flags flags) {
   profile_func_begin;
+  (void)flags;
   g_vmem_stats.reserve_calls += 1;
   void* ptr = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
   if (ptr != NULL) {
@@ -68,12 +96,16 @@ func void* vmem_reserve(sz size) {
   return ptr;
 }
 
-func b32 vmem_commit(void* ptr, sz size) {
+func b32 vmem_commit_ex(void* ptr, sz size, vmem_flags flags) {
   profile_func_begin;
   g_vmem_stats.commit_calls += 1;
   b32 success = VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL ? true : false;
   if (success) {
     g_vmem_stats.committed_bytes += size;
+    if (flags & VMEM_FLAG_PREFAULT) {
+      vmem_touch_pages(ptr, size);
+      g_vmem_stats.prefaulted_bytes += size;
+    }
   }
   profile_func_end;
   return success;
@@ -123,6 +155,19 @@ func b32 vmem_platform_free(void* ptr, sz size) {
   return success;
 }
 
+// Windows needs placeholder mappings (VirtualAlloc2/MapViewOfFile3) for this,
+// which are not available on every supported version.
+func void* vmem_alloc_mirrored(sz size) {
+  (void)size;
+  return NULL;
+}
+
+func b32 vmem_free_mirrored(void* ptr, sz size) {
+  (void)ptr;
+  (void)size;
+  return false;
+}
+
 #elif defined(PLATFORM_UNIX)
 func sz vmem_page_size(void) {
   profile_func_begin;
@@ -131,26 +176,149 @@ func sz vmem_page_size(void) {
   return res;
 }
 
-func void* vmem_reserve(sz size) {
+#  if defined(PLATFORM_LINUX) && defined(MADV_HUGEPAGE)
+// Huge page size plus one, or 0 before the first probe. Racing first calls may
+// both probe; they read the same files and store the same value.
+global_var atomic_u64 g_vmem_huge_page_probe;
+
+// Reads a small sysfs/procfs file into buf as a NUL-terminated string.
+// Returns false when the file cannot be read.
+func b32 vmem_read_text_file(cstr8 path, c8* buf, sz cap) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  ssize_t len = read(fd, buf, cap - 1);
+  close(fd);
+  if (len <= 0) {
+    return false;
+  }
+  buf[len] = 0;
+  return true;
+}
+
+func sz vmem_huge_page_size(void) {
+  profile_func_begin;
+  u64 probe = atomic_u64_get(&g_vmem_huge_page_probe);
+  if (probe == 0) {
+    c8 buf[128];
+    sz size = 0;
+    // "[never]" means the kernel ignores MADV_HUGEPAGE, so report no huge pages.
+    if (vmem_read_text_file("/sys/kernel/mm/transparent_hugepage/enabled", buf, size_of(buf)) &&
+        strstr(buf, "[never]") == NULL &&
+        vmem_read_text_file("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", buf, size_of(buf))) {
+      size = (sz)strtoull(buf, NULL, 10);
+    }
+    probe = (u64)size + 1;
+    atomic_u64_set(&g_vmem_huge_page_probe, probe);
+  }
+  profile_func_end;
+  return (sz)(probe - 1);
+}
+
+func sz vmem_query_process_huge_bytes(void) {
+  profile_func_begin;
+  c8 buf[4096];
+  sz bytes = 0;
+  if (vmem_read_text_file("/proc/self/smaps_rollup", buf, size_of(buf))) {
+    c8* line = strstr(buf, "AnonHugePages:");
+    if (line) {
+      bytes = (sz)strtoull(line + 14, NULL, 10) * 1024;
+    }
+  }
+  profile_func_end;
+  return bytes;
+}
+
+func void vmem_advise_huge(void* ptr, sz size) {
+  profile_func_begin;
+  if (madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+    g_vmem_stats.huge_advised_bytes += size;
+  }
+  profile_func_end;
+}
+#  else
+func sz vmem_huge_page_size(void) {
+  return 0;
+}
+
+func sz vmem_query_process_huge_bytes(void) {
+  return 0;
+}
+
+func void vmem_advise_huge(void* ptr, sz size) {
+  (void)ptr;
+  (void)size;
+}
+#  endif
+
+// Maps size bytes of PROT_NONE address space starting at a multiple of align by
+// over-mapping and unmapping the unaligned head and tail.
+func void* vmem_map_aligned(sz size, sz align) {
+  profile_func_begin;
+  if (size > SZ_MAX - align) {
+    profile_func_end;
+    return NULL;
+  }
+  u8* raw = (u8*)mmap(NULL, size + align, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ((void*)raw == MAP_FAILED) {
+    profile_func_end;
+    return NULL;
+  }
+  u8* ptr = (u8*)align_up((up)raw, (up)align);
+  sz head = (sz)(ptr - raw);
+  if (head > 0) {
+    (void)munmap(raw, head);
+  }
+  (void)munmap(ptr + size, align - head);
+  profile_func_end;
+  return ptr;
+}
+
+func void* vmem_reserve_ex(sz size, vmem_flags flags) {
   profile_func_begin;
   g_vmem_stats.reserve_calls += 1;
-  void* ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-  if (ptr == MAP_FAILED) {
+  sz huge = (flags & VMEM_FLAG_HUGE_PAGES) ? vmem_huge_page_size() : 0;
+  void* ptr = NULL;
+  if (huge > 0 && size >= huge) {
+    ptr = vmem_map_aligned(size, huge);
+  } else {
+    ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ptr = ptr == MAP_FAILED ? NULL : ptr;
+  }
+  if (ptr == NULL) {
     profile_func_end;
     return NULL;
   }
+  if (huge > 0) {
+    vmem_advise_huge(ptr, size);
+  }
   g_vmem_stats.reserved_bytes += size;
   TracyCAlloc(ptr, size);
   profile_func_end;
   return ptr;
 }
 
-func b32 vmem_commit(void* ptr, sz size) {
+func b32 vmem_commit_ex(void* ptr, sz size, vmem_flags flags) {
   profile_func_begin;
   g_vmem_stats.commit_calls += 1;
   b32 success = mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0 ? true : false;
   if (success) {
     g_vmem_stats.committed_bytes += size;
+    if ((flags & VMEM_FLAG_HUGE_PAGES) && vmem_huge_page_size() > 0) {
+      vmem_advise_huge(ptr, size);
+    }
+    if (flags & VMEM_FLAG_PREFAULT) {
+#  if defined(MADV_POPULATE_WRITE)
+      // Faults the whole range in one call; older kernels reject it with EINVAL.
+      if (madvise(ptr, size, MADV_POPULATE_WRITE) != 0) {
+        vmem_touch_pages(ptr, size);
+      }
+#  else
+      vmem_touch_pages(ptr, size);
+#  endif
+      g_vmem_stats.prefaulted_bytes += size;
+    }
   }
   profile_func_end;
   return success;
@@ -204,6 +372,70 @@ func b32 vmem_platform_free(void* ptr, sz size) {
   return success;
 }
 
+#  if defined(PLATFORM_LINUX)
+func void* vmem_alloc_mirrored(sz size) {
+  profile_func_begin;
+  if (size == 0 || size % vmem_page_size() != 0) {
+    profile_func_end;
+    return NULL;
+  }
+  int fd = memfd_create("vmem_mirror", MFD_CLOEXEC);
+  if (fd < 0) {
+    profile_func_end;
+    return NULL;
+  }
+  u8* base = NULL;
+  if (ftruncate(fd, (off_t)size) == 0) {
+    // Reserve both halves first so nothing else can be mapped in between,
+    // then replace each half with a shared view of the same file.
+    base = (u8*)mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void*)base == MAP_FAILED) {
+      base = NULL;
+    } else if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+               mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      (void)munmap(base, size * 2);
+      base = NULL;
+    }
+  }
+  // The mappings keep the file alive; the descriptor is no longer needed.
+  close(fd);
+  if (base != NULL) {
+    g_vmem_stats.reserved_bytes += size * 2;
+    g_vmem_stats.committed_bytes += size;
+    TracyCAlloc(base, size * 2);
+  }
+  profile_func_end;
+  return base;
+}
+
+func b32 vmem_free_mirrored(void* ptr, sz size) {
+  profile_func_begin;
+  if (ptr == NULL) {
+    profile_func_end;
+    return false;
+  }
+  b32 success = munmap(ptr, size * 2) == 0 ? true : false;
+  if (success) {
+    g_vmem_stats.released_bytes += size * 2;
+    TracyCFree(ptr);
+  }
+  profile_func_end;
+  return success;
+}
+#  else
+// macOS would need mach_vm_remap; not implemented.
+func void* vmem_alloc_mirrored(sz size) {
+  (void)size;
+  return NULL;
+}
+
+func b32 vmem_free_mirrored(void* ptr, sz size) {
+  (void)ptr;
+  (void)size;
+  return false;
+}
+#  endif
+
 #else
 
 // =========================================================================
@@ -215,18 +447,28 @@ func sz vmem_page_size(void) {
   return 0;
 }
 
-func void* vmem_reserve(sz size) {
+func sz vmem_huge_page_size(void) {
+  return 0;
+}
+
+func sz vmem_query_process_huge_bytes(void) {
+  return 0;
+}
+
+func void* vmem_reserve_ex(sz size, vmem_flags flags) {
   profile_func_begin;
   (void)size;
+  (void)flags;
   invalid_code_path;
   profile_func_end;
   return NULL;
 }
 
-func b32 vmem_commit(void* ptr, sz size) {
+func b32 vmem_commit_ex(void* ptr, sz size, vmem_flags flags) {
   profile_func_begin;
   (void)ptr;
   (void)size;
+  (void)flags;
   invalid_code_path;
   profile_func_end;
   return false;
@@ -267,8 +509,27 @@ func b32 vmem_platform_free(void* ptr, sz size) {
   return false;
 }
 
+func void* vmem_alloc_mirrored(sz size) {
+  (void)size;
+  return NULL;
+}
+
+func b32 vmem_free_mirrored(void* ptr, sz size) {
+  (void)ptr;
+  (void)size;
+  return false;
+}
+
 #endif
 
+func void* vmem_reserve(sz size) {
+  return vmem_reserve_ex(size, VMEM_FLAG_NONE);
+}
+
+func b32 vmem_commit(void* ptr, sz size) {
+  return vmem_commit_ex(ptr, size, VMEM_FLAG_NONE);
+}
+
 // =========================================================================
 // Allocation Wrappers
 // =========================================================================
@@ -497,6 +758,21 @@ func vmem_stats vmem_get_stats(void) {
   stats.peak_live_allocated_bytes = g_vmem_stats.peak_live_allocated_bytes;
   stats.total_allocated_bytes = g_vmem_stats.total_allocated_bytes;
   stats.total_freed_bytes = g_vmem_stats.total_freed_bytes;
+
+  stats.huge_page_size = vmem_huge_page_size();
+  stats.huge_advised_bytes = g_vmem_stats.huge_advised_bytes;
+  stats.huge_backed_bytes = 0;
+  stats.prefaulted_bytes = g_vmem_stats.prefaulted_bytes;
+  profile_func_end;
+  return stats;
+}
+
+func vmem_stats vmem_get_stats_ex(b32 query_huge_backing) {
+  profile_func_begin;
+  vmem_stats stats = vmem_get_stats();
+  if (query_huge_backing) {
+    stats.huge_backed_bytes = vmem_query_process_huge_bytes();
+  }
   profile_func_end;
   return stats;
 }
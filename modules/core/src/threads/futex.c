@@ -0,0 +1,240 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "threads/futex.h"
+#include "basic/assert.h"
+#include "basic/env_defines.h"
+#include "basic/profiler.h"
+#include "basic/safe.h"
+#include "context/thread_ctx.h"
+#include "threads/thread_current.h"
+#include "platform_includes.h"
+
+#include <stdatomic.h>
+
+#if defined(PLATFORM_LINUX)
+#  include <errno.h>
+#  include <limits.h>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <time.h>
+#endif
+
+#define FUTEX_MUTEX_UNLOCKED  0U
+#define FUTEX_MUTEX_LOCKED    1U
+#define FUTEX_MUTEX_CONTENDED 2U
+
+// The lock and unlock fast paths use C11 atomics on the state word directly, the
+// way atomics.c does, so an uncontended lock or unlock is one inlined atomic
+// instruction with acquire or release ordering instead of a call chain. The fast
+// paths here and in rwlock.c carry no profiler zones, which would cost more than
+// the lock itself.
+func _Atomic uint32_t* futex_mutex_word(futex_mutex* mtx) {
+  return (_Atomic uint32_t*)(void*)&mtx->state;
+}
+
+func b32 futex_mutex_try_acquire(futex_mutex* mtx) {
+  uint32_t expected = FUTEX_MUTEX_UNLOCKED;
+  return atomic_compare_exchange_strong_explicit(
+      futex_mutex_word(mtx), &expected, FUTEX_MUTEX_LOCKED, memory_order_acquire, memory_order_relaxed);
+}
+
+// =========================================================================
+// Futex Word
+// =========================================================================
+
+func b32 futex_wait(atomic_u32* word, u32 expected, u32 millis) {
+  profile_func_begin;
+  if (word == NULL) {
+    thread_log_error("Rejected futex wait for invalid word");
+    profile_func_end;
+    return false;
+  }
+
+#if defined(PLATFORM_LINUX)
+  struct timespec timeout = {0};
+  struct timespec* timeout_ptr = NULL;
+  if (millis != FUTEX_WAIT_INFINITE) {
+    timeout.tv_sec = (time_t)(millis / 1000);
+    timeout.tv_nsec = (long)(millis % 1000) * 1000000L;
+    timeout_ptr = &timeout;
+  }
+
+  // EAGAIN (the word no longer held expected) and EINTR count as wake-ups.
+  long result = syscall(SYS_futex, (u32*)(void*)word, FUTEX_WAIT_PRIVATE, expected, timeout_ptr, NULL, 0);
+  b32 woken = result == 0 || errno != ETIMEDOUT;
+#elif defined(PLATFORM_WINDOWS)
+  DWORD timeout = millis == FUTEX_WAIT_INFINITE ? INFINITE : (DWORD)millis;
+  b32 woken = WaitOnAddress((volatile VOID*)word, &expected, size_of(expected), timeout) ||
+              GetLastError() != ERROR_TIMEOUT;
+#else
+  // No address-wait primitive: poll once per millisecond.
+  b32 woken = true;
+  u32 waited = 0;
+  while (atomic_u32_get(word) == expected) {
+    if (millis != FUTEX_WAIT_INFINITE && waited >= millis) {
+      woken = false;
+      break;
+    }
+
+    thread_sleep(1);
+    waited += 1;
+  }
+#endif
+
+  profile_func_end;
+  return woken;
+}
+
+func void futex_wake_one(atomic_u32* word) {
+  profile_func_begin;
+#if defined(PLATFORM_LINUX)
+  syscall(SYS_futex, (u32*)(void*)word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#elif defined(PLATFORM_WINDOWS)
+  WakeByAddressSingle((PVOID)word);
+#else
+  (void)word;
+#endif
+  profile_func_end;
+}
+
+func void futex_wake_all(atomic_u32* word) {
+  profile_func_begin;
+#if defined(PLATFORM_LINUX)
+  syscall(SYS_futex, (u32*)(void*)word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#elif defined(PLATFORM_WINDOWS)
+  WakeByAddressAll((PVOID)word);
+#else
+  (void)word;
+#endif
+  profile_func_end;
+}
+
+// =========================================================================
+// Futex Mutex
+// =========================================================================
+
+// Sleeps until the lock is handed over. Marks the lock contended on the way, so
+// its eventual owner always wakes the next sleeper when it unlocks.
+func void futex_mutex_lock_contended(futex_mutex* mtx) {
+  while (atomic_exchange_explicit(futex_mutex_word(mtx), FUTEX_MUTEX_CONTENDED, memory_order_acquire) !=
+         FUTEX_MUTEX_UNLOCKED) {
+    futex_wait(&mtx->state, FUTEX_MUTEX_CONTENDED, FUTEX_WAIT_INFINITE);
+  }
+}
+
+func void futex_mutex_lock_slow(futex_mutex* mtx) {
+  profile_func_begin;
+
+  // Spin for about twice as long as recent contended locks needed. The estimate
+  // follows successful spins and decays when spinning fails, so a lock that
+  // is held for long stops burning cycles before each sleep.
+  u32 estimate = atomic_u32_get_explicit(&mtx->spin_estimate, ATOMIC_MEMORY_ORDER_RELAXED);
+  u32 max_spins = estimate * 2 + FUTEX_MUTEX_MIN_SPINS;
+  max_spins = max_spins > FUTEX_MUTEX_MAX_SPINS ? FUTEX_MUTEX_MAX_SPINS : max_spins;
+
+  safe_for (u32 spins = 0; spins < max_spins; spins += 1) {
+    u32 state = atomic_load_explicit(futex_mutex_word(mtx), memory_order_relaxed);
+    if (state == FUTEX_MUTEX_UNLOCKED && futex_mutex_try_acquire(mtx)) {
+      i32 delta = ((i32)spins - (i32)estimate) / 8;
+      atomic_u32_set_explicit(&mtx->spin_estimate, (u32)((i32)estimate + delta), ATOMIC_MEMORY_ORDER_RELAXED);
+      profile_func_end;
+      return;
+    }
+
+    atomic_pause();
+  }
+
+  atomic_u32_set_explicit(&mtx->spin_estimate, estimate - estimate / 8, ATOMIC_MEMORY_ORDER_RELAXED);
+  futex_mutex_lock_contended(mtx);
+  profile_func_end;
+}
+
+func void futex_mutex_lock(futex_mutex* mtx) {
+  if (mtx == NULL) {
+    thread_log_error("Rejected futex mutex lock for invalid mutex");
+    return;
+  }
+
+  if (!futex_mutex_try_acquire(mtx)) {
+    futex_mutex_lock_slow(mtx);
+  }
+}
+
+func b32 futex_mutex_try_lock(futex_mutex* mtx) {
+  if (mtx == NULL) {
+    thread_log_error("Rejected futex mutex try lock for invalid mutex");
+    return false;
+  }
+
+  return futex_mutex_try_acquire(mtx);
+}
+
+func void futex_mutex_unlock(futex_mutex* mtx) {
+  if (mtx == NULL) {
+    thread_log_error("Rejected futex mutex unlock for invalid mutex");
+    return;
+  }
+
+  u32 previous = atomic_exchange_explicit(futex_mutex_word(mtx), FUTEX_MUTEX_UNLOCKED, memory_order_release);
+  assert(previous != FUTEX_MUTEX_UNLOCKED);
+  if (previous == FUTEX_MUTEX_CONTENDED) {
+    futex_wake_one(&mtx->state);
+  }
+}
+
+// =========================================================================
+// Futex Condition Variable
+// =========================================================================
+
+func void futex_condvar_wait(futex_condvar* cond, futex_mutex* mtx) {
+  futex_condvar_wait_timeout(cond, mtx, FUTEX_WAIT_INFINITE);
+}
+
+func b32 futex_condvar_wait_timeout(futex_condvar* cond, futex_mutex* mtx, u32 millis) {
+  profile_func_begin;
+  if (cond == NULL || mtx == NULL) {
+    thread_log_error("Rejected futex condvar wait cond=%p mtx=%p", cond, mtx);
+    profile_func_end;
+    return false;
+  }
+
+  // The sequence is sampled while mtx is still held, so a signal sent after
+  // the unlock changes it and the wait below returns at once.
+  atomic_u32_add(&cond->waiter_count, 1);
+  u32 seq = atomic_u32_get(&cond->seq);
+  futex_mutex_unlock(mtx);
+
+  b32 woken = futex_wait(&cond->seq, seq, millis);
+  atomic_u32_sub(&cond->waiter_count, 1);
+
+  // Other woken waiters may be racing for mtx, so take it in contended mode
+  // to make sure whoever ends up holding it wakes the rest.
+  futex_mutex_lock_contended(mtx);
+  profile_func_end;
+  return woken;
+}
+
+func void futex_condvar_signal(futex_condvar* cond) {
+  if (cond == NULL) {
+    thread_log_error("Rejected futex condvar signal for invalid condvar");
+    return;
+  }
+
+  atomic_u32_add(&cond->seq, 1);
+  if (atomic_u32_get(&cond->waiter_count) != 0) {
+    futex_wake_one(&cond->seq);
+  }
+}
+
+func void futex_condvar_broadcast(futex_condvar* cond) {
+  if (cond == NULL) {
+    thread_log_error("Rejected futex condvar broadcast for invalid condvar");
+    return;
+  }
+
+  atomic_u32_add(&cond->seq, 1);
+  if (atomic_u32_get(&cond->waiter_count) != 0) {
+    futex_wake_all(&cond->seq);
+  }
+}
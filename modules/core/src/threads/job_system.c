@@ -0,0 +1,662 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "threads/job_system.h"
+#include "basic/assert.h"
+#include "basic/env_defines.h"
+#include "basic/profiler.h"
+#include "basic/safe.h"
+#include "context/global_ctx.h"
+#include "context/thread_ctx.h"
+#include "memory/memops.h"
+#include "memory/pool.h"
+#include "system/cpu_info.h"
+#include "threads/mutex.h"
+#include "threads/semaphore.h"
+#include "threads/thread_current.h"
+#include "threads/thread_group.h"
+
+#define JOB_SYSTEM_QUEUE_MASK        (JOB_SYSTEM_QUEUE_CAPACITY - 1)
+#define JOB_SYSTEM_WAITER_BLOCK_SIZE (64 * 1024)
+
+// Marks a counter whose last job is scheduling its dependents. Waiters keep
+// waiting until the finishing thread has stored zero, which is its final access,
+// so a counter on the waiting thread's stack stays valid for as long as it is used.
+#define JOB_COUNTER_RELEASING 0x80000000U
+
+typedef struct job_entry {
+  job_func entry;
+  void* arg;
+  job_counter* counter;
+} job_entry;
+
+// Deferred job parked on a dependency counter until that counter drops to zero.
+typedef struct job_waiter {
+  struct job_waiter* next;
+  job_entry job;
+} job_waiter;
+
+// Chase-Lev work-stealing deque with a fixed power-of-two ring.
+// Only the owning worker touches bottom; thieves race on top with a compare-and-swap.
+// Both ends live on their own cache line so thieves polling top do not keep
+// invalidating the line the owner writes on every push and pop.
+typedef struct job_deque {
+  align_as(ARCH_CACHE_LINE_SIZE) atomic_i64 top;
+  align_as(ARCH_CACHE_LINE_SIZE) atomic_i64 bottom;
+  job_entry* slots;
+} job_deque;
+
+typedef struct job_system_data {
+  thread_group workers;
+  u32 worker_count;
+  job_deque* deques;  // deques[idx - 1] belongs to worker idx.
+
+  // Jobs submitted by threads that are not workers of this system.
+  mutex shared_mutex;
+  job_entry* shared_slots;
+  u64 shared_head;
+  u64 shared_tail;
+  atomic_u32 shared_count;  // Read without the lock by idle workers.
+
+  pool waiter_pool;
+  semaphore wake_sem;
+  atomic_u32 sleeper_count;
+  atomic_u32 stop;
+} job_system_data;
+
+// Identifies the system and worker slot of the current thread; zero on non-workers.
+thread_local global_var job_system_data* job_tls_system = NULL;
+thread_local global_var u32 job_tls_worker_idx = 0;
+thread_local global_var u32 job_tls_steal_seed = 0;
+
+func void job_system_submit(job_system_data* sys, job_entry const* job);
+
+func job_system_data* job_system_data_from_handle(job_system sys) {
+  return (job_system_data*)sys;
+}
+
+func u32 job_system_current_worker_idx(job_system_data* sys) {
+  return job_tls_system == sys ? job_tls_worker_idx : 0;
+}
+
+// =========================================================================
+// Deque
+// =========================================================================
+
+// Every index access is sequentially consistent: pop publishes the reserved
+// bottom before it reads top, which needs store-load ordering that the
+// acquire/release fences do not give.
+func b32 job_deque_push(job_deque* deq, job_entry const* job) {
+  i64 bottom = atomic_i64_get_explicit(&deq->bottom, ATOMIC_MEMORY_ORDER_RELAXED);
+  i64 top = atomic_i64_get(&deq->top);
+  if (bottom - top >= JOB_SYSTEM_QUEUE_CAPACITY) {
+    return false;
+  }
+
+  deq->slots[bottom & JOB_SYSTEM_QUEUE_MASK] = *job;
+  atomic_i64_set(&deq->bottom, bottom + 1);
+  return true;
+}
+
+func b32 job_deque_pop(job_deque* deq, job_entry* out_job) {
+  i64 bottom = atomic_i64_get_explicit(&deq->bottom, ATOMIC_MEMORY_ORDER_RELAXED) - 1;
+  atomic_i64_set(&deq->bottom, bottom);
+  i64 top = atomic_i64_get(&deq->top);
+  if (top > bottom) {
+    atomic_i64_set(&deq->bottom, bottom + 1);
+    return false;
+  }
+
+  *out_job = deq->slots[bottom & JOB_SYSTEM_QUEUE_MASK];
+  if (top != bottom) {
+    return true;
+  }
+
+  // Last job: thieves may be after it too, so claim it through top.
+  b32 won = atomic_i64_cmpex(&deq->top, &top, top + 1);
+  atomic_i64_set(&deq->bottom, bottom + 1);
+  return won;
+}
+
+func b32 job_deque_steal(job_deque* deq, job_entry* out_job) {
+  i64 top = atomic_i64_get(&deq->top);
+  i64 bottom = atomic_i64_get(&deq->bottom);
+  if (top >= bottom) {
+    return false;
+  }
+
+  // The slot cannot be reused while top still points at it, so a copy taken
+  // before a successful compare-and-swap is the job that was claimed.
+  job_entry job = deq->slots[top & JOB_SYSTEM_QUEUE_MASK];
+  if (!atomic_i64_cmpex(&deq->top, &top, top + 1)) {
+    return false;
+  }
+
+  *out_job = job;
+  return true;
+}
+
+func b32 job_deque_is_empty(job_deque* deq) {
+  return atomic_i64_get(&deq->bottom) <= atomic_i64_get(&deq->top);
+}
+
+// =========================================================================
+// Shared Queue
+// =========================================================================
+
+// Appends up to count jobs and returns how many fit.
+func u32 job_system_shared_push(job_system_data* sys, job_entry const* jobs, u32 count) {
+  mutex_lock(sys->shared_mutex);
+  u64 free_count = JOB_SYSTEM_QUEUE_CAPACITY - (sys->shared_tail - sys->shared_head);
+  u32 push_count = free_count < count ? (u32)free_count : count;
+  safe_for (u32 idx = 0; idx < push_count; idx += 1) {
+    sys->shared_slots[sys->shared_tail & JOB_SYSTEM_QUEUE_MASK] = jobs[idx];
+    sys->shared_tail += 1;
+  }
+
+  atomic_u32_add(&sys->shared_count, push_count);
+  mutex_unlock(sys->shared_mutex);
+  return push_count;
+}
+
+func b32 job_system_shared_pop(job_system_data* sys, job_entry* out_job) {
+  if (atomic_u32_get(&sys->shared_count) == 0) {
+    return false;
+  }
+
+  b32 found = false;
+  mutex_lock(sys->shared_mutex);
+  if (sys->shared_head != sys->shared_tail) {
+    *out_job = sys->shared_slots[sys->shared_head & JOB_SYSTEM_QUEUE_MASK];
+    sys->shared_head += 1;
+    atomic_u32_sub(&sys->shared_count, 1);
+    found = true;
+  }
+
+  mutex_unlock(sys->shared_mutex);
+  return found;
+}
+
+// =========================================================================
+// Scheduling
+// =========================================================================
+
+func b32 job_system_steal(job_system_data* sys, u32 worker_idx, job_entry* out_job) {
+  // xorshift32; a fixed victim order would make every thief hit the same deque first.
+  u32 seed = job_tls_steal_seed != 0 ? job_tls_steal_seed : 0x9E3779B9U;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  job_tls_steal_seed = seed;
+
+  u32 start = seed % sys->worker_count;
+  safe_for (u32 offset = 0; offset < sys->worker_count; offset += 1) {
+    u32 victim = (start + offset) % sys->worker_count;
+    if (victim + 1 == worker_idx) {
+      continue;
+    }
+
+    if (job_deque_steal(&sys->deques[victim], out_job)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+func b32 job_system_find(job_system_data* sys, u32 worker_idx, job_entry* out_job) {
+  if (worker_idx != 0 && job_deque_pop(&sys->deques[worker_idx - 1], out_job)) {
+    return true;
+  }
+
+  if (job_system_shared_pop(sys, out_job)) {
+    return true;
+  }
+
+  return job_system_steal(sys, worker_idx, out_job);
+}
+
+func b32 job_system_has_work(job_system_data* sys) {
+  if (atomic_u32_get(&sys->shared_count) != 0) {
+    return true;
+  }
+
+  safe_for (u32 idx = 0; idx < sys->worker_count; idx += 1) {
+    if (!job_deque_is_empty(&sys->deques[idx])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Wakes up to job_count sleeping workers. A surplus release only makes a
+// worker look for work once more before going back to sleep.
+func void job_system_wake(job_system_data* sys, u32 job_count) {
+  u32 sleeper_count = atomic_u32_get(&sys->sleeper_count);
+  u32 wake_count = sleeper_count < job_count ? sleeper_count : job_count;
+  safe_for (u32 idx = 0; idx < wake_count; idx += 1) {
+    semaphore_release(sys->wake_sem);
+  }
+}
+
+func void job_system_release_waiters(job_system_data* sys, job_counter* counter) {
+  job_waiter* waiter = (job_waiter*)atomic_ptr_set(&counter->waiters, NULL);
+
+  while (waiter != NULL) {
+    job_waiter* next = waiter->next;
+    job_entry job = waiter->job;
+    pool_dealloc(&sys->waiter_pool, waiter);
+    job_system_submit(sys, &job);
+    waiter = next;
+  }
+}
+
+func void job_counter_finish(job_system_data* sys, job_counter* counter) {
+  u32 pending = atomic_u32_get(&counter->pending);
+  u32 next = pending == 1 ? JOB_COUNTER_RELEASING : pending - 1;
+  while (!atomic_u32_cmpex(&counter->pending, &pending, next)) {
+    atomic_pause();
+    next = pending == 1 ? JOB_COUNTER_RELEASING : pending - 1;
+  }
+
+  if (next == JOB_COUNTER_RELEASING) {
+    job_system_release_waiters(sys, counter);
+    atomic_u32_set(&counter->pending, 0);
+  }
+}
+
+func void job_system_execute(job_system_data* sys, job_entry const* job) {
+  job->entry(job->arg);
+  if (job->counter != NULL) {
+    job_counter_finish(sys, job->counter);
+  }
+}
+
+func void job_system_submit(job_system_data* sys, job_entry const* job) {
+  u32 worker_idx = job_system_current_worker_idx(sys);
+  b32 queued = worker_idx != 0 ? job_deque_push(&sys->deques[worker_idx - 1], job)
+                               : job_system_shared_push(sys, job, 1) == 1;
+  if (!queued) {
+    job_system_execute(sys, job);
+    return;
+  }
+
+  job_system_wake(sys, 1);
+}
+
+func i32 job_system_worker_main(u32 idx, void* arg) {
+  profile_func_begin;
+
+  job_system_data* sys = (job_system_data*)arg;
+  u32 worker_idx = idx + 1;
+  job_tls_system = sys;
+  job_tls_worker_idx = worker_idx;
+  job_tls_steal_seed = worker_idx * 0x9E3779B9U;
+
+  job_entry job;
+  u32 idle_rounds = 0;
+
+  while (!atomic_u32_get(&sys->stop)) {
+    if (job_system_find(sys, worker_idx, &job)) {
+      job_system_execute(sys, &job);
+      idle_rounds = 0;
+      continue;
+    }
+
+    idle_rounds += 1;
+    if (idle_rounds < JOB_SYSTEM_IDLE_SPIN_COUNT) {
+      atomic_pause();
+      continue;
+    }
+
+    // Announce the sleep before the final look so a submitter that missed this
+    // worker's search is guaranteed to see it in sleeper_count.
+    idle_rounds = 0;
+    atomic_u32_add(&sys->sleeper_count, 1);
+    if (!job_system_has_work(sys) && !atomic_u32_get(&sys->stop)) {
+      semaphore_acquire(sys->wake_sem);
+    }
+
+    atomic_u32_sub(&sys->sleeper_count, 1);
+  }
+
+  job_tls_system = NULL;
+  job_tls_worker_idx = 0;
+  profile_func_end;
+  return 0;
+}
+
+// =========================================================================
+// Lifecycle
+// =========================================================================
+
+func void job_system_destroy_storage(heap* hp, job_system_data* sys) {
+  if (hp == NULL || sys == NULL) {
+    return;
+  }
+
+  if (sys->deques != NULL) {
+    safe_for (u32 idx = 0; idx < sys->worker_count; idx += 1) {
+      heap_dealloc(hp, sys->deques[idx].slots);
+    }
+
+    heap_dealloc(hp, sys->deques);
+  }
+
+  heap_dealloc(hp, sys->shared_slots);
+  if (mutex_is_valid(sys->shared_mutex)) {
+    mutex_destroy(sys->shared_mutex);
+  }
+
+  if (semaphore_is_valid(sys->wake_sem)) {
+    semaphore_destroy(sys->wake_sem);
+  }
+
+  pool_destroy(&sys->waiter_pool);
+  heap_dealloc(hp, sys);
+}
+
+func u32 job_system_default_worker_count(void) {
+  cpu_info info = {0};
+  if (!cpu_info_query(&info) || info.logical_core_count <= 1) {
+    return 1;
+  }
+
+  return info.logical_core_count - 1;
+}
+
+func job_system _job_system_create(u32 worker_count, ctx_setup setup, callsite site) {
+  profile_func_begin;
+
+  if (worker_count == 0) {
+    worker_count = job_system_default_worker_count();
+  }
+
+  // The global heap is shared, so any thread may later destroy the system.
+  heap* hp = global_get_perm_heap();
+  if (hp == NULL) {
+    global_log_error("Failed to acquire global heap");
+    profile_func_end;
+    return NULL;
+  }
+
+  job_system_data* sys = heap_alloc_type(hp, job_system_data);
+  if (sys == NULL) {
+    thread_log_error("Failed to allocate job system handle worker_count=%u", worker_count);
+    profile_func_end;
+    return NULL;
+  }
+
+  mem_zero(sys, size_of(*sys));
+  sys->deques = heap_alloc_array(hp, job_deque, worker_count);
+  if (sys->deques == NULL) {
+    thread_log_error("Failed to allocate job system deques worker_count=%u", worker_count);
+    job_system_destroy_storage(hp, sys);
+    profile_func_end;
+    return NULL;
+  }
+
+  mem_zero(sys->deques, size_of(job_deque) * worker_count);
+  sys->worker_count = worker_count;
+  safe_for (u32 idx = 0; idx < worker_count; idx += 1) {
+    sys->deques[idx].slots = heap_alloc_array(hp, job_entry, JOB_SYSTEM_QUEUE_CAPACITY);
+    if (sys->deques[idx].slots == NULL) {
+      thread_log_error("Failed to allocate job system deque idx=%u", idx);
+      job_system_destroy_storage(hp, sys);
+      profile_func_end;
+      return NULL;
+    }
+  }
+
+  sys->shared_slots = heap_alloc_array(hp, job_entry, JOB_SYSTEM_QUEUE_CAPACITY);
+  sys->shared_mutex = mutex_create();
+  sys->wake_sem = semaphore_create(0);
+  sys->waiter_pool = pool_create_lockfree(
+      global_get_allocator(),
+      JOB_SYSTEM_WAITER_BLOCK_SIZE,
+      size_of(job_waiter),
+      align_of(job_waiter));
+  if (sys->shared_slots == NULL || !mutex_is_valid(sys->shared_mutex) || !semaphore_is_valid(sys->wake_sem)) {
+    thread_log_error("Failed to create job system shared queue worker_count=%u", worker_count);
+    job_system_destroy_storage(hp, sys);
+    profile_func_end;
+    return NULL;
+  }
+
+  sys->workers = _thread_group_create_named(worker_count, job_system_worker_main, sys, setup, "job_worker", site);
+  if (!thread_group_is_valid(sys->workers)) {
+    thread_log_error("Failed to start job system workers worker_count=%u", worker_count);
+    job_system_destroy_storage(hp, sys);
+    profile_func_end;
+    return NULL;
+  }
+
+  thread_log_info("Created job system handle=%p worker_count=%u", sys, worker_count);
+  profile_func_end;
+  return sys;
+}
+
+func b32 _job_system_destroy(job_system sys, callsite site) {
+  profile_func_begin;
+
+  job_system_data* data = job_system_data_from_handle(sys);
+  if (data == NULL) {
+    thread_log_warn("Skipping job system destroy for invalid handle");
+    profile_func_end;
+    return false;
+  }
+
+  heap* hp = global_get_perm_heap();
+  if (hp == NULL) {
+    global_log_error("Failed to acquire global heap");
+    profile_func_end;
+    return false;
+  }
+
+  // One release per worker covers the ones that are asleep or about to sleep.
+  atomic_u32_set(&data->stop, 1);
+  safe_for (u32 idx = 0; idx < data->worker_count; idx += 1) {
+    semaphore_release(data->wake_sem);
+  }
+
+  b32 success = thread_group_join_all(data->workers, NULL);
+  success = _thread_group_destroy(data->workers, site) && success;
+
+  thread_log_info("Destroyed job system handle=%p success=%u", sys, (u32)success);
+  job_system_destroy_storage(hp, data);
+  profile_func_end;
+  return success;
+}
+
+func b32 job_system_is_valid(job_system sys) {
+  return sys != NULL;
+}
+
+func u32 job_system_get_worker_count(job_system sys) {
+  job_system_data* data = job_system_data_from_handle(sys);
+  return data != NULL ? data->worker_count : 0;
+}
+
+func u32 job_system_get_worker_idx(job_system sys) {
+  job_system_data* data = job_system_data_from_handle(sys);
+  return data != NULL ? job_system_current_worker_idx(data) : 0;
+}
+
+// =========================================================================
+// Submission
+// =========================================================================
+
+func void job_system_run(job_system sys, job_func entry, void* arg, job_counter* counter) {
+  profile_func_begin;
+
+  job_system_data* data = job_system_data_from_handle(sys);
+  if (data == NULL || entry == NULL) {
+    thread_log_error("Rejected job submission handle=%p has_entry=%u", sys, (u32)(entry != NULL));
+    profile_func_end;
+    return;
+  }
+
+  if (counter != NULL) {
+    atomic_u32_add(&counter->pending, 1);
+  }
+
+  job_entry job = {.entry = entry, .arg = arg, .counter = counter};
+  job_system_submit(data, &job);
+  profile_func_end;
+}
+
+func void job_system_run_many(job_system sys, job_decl const* jobs, u32 count, job_counter* counter) {
+  profile_func_begin;
+
+  job_system_data* data = job_system_data_from_handle(sys);
+  if (data == NULL || (jobs == NULL && count != 0)) {
+    thread_log_error("Rejected job batch submission handle=%p count=%u", sys, count);
+    profile_func_end;
+    return;
+  }
+
+  if (counter != NULL && count != 0) {
+    atomic_u32_add(&counter->pending, count);
+  }
+
+  // Jobs that do not fit into the queue run inline once the rest has been
+  // published.
+  u32 worker_idx = job_system_current_worker_idx(data);
+  u32 queued_count = 0;
+  job_entry job = {.counter = counter};
+  if (worker_idx != 0) {
+    job_deque* deq = &data->deques[worker_idx - 1];
+    while (queued_count < count) {
+      job.entry = jobs[queued_count].entry;
+      job.arg = jobs[queued_count].arg;
+      if (!job_deque_push(deq, &job)) {
+        break;
+      }
+
+      queued_count += 1;
+    }
+  } else {
+    job_entry staged[64];
+    while (queued_count < count) {
+      u32 staged_count = count - queued_count < 64 ? count - queued_count : 64;
+      for (u32 idx = 0; idx < staged_count; idx += 1) {
+        staged[idx] = (job_entry){
+            .entry = jobs[queued_count + idx].entry,
+            .arg = jobs[queued_count + idx].arg,
+            .counter = counter,
+        };
+      }
+
+      u32 pushed_count = job_system_shared_push(data, staged, staged_count);
+      queued_count += pushed_count;
+      if (pushed_count < staged_count) {
+        break;
+      }
+    }
+  }
+
+  job_system_wake(data, queued_count);
+  for (u32 idx = queued_count; idx < count; idx += 1) {
+    job.entry = jobs[idx].entry;
+    job.arg = jobs[idx].arg;
+    job_system_execute(data, &job);
+  }
+
+  profile_func_end;
+}
+
+func b32 job_system_run_after(
+    job_system sys,
+    job_counter* dependency,
+    job_func entry,
+    void* arg,
+    job_counter* counter) {
+  profile_func_begin;
+
+  job_system_data* data = job_system_data_from_handle(sys);
+  if (data == NULL || entry == NULL) {
+    thread_log_error("Rejected dependent job submission handle=%p has_entry=%u", sys, (u32)(entry != NULL));
+    profile_func_end;
+    return false;
+  }
+
+  if (dependency == NULL) {
+    job_system_run(sys, entry, arg, counter);
+    profile_func_end;
+    return true;
+  }
+
+  job_waiter* waiter = (job_waiter*)pool_alloc(&data->waiter_pool);
+  if (waiter == NULL) {
+    thread_log_error("Failed to allocate dependent job handle=%p", sys);
+    profile_func_end;
+    return false;
+  }
+
+  if (counter != NULL) {
+    atomic_u32_add(&counter->pending, 1);
+  }
+
+  waiter->job = (job_entry){.entry = entry, .arg = arg, .counter = counter};
+  void* head = atomic_ptr_get(&dependency->waiters);
+  waiter->next = (job_waiter*)head;
+  while (!atomic_ptr_cmpex(&dependency->waiters, &head, waiter)) {
+    atomic_pause();
+    waiter->next = (job_waiter*)head;
+  }
+
+  // A finisher that swapped the list out before the waiter was linked has
+  // missed it. Let it finish, then schedule the waiter here; whoever swaps the
+  // list out first schedules it, so it runs exactly once.
+  u32 pending = atomic_u32_get(&dependency->pending);
+
+  while ((pending & JOB_COUNTER_RELEASING) != 0) {
+    atomic_pause();
+    pending = atomic_u32_get(&dependency->pending);
+  }
+
+  if (pending == 0) {
+    job_system_release_waiters(data, dependency);
+  }
+
+  profile_func_end;
+  return true;
+}
+
+func void job_system_wait(job_system sys, job_counter* counter) {
+  profile_func_begin;
+
+  job_system_data* data = job_system_data_from_handle(sys);
+  if (data == NULL || counter == NULL) {
+    thread_log_error("Rejected job wait handle=%p counter=%p", sys, counter);
+    profile_func_end;
+    return;
+  }
+
+  u32 worker_idx = job_system_current_worker_idx(data);
+  job_entry job;
+  u32 idle_rounds = 0;
+
+  while (atomic_u32_get(&counter->pending) != 0) {
+    if (job_system_find(data, worker_idx, &job)) {
+      job_system_execute(data, &job);
+      idle_rounds = 0;
+      continue;
+    }
+
+    // The remaining jobs are running elsewhere.
+    idle_rounds += 1;
+    if (idle_rounds < JOB_SYSTEM_IDLE_SPIN_COUNT) {
+      atomic_pause();
+    } else {
+      thread_yield();
+    }
+  }
+
+  profile_func_end;
+}
+
+func b32 job_counter_is_done(job_counter* counter) {
+  return counter == NULL || atomic_u32_get(&counter->pending) == 0;
+}
@@ -0,0 +1,206 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "threads/parallel.h"
+#include "basic/assert.h"
+#include "basic/env_defines.h"
+#include "basic/profiler.h"
+#include "basic/safe.h"
+#include "basic/utility_defines.h"
+#include "context/thread_ctx.h"
+#include "memory/memops.h"
+
+// State shared by every participant of one loop. Lives on the calling thread's
+// stack, which stays valid because the caller waits for all participants.
+typedef struct parallel_loop {
+  atomic_u64 next;
+  u64 end;
+  u64 grain;
+  u64 split_factor;
+  parallel_for_func for_body;
+  parallel_reduce_func reduce_body;
+  void* arg;
+  u8* partials;
+  sz partial_stride;
+} parallel_loop;
+
+typedef struct parallel_task {
+  parallel_loop* loop;
+  u32 idx;
+} parallel_task;
+
+// Claims the next chunk: a 1/split_factor share of the indices left, but never
+// fewer than grain. Returns false once the range is exhausted.
+func b32 parallel_claim(parallel_loop* loop, u64* out_begin, u64* out_end) {
+  u64 cur = atomic_u64_get(&loop->next);
+  safe_while (cur < loop->end) {
+    u64 remaining = loop->end - cur;
+    u64 chunk = remaining / loop->split_factor;
+    chunk = chunk < loop->grain ? loop->grain : chunk;
+    chunk = chunk > remaining ? remaining : chunk;
+    if (atomic_u64_cmpex(&loop->next, &cur, cur + chunk)) {
+      *out_begin = cur;
+      *out_end = cur + chunk;
+      return true;
+    }
+
+    atomic_pause();
+  }
+
+  return false;
+}
+
+func void parallel_task_run(void* raw) {
+  parallel_task* task = (parallel_task*)raw;
+  parallel_loop* loop = task->loop;
+  void* partial = loop->partials != NULL ? loop->partials + loop->partial_stride * task->idx : NULL;
+
+  u64 chunk_begin = 0;
+  u64 chunk_end = 0;
+
+  while (parallel_claim(loop, &chunk_begin, &chunk_end)) {
+    if (loop->for_body != NULL) {
+      loop->for_body(chunk_begin, chunk_end, loop->arg);
+    } else {
+      loop->reduce_body(chunk_begin, chunk_end, partial, loop->arg);
+    }
+  }
+}
+
+// Number of participants worth starting for count indices, including the caller.
+func u32 parallel_task_count(job_system sys, u64 count, u64 grain) {
+  u64 task_count = (u64)job_system_get_worker_count(sys) + 1;
+  task_count = task_count > PARALLEL_MAX_TASKS ? PARALLEL_MAX_TASKS : task_count;
+
+  u64 chunk_count = count / grain + (count % grain != 0);
+  return (u32)(chunk_count < task_count ? chunk_count : task_count);
+}
+
+func u64 parallel_resolve_grain(job_system sys, u64 count, u64 grain) {
+  if (grain != 0) {
+    return grain;
+  }
+
+  u64 task_count = (u64)job_system_get_worker_count(sys) + 1;
+  task_count = task_count > PARALLEL_MAX_TASKS ? PARALLEL_MAX_TASKS : task_count;
+  u64 auto_grain = count / (task_count * PARALLEL_AUTO_CHUNKS_PER_TASK);
+  return auto_grain != 0 ? auto_grain : 1;
+}
+
+// Runs task 0 on the calling thread and the others as jobs, then waits.
+func void parallel_run_tasks(job_system sys, parallel_loop* loop, u32 task_count) {
+  parallel_task tasks[PARALLEL_MAX_TASKS];
+  job_decl jobs[PARALLEL_MAX_TASKS];
+  safe_for (u32 idx = 0; idx < task_count; idx += 1) {
+    tasks[idx] = (parallel_task){.loop = loop, .idx = idx};
+    jobs[idx] = (job_decl){.entry = parallel_task_run, .arg = &tasks[idx]};
+  }
+
+  job_counter counter = {0};
+  job_system_run_many(sys, jobs + 1, task_count - 1, &counter);
+  parallel_task_run(&tasks[0]);
+  job_system_wait(sys, &counter);
+}
+
+func void parallel_for(job_system sys, u64 begin, u64 end, u64 grain, parallel_for_func body, void* arg) {
+  profile_func_begin;
+
+  if (body == NULL) {
+    thread_log_error("Rejected parallel_for without a body");
+    profile_func_end;
+    return;
+  }
+
+  if (begin >= end) {
+    profile_func_end;
+    return;
+  }
+
+  u64 count = end - begin;
+  grain = parallel_resolve_grain(sys, count, grain);
+  u32 task_count = parallel_task_count(sys, count, grain);
+  if (!job_system_is_valid(sys) || task_count <= 1) {
+    body(begin, end, arg);
+    profile_func_end;
+    return;
+  }
+
+  parallel_loop loop = {
+      .end = end,
+      .grain = grain,
+      .split_factor = (u64)task_count * 2,
+      .for_body = body,
+      .arg = arg,
+  };
+  atomic_u64_set(&loop.next, begin);
+  parallel_run_tasks(sys, &loop, task_count);
+  profile_func_end;
+}
+
+func b32 parallel_reduce(
+    job_system sys,
+    u64 begin,
+    u64 end,
+    u64 grain,
+    void* result,
+    sz result_size,
+    parallel_reduce_func body,
+    parallel_combine_func combine,
+    void* arg) {
+  profile_func_begin;
+
+  if (body == NULL || combine == NULL || result == NULL || result_size == 0) {
+    thread_log_error("Rejected parallel_reduce result=%p result_size=%zu", result, result_size);
+    profile_func_end;
+    return false;
+  }
+
+  if (begin >= end) {
+    profile_func_end;
+    return true;
+  }
+
+  u64 count = end - begin;
+  grain = parallel_resolve_grain(sys, count, grain);
+  u32 task_count = parallel_task_count(sys, count, grain);
+  if (!job_system_is_valid(sys) || task_count <= 1) {
+    body(begin, end, result, arg);
+    profile_func_end;
+    return true;
+  }
+
+  // One cache line per partial at least, so participants never share a line.
+  allocator alloc = thread_get_allocator();
+  sz stride = align_up(result_size, (sz)ARCH_CACHE_LINE_SIZE);
+  void* storage = allocator_alloc(alloc, stride * task_count + ARCH_CACHE_LINE_SIZE);
+  if (storage == NULL) {
+    thread_log_error("Failed to allocate parallel_reduce partials count=%u result_size=%zu", task_count, result_size);
+    profile_func_end;
+    return false;
+  }
+
+  u8* partials = (u8*)mem_align_forward(storage, ARCH_CACHE_LINE_SIZE);
+  safe_for (u32 idx = 0; idx < task_count; idx += 1) {
+    mem_cpy(partials + stride * idx, result, result_size);
+  }
+
+  parallel_loop loop = {
+      .end = end,
+      .grain = grain,
+      .split_factor = (u64)task_count * 2,
+      .reduce_body = body,
+      .arg = arg,
+      .partials = partials,
+      .partial_stride = stride,
+  };
+  atomic_u64_set(&loop.next, begin);
+  parallel_run_tasks(sys, &loop, task_count);
+
+  safe_for (u32 idx = 0; idx < task_count; idx += 1) {
+    combine(result, partials + stride * idx, arg);
+  }
+
+  allocator_dealloc(alloc, storage);
+  profile_func_end;
+  return true;
+}
@@ -10,6 +10,10 @@
 #include "basic/profiler.h"
 #include "threads/atomics.h"
 #include "basic/safe.h"
+#include "memory/memops.h"
+#include "threads/thread_current.h"
+
+#include <stdatomic.h>
 
 func rwlock _rwlock_create(callsite site) {
   profile_func_begin;
@@ -193,3 +197,244 @@ func b32 rwlock_timed_write_lock(rwlock rw, i32 timeout_ms) {
   profile_func_end;
   return true;
 }
+
+// =========================================================================
+// Sharded Reader-Writer Lock
+// =========================================================================
+
+#define RWLOCK_SHARDED_WRITER_NONE     0U
+#define RWLOCK_SHARDED_WRITER_ACTIVE   1U
+#define RWLOCK_SHARDED_WRITER_SLEEPERS 2U
+
+// Pauses a writer spends on one busy reader slot before it starts yielding.
+#define RWLOCK_SHARDED_DRAIN_PAUSES 64
+
+// Slot index plus one for the calling thread, 0 until its first read lock.
+// Slots are handed out round-robin, so up to RWLOCK_SHARDED_SLOT_COUNT threads
+// each get a cache line of their own in every sharded lock.
+thread_local global_var u32 rwlock_sharded_tls_slot = 0;
+global_var atomic_u32 rwlock_sharded_next_slot = {0};
+
+// Every reader and writer access is sequentially consistent: a reader publishes
+// its slot count before it checks the writer flag, and a writer raises the flag
+// before it checks the slots, so at least one of them sees the other.
+func _Atomic uint32_t* rwlock_sharded_word(atomic_u32* atom) {
+  return (_Atomic uint32_t*)(void*)atom;
+}
+
+func atomic_u32* rwlock_sharded_thread_slot(rwlock_sharded* rw) {
+  if (rwlock_sharded_tls_slot == 0) {
+    rwlock_sharded_tls_slot = atomic_u32_add(&rwlock_sharded_next_slot, 1) % RWLOCK_SHARDED_SLOT_COUNT + 1;
+  }
+
+  return &rw->slots[rwlock_sharded_tls_slot - 1].reader_count;
+}
+
+// Publishes a reader in its slot. Returns false, with the slot restored, if a
+// writer holds or waits for the lock.
+func b32 rwlock_sharded_try_enter(atomic_u32* slot, rwlock_sharded* rw) {
+  atomic_fetch_add_explicit(rwlock_sharded_word(slot), 1, memory_order_seq_cst);
+  if (atomic_load_explicit(rwlock_sharded_word(&rw->writer_active), memory_order_seq_cst) ==
+      RWLOCK_SHARDED_WRITER_NONE) {
+    return true;
+  }
+
+  atomic_fetch_sub_explicit(rwlock_sharded_word(slot), 1, memory_order_release);
+  return false;
+}
+
+// Sleeps until the current writer unlocks. Marks the flag on the way, so the
+// writer knows it has to wake someone.
+func void rwlock_sharded_wait_for_writer(rwlock_sharded* rw) {
+  profile_func_begin;
+  _Atomic uint32_t* word = rwlock_sharded_word(&rw->writer_active);
+
+  uint32_t state = atomic_load_explicit(word, memory_order_relaxed);
+  while (state != RWLOCK_SHARDED_WRITER_NONE) {
+    if (state == RWLOCK_SHARDED_WRITER_SLEEPERS ||
+        atomic_compare_exchange_weak_explicit(
+            word, &state, RWLOCK_SHARDED_WRITER_SLEEPERS, memory_order_relaxed, memory_order_relaxed)) {
+      futex_wait(&rw->writer_active, RWLOCK_SHARDED_WRITER_SLEEPERS, FUTEX_WAIT_INFINITE);
+    }
+
+    state = atomic_load_explicit(word, memory_order_relaxed);
+  }
+
+  profile_func_end;
+}
+
+func void rwlock_sharded_read_lock(rwlock_sharded* rw) {
+  if (rw == NULL) {
+    thread_log_error("Rejected sharded rwlock read lock for invalid lock");
+    return;
+  }
+
+  atomic_u32* slot = rwlock_sharded_thread_slot(rw);
+
+  while (!rwlock_sharded_try_enter(slot, rw)) {
+    rwlock_sharded_wait_for_writer(rw);
+  }
+}
+
+func b32 rwlock_sharded_try_read_lock(rwlock_sharded* rw) {
+  if (rw == NULL) {
+    thread_log_error("Rejected sharded rwlock try read lock for invalid lock");
+    return false;
+  }
+
+  return rwlock_sharded_try_enter(rwlock_sharded_thread_slot(rw), rw);
+}
+
+func void rwlock_sharded_read_unlock(rwlock_sharded* rw) {
+  if (rw == NULL) {
+    thread_log_error("Rejected sharded rwlock read unlock for invalid lock");
+    return;
+  }
+
+  u32 previous = atomic_fetch_sub_explicit(rwlock_sharded_word(rwlock_sharded_thread_slot(rw)), 1, memory_order_release);
+  assert(previous != 0);
+  (void)previous;
+}
+
+func void rwlock_sharded_write_lock(rwlock_sharded* rw) {
+  profile_func_begin;
+  if (rw == NULL) {
+    thread_log_error("Rejected sharded rwlock write lock for invalid lock");
+    profile_func_end;
+    return;
+  }
+
+  futex_mutex_lock(&rw->writer_mutex);
+  atomic_store_explicit(rwlock_sharded_word(&rw->writer_active), RWLOCK_SHARDED_WRITER_ACTIVE, memory_order_seq_cst);
+
+  // New readers back off now, so every slot drains once its current holders
+  // unlock. Read sections are short, so spin briefly before yielding.
+  safe_for (u32 idx = 0; idx < RWLOCK_SHARDED_SLOT_COUNT; idx += 1) {
+    _Atomic uint32_t* slot = rwlock_sharded_word(&rw->slots[idx].reader_count);
+    u32 pauses = 0;
+
+    while (atomic_load_explicit(slot, memory_order_seq_cst) != 0) {
+      if (pauses < RWLOCK_SHARDED_DRAIN_PAUSES) {
+        atomic_pause();
+        pauses += 1;
+      } else {
+        thread_yield();
+      }
+    }
+  }
+
+  profile_func_end;
+}
+
+func void rwlock_sharded_write_unlock(rwlock_sharded* rw) {
+  profile_func_begin;
+  if (rw == NULL) {
+    thread_log_error("Rejected sharded rwlock write unlock for invalid lock");
+    profile_func_end;
+    return;
+  }
+
+  u32 previous =
+      atomic_exchange_explicit(rwlock_sharded_word(&rw->writer_active), RWLOCK_SHARDED_WRITER_NONE, memory_order_release);
+  assert(previous != RWLOCK_SHARDED_WRITER_NONE);
+  if (previous == RWLOCK_SHARDED_WRITER_SLEEPERS) {
+    futex_wake_all(&rw->writer_active);
+  }
+
+  futex_mutex_unlock(&rw->writer_mutex);
+  profile_func_end;
+}
+
+// =========================================================================
+// Sequence Lock
+// =========================================================================
+
+// Reader spins on an odd sequence before it starts yielding to the writer.
+#define SEQLOCK_READ_PAUSES 64
+
+func u32 seqlock_read_begin(seqlock* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected seqlock read begin for invalid lock");
+    return 0;
+  }
+
+  _Atomic uint32_t* word = (_Atomic uint32_t*)(void*)&lock->seq;
+  u32 pauses = 0;
+  u32 seq = atomic_load_explicit(word, memory_order_acquire);
+
+  while ((seq & 1U) != 0) {
+    if (pauses < SEQLOCK_READ_PAUSES) {
+      atomic_pause();
+      pauses += 1;
+    } else {
+      thread_yield();
+    }
+
+    seq = atomic_load_explicit(word, memory_order_acquire);
+  }
+
+  return seq;
+}
+
+func b32 seqlock_read_retry(seqlock* lock, u32 seq) {
+  if (lock == NULL) {
+    thread_log_error("Rejected seqlock read retry for invalid lock");
+    return false;
+  }
+
+  // Keeps the data reads of the section from moving past the sequence check.
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit((_Atomic uint32_t*)(void*)&lock->seq, memory_order_relaxed) != seq;
+}
+
+func void seqlock_write_lock(seqlock* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected seqlock write lock for invalid lock");
+    return;
+  }
+
+  futex_mutex_lock(&lock->writer_mutex);
+  _Atomic uint32_t* word = (_Atomic uint32_t*)(void*)&lock->seq;
+  atomic_store_explicit(word, atomic_load_explicit(word, memory_order_relaxed) + 1, memory_order_relaxed);
+
+  // Makes the odd sequence visible before any of the data writes that follow.
+  atomic_thread_fence(memory_order_release);
+}
+
+func void seqlock_write_unlock(seqlock* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected seqlock write unlock for invalid lock");
+    return;
+  }
+
+  _Atomic uint32_t* word = (_Atomic uint32_t*)(void*)&lock->seq;
+  u32 seq = atomic_load_explicit(word, memory_order_relaxed);
+  assert((seq & 1U) != 0);
+  atomic_store_explicit(word, seq + 1, memory_order_release);
+  futex_mutex_unlock(&lock->writer_mutex);
+}
+
+func void seqlock_read(seqlock* lock, void* dst, void const* src, sz size) {
+  if (lock == NULL || dst == NULL || src == NULL) {
+    thread_log_error("Rejected seqlock read lock=%p dst=%p src=%p", lock, dst, src);
+    return;
+  }
+
+  u32 seq = 0;
+
+  do {
+    seq = seqlock_read_begin(lock);
+    mem_cpy(dst, src, size);
+  } while (seqlock_read_retry(lock, seq));
+}
+
+func void seqlock_write(seqlock* lock, void* dst, void const* src, sz size) {
+  if (lock == NULL || dst == NULL || src == NULL) {
+    thread_log_error("Rejected seqlock write lock=%p dst=%p src=%p", lock, dst, src);
+    return;
+  }
+
+  seqlock_write_lock(lock);
+  mem_cpy(dst, src, size);
+  seqlock_write_unlock(lock);
+}
@@ -9,6 +9,10 @@
 #include "input/msg_core.h"
 #include "../sdl3_include.h"
 #include "basic/profiler.h"
+#include "basic/safe.h"
+#include "threads/thread_current.h"
+
+#include <stdatomic.h>
 
 func spinlock _spinlock_create(callsite site) {
   profile_func_begin;
@@ -26,6 +30,8 @@ func spinlock _spinlock_create(callsite site) {
     profile_func_end;
     return NULL;
   }
+  // Heap memory is recycled; a stale non-zero word would read as locked.
+  *spl = 0;
 
   msg_core_object_lifecycle_data msg_data = {
       .event_kind = MSG_CORE_OBJECT_EVENT_CREATE,
@@ -119,3 +125,142 @@ func b32 spinlock_try_lock(spinlock sl) {
   profile_func_end;
   return res;
 }
+
+// =========================================================================
+// Queue Spinlocks
+// =========================================================================
+
+func _Atomic uint32_t* spinlock_u32_word(atomic_u32* atom) {
+  return (_Atomic uint32_t*)(void*)atom;
+}
+
+func void* _Atomic* spinlock_ptr_word(atomic_ptr* atom) {
+  return (void* _Atomic*)(void*)atom;
+}
+
+// Pauses for *pauses spins and doubles the next wait. Once the backoff is
+// maxed out the thread yields instead, so a preempted owner or next-in-line
+// waiter gets to run when there are more threads than cores.
+func void spinlock_backoff(u32* pauses) {
+  if (*pauses >= SPINLOCK_BACKOFF_MAX_PAUSES) {
+    thread_yield();
+    return;
+  }
+
+  safe_for (u32 idx = 0; idx < *pauses; idx += 1) {
+    atomic_pause();
+  }
+
+  *pauses *= 2;
+}
+
+func void spinlock_ticket_lock(spinlock_ticket* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected ticket spinlock lock for invalid lock");
+    return;
+  }
+
+  u32 ticket = atomic_fetch_add_explicit(spinlock_u32_word(&lock->next), 1, memory_order_relaxed);
+  u32 pauses = SPINLOCK_BACKOFF_MIN_PAUSES;
+
+  while (true) {
+    u32 serving = atomic_load_explicit(spinlock_u32_word(&lock->serving), memory_order_acquire);
+    if (serving == ticket) {
+      return;
+    }
+
+    // Waiters further back in line poll less often, which spares the shared line.
+    u32 ahead = ticket - serving;
+    u64 wait = (u64)pauses * ahead;
+    u32 wait_pauses = wait > SPINLOCK_BACKOFF_MAX_PAUSES ? SPINLOCK_BACKOFF_MAX_PAUSES : (u32)wait;
+    spinlock_backoff(&wait_pauses);
+    pauses = pauses < SPINLOCK_BACKOFF_MAX_PAUSES ? pauses * 2 : pauses;
+  }
+}
+
+func b32 spinlock_ticket_try_lock(spinlock_ticket* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected ticket spinlock try lock for invalid lock");
+    return false;
+  }
+
+  // Take a ticket only if it would be served right away.
+  u32 serving = atomic_load_explicit(spinlock_u32_word(&lock->serving), memory_order_acquire);
+  u32 expected = serving;
+  return atomic_compare_exchange_strong_explicit(
+      spinlock_u32_word(&lock->next), &expected, serving + 1, memory_order_acquire, memory_order_relaxed);
+}
+
+func void spinlock_ticket_unlock(spinlock_ticket* lock) {
+  if (lock == NULL) {
+    thread_log_error("Rejected ticket spinlock unlock for invalid lock");
+    return;
+  }
+
+  // Only the owner writes serving, so a plain increment is enough.
+  u32 serving = atomic_load_explicit(spinlock_u32_word(&lock->serving), memory_order_relaxed);
+  atomic_store_explicit(spinlock_u32_word(&lock->serving), serving + 1, memory_order_release);
+}
+
+func void spinlock_mcs_lock(spinlock_mcs* lock, spinlock_mcs_node* node) {
+  if (lock == NULL || node == NULL) {
+    thread_log_error("Rejected MCS spinlock lock lock=%p node=%p", lock, node);
+    return;
+  }
+
+  atomic_store_explicit(spinlock_ptr_word(&node->next), NULL, memory_order_relaxed);
+  atomic_store_explicit(spinlock_u32_word(&node->is_waiting), 1, memory_order_relaxed);
+
+  spinlock_mcs_node* prev =
+      (spinlock_mcs_node*)atomic_exchange_explicit(spinlock_ptr_word(&lock->tail), node, memory_order_acq_rel);
+  if (prev == NULL) {
+    return;
+  }
+
+  atomic_store_explicit(spinlock_ptr_word(&prev->next), node, memory_order_release);
+
+  u32 pauses = SPINLOCK_BACKOFF_MIN_PAUSES;
+  while (atomic_load_explicit(spinlock_u32_word(&node->is_waiting), memory_order_acquire) != 0) {
+    spinlock_backoff(&pauses);
+  }
+}
+
+func b32 spinlock_mcs_try_lock(spinlock_mcs* lock, spinlock_mcs_node* node) {
+  if (lock == NULL || node == NULL) {
+    thread_log_error("Rejected MCS spinlock try lock lock=%p node=%p", lock, node);
+    return false;
+  }
+
+  atomic_store_explicit(spinlock_ptr_word(&node->next), NULL, memory_order_relaxed);
+  atomic_store_explicit(spinlock_u32_word(&node->is_waiting), 0, memory_order_relaxed);
+
+  void* expected = NULL;
+  return atomic_compare_exchange_strong_explicit(
+      spinlock_ptr_word(&lock->tail), &expected, node, memory_order_acq_rel, memory_order_relaxed);
+}
+
+func void spinlock_mcs_unlock(spinlock_mcs* lock, spinlock_mcs_node* node) {
+  if (lock == NULL || node == NULL) {
+    thread_log_error("Rejected MCS spinlock unlock lock=%p node=%p", lock, node);
+    return;
+  }
+
+  spinlock_mcs_node* next =
+      (spinlock_mcs_node*)atomic_load_explicit(spinlock_ptr_word(&node->next), memory_order_acquire);
+  if (next == NULL) {
+    // No known successor: release the lock unless one is enqueueing right now.
+    void* expected = node;
+    if (atomic_compare_exchange_strong_explicit(
+            spinlock_ptr_word(&lock->tail), &expected, NULL, memory_order_release, memory_order_relaxed)) {
+      return;
+    }
+
+    u32 pauses = SPINLOCK_BACKOFF_MIN_PAUSES;
+    while ((next = (spinlock_mcs_node*)atomic_load_explicit(spinlock_ptr_word(&node->next), memory_order_acquire)) ==
+           NULL) {
+      spinlock_backoff(&pauses);
+    }
+  }
+
+  atomic_store_explicit(spinlock_u32_word(&next->is_waiting), 0, memory_order_release);
+}
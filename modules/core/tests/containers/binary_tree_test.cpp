@@ -264,3 +264,195 @@ TEST(containers_binary_tree_test, foreach_postorder) {
   EXPECT_EQ(2, order[1]);
   EXPECT_EQ(3, order[2]);
 }
+
+namespace {
+
+  struct rb_node {
+    struct rb_node* left;
+    struct rb_node* right;
+    struct rb_node* parent;
+    u8 color;
+    i32 key;
+    i32 order;
+  };
+
+  i32 rb_compare(rb_node const* lhs, rb_node const* rhs) {
+    return lhs->key < rhs->key ? -1 : lhs->key > rhs->key;
+  }
+
+  i32 rb_compare_key(i32 key, rb_node const* node) {
+    return key < node->key ? -1 : key > node->key;
+  }
+
+  // Checks links, key order and both red-black rules below node.
+  // Returns the black height, counting NULL leaves as one.
+  i32 rb_check(rb_node const* node, rb_node const* parent, sz* count) {
+    if (node == NULL) {
+      return 1;
+    }
+    EXPECT_EQ(parent, node->parent);
+    if (node->color == BINARY_TREE_RB_RED) {
+      EXPECT_FALSE(BINARY_TREE_RB_IS_RED(node->left));
+      EXPECT_FALSE(BINARY_TREE_RB_IS_RED(node->right));
+    }
+    if (node->left != NULL) {
+      EXPECT_LE(node->left->key, node->key);
+    }
+    if (node->right != NULL) {
+      EXPECT_GE(node->right->key, node->key);
+    }
+    *count += 1;
+    i32 left_height = rb_check(node->left, node, count);
+    i32 right_height = rb_check(node->right, node, count);
+    EXPECT_EQ(left_height, right_height);
+    return left_height + (node->color == BINARY_TREE_RB_BLACK ? 1 : 0);
+  }
+
+  i32 rb_depth(rb_node const* node) {
+    if (node == NULL) {
+      return 0;
+    }
+    i32 left_depth = rb_depth(node->left);
+    i32 right_depth = rb_depth(node->right);
+    return 1 + (left_depth > right_depth ? left_depth : right_depth);
+  }
+
+  void rb_check_tree(rb_node const* root, sz expected_count) {
+    sz count = 0;
+    if (root != NULL) {
+      EXPECT_EQ(BINARY_TREE_RB_BLACK, root->color);
+    }
+    rb_check(root, NULL, &count);
+    EXPECT_EQ(expected_count, count);
+    // A red-black tree is never deeper than 2 * log2(n + 1).
+    i32 limit = 0;
+    for (sz span = expected_count + 1; span > 1; span /= 2) {
+      limit += 2;
+    }
+    EXPECT_LE(rb_depth(root), limit + 2);
+  }
+
+}  // namespace
+
+TEST(containers_binary_tree_test, rb_sorted_insert_stays_balanced) {
+  constexpr i32 count = 4096;
+  static rb_node nodes[count];
+  rb_node* root = NULL;
+  for (i32 idx = 0; idx < count; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].key = idx;
+    BINARY_TREE_RB_INSERT(&root, &nodes[idx], rb_compare);
+  }
+  rb_check_tree(root, count);
+  // An unbalanced tree would be 4096 deep here.
+  EXPECT_LE(rb_depth(root), 24);
+
+  i32 expected = 0;
+  BINARY_TREE_FOREACH_INORDER(root, it) {
+    EXPECT_EQ(expected, it->key);
+    expected++;
+  }
+  EXPECT_EQ(count, expected);
+
+  rb_node* found = NULL;
+  BINARY_TREE_FIND(root, 1234, rb_compare_key, found);
+  EXPECT_EQ(&nodes[1234], found);
+  BINARY_TREE_FIND(root, count, rb_compare_key, found);
+  EXPECT_EQ(nullptr, found);
+}
+
+TEST(containers_binary_tree_test, rb_remove_keeps_invariants) {
+  constexpr i32 count = 2000;
+  static rb_node nodes[count];
+  rb_node* root = NULL;
+  // Keys 0, 7, 14, ... inserted in a scrambled order.
+  for (i32 idx = 0; idx < count; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].key = ((idx * 733) % count) * 7;
+    BINARY_TREE_RB_INSERT(&root, &nodes[idx], rb_compare);
+  }
+  rb_check_tree(root, count);
+
+  sz remaining = count;
+  for (i32 idx = 0; idx < count; idx += 2) {
+    BINARY_TREE_RB_REMOVE(&root, &nodes[idx]);
+    remaining--;
+    EXPECT_EQ(nullptr, nodes[idx].parent);
+    if (idx % 250 == 0) {
+      rb_check_tree(root, remaining);
+    }
+  }
+  rb_check_tree(root, remaining);
+
+  for (i32 idx = 0; idx < count; ++idx) {
+    rb_node* found = NULL;
+    BINARY_TREE_FIND(root, nodes[idx].key, rb_compare_key, found);
+    EXPECT_EQ(idx % 2 == 0 ? nullptr : &nodes[idx], found);
+  }
+
+  // Removed nodes can go straight back in.
+  for (i32 idx = 0; idx < count; idx += 2) {
+    BINARY_TREE_RB_INSERT(&root, &nodes[idx], rb_compare);
+  }
+  rb_check_tree(root, count);
+
+  for (i32 idx = count - 1; idx >= 0; --idx) {
+    BINARY_TREE_RB_REMOVE(&root, &nodes[idx]);
+  }
+  EXPECT_EQ(nullptr, root);
+}
+
+TEST(containers_binary_tree_test, rb_duplicates_and_lower_bound) {
+  static rb_node nodes[300];
+  rb_node* root = NULL;
+  for (i32 idx = 0; idx < 300; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].key = (idx % 100) * 10;
+    nodes[idx].order = idx;
+    BINARY_TREE_RB_INSERT(&root, &nodes[idx], rb_compare);
+  }
+  rb_check_tree(root, 300);
+
+  // Equal keys keep their insertion order.
+  i32 prev_key = -1;
+  i32 prev_order = -1;
+  BINARY_TREE_FOREACH_INORDER(root, it) {
+    if (it->key == prev_key) {
+      EXPECT_GT(it->order, prev_order);
+    }
+    prev_key = it->key;
+    prev_order = it->order;
+  }
+
+  rb_node* lower = NULL;
+  BINARY_TREE_LOWER_BOUND(root, 55, rb_compare_key, lower);
+  ASSERT_NE(nullptr, lower);
+  EXPECT_EQ(60, lower->key);
+  // The leftmost of the equal keys is the first one inserted.
+  BINARY_TREE_LOWER_BOUND(root, 60, rb_compare_key, lower);
+  EXPECT_EQ(&nodes[6], lower);
+  BINARY_TREE_LOWER_BOUND(root, 991, rb_compare_key, lower);
+  EXPECT_EQ(nullptr, lower);
+}
+
+TEST(containers_binary_tree_test, rb_insert_fixup_after_manual_link) {
+  static rb_node nodes[64];
+  rb_node* root = NULL;
+  for (i32 idx = 0; idx < 64; ++idx) {
+    rb_node* node = &nodes[idx];
+    *node = {};
+    node->key = idx;
+    if (root == NULL) {
+      root = node;
+    } else {
+      // Ascending keys always go to the far right.
+      rb_node* parent_node = root;
+      while (parent_node->right != NULL) {
+        parent_node = parent_node->right;
+      }
+      BINARY_TREE_INSERT_RIGHT(parent_node, node);
+    }
+    BINARY_TREE_RB_INSERT_FIXUP(&root, node);
+  }
+  rb_check_tree(root, 64);
+}
@@ -0,0 +1,405 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+namespace {
+
+  // Walks the whole tree and checks key order, separator bounds, minimum fill
+  // and uniform leaf depth. Returns the number of entries below node.
+  sz check_node(btree_map_node const* node, u32 depth, u32 height, b32 is_root, u64 lo, u64 hi, b32 has_hi) {
+    EXPECT_LE(node->count, (u16)BTREE_MAP_NODE_KEYS);
+    for (u32 idx = 0; idx < node->count; ++idx) {
+      EXPECT_GE(node->keys[idx], lo);
+      if (has_hi) {
+        EXPECT_LT(node->keys[idx], hi);
+      }
+      if (idx > 0) {
+        EXPECT_LT(node->keys[idx - 1], node->keys[idx]);
+      }
+    }
+    if (node->is_leaf) {
+      EXPECT_EQ(height, depth + 1);
+      if (!is_root) {
+        EXPECT_GE(node->count, (u16)BTREE_MAP_LEAF_MIN_KEYS);
+      }
+      return node->count;
+    }
+    EXPECT_GE(node->count, is_root ? 1 : (u16)BTREE_MAP_INTERNAL_MIN_KEYS);
+    sz total = 0;
+    for (u32 idx = 0; idx <= node->count; ++idx) {
+      u64 child_lo = idx > 0 ? node->keys[idx - 1] : lo;
+      b32 child_has_hi = idx < node->count ? true : has_hi;
+      u64 child_hi = idx < node->count ? node->keys[idx] : hi;
+      total += check_node((btree_map_node const*)node->slots[idx], depth + 1, height, false, child_lo, child_hi, child_has_hi);
+    }
+    return total;
+  }
+
+  void check_tree(btree_map* map) {
+    if (map->root == NULL) {
+      EXPECT_EQ(0U, btree_map_count(map));
+      EXPECT_EQ(0U, btree_map_height(map));
+      return;
+    }
+    EXPECT_EQ(btree_map_count(map), check_node(map->root, 0, map->height, true, 0, 0, false));
+
+    sz chained = 0;
+    b32 has_prev = false;
+    u64 prev = 0;
+    BTREE_MAP_FOREACH(map, it) {
+      if (has_prev) {
+        EXPECT_LT(prev, btree_map_iter_key(it));
+      }
+      prev = btree_map_iter_key(it);
+      has_prev = true;
+      chained++;
+    }
+    EXPECT_EQ(btree_map_count(map), chained);
+  }
+
+  // Fixed-seed xorshift so the shuffled orders are reproducible.
+  u64 next_random(u64* state) {
+    u64 x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+  }
+
+  void shuffle(u64* keys, sz count, u64 seed) {
+    for (sz idx = count; idx > 1; --idx) {
+      sz other = (sz)(next_random(&seed) % idx);
+      u64 tmp = keys[idx - 1];
+      keys[idx - 1] = keys[other];
+      keys[other] = tmp;
+    }
+  }
+
+  struct range_sum {
+    u64 sum;
+    sz limit;
+    sz seen;
+  };
+
+  b32 sum_visit(u64 key, void* value, void* user_data) {
+    range_sum* acc = static_cast<range_sum*>(user_data);
+    EXPECT_EQ((void*)(up)(key + 1), value);
+    acc->sum += key;
+    acc->seen++;
+    return acc->limit == 0 || acc->seen < acc->limit;
+  }
+
+}  // namespace
+
+TEST(containers_btree_map_test, create_destroy) {
+  allocator zero_alloc = {0};
+  btree_map map = btree_map_create(zero_alloc);
+  EXPECT_EQ(0U, btree_map_count(&map));
+  EXPECT_EQ(0U, btree_map_height(&map));
+  EXPECT_EQ(NULL, btree_map_get(&map, 1));
+  EXPECT_EQ(0, btree_map_remove(&map, 1));
+  EXPECT_EQ(0, btree_map_iter_valid(btree_map_first(&map)));
+  EXPECT_EQ(0, btree_map_iter_valid(btree_map_lower_bound(&map, 0)));
+
+  // Nodes are pool slots starting on a cache line.
+  EXPECT_EQ(sizeof(btree_map_node), pool_slot_size(&map.nodes));
+  EXPECT_NE(0, btree_map_set(&map, 1, NULL));
+  EXPECT_NE(0, btree_map_set(&map, 2, NULL));
+  EXPECT_EQ(0U, (up)map.root % ARCH_CACHE_LINE_SIZE);
+
+  btree_map_destroy(&map);
+  EXPECT_EQ(0U, btree_map_count(&map));
+}
+
+TEST(containers_btree_map_test, set_get_ordered) {
+  allocator zero_alloc = {0};
+  btree_map map = btree_map_create(zero_alloc);
+
+  constexpr sz count = 5000;
+  static u64 keys[count];
+  for (sz idx = 0; idx < count; ++idx) {
+    keys[idx] = idx * 3;
+  }
+  shuffle(keys, count, 0x9E3779B97F4A7C15ULL);
+  for (sz idx = 0; idx < count; ++idx) {
+    EXPECT_NE(0, btree_map_set(&map, keys[idx], (void*)(up)(keys[idx] + 1)));
+  }
+  EXPECT_EQ(count, btree_map_count(&map));
+  EXPECT_GE(btree_map_height(&map), 3U);
+  check_tree(&map);
+
+  EXPECT_EQ((void*)(up)31, btree_map_get(&map, 30));
+  EXPECT_EQ(NULL, btree_map_get(&map, 31));
+  EXPECT_NE(0, btree_map_has(&map, (count - 1) * 3));
+
+  // Replacing keeps the count.
+  EXPECT_NE(0, btree_map_set(&map, 30, (void*)(up)7));
+  EXPECT_EQ(count, btree_map_count(&map));
+  EXPECT_EQ((void*)(up)7, btree_map_get(&map, 30));
+  btree_map_set(&map, 30, (void*)(up)31);
+
+  u64 expected = 0;
+  BTREE_MAP_FOREACH(&map, it) {
+    EXPECT_EQ(expected, btree_map_iter_key(it));
+    EXPECT_EQ((void*)(up)(expected + 1), btree_map_iter_value(it));
+    expected += 3;
+  }
+  EXPECT_EQ(count * 3, expected);
+
+  btree_map_clear(&map);
+  EXPECT_EQ(0U, btree_map_count(&map));
+  EXPECT_EQ(0, btree_map_has(&map, 30));
+  EXPECT_NE(0, btree_map_set(&map, 1, NULL));
+  EXPECT_EQ(1U, btree_map_count(&map));
+
+  btree_map_destroy(&map);
+}
+
+TEST(containers_btree_map_test, remove_rebalances) {
+  allocator zero_alloc = {0};
+  btree_map map = btree_map_create(zero_alloc);
+
+  constexpr sz count = 4000;
+  static u64 keys[count];
+  for (sz idx = 0; idx < count; ++idx) {
+    keys[idx] = idx;
+    btree_map_set(&map, idx, (void*)(up)(idx + 1));
+  }
+  sz free_before = pool_free_count(&map.nodes);
+
+  // Remove every other key in random order, then the rest in ascending order,
+  // so borrows and merges happen on both sides.
+  shuffle(keys, count, 12345);
+  sz removed = 0;
+  for (sz idx = 0; idx < count; ++idx) {
+    if (keys[idx] % 2 == 0) {
+      EXPECT_NE(0, btree_map_remove(&map, keys[idx]));
+      removed++;
+    }
+  }
+  EXPECT_EQ(0, btree_map_remove(&map, 0));
+  EXPECT_EQ(count - removed, btree_map_count(&map));
+  check_tree(&map);
+  EXPECT_GT(pool_free_count(&map.nodes), free_before);
+
+  for (u64 key = 0; key < count; ++key) {
+    EXPECT_EQ(key % 2 == 1, btree_map_has(&map, key) != 0);
+  }
+
+  for (u64 key = 1; key < count; key += 2) {
+    EXPECT_NE(0, btree_map_remove(&map, key));
+    if (key % 501 == 0) {
+      check_tree(&map);
+    }
+  }
+  EXPECT_EQ(0U, btree_map_count(&map));
+  EXPECT_EQ(0U, btree_map_height(&map));
+  EXPECT_EQ(0, btree_map_iter_valid(btree_map_first(&map)));
+  check_tree(&map);
+
+  btree_map_destroy(&map);
+}
+
+TEST(containers_btree_map_test, bounds_and_range) {
+  allocator zero_alloc = {0};
+  btree_map map = btree_map_create(zero_alloc);
+  for (u64 key = 10; key <= 10000; key += 10) {
+    btree_map_set(&map, key, (void*)(up)(key + 1));
+  }
+
+  btree_map_iter it = btree_map_lower_bound(&map, 25);
+  ASSERT_NE(0, btree_map_iter_valid(it));
+  EXPECT_EQ(30U, btree_map_iter_key(it));
+  it = btree_map_lower_bound(&map, 30);
+  EXPECT_EQ(30U, btree_map_iter_key(it));
+  it = btree_map_upper_bound(&map, 30);
+  EXPECT_EQ(40U, btree_map_iter_key(it));
+  it = btree_map_lower_bound(&map, 0);
+  EXPECT_EQ(10U, btree_map_iter_key(it));
+  EXPECT_EQ(0, btree_map_iter_valid(btree_map_lower_bound(&map, 10001)));
+  EXPECT_EQ(0, btree_map_iter_valid(btree_map_upper_bound(&map, 10000)));
+
+  // Every leaf boundary is crossed by lower_bound on a missing key.
+  for (u64 key = 11; key < 10000; key += 10) {
+    it = btree_map_lower_bound(&map, key);
+    ASSERT_NE(0, btree_map_iter_valid(it));
+    EXPECT_EQ(key + 9, btree_map_iter_key(it));
+  }
+
+  range_sum acc = {};
+  EXPECT_EQ(11U, btree_map_range(&map, 1000, 1100, sum_visit, &acc));
+  EXPECT_EQ(11U * 1050U, acc.sum);
+
+  acc = {};
+  EXPECT_EQ(1000U, btree_map_range(&map, 0, U64_MAX, sum_visit, &acc));
+  EXPECT_EQ(10U * 1000U * 1001U / 2, acc.sum);
+
+  acc = {};
+  acc.limit = 5;
+  EXPECT_EQ(5U, btree_map_range(&map, 500, 9000, sum_visit, &acc));
+  EXPECT_EQ(500U + 510U + 520U + 530U + 540U, acc.sum);
+
+  acc = {};
+  EXPECT_EQ(0U, btree_map_range(&map, 11, 19, sum_visit, &acc));
+  EXPECT_EQ(0U, btree_map_range(&map, 100, 50, sum_visit, &acc));
+
+  btree_map_destroy(&map);
+}
+
+TEST(containers_btree_map_test, bulk_load) {
+  allocator zero_alloc = {0};
+  btree_map map = btree_map_create(zero_alloc);
+
+  constexpr sz count = 20000;
+  static u64 keys[count];
+  static void* values[count];
+  for (sz idx = 0; idx < count; ++idx) {
+    keys[idx] = idx * 2 + 1;
+    values[idx] = (void*)(up)(keys[idx] + 1);
+  }
+
+  u64 unsorted[3] = {1, 3, 3};
+  EXPECT_EQ(0, btree_map_bulk_load(&map, unsorted, NULL, 3));
+  EXPECT_EQ(0U, btree_map_count(&map));
+
+  EXPECT_NE(0, btree_map_bulk_load(&map, keys, values, count));
+  EXPECT_EQ(count, btree_map_count(&map));
+  check_tree(&map);
+  EXPECT_EQ((void*)(up)(4001 + 1), btree_map_get(&map, 4001));
+  EXPECT_EQ(NULL, btree_map_get(&map, 4000));
+
+  // Only empty maps can be bulk loaded.
+  EXPECT_EQ(0, btree_map_bulk_load(&map, keys, values, count));
+
+  // The loaded tree accepts regular updates, splitting its full leaves.
+  for (u64 key = 0; key < count * 2; key += 2) {
+    EXPECT_NE(0, btree_map_set(&map, key, (void*)(up)(key + 1)));
+  }
+  for (u64 key = 1; key < count * 2; key += 4) {
+    EXPECT_NE(0, btree_map_remove(&map, key));
+  }
+  EXPECT_EQ(count + count / 2, btree_map_count(&map));
+  check_tree(&map);
+
+  // Every size up to a few levels builds a valid tree.
+  for (sz size = 0; size < 1000; size += 37) {
+    btree_map_clear(&map);
+    EXPECT_NE(0, btree_map_bulk_load(&map, keys, NULL, size));
+    EXPECT_EQ(size, btree_map_count(&map));
+    check_tree(&map);
+  }
+
+  btree_map_destroy(&map);
+}
+
+namespace {
+
+  b32 count_visit(u64 key, void* value, void* user_data) {
+    (void)value;
+    *static_cast<u64*>(user_data) += key;
+    return true;
+  }
+
+}  // namespace
+
+// Compares inserts, point lookups and range scans against hash_map, which has
+// to probe every key of a range. Results are logged only; timing is too noisy
+// to assert on.
+TEST(containers_btree_map_test, benchmark_vs_hash_map) {
+  allocator zero_alloc = {0};
+  // hash_map rehashes with bounded loops, which caps it near 7500 entries.
+  constexpr sz count = 6000;
+  constexpr u64 span = 200;
+  constexpr sz range_queries = 2000;
+  static u64 keys[count];
+  for (sz idx = 0; idx < count; ++idx) {
+    keys[idx] = idx;
+  }
+  shuffle(keys, count, 777);
+
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  btree_map tree = btree_map_create(zero_alloc);
+  auto start = std::chrono::steady_clock::now();
+  for (sz idx = 0; idx < count; ++idx) {
+    btree_map_set(&tree, keys[idx], (void*)(up)(keys[idx] + 1));
+  }
+  f64 tree_insert_ms = elapsed_ms(start);
+
+  hash_map hashed = hash_map_create(16, zero_alloc);
+  start = std::chrono::steady_clock::now();
+  for (sz idx = 0; idx < count; ++idx) {
+    hash_map_set(&hashed, keys[idx], (void*)(up)(keys[idx] + 1));
+  }
+  f64 hash_insert_ms = elapsed_ms(start);
+
+  u64 tree_sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (sz idx = 0; idx < count; ++idx) {
+    tree_sum += (u64)(up)btree_map_get(&tree, keys[idx]);
+  }
+  f64 tree_get_ms = elapsed_ms(start);
+
+  u64 hash_sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (sz idx = 0; idx < count; ++idx) {
+    hash_sum += (u64)(up)hash_map_get(&hashed, keys[idx]);
+  }
+  f64 hash_get_ms = elapsed_ms(start);
+  EXPECT_EQ(tree_sum, hash_sum);
+
+  u64 tree_range = 0;
+  start = std::chrono::steady_clock::now();
+  for (sz query = 0; query < range_queries; ++query) {
+    u64 lo = keys[query] % (count - span);
+    btree_map_range(&tree, lo, lo + span - 1, count_visit, &tree_range);
+  }
+  f64 tree_range_ms = elapsed_ms(start);
+
+  u64 hash_range = 0;
+  start = std::chrono::steady_clock::now();
+  for (sz query = 0; query < range_queries; ++query) {
+    u64 lo = keys[query] % (count - span);
+    for (u64 key = lo; key < lo + span; ++key) {
+      if (hash_map_has(&hashed, key)) {
+        hash_range += key;
+      }
+    }
+  }
+  f64 hash_range_ms = elapsed_ms(start);
+  EXPECT_EQ(tree_range, hash_range);
+
+  btree_map tree_bulk = btree_map_create(zero_alloc);
+  static void* values[count];
+  for (sz idx = 0; idx < count; ++idx) {
+    keys[idx] = idx;
+    values[idx] = (void*)(up)(idx + 1);
+  }
+  start = std::chrono::steady_clock::now();
+  EXPECT_NE(0, btree_map_bulk_load(&tree_bulk, keys, values, count));
+  f64 bulk_ms = elapsed_ms(start);
+
+  thread_log_info("btree_map vs hash_map (%llu keys): insert %.2f / %.2f ms, get %.2f / %.2f ms, "
+                  "%llu range scans of %llu keys %.2f / %.2f ms, bulk load %.2f ms (height %u)",
+                  (unsigned long long)count,
+                  tree_insert_ms,
+                  hash_insert_ms,
+                  tree_get_ms,
+                  hash_get_ms,
+                  (unsigned long long)range_queries,
+                  (unsigned long long)span,
+                  tree_range_ms,
+                  hash_range_ms,
+                  bulk_ms,
+                  btree_map_height(&tree_bulk));
+
+  btree_map_destroy(&tree_bulk);
+  hash_map_destroy(&hashed);
+  btree_map_destroy(&tree);
+}
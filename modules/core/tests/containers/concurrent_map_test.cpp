@@ -0,0 +1,228 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+TEST(containers_concurrent_map_test, create_destroy) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(5, 100, zero_alloc);
+
+  EXPECT_EQ(8U, concurrent_map_shard_count(&map));
+  EXPECT_EQ(0U, concurrent_map_count(&map));
+
+  concurrent_map_destroy(&map);
+  EXPECT_EQ(0U, concurrent_map_shard_count(&map));
+
+  map = concurrent_map_create(0, 0, zero_alloc);
+  EXPECT_EQ((u32)CONCURRENT_MAP_DEFAULT_SHARDS, concurrent_map_shard_count(&map));
+  concurrent_map_destroy(&map);
+}
+
+TEST(containers_concurrent_map_test, set_get_remove) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(4, 0, zero_alloc);
+
+  for (u64 key = 1; key <= 500; ++key) {
+    EXPECT_NE(0, concurrent_map_set(&map, key, (void*)(up)(key * 10)));
+  }
+  EXPECT_EQ(500U, concurrent_map_count(&map));
+  EXPECT_EQ((void*)(up)70, concurrent_map_get(&map, 7));
+  EXPECT_EQ(NULL, concurrent_map_get(&map, 501));
+
+  EXPECT_NE(0, concurrent_map_remove(&map, 7));
+  EXPECT_EQ(0, concurrent_map_remove(&map, 7));
+  EXPECT_EQ(0, concurrent_map_has(&map, 7));
+  EXPECT_EQ(499U, concurrent_map_count(&map));
+
+  // get_or_set keeps the first value.
+  EXPECT_EQ((void*)(up)80, concurrent_map_get_or_set(&map, 8, (void*)(up)1));
+  EXPECT_EQ((void*)(up)2, concurrent_map_get_or_set(&map, 7, (void*)(up)2));
+  EXPECT_EQ((void*)(up)2, concurrent_map_get(&map, 7));
+
+  concurrent_map_clear(&map);
+  EXPECT_EQ(0U, concurrent_map_count(&map));
+
+  concurrent_map_destroy(&map);
+}
+
+TEST(containers_concurrent_map_test, reserve_snapshot_stats) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(4, 0, zero_alloc);
+  EXPECT_NE(0, concurrent_map_reserve(&map, 1000));
+
+  sz caps[4] = {0};
+  for (u32 idx = 0; idx < 4; ++idx) {
+    concurrent_map_shard_stats stats = {};
+    EXPECT_NE(0, concurrent_map_get_shard_stats(&map, idx, &stats));
+    caps[idx] = stats.capacity;
+  }
+
+  for (u64 key = 0; key < 1000; ++key) {
+    concurrent_map_set(&map, key, (void*)(up)(key + 1));
+  }
+  sz total = 0;
+  u64 writes = 0;
+  for (u32 idx = 0; idx < 4; ++idx) {
+    concurrent_map_shard_stats stats = {};
+    EXPECT_NE(0, concurrent_map_get_shard_stats(&map, idx, &stats));
+    // Reserved shards absorb an even spread without rehashing.
+    EXPECT_EQ(caps[idx], stats.capacity);
+    EXPECT_GT(stats.count, 0U);
+    total += stats.count;
+    writes += stats.writes;
+  }
+  concurrent_map_shard_stats stats = {};
+  EXPECT_EQ(0, concurrent_map_get_shard_stats(&map, 4, &stats));
+  EXPECT_EQ(1000U, total);
+  EXPECT_EQ(1000U, writes);
+
+  concurrent_map_entries snapshot = concurrent_map_snapshot(&map, zero_alloc);
+  EXPECT_EQ(1000U, snapshot.count);
+  u64 key_sum = 0;
+  for (sz idx = 0; idx < snapshot.count; ++idx) {
+    EXPECT_EQ((void*)(up)(snapshot.data[idx].key + 1), snapshot.data[idx].value);
+    key_sum += snapshot.data[idx].key;
+  }
+  EXPECT_EQ(999U * 1000U / 2, key_sum);
+  concurrent_map_entries_destroy(&snapshot);
+
+  concurrent_map_destroy(&map);
+}
+
+// A single shard far beyond the safe-loop limit must snapshot completely.
+TEST(containers_concurrent_map_test, snapshot_large_shard) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(1, 0, zero_alloc);
+  constexpr u64 large_count = 50000;
+  for (u64 key = 1; key <= large_count; ++key) {
+    ASSERT_NE(0, concurrent_map_set(&map, key, (void*)(up)(key * 2)));
+  }
+
+  concurrent_map_entries snapshot = concurrent_map_snapshot(&map, zero_alloc);
+  ASSERT_EQ(large_count, snapshot.count);
+  u64 key_sum = 0;
+  for (sz idx = 0; idx < snapshot.count; ++idx) {
+    EXPECT_EQ((void*)(up)(snapshot.data[idx].key * 2), snapshot.data[idx].value);
+    key_sum += snapshot.data[idx].key;
+  }
+  EXPECT_EQ(large_count * (large_count + 1) / 2, key_sum);
+  concurrent_map_entries_destroy(&snapshot);
+  EXPECT_EQ(nullptr, snapshot.data);
+
+  concurrent_map_destroy(&map);
+}
+
+namespace {
+
+  constexpr u32 cmap_thread_count = 4;
+  constexpr u64 cmap_keys_per_thread = 2000;
+  constexpr u64 cmap_reads_per_write = 4;
+
+  // Each thread writes its own key range, then reads back every key it wrote
+  // while the other threads are still writing theirs.
+  struct concurrent_map_workload {
+    concurrent_map* map;
+    atomic_i32 failures;
+  };
+
+  i32 concurrent_map_worker(u32 idx, void* arg) {
+    concurrent_map_workload* work = static_cast<concurrent_map_workload*>(arg);
+    u64 base = (u64)idx * cmap_keys_per_thread;
+    for (u64 key = base; key < base + cmap_keys_per_thread; ++key) {
+      concurrent_map_set(work->map, key, (void*)(up)(key + 1));
+      for (u64 read = 0; read < cmap_reads_per_write; ++read) {
+        if (concurrent_map_get(work->map, key) != (void*)(up)(key + 1)) {
+          atomic_i32_add(&work->failures, 1);
+        }
+      }
+    }
+    return 0;
+  }
+
+  // Baseline: one hash_map behind one rwlock.
+  struct locked_map_workload {
+    hash_map* map;
+    rwlock lock;
+    atomic_i32 failures;
+  };
+
+  i32 locked_map_worker(u32 idx, void* arg) {
+    locked_map_workload* work = static_cast<locked_map_workload*>(arg);
+    u64 base = (u64)idx * cmap_keys_per_thread;
+    for (u64 key = base; key < base + cmap_keys_per_thread; ++key) {
+      rwlock_write_lock(work->lock);
+      hash_map_set(work->map, key, (void*)(up)(key + 1));
+      rwlock_write_unlock(work->lock);
+      for (u64 read = 0; read < cmap_reads_per_write; ++read) {
+        rwlock_read_lock(work->lock);
+        void* value = hash_map_get(work->map, key);
+        rwlock_read_unlock(work->lock);
+        if (value != (void*)(up)(key + 1)) {
+          atomic_i32_add(&work->failures, 1);
+        }
+      }
+    }
+    return 0;
+  }
+
+  f64 run_workload(thread_group_func entry, void* arg) {
+    auto start = std::chrono::steady_clock::now();
+    thread_group group = thread_group_create(cmap_thread_count, entry, arg, thread_get_setup());
+    EXPECT_NE(0, thread_group_is_valid(group));
+    thread_group_join_all(group, NULL);
+    thread_group_destroy(group);
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}  // namespace
+
+TEST(containers_concurrent_map_test, threads) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(0, 0, zero_alloc);
+  concurrent_map_workload work = {};
+  work.map = &map;
+
+  run_workload(concurrent_map_worker, &work);
+
+  EXPECT_EQ(0, atomic_i32_get(&work.failures));
+  EXPECT_EQ(cmap_thread_count * cmap_keys_per_thread, concurrent_map_count(&map));
+  concurrent_map_destroy(&map);
+}
+
+// Times the same write-heavy workload against a single rwlock-wrapped hash_map.
+// Results are logged only; timing is too noisy to assert on.
+TEST(containers_concurrent_map_test, benchmark_vs_rwlock_hash_map) {
+  allocator zero_alloc = {0};
+  concurrent_map map = concurrent_map_create(0, 0, zero_alloc);
+  concurrent_map_workload work = {};
+  work.map = &map;
+  f64 sharded_ms = run_workload(concurrent_map_worker, &work);
+  EXPECT_EQ(0, atomic_i32_get(&work.failures));
+
+  u64 contended = 0;
+  for (u32 idx = 0; idx < concurrent_map_shard_count(&map); ++idx) {
+    concurrent_map_shard_stats stats = {};
+    concurrent_map_get_shard_stats(&map, idx, &stats);
+    contended += stats.contended;
+  }
+  concurrent_map_destroy(&map);
+
+  hash_map locked = hash_map_create(16, zero_alloc);
+  locked_map_workload locked_work = {};
+  locked_work.map = &locked;
+  locked_work.lock = rwlock_create();
+  f64 locked_ms = run_workload(locked_map_worker, &locked_work);
+  EXPECT_EQ(0, atomic_i32_get(&locked_work.failures));
+  EXPECT_EQ(cmap_thread_count * cmap_keys_per_thread, hash_map_count(&locked));
+  rwlock_destroy(locked_work.lock);
+  hash_map_destroy(&locked);
+
+  thread_log_info("concurrent_map %.2f ms (%llu contended locks), rwlock+hash_map %.2f ms (%u threads, %llu keys each)",
+                  sharded_ms,
+                  (unsigned long long)contended,
+                  locked_ms,
+                  cmap_thread_count,
+                  (unsigned long long)cmap_keys_per_thread);
+}
@@ -0,0 +1,256 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+TEST(containers_mpmc_queue_test, create_destroy) {
+  allocator zero_alloc = {0};
+  mpmc_queue que = mpmc_queue_create(100, zero_alloc);
+
+  EXPECT_EQ(128U, mpmc_queue_capacity(&que));
+  EXPECT_EQ(0U, mpmc_queue_count(&que));
+
+  mpmc_queue_destroy(&que);
+  EXPECT_EQ(0U, mpmc_queue_capacity(&que));
+}
+
+TEST(containers_mpmc_queue_test, push_pop_fifo) {
+  allocator zero_alloc = {0};
+  mpmc_queue que = mpmc_queue_create(4, zero_alloc);
+
+  // Several laps around the cell array.
+  for (up round = 0; round < 5; ++round) {
+    for (up idx = 1; idx <= 4; ++idx) {
+      EXPECT_NE(0, mpmc_queue_try_push(&que, (void*)(round * 10 + idx)));
+    }
+    EXPECT_EQ(0, mpmc_queue_try_push(&que, (void*)99));
+    EXPECT_EQ(4U, mpmc_queue_count(&que));
+
+    for (up idx = 1; idx <= 4; ++idx) {
+      void* val = NULL;
+      EXPECT_NE(0, mpmc_queue_try_pop(&que, &val));
+      EXPECT_EQ((void*)(round * 10 + idx), val);
+    }
+    void* val = NULL;
+    EXPECT_EQ(0, mpmc_queue_try_pop(&que, &val));
+  }
+
+  mpmc_queue_destroy(&que);
+}
+
+TEST(containers_mpmc_queue_test, batch) {
+  allocator zero_alloc = {0};
+  mpmc_queue que = mpmc_queue_create(8, zero_alloc);
+
+  void* in[12];
+  for (up idx = 0; idx < 12; ++idx) {
+    in[idx] = (void*)(idx + 1);
+  }
+  EXPECT_EQ(5U, mpmc_queue_try_push_batch(&que, in, 5));
+  EXPECT_EQ(3U, mpmc_queue_try_push_batch(&que, in + 5, 7));
+  EXPECT_EQ(0U, mpmc_queue_try_push_batch(&que, in + 8, 4));
+
+  void* out[12] = {0};
+  EXPECT_EQ(6U, mpmc_queue_try_pop_batch(&que, out, 6));
+  EXPECT_EQ(2U, mpmc_queue_try_pop_batch(&que, out + 6, 6));
+  for (up idx = 0; idx < 8; ++idx) {
+    EXPECT_EQ(in[idx], out[idx]);
+  }
+  EXPECT_EQ(0U, mpmc_queue_try_pop_batch(&que, out, 6));
+
+  // A batch that wraps around the end of the cell array.
+  EXPECT_EQ(8U, mpmc_queue_try_push_batch(&que, in + 4, 8));
+  EXPECT_EQ(8U, mpmc_queue_try_pop_batch(&que, out, 12));
+  EXPECT_EQ(in[4], out[0]);
+  EXPECT_EQ(in[11], out[7]);
+
+  mpmc_queue_destroy(&que);
+}
+
+namespace {
+
+  constexpr sz large_cap = 1 << 16;
+  void* large_in[large_cap];
+  void* large_out[large_cap];
+
+}  // namespace
+
+// Capacities and batches past the safe-loop limit must work like small ones.
+TEST(containers_mpmc_queue_test, large_capacity) {
+  allocator zero_alloc = {0};
+  mpmc_queue que = mpmc_queue_create(large_cap, zero_alloc);
+  ASSERT_EQ(large_cap, mpmc_queue_capacity(&que));
+
+  for (sz idx = 0; idx < large_cap; ++idx) {
+    large_in[idx] = (void*)(up)(idx + 1);
+  }
+  EXPECT_EQ(large_cap, mpmc_queue_try_push_batch(&que, large_in, large_cap));
+  EXPECT_EQ(large_cap, mpmc_queue_count(&que));
+  EXPECT_EQ(0, mpmc_queue_try_push(&que, (void*)1));
+
+  EXPECT_EQ(large_cap, mpmc_queue_try_pop_batch(&que, large_out, large_cap));
+  EXPECT_EQ(0, memcmp(large_in, large_out, size_of(large_in)));
+  EXPECT_EQ(0U, mpmc_queue_count(&que));
+
+  mpmc_queue_destroy(&que);
+}
+
+TEST(containers_mpmc_queue_test, timeout) {
+  allocator zero_alloc = {0};
+  mpmc_queue que = mpmc_queue_create(2, zero_alloc);
+
+  void* val = NULL;
+  EXPECT_EQ(0, mpmc_queue_pop_timeout(&que, &val, 1));
+  EXPECT_NE(0, mpmc_queue_push_timeout(&que, (void*)1, 1));
+  EXPECT_NE(0, mpmc_queue_push_timeout(&que, (void*)2, 1));
+  EXPECT_EQ(0, mpmc_queue_push_timeout(&que, (void*)3, 1));
+  EXPECT_NE(0, mpmc_queue_pop_timeout(&que, &val, 1));
+  EXPECT_EQ((void*)1, val);
+
+  mpmc_queue_destroy(&que);
+}
+
+namespace {
+
+  constexpr u32 mpmc_producer_count = 2;
+  constexpr u32 mpmc_consumer_count = 2;
+  constexpr i32 mpmc_values_per_producer = 20000;
+
+  // Producers push 1..mpmc_values_per_producer; consumers add up everything they pop.
+  struct mpmc_queue_workload {
+    mpmc_queue* que;
+    atomic_i32 remaining;
+    atomic_i64 sum;
+  };
+
+  i32 mpmc_queue_worker(u32 idx, void* arg) {
+    mpmc_queue_workload* work = static_cast<mpmc_queue_workload*>(arg);
+    if (idx < mpmc_producer_count) {
+      for (i32 val = 1; val <= mpmc_values_per_producer; ++val) {
+        mpmc_queue_push(work->que, (void*)(up)val);
+      }
+    } else {
+      i64 local = 0;
+      // Every pop is backed by a reserved item, so blocking here cannot hang.
+      while (atomic_i32_sub(&work->remaining, 1) > 0) {
+        void* val = NULL;
+        mpmc_queue_pop(work->que, &val);
+        local += (i64)(up)val;
+      }
+      atomic_i64_add(&work->sum, local);
+    }
+    return 0;
+  }
+
+  // Baseline: bounded ring guarded by a mutex with two condition variables.
+  struct locked_queue {
+    void* items[64];
+    sz head;
+    sz count;
+    mutex mtx;
+    condvar not_empty;
+    condvar not_full;
+  };
+
+  struct locked_queue_workload {
+    locked_queue* que;
+    atomic_i32 remaining;
+    atomic_i64 sum;
+  };
+
+  i32 locked_queue_worker(u32 idx, void* arg) {
+    locked_queue_workload* work = static_cast<locked_queue_workload*>(arg);
+    locked_queue* que = work->que;
+    if (idx < mpmc_producer_count) {
+      for (i32 val = 1; val <= mpmc_values_per_producer; ++val) {
+        mutex_lock(que->mtx);
+        while (que->count == count_of(que->items)) {
+          condvar_wait(que->not_full, que->mtx);
+        }
+        que->items[(que->head + que->count) % count_of(que->items)] = (void*)(up)val;
+        que->count++;
+        condvar_signal(que->not_empty);
+        mutex_unlock(que->mtx);
+      }
+    } else {
+      i64 local = 0;
+      while (atomic_i32_sub(&work->remaining, 1) > 0) {
+        mutex_lock(que->mtx);
+        while (que->count == 0) {
+          condvar_wait(que->not_empty, que->mtx);
+        }
+        local += (i64)(up)que->items[que->head];
+        que->head = (que->head + 1) % count_of(que->items);
+        que->count--;
+        condvar_signal(que->not_full);
+        mutex_unlock(que->mtx);
+      }
+      atomic_i64_add(&work->sum, local);
+    }
+    return 0;
+  }
+
+  i64 mpmc_expected_sum() {
+    i64 per_producer = (i64)mpmc_values_per_producer * (mpmc_values_per_producer + 1) / 2;
+    return per_producer * mpmc_producer_count;
+  }
+
+  f64 run_workload(thread_group_func entry, void* arg) {
+    auto start = std::chrono::steady_clock::now();
+    thread_group group = thread_group_create(mpmc_producer_count + mpmc_consumer_count, entry, arg, thread_get_setup());
+    EXPECT_NE(0, thread_group_is_valid(group));
+    thread_group_join_all(group, NULL);
+    thread_group_destroy(group);
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}  // namespace
+
+TEST(containers_mpmc_queue_test, threads_blocking) {
+  mpmc_queue que = mpmc_queue_create(64, thread_get_allocator());
+  mpmc_queue_workload work = {};
+  work.que = &que;
+  atomic_i32_set(&work.remaining, mpmc_values_per_producer * (i32)mpmc_producer_count);
+
+  run_workload(mpmc_queue_worker, &work);
+
+  EXPECT_EQ(mpmc_expected_sum(), atomic_i64_get(&work.sum));
+  EXPECT_EQ(0U, mpmc_queue_count(&que));
+  mpmc_queue_destroy(&que);
+}
+
+// Times the same producer/consumer workload against a mutex + condvar queue of
+// equal capacity. Results are logged only; timing is too noisy to assert on.
+TEST(containers_mpmc_queue_test, benchmark_vs_mutex_condvar) {
+  i32 total = mpmc_values_per_producer * (i32)mpmc_producer_count;
+
+  mpmc_queue que = mpmc_queue_create(64, thread_get_allocator());
+  mpmc_queue_workload work = {};
+  work.que = &que;
+  atomic_i32_set(&work.remaining, total);
+  f64 mpmc_ms = run_workload(mpmc_queue_worker, &work);
+  EXPECT_EQ(mpmc_expected_sum(), atomic_i64_get(&work.sum));
+  mpmc_queue_destroy(&que);
+
+  locked_queue locked = {};
+  locked.mtx = mutex_create();
+  locked.not_empty = condvar_create();
+  locked.not_full = condvar_create();
+  locked_queue_workload locked_work = {};
+  locked_work.que = &locked;
+  atomic_i32_set(&locked_work.remaining, total);
+  f64 locked_ms = run_workload(locked_queue_worker, &locked_work);
+  EXPECT_EQ(mpmc_expected_sum(), atomic_i64_get(&locked_work.sum));
+  condvar_destroy(locked.not_full);
+  condvar_destroy(locked.not_empty);
+  mutex_destroy(locked.mtx);
+
+  thread_log_info("mpmc_queue %.2f ms, mutex+condvar %.2f ms (%d items, %u producers, %u consumers)",
+                  mpmc_ms,
+                  locked_ms,
+                  mpmc_values_per_producer * (i32)mpmc_producer_count,
+                  mpmc_producer_count,
+                  mpmc_consumer_count);
+}
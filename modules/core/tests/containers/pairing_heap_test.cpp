@@ -0,0 +1,138 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+namespace {
+
+  struct path_node {
+    struct path_node* child;
+    struct path_node* sibling;
+    struct path_node* prev;
+    i32 distance;
+    i32 id;
+  };
+
+#define PATH_NODE_LESS(lhs, rhs) ((lhs)->distance < (rhs)->distance)
+
+  // Checks heap order and the child/sibling/prev links below node.
+  sz check_subtree(path_node const* node) {
+    sz count = 0;
+    path_node const* prev = node;
+    for (path_node const* kid = node->child; kid != NULL; kid = kid->sibling) {
+      EXPECT_EQ(prev, kid->prev);
+      EXPECT_GE(kid->distance, node->distance);
+      count += 1 + check_subtree(kid);
+      prev = kid;
+    }
+    return count;
+  }
+
+  sz check_heap(path_node const* root) {
+    if (root == NULL) {
+      return 0;
+    }
+    EXPECT_EQ(nullptr, root->prev);
+    EXPECT_EQ(nullptr, root->sibling);
+    return 1 + check_subtree(root);
+  }
+
+}  // namespace
+
+TEST(containers_pairing_heap_test, push_pop_order) {
+  static path_node nodes[2000];
+  path_node* root = NULL;
+  EXPECT_NE(0, PAIRING_HEAP_EMPTY(root));
+
+  for (i32 idx = 0; idx < 2000; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].distance = (idx * 1237) % 2000;
+    nodes[idx].id = idx;
+    PAIRING_HEAP_PUSH(root, &nodes[idx], PATH_NODE_LESS);
+  }
+  EXPECT_EQ(2000U, check_heap(root));
+  EXPECT_EQ(0, PAIRING_HEAP_PEEK(root)->distance);
+
+  for (i32 expected = 0; expected < 2000; ++expected) {
+    path_node* top = NULL;
+    PAIRING_HEAP_POP(root, PATH_NODE_LESS, top);
+    ASSERT_NE(nullptr, top);
+    EXPECT_EQ(expected, top->distance);
+    EXPECT_EQ(nullptr, top->child);
+    if (expected % 400 == 0) {
+      EXPECT_EQ((sz)(1999 - expected), check_heap(root));
+    }
+  }
+  path_node* none = &nodes[0];
+  PAIRING_HEAP_POP(root, PATH_NODE_LESS, none);
+  EXPECT_EQ(nullptr, none);
+  EXPECT_EQ(nullptr, root);
+}
+
+TEST(containers_pairing_heap_test, decrease_and_remove) {
+  static path_node nodes[500];
+  path_node* root = NULL;
+  for (i32 idx = 0; idx < 500; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].distance = 1000 + idx;
+    nodes[idx].id = idx;
+    PAIRING_HEAP_PUSH(root, &nodes[idx], PATH_NODE_LESS);
+  }
+  // Pop once so the remaining nodes form a real tree instead of one child list.
+  path_node* top = NULL;
+  PAIRING_HEAP_POP(root, PATH_NODE_LESS, top);
+  EXPECT_EQ(0, top->id);
+
+  // Decrease-key on interior nodes: the last nodes become the smallest, in reverse.
+  for (i32 idx = 499; idx >= 400; --idx) {
+    nodes[idx].distance = 499 - idx;
+    PAIRING_HEAP_DECREASE(root, &nodes[idx], PATH_NODE_LESS);
+  }
+  EXPECT_EQ(499U, check_heap(root));
+  EXPECT_EQ(499, root->id);
+
+  // Remove every third node, including the current root.
+  sz removed = 0;
+  for (i32 idx = 1; idx < 500; idx += 3) {
+    PAIRING_HEAP_REMOVE(root, &nodes[idx], PATH_NODE_LESS);
+    EXPECT_EQ(nullptr, nodes[idx].child);
+    removed++;
+  }
+  PAIRING_HEAP_REMOVE(root, root, PATH_NODE_LESS);
+  removed++;
+  EXPECT_EQ(499U - removed, check_heap(root));
+
+  i32 prev = -1;
+  sz popped = 0;
+  while (!PAIRING_HEAP_EMPTY(root)) {
+    PAIRING_HEAP_POP(root, PATH_NODE_LESS, top);
+    EXPECT_GE(top->distance, prev);
+    EXPECT_NE(1, top->id % 3);
+    prev = top->distance;
+    popped++;
+  }
+  EXPECT_EQ(499U - removed, popped);
+}
+
+TEST(containers_pairing_heap_test, meld) {
+  static path_node nodes[100];
+  path_node* lhs = NULL;
+  path_node* rhs = NULL;
+  for (i32 idx = 0; idx < 100; ++idx) {
+    nodes[idx] = {};
+    nodes[idx].distance = idx;
+    if (idx % 2 == 0) {
+      PAIRING_HEAP_PUSH(lhs, &nodes[idx], PATH_NODE_LESS);
+    } else {
+      PAIRING_HEAP_PUSH(rhs, &nodes[idx], PATH_NODE_LESS);
+    }
+  }
+  path_node* both = NULL;
+  PAIRING_HEAP_MELD(lhs, rhs, PATH_NODE_LESS, both);
+  EXPECT_EQ(100U, check_heap(both));
+  for (i32 expected = 0; expected < 100; ++expected) {
+    path_node* top = NULL;
+    PAIRING_HEAP_POP(both, PATH_NODE_LESS, top);
+    EXPECT_EQ(expected, top->distance);
+  }
+}
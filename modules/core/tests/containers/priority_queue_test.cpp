@@ -0,0 +1,113 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+namespace {
+
+  struct timed_event {
+    u64 due_tick;
+    u32 event_idx;
+  };
+
+  i32 event_compare(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    u64 lhs = static_cast<timed_event const*>(lhs_ptr)->due_tick;
+    u64 rhs = static_cast<timed_event const*>(rhs_ptr)->due_tick;
+    return lhs < rhs ? -1 : lhs > rhs;
+  }
+
+  i32 i32_descending(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    i32 lhs = *static_cast<i32 const*>(lhs_ptr);
+    i32 rhs = *static_cast<i32 const*>(rhs_ptr);
+    return lhs > rhs ? -1 : lhs < rhs;
+  }
+
+}  // namespace
+
+TEST(containers_priority_queue_test, create_destroy) {
+  allocator zero_alloc = {0};
+  priority_queue queue = priority_queue_create(sizeof(timed_event), 0, event_compare, NULL, 10, zero_alloc);
+  EXPECT_EQ((u32)PRIORITY_QUEUE_DEFAULT_ARITY, queue.arity);
+  EXPECT_GE(priority_queue_capacity(&queue), 10U);
+  EXPECT_EQ(0U, priority_queue_count(&queue));
+  EXPECT_EQ(nullptr, priority_queue_peek(&queue));
+  EXPECT_EQ(0, priority_queue_pop(&queue, NULL));
+  priority_queue_destroy(&queue);
+  EXPECT_EQ(0U, priority_queue_capacity(&queue));
+
+  queue = priority_queue_create(sizeof(i32), 100, i32_descending, NULL, 0, zero_alloc);
+  EXPECT_EQ((u32)PRIORITY_QUEUE_MAX_ARITY, queue.arity);
+  priority_queue_destroy(&queue);
+
+  queue = priority_queue_create(0, 2, i32_descending, NULL, 0, zero_alloc);
+  EXPECT_EQ(0, priority_queue_push(&queue, "x"));
+}
+
+TEST(containers_priority_queue_test, push_pop_order) {
+  allocator zero_alloc = {0};
+  for (u32 arity = 2; arity <= 8; arity += 3) {
+    priority_queue queue = priority_queue_create(sizeof(timed_event), arity, event_compare, NULL, 0, zero_alloc);
+    for (u32 idx = 0; idx < 1000; ++idx) {
+      timed_event event = {(u64)((idx * 7919) % 1000), idx};
+      EXPECT_NE(0, priority_queue_push(&queue, &event));
+    }
+    EXPECT_EQ(1000U, priority_queue_count(&queue));
+    EXPECT_NE(0, priority_queue_check(queue.data, queue.count, queue.elem_size, arity, event_compare, NULL));
+    EXPECT_EQ(0U, static_cast<timed_event const*>(priority_queue_peek(&queue))->due_tick);
+
+    for (u64 expected = 0; expected < 1000; ++expected) {
+      timed_event event = {};
+      ASSERT_NE(0, priority_queue_pop(&queue, &event));
+      EXPECT_EQ(expected, event.due_tick);
+    }
+    EXPECT_EQ(0, priority_queue_pop(&queue, NULL));
+    priority_queue_destroy(&queue);
+  }
+}
+
+TEST(containers_priority_queue_test, max_heap_and_batches) {
+  allocator zero_alloc = {0};
+  priority_queue queue = priority_queue_create(sizeof(i32), 3, i32_descending, NULL, 0, zero_alloc);
+
+  i32 first[500];
+  for (i32 idx = 0; idx < 500; ++idx) {
+    first[idx] = (idx * 37) % 500;
+  }
+  // Large batch: rebuilt bottom-up.
+  EXPECT_NE(0, priority_queue_push_many(&queue, first, 500));
+  EXPECT_NE(0, priority_queue_check(queue.data, queue.count, queue.elem_size, 3, i32_descending, NULL));
+
+  // Small batch: sifted in one by one.
+  i32 second[10] = {1000, -1, 250, 250, 999, 0, 1, 2, 3, 4};
+  EXPECT_NE(0, priority_queue_push_many(&queue, second, 10));
+  EXPECT_EQ(510U, priority_queue_count(&queue));
+  EXPECT_NE(0, priority_queue_check(queue.data, queue.count, queue.elem_size, 3, i32_descending, NULL));
+
+  i32 prev = 1 << 30;
+  i32 value = 0;
+  while (priority_queue_pop(&queue, &value)) {
+    EXPECT_LE(value, prev);
+    prev = value;
+  }
+  EXPECT_EQ(-1, prev);
+
+  priority_queue_clear(&queue);
+  EXPECT_EQ(0U, priority_queue_count(&queue));
+  priority_queue_destroy(&queue);
+}
+
+TEST(containers_priority_queue_test, heapify_array) {
+  i32 values[777];
+  for (i32 idx = 0; idx < 777; ++idx) {
+    values[idx] = (idx * 101) % 777;
+  }
+  EXPECT_EQ(0, priority_queue_check(values, 777, sizeof(i32), 2, i32_descending, NULL));
+  EXPECT_EQ(777U, priority_queue_heapify(values, 777, sizeof(i32), 2, i32_descending, NULL));
+  EXPECT_NE(0, priority_queue_check(values, 777, sizeof(i32), 2, i32_descending, NULL));
+  EXPECT_EQ(776, values[0]);
+
+  EXPECT_EQ(0U, priority_queue_heapify(NULL, 10, sizeof(i32), 2, i32_descending, NULL));
+  EXPECT_EQ(1U, priority_queue_heapify(values, 1, sizeof(i32), 2, i32_descending, NULL));
+}
@@ -3,6 +3,9 @@
 
 #include "test_common.hpp"
 
+#include <chrono>
+#include <string.h>
+
 namespace {
   i32 compare_int(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
     (void)user_data;
@@ -179,3 +182,383 @@ TEST(containers_sort_test, radix64) {
   EXPECT_EQ(720ULL, arr[5]);
   EXPECT_EQ(839ULL, arr[6]);
 }
+
+namespace {
+  u64 radix_test_rand(u64* state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 11;
+  }
+
+  // Order-independent fingerprint of the raw key bits, to check that a sort
+  // only permuted its input.
+  template <typename T>
+  u64 radix_test_fingerprint(const T* keys, sz count) {
+    u64 sum = 0;
+    u64 mix = 0;
+    for (sz idx = 0; idx < count; ++idx) {
+      u64 bits = 0;
+      memcpy(&bits, &keys[idx], sizeof(T));
+      sum += bits;
+      mix ^= bits * 0x9E3779B97F4A7C15ULL;
+    }
+    return sum ^ (mix << 1);
+  }
+
+  template <typename T>
+  b32 radix_test_is_sorted(const T* keys, sz count) {
+    for (sz idx = 1; idx < count; ++idx) {
+      if (keys[idx] < keys[idx - 1]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename T>
+  void radix_test_check(T* keys, sz count, sz (*sort_fn)(T*, sz, allocator)) {
+    allocator zero_alloc = {0};
+    u64 before = radix_test_fingerprint(keys, count);
+    EXPECT_EQ(count, sort_fn(keys, count, zero_alloc));
+    EXPECT_TRUE(radix_test_is_sorted(keys, count));
+    EXPECT_EQ(before, radix_test_fingerprint(keys, count));
+  }
+
+  constexpr sz radix_test_count = 5000;
+  u32 radix_keys_u32[radix_test_count];
+  u64 radix_keys_u64[radix_test_count];
+  i32 radix_keys_i32[radix_test_count];
+  i64 radix_keys_i64[radix_test_count];
+  f32 radix_keys_f32[radix_test_count];
+  f64 radix_keys_f64[radix_test_count];
+}  // namespace
+
+TEST(containers_sort_test, radix_lsd_unsigned) {
+  u64 state = 1;
+  for (sz idx = 0; idx < radix_test_count; ++idx) {
+    radix_keys_u32[idx] = (u32)radix_test_rand(&state);
+    radix_keys_u64[idx] = radix_test_rand(&state) * 2654435761ULL;
+  }
+  radix_test_check(radix_keys_u32, radix_test_count, sort_radix_u32);
+  radix_test_check(radix_keys_u64, radix_test_count, sort_radix_u64);
+
+  // Narrow keys skip the digit passes where every key agrees.
+  for (sz idx = 0; idx < radix_test_count; ++idx) {
+    radix_keys_u32[idx] = (u32)(radix_test_rand(&state) % 200) + 0x12340000U;
+  }
+  u64 before = radix_test_fingerprint(radix_keys_u32, radix_test_count);
+  EXPECT_EQ(radix_test_count, sort_radix32(radix_keys_u32, radix_test_count));
+  EXPECT_TRUE(radix_test_is_sorted(radix_keys_u32, radix_test_count));
+  EXPECT_EQ(before, radix_test_fingerprint(radix_keys_u32, radix_test_count));
+}
+
+TEST(containers_sort_test, radix_lsd_signed_and_float) {
+  u64 state = 7;
+  for (sz idx = 0; idx < radix_test_count; ++idx) {
+    radix_keys_i32[idx] = (i32)(u32)radix_test_rand(&state);
+    radix_keys_i64[idx] = (i64)(radix_test_rand(&state) << 11) - (i64)(radix_test_rand(&state) << 10);
+    radix_keys_f32[idx] = ((f32)(radix_test_rand(&state) % 20001) - 10000.0F) * 0.37F;
+    radix_keys_f64[idx] = ((f64)(radix_test_rand(&state) % 2000001) - 1000000.0) * 1e-3;
+  }
+  radix_keys_f32[0] = -1e30F;
+  radix_keys_f32[1] = 1e30F;
+  radix_keys_f64[0] = 0.0;
+  radix_keys_f64[1] = -0.0;
+
+  radix_test_check(radix_keys_i32, radix_test_count, sort_radix_i32);
+  radix_test_check(radix_keys_i64, radix_test_count, sort_radix_i64);
+  radix_test_check(radix_keys_f32, radix_test_count, sort_radix_f32);
+  radix_test_check(radix_keys_f64, radix_test_count, sort_radix_f64);
+  EXPECT_EQ(-1e30F, radix_keys_f32[0]);
+  EXPECT_EQ(1e30F, radix_keys_f32[radix_test_count - 1]);
+}
+
+TEST(containers_sort_test, radix_lsd_pairs_stable) {
+  allocator zero_alloc = {0};
+  struct record {
+    u32 id;
+    u16 tag;
+    u8 pad[10];
+  };
+  static record records[radix_test_count];
+  u64 state = 3;
+  for (sz idx = 0; idx < radix_test_count; ++idx) {
+    radix_keys_i64[idx] = (i64)(radix_test_rand(&state) % 50) - 25;
+    records[idx] = record {(u32)idx, (u16)(radix_keys_i64[idx] & 0xFFFF), {}};
+  }
+
+  EXPECT_EQ(radix_test_count,
+            sort_radix_pairs(radix_keys_i64, SORT_KEY_I64, records, sizeof(record), radix_test_count, zero_alloc));
+  for (sz idx = 0; idx < radix_test_count; ++idx) {
+    EXPECT_EQ((u16)(radix_keys_i64[idx] & 0xFFFF), records[idx].tag);
+    if (idx > 0) {
+      EXPECT_LE(radix_keys_i64[idx - 1], radix_keys_i64[idx]);
+      if (radix_keys_i64[idx - 1] == radix_keys_i64[idx]) {
+        EXPECT_LT(records[idx - 1].id, records[idx].id);
+      }
+    }
+  }
+}
+
+TEST(containers_sort_test, radix_lsd_indices) {
+  allocator zero_alloc = {0};
+  f32 keys[] = {3.5F, -1.0F, 2.0F, -1.0F, 0.0F, -7.25F};
+  u32 indices[6] = {0};
+
+  EXPECT_EQ(6U, sort_radix_indices(keys, SORT_KEY_F32, indices, 6, zero_alloc));
+  u32 expected[] = {5, 1, 3, 4, 2, 0};
+  for (sz idx = 0; idx < 6; ++idx) {
+    EXPECT_EQ(expected[idx], indices[idx]);
+  }
+  // Keys are left untouched.
+  EXPECT_EQ(3.5F, keys[0]);
+  EXPECT_EQ(-7.25F, keys[5]);
+
+  EXPECT_EQ(0U, sort_radix_pairs(NULL, SORT_KEY_U32, NULL, 0, 4, zero_alloc));
+}
+
+namespace {
+  // Enough for four workers of SORT_PARALLEL_MIN_CHUNK elements plus an uneven tail.
+  constexpr sz parallel_test_count = (4 * SORT_PARALLEL_MIN_CHUNK) + 37;
+
+  struct parallel_record {
+    u32 key;
+    u32 id;
+  };
+
+  i32 compare_parallel_record(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    u32 lhs = ((const parallel_record*)lhs_ptr)->key;
+    u32 rhs = ((const parallel_record*)rhs_ptr)->key;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+  }
+
+  parallel_record parallel_records[parallel_test_count];
+  i64 parallel_keys[parallel_test_count];
+  i64 parallel_keys_serial[parallel_test_count];
+  u32 parallel_values[parallel_test_count];
+  u32 parallel_values_serial[parallel_test_count];
+
+  void parallel_test_fill_records(u64 seed, u32 key_range) {
+    u64 state = seed;
+    for (sz idx = 0; idx < parallel_test_count; ++idx) {
+      parallel_records[idx] = parallel_record {(u32)(radix_test_rand(&state) % key_range), (u32)idx};
+    }
+  }
+
+  // Sorted by key, equal keys in input order, and every id present exactly once.
+  void parallel_test_check_records(void) {
+    u64 id_sum = 0;
+    for (sz idx = 0; idx < parallel_test_count; ++idx) {
+      id_sum += parallel_records[idx].id;
+      if (idx == 0) {
+        continue;
+      }
+      parallel_record const& prev = parallel_records[idx - 1];
+      parallel_record const& cur = parallel_records[idx];
+      ASSERT_LE(prev.key, cur.key);
+      if (prev.key == cur.key) {
+        ASSERT_LT(prev.id, cur.id);
+      }
+    }
+    EXPECT_EQ((u64)parallel_test_count * (parallel_test_count - 1) / 2, id_sum);
+  }
+
+  void parallel_test_fill_keys(u64 seed) {
+    u64 state = seed;
+    for (sz idx = 0; idx < parallel_test_count; ++idx) {
+      parallel_keys[idx] = (i64)(radix_test_rand(&state) % 100000) - 50000;
+      parallel_values[idx] = (u32)idx;
+    }
+    memcpy(parallel_keys_serial, parallel_keys, sizeof(parallel_keys));
+    memcpy(parallel_values_serial, parallel_values, sizeof(parallel_values));
+  }
+
+  void* failing_alloc_fn(void* user_data, callsite site, sz size) {
+    (void)user_data;
+    (void)site;
+    (void)size;
+    return NULL;
+  }
+
+  void failing_dealloc_fn(void* user_data, callsite site, void* ptr) {
+    (void)user_data;
+    (void)site;
+    (void)ptr;
+  }
+
+  // Runs on a thread whose zeroed ctx_setup leaves it without a temp arena.
+  i32 merge_without_scratch_entry(void* arg) {
+    allocator failing_alloc = {0};
+    failing_alloc.alloc_fn = failing_alloc_fn;
+    failing_alloc.dealloc_fn = failing_dealloc_fn;
+    *(sz*)arg = sort_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, failing_alloc);
+    return 0;
+  }
+
+  f64 parallel_test_elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+}  // namespace
+
+TEST(containers_sort_test, parallel_merge_stable) {
+  allocator zero_alloc = {0};
+  parallel_test_fill_records(11, 1000);
+  EXPECT_EQ(parallel_test_count,
+            sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 4));
+  parallel_test_check_records();
+
+  // Three threads round down to two workers; the split stays exact with heavy ties.
+  parallel_test_fill_records(12, 3);
+  EXPECT_EQ(parallel_test_count,
+            sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 3));
+  parallel_test_check_records();
+
+  // Already sorted input must come back unchanged.
+  EXPECT_EQ(parallel_test_count,
+            sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 4));
+  parallel_test_check_records();
+}
+
+// A single thread takes the serial path, well beyond the safe-loop limit.
+TEST(containers_sort_test, parallel_merge_single_thread_stable) {
+  allocator zero_alloc = {0};
+  parallel_test_fill_records(13, 100);
+  EXPECT_EQ(parallel_test_count,
+            sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 1));
+  parallel_test_check_records();
+}
+
+// Without a temp arena or a working allocator sort_merge merges in place and stays stable.
+TEST(containers_sort_test, merge_sort_without_scratch_stable) {
+  parallel_test_fill_records(14, 50);
+  sz sorted = 0;
+  thread worker = thread_create(merge_without_scratch_entry, &sorted, (ctx_setup) {0});
+  ASSERT_NE(0, thread_is_valid(worker));
+  thread_join(worker, NULL);
+  EXPECT_EQ(parallel_test_count, sorted);
+  parallel_test_check_records();
+}
+
+TEST(containers_sort_test, parallel_small_inputs_use_serial_path) {
+  allocator zero_alloc = {0};
+  i32 values[] = {5, 2, 9, 1, 5, 6};
+  EXPECT_EQ(6U, sort_parallel_merge(values, 6, sizeof(i32), compare_int, NULL, zero_alloc, 8));
+  EXPECT_TRUE(sort_check(values, 6, sizeof(i32), compare_int, NULL));
+
+  u32 keys[] = {7, 3, 3, 0, 9};
+  EXPECT_EQ(5U, sort_parallel_radix(keys, SORT_KEY_U32, NULL, 0, 5, zero_alloc, 8));
+  EXPECT_TRUE(radix_test_is_sorted(keys, 5));
+
+  EXPECT_EQ(0U, sort_parallel_merge(NULL, 6, sizeof(i32), compare_int, NULL, zero_alloc, 8));
+  EXPECT_EQ(0U, sort_parallel_radix(NULL, SORT_KEY_U32, NULL, 0, 5, zero_alloc, 8));
+}
+
+TEST(containers_sort_test, parallel_radix_matches_serial) {
+  allocator zero_alloc = {0};
+  parallel_test_fill_keys(21);
+  EXPECT_EQ(parallel_test_count,
+            sort_radix_pairs(parallel_keys_serial, SORT_KEY_I64, parallel_values_serial, sizeof(u32), parallel_test_count, zero_alloc));
+  EXPECT_EQ(parallel_test_count,
+            sort_parallel_radix(parallel_keys, SORT_KEY_I64, parallel_values, sizeof(u32), parallel_test_count, zero_alloc, 4));
+  EXPECT_EQ(0, memcmp(parallel_keys, parallel_keys_serial, sizeof(parallel_keys)));
+  EXPECT_EQ(0, memcmp(parallel_values, parallel_values_serial, sizeof(parallel_values)));
+
+  // 32-bit float keys without payload.
+  f32* float_keys = (f32*)parallel_values;
+  f32* float_keys_serial = (f32*)parallel_values_serial;
+  u64 state = 22;
+  for (sz idx = 0; idx < parallel_test_count; ++idx) {
+    float_keys[idx] = ((f32)(radix_test_rand(&state) % 20001) - 10000.0F) * 0.25F;
+  }
+  memcpy(float_keys_serial, float_keys, parallel_test_count * sizeof(f32));
+  EXPECT_EQ(parallel_test_count, sort_radix_f32(float_keys_serial, parallel_test_count, zero_alloc));
+  EXPECT_EQ(parallel_test_count, sort_parallel_radix(float_keys, SORT_KEY_F32, NULL, 0, parallel_test_count, zero_alloc, 2));
+  EXPECT_EQ(0, memcmp(float_keys, float_keys_serial, parallel_test_count * sizeof(f32)));
+}
+
+// Times the parallel sorts against the serial radix path and against fewer workers.
+// Results are logged only; timing is too noisy to assert on.
+TEST(containers_sort_test, benchmark_parallel) {
+  allocator zero_alloc = {0};
+  parallel_test_fill_keys(31);
+  auto start = std::chrono::steady_clock::now();
+  sort_radix_pairs(parallel_keys_serial, SORT_KEY_I64, parallel_values_serial, sizeof(u32), parallel_test_count, zero_alloc);
+  f64 radix_serial_ms = parallel_test_elapsed_ms(start);
+  start = std::chrono::steady_clock::now();
+  sort_parallel_radix(parallel_keys, SORT_KEY_I64, parallel_values, sizeof(u32), parallel_test_count, zero_alloc, 4);
+  f64 radix_parallel_ms = parallel_test_elapsed_ms(start);
+  EXPECT_EQ(0, memcmp(parallel_keys, parallel_keys_serial, sizeof(parallel_keys)));
+
+  parallel_test_fill_records(32, 1U << 30);
+  start = std::chrono::steady_clock::now();
+  sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 2);
+  f64 merge_two_ms = parallel_test_elapsed_ms(start);
+  parallel_test_check_records();
+  parallel_test_fill_records(32, 1U << 30);
+  start = std::chrono::steady_clock::now();
+  sort_parallel_merge(parallel_records, parallel_test_count, sizeof(parallel_record), compare_parallel_record, NULL, zero_alloc, 4);
+  f64 merge_four_ms = parallel_test_elapsed_ms(start);
+  parallel_test_check_records();
+
+  thread_log_info("radix serial %.2f ms, parallel x4 %.2f ms; merge x2 %.2f ms, x4 %.2f ms (%llu elements)",
+                  radix_serial_ms,
+                  radix_parallel_ms,
+                  merge_two_ms,
+                  merge_four_ms,
+                  (unsigned long long)parallel_test_count);
+}
+
+namespace {
+  constexpr sz pattern_test_count = 3000;
+  constexpr i32 pattern_test_kinds = 8;
+  i32 pattern_values[pattern_test_count];
+
+  // Inputs that degrade naive quicksorts: sorted, reversed, all equal, organ
+  // pipe, few distinct values, sawtooth and a sorted prefix with a random tail.
+  void pattern_test_fill(i32* values, sz count, i32 kind, u64 seed) {
+    u64 state = seed;
+    for (sz idx = 0; idx < count; ++idx) {
+      i32 rnd = (i32)(radix_test_rand(&state) % 1000000);
+      switch (kind) {
+        case 0: values[idx] = rnd; break;
+        case 1: values[idx] = (i32)idx; break;
+        case 2: values[idx] = (i32)(count - idx); break;
+        case 3: values[idx] = 42; break;
+        case 4: values[idx] = (i32)(idx < count / 2 ? idx : count - idx); break;
+        case 5: values[idx] = rnd % 4; break;
+        case 6: values[idx] = (i32)(idx % 97); break;
+        default: values[idx] = idx < count - 20 ? (i32)idx : rnd; break;
+      }
+    }
+  }
+}  // namespace
+
+TEST(containers_sort_test, quick_sort_patterns) {
+  allocator zero_alloc = {0};
+  for (i32 kind = 0; kind < pattern_test_kinds; ++kind) {
+    pattern_test_fill(pattern_values, pattern_test_count, kind, 17 + kind);
+    u64 before = radix_test_fingerprint(pattern_values, pattern_test_count);
+    EXPECT_EQ(pattern_test_count, sort_quick(pattern_values, pattern_test_count, sizeof(i32), compare_int, NULL, zero_alloc));
+    EXPECT_TRUE(radix_test_is_sorted(pattern_values, pattern_test_count)) << "pattern " << kind;
+    EXPECT_EQ(before, radix_test_fingerprint(pattern_values, pattern_test_count)) << "pattern " << kind;
+  }
+
+  // Odd element sizes go through the word-wise swap plus a byte tail.
+  struct odd_record {
+    i32 key;
+    u8 payload[15];
+  };
+  static odd_record records[pattern_test_count];
+  pattern_test_fill(pattern_values, pattern_test_count, 5, 3);
+  for (sz idx = 0; idx < pattern_test_count; ++idx) {
+    records[idx].key = pattern_values[idx];
+    memset(records[idx].payload, records[idx].key, sizeof(records[idx].payload));
+  }
+  EXPECT_EQ(pattern_test_count, sort_quick(records, pattern_test_count, sizeof(odd_record), compare_int, NULL, zero_alloc));
+  for (sz idx = 0; idx < pattern_test_count; ++idx) {
+    EXPECT_EQ((u8)records[idx].key, records[idx].payload[14]);
+    if (idx > 0) {
+      EXPECT_LE(records[idx - 1].key, records[idx].key);
+    }
+  }
+}
@@ -0,0 +1,243 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+TEST(containers_swiss_map_test, create_destroy) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  EXPECT_EQ(0U, swiss_map_count(&map));
+  EXPECT_EQ(16U, swiss_map_capacity(&map));
+
+  swiss_map_destroy(&map);
+  EXPECT_EQ(0U, swiss_map_capacity(&map));
+}
+
+TEST(containers_swiss_map_test, set_get_has_remove) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  EXPECT_EQ(0, swiss_map_has(&map, 1));
+  EXPECT_NE(0, swiss_map_set(&map, 1, (void*)100));
+  EXPECT_NE(0, swiss_map_set(&map, 2, (void*)200));
+  EXPECT_EQ(2U, swiss_map_count(&map));
+  EXPECT_EQ((void*)100, swiss_map_get(&map, 1));
+  EXPECT_EQ((void*)200, swiss_map_get(&map, 2));
+  EXPECT_EQ(NULL, swiss_map_get(&map, 3));
+
+  // Overwriting keeps the count.
+  EXPECT_NE(0, swiss_map_set(&map, 1, (void*)101));
+  EXPECT_EQ(2U, swiss_map_count(&map));
+  EXPECT_EQ((void*)101, swiss_map_get(&map, 1));
+
+  EXPECT_NE(0, swiss_map_remove(&map, 1));
+  EXPECT_EQ(0, swiss_map_remove(&map, 1));
+  EXPECT_EQ(0, swiss_map_has(&map, 1));
+  EXPECT_NE(0, swiss_map_has(&map, 2));
+  EXPECT_EQ(1U, swiss_map_count(&map));
+
+  swiss_map_clear(&map);
+  EXPECT_EQ(0U, swiss_map_count(&map));
+  EXPECT_EQ(0, swiss_map_has(&map, 2));
+
+  swiss_map_destroy(&map);
+}
+
+TEST(containers_swiss_map_test, growth_and_churn) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  for (u64 key = 0; key < 2000; ++key) {
+    EXPECT_NE(0, swiss_map_set(&map, key * 7919, (void*)(up)(key + 1)));
+  }
+  EXPECT_EQ(2000U, swiss_map_count(&map));
+  EXPECT_LE(swiss_map_load_factor(&map), 0.875F);
+
+  // Remove every other key, then reinsert new ones so tombstones get reused
+  // and eventually purged by an in-place rebuild.
+  for (u64 round = 0; round < 4; ++round) {
+    for (u64 key = round % 2; key < 2000; key += 2) {
+      EXPECT_NE(0, swiss_map_remove(&map, key * 7919));
+    }
+    for (u64 key = round % 2; key < 2000; key += 2) {
+      EXPECT_NE(0, swiss_map_set(&map, key * 7919, (void*)(up)(key + 1)));
+    }
+  }
+  EXPECT_EQ(2000U, swiss_map_count(&map));
+  for (u64 key = 0; key < 2000; ++key) {
+    EXPECT_EQ((void*)(up)(key + 1), swiss_map_get(&map, key * 7919));
+    EXPECT_EQ(0, swiss_map_has(&map, key * 7919 + 1));
+  }
+
+  swiss_map_destroy(&map);
+}
+
+TEST(containers_swiss_map_test, reserve_rehash) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  EXPECT_NE(0, swiss_map_reserve(&map, 100));
+  sz cap = swiss_map_capacity(&map);
+  EXPECT_GE(cap, 128U);
+  for (u64 key = 0; key < 100; ++key) {
+    swiss_map_set(&map, key, (void*)(up)(key + 1));
+  }
+  EXPECT_EQ(cap, swiss_map_capacity(&map));
+
+  // Rehash never drops below what the entries need.
+  EXPECT_NE(0, swiss_map_rehash(&map, 16));
+  EXPECT_EQ(128U, swiss_map_capacity(&map));
+  for (u64 key = 0; key < 100; ++key) {
+    EXPECT_EQ((void*)(up)(key + 1), swiss_map_get(&map, key));
+  }
+
+  swiss_map_destroy(&map);
+}
+
+TEST(containers_swiss_map_test, foreach) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  u64 expected = 0;
+  for (u64 key = 1; key <= 50; ++key) {
+    swiss_map_set(&map, key, (void*)(up)(key * 2));
+    expected += key;
+  }
+
+  u64 key_sum = 0;
+  sz visited = 0;
+  SWISS_MAP_FOREACH(&map, slot) {
+    EXPECT_EQ((void*)(up)(slot->key * 2), slot->value);
+    key_sum += slot->key;
+    visited++;
+  }
+  EXPECT_EQ(50U, visited);
+  EXPECT_EQ(expected, key_sum);
+
+  swiss_map_destroy(&map);
+}
+
+// Grows well past the safe-loop limit so rehashing and iteration have to scale
+// with the data instead of a fixed iteration cap.
+TEST(containers_swiss_map_test, large_growth_and_foreach) {
+  allocator zero_alloc = {0};
+  swiss_map map = swiss_map_create(16, zero_alloc);
+
+  constexpr u64 large_count = 100000;
+  for (u64 key = 1; key <= large_count; ++key) {
+    ASSERT_NE(0, swiss_map_set(&map, key, (void*)(up)(key * 2)));
+  }
+  EXPECT_EQ(large_count, swiss_map_count(&map));
+  EXPECT_GT(swiss_map_capacity(&map), 65536U);
+
+  u64 key_sum = 0;
+  sz visited = 0;
+  SWISS_MAP_FOREACH(&map, slot) {
+    key_sum += slot->key;
+    visited++;
+  }
+  EXPECT_EQ(large_count, visited);
+  EXPECT_EQ(large_count * (large_count + 1) / 2, key_sum);
+
+  visited = 0;
+  swiss_map_iter iter = 0;
+  while (swiss_map_next(&map, &iter) != NULL) {
+    visited++;
+  }
+  EXPECT_EQ(large_count, visited);
+
+  EXPECT_EQ((void*)(up)(large_count * 2), swiss_map_get(&map, large_count));
+  swiss_map_destroy(&map);
+}
+
+namespace {
+
+  constexpr u64 swiss_bench_keys = 4096;
+  constexpr i32 swiss_bench_rounds = 20;
+
+  u64 swiss_bench_key(u64 idx) {
+    return idx * 0x9E3779B97F4A7C15ULL;
+  }
+
+  f64 elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}  // namespace
+
+// Times insert, hit lookup, miss lookup and remove against hash_map on the same
+// keys. Results are logged only; timing is too noisy to assert on.
+TEST(containers_swiss_map_test, benchmark_vs_hash_map) {
+  allocator alloc = thread_get_allocator();
+  f64 swiss_ms[4] = {0};
+  f64 hash_ms[4] = {0};
+  up checksum = 0;
+
+  for (i32 round = 0; round < swiss_bench_rounds; ++round) {
+    swiss_map swiss = swiss_map_create(16, alloc);
+    auto start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      swiss_map_set(&swiss, swiss_bench_key(idx), (void*)(up)(idx + 1));
+    }
+    swiss_ms[0] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      checksum += (up)swiss_map_get(&swiss, swiss_bench_key(idx));
+    }
+    swiss_ms[1] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      checksum += (up)swiss_map_has(&swiss, swiss_bench_key(idx) + 1);
+    }
+    swiss_ms[2] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      swiss_map_remove(&swiss, swiss_bench_key(idx));
+    }
+    swiss_ms[3] += elapsed_ms(start);
+    EXPECT_EQ(0U, swiss_map_count(&swiss));
+    swiss_map_destroy(&swiss);
+
+    hash_map hash = hash_map_create(16, alloc);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      hash_map_set(&hash, swiss_bench_key(idx), (void*)(up)(idx + 1));
+    }
+    hash_ms[0] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      checksum -= (up)hash_map_get(&hash, swiss_bench_key(idx));
+    }
+    hash_ms[1] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      checksum -= (up)hash_map_has(&hash, swiss_bench_key(idx) + 1);
+    }
+    hash_ms[2] += elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (u64 idx = 0; idx < swiss_bench_keys; ++idx) {
+      hash_map_remove(&hash, swiss_bench_key(idx));
+    }
+    hash_ms[3] += elapsed_ms(start);
+    EXPECT_EQ(0U, hash_map_count(&hash));
+    hash_map_destroy(&hash);
+  }
+
+  // Both maps must have returned the same values.
+  EXPECT_EQ(0U, checksum);
+  thread_log_info("swiss_map vs hash_map (%d rounds x %d keys): insert %.2f/%.2f ms, hit %.2f/%.2f ms, "
+                  "miss %.2f/%.2f ms, remove %.2f/%.2f ms",
+                  swiss_bench_rounds,
+                  (i32)swiss_bench_keys,
+                  swiss_ms[0],
+                  hash_ms[0],
+                  swiss_ms[1],
+                  hash_ms[1],
+                  swiss_ms[2],
+                  hash_ms[2],
+                  swiss_ms[3],
+                  hash_ms[3]);
+}
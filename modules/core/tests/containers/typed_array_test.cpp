@@ -0,0 +1,212 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+#include <stdlib.h>
+
+namespace {
+
+  struct particle {
+    f32 x;
+    f32 y;
+    u32 id;
+  };
+
+  TYPED_ARRAY_DECLARE(u32_array, u32)
+  TYPED_ARRAY_IMPLEMENT(u32_array, u32)
+
+  TYPED_ARRAY_DECLARE(particle_array, particle)
+  TYPED_ARRAY_IMPLEMENT(particle_array, particle)
+
+  // Allocator without a realloc callback, so growth takes the copy path.
+  struct counting_heap {
+    u32 allocs;
+    u32 frees;
+  };
+
+  void* counting_alloc(void* user_data, callsite site, sz size) {
+    (void)site;
+    static_cast<counting_heap*>(user_data)->allocs++;
+    return malloc(size);
+  }
+
+  void counting_free(void* user_data, callsite site, void* ptr) {
+    (void)site;
+    static_cast<counting_heap*>(user_data)->frees++;
+    free(ptr);
+  }
+
+  allocator counting_allocator(counting_heap* heap) {
+    allocator alloc = {};
+    alloc.user_data = heap;
+    alloc.alloc_fn = counting_alloc;
+    alloc.dealloc_fn = counting_free;
+    return alloc;
+  }
+
+}  // namespace
+
+TEST(containers_typed_array_test, push_pop_at) {
+  allocator zero_alloc = {0};
+  u32_array arr = u32_array_create(0, zero_alloc);
+  EXPECT_EQ(0U, u32_array_capacity(&arr));
+  EXPECT_EQ(nullptr, u32_array_at(&arr, 0));
+
+  for (u32 idx = 0; idx < 100; ++idx) {
+    EXPECT_NE(0, u32_array_push(&arr, idx * 2));
+  }
+  EXPECT_EQ(100U, u32_array_count(&arr));
+  EXPECT_EQ(128U, u32_array_capacity(&arr));
+  EXPECT_EQ(84U, *u32_array_at(&arr, 42));
+  EXPECT_EQ(nullptr, u32_array_at(&arr, 100));
+
+  u32 last = 0;
+  EXPECT_NE(0, u32_array_pop(&arr, &last));
+  EXPECT_EQ(198U, last);
+  EXPECT_NE(0, u32_array_pop(&arr, NULL));
+  EXPECT_EQ(98U, u32_array_count(&arr));
+
+  u32_array_clear(&arr);
+  EXPECT_EQ(0U, u32_array_count(&arr));
+  EXPECT_EQ(128U, u32_array_capacity(&arr));
+  EXPECT_EQ(0, u32_array_pop(&arr, &last));
+
+  u32_array_destroy(&arr);
+  EXPECT_EQ(0U, u32_array_capacity(&arr));
+  EXPECT_EQ(nullptr, arr.data);
+}
+
+TEST(containers_typed_array_test, insert_remove_swap_remove) {
+  allocator zero_alloc = {0};
+  u32_array arr = u32_array_create(4, zero_alloc);
+  EXPECT_EQ(8U, u32_array_capacity(&arr));
+
+  u32 values[] = {10, 20, 30, 40, 50};
+  EXPECT_NE(0, u32_array_push_many(&arr, values, 5));
+  EXPECT_NE(0, u32_array_insert(&arr, 0, 5));
+  EXPECT_NE(0, u32_array_insert(&arr, 3, 25));
+  EXPECT_NE(0, u32_array_insert(&arr, 7, 60));
+  EXPECT_EQ(0, u32_array_insert(&arr, 9, 99));
+  u32 expected_insert[] = {5, 10, 20, 25, 30, 40, 50, 60};
+  ASSERT_EQ(8U, arr.count);
+  for (sz idx = 0; idx < 8; ++idx) {
+    EXPECT_EQ(expected_insert[idx], arr.data[idx]);
+  }
+
+  EXPECT_NE(0, u32_array_remove(&arr, 0));
+  EXPECT_NE(0, u32_array_remove(&arr, 6));
+  EXPECT_EQ(0, u32_array_remove(&arr, 6));
+  u32 expected_remove[] = {10, 20, 25, 30, 40, 50};
+  ASSERT_EQ(6U, arr.count);
+  for (sz idx = 0; idx < 6; ++idx) {
+    EXPECT_EQ(expected_remove[idx], arr.data[idx]);
+  }
+
+  EXPECT_NE(0, u32_array_swap_remove(&arr, 1));
+  EXPECT_NE(0, u32_array_swap_remove(&arr, 4));
+  u32 expected_swap[] = {10, 50, 25, 30};
+  ASSERT_EQ(4U, arr.count);
+  for (sz idx = 0; idx < 4; ++idx) {
+    EXPECT_EQ(expected_swap[idx], arr.data[idx]);
+  }
+
+  u32 sum = 0;
+  TYPED_ARRAY_FOREACH(&arr, it) {
+    sum += *it;
+  }
+  EXPECT_EQ(115U, sum);
+
+  u32_array_destroy(&arr);
+}
+
+TEST(containers_typed_array_test, resize_and_shrink) {
+  allocator zero_alloc = {0};
+  particle_array arr = particle_array_create(0, zero_alloc);
+  EXPECT_NE(0, particle_array_push(&arr, particle {1.0F, 2.0F, 7}));
+  EXPECT_NE(0, particle_array_resize(&arr, 20));
+  EXPECT_EQ(20U, particle_array_count(&arr));
+  EXPECT_EQ(7U, arr.data[0].id);
+  EXPECT_EQ(0U, arr.data[19].id);
+  EXPECT_EQ(0.0F, arr.data[19].x);
+
+  EXPECT_NE(0, particle_array_resize(&arr, 3));
+  EXPECT_NE(0, particle_array_shrink_to_fit(&arr));
+  EXPECT_EQ(3U, particle_array_capacity(&arr));
+  EXPECT_EQ(2.0F, arr.data[0].y);
+
+  particle_array_clear(&arr);
+  EXPECT_NE(0, particle_array_shrink_to_fit(&arr));
+  EXPECT_EQ(0U, particle_array_capacity(&arr));
+  EXPECT_NE(0, particle_array_push(&arr, particle {3.0F, 4.0F, 9}));
+  EXPECT_EQ(9U, particle_array_at(&arr, 0)->id);
+  particle_array_destroy(&arr);
+}
+
+TEST(containers_typed_array_test, arena_grows_in_place) {
+  arena arn = arena_create(global_get_allocator(), NULL, 1024 * 1024);
+  u32_array arr = u32_array_create(0, arena_get_allocator(&arn));
+
+  EXPECT_NE(0, u32_array_push(&arr, 0));
+  u32* first_data = arr.data;
+  for (u32 idx = 1; idx < 10000; ++idx) {
+    u32_array_push(&arr, idx);
+  }
+  // The array is the only allocation, so every doubling extends at the cursor.
+  EXPECT_EQ(first_data, arr.data);
+  EXPECT_EQ(9999U, arr.data[9999]);
+  EXPECT_LT(arena_total_used(&arn), 16384U * sizeof(u32) + 1024U);
+
+  u32_array_destroy(&arr);
+  arena_destroy(&arn);
+}
+
+TEST(containers_typed_array_test, copy_growth_without_realloc) {
+  counting_heap heap = {};
+  u32_array arr = u32_array_create(0, counting_allocator(&heap));
+  for (u32 idx = 0; idx < 1000; ++idx) {
+    EXPECT_NE(0, u32_array_push(&arr, idx));
+  }
+  for (u32 idx = 0; idx < 1000; ++idx) {
+    EXPECT_EQ(idx, arr.data[idx]);
+  }
+  // 8 -> 1024 takes eight allocations; every replaced block was freed.
+  EXPECT_EQ(8U, heap.allocs);
+  EXPECT_EQ(7U, heap.frees);
+  u32_array_destroy(&arr);
+  EXPECT_EQ(heap.allocs, heap.frees);
+}
+
+// Times push-driven growth on an arena (in-place realloc) against an
+// allocator without realloc (copy on every doubling).
+// Results are logged only; timing is too noisy to assert on.
+TEST(containers_typed_array_test, benchmark_in_place_vs_copy_growth) {
+  constexpr u32 push_count = 1000000;
+  arena arn = arena_create(global_get_allocator(), NULL, 8 * 1024 * 1024);
+  u32_array in_place = u32_array_create(0, arena_get_allocator(&arn));
+  auto start = std::chrono::steady_clock::now();
+  for (u32 idx = 0; idx < push_count; ++idx) {
+    u32_array_push(&in_place, idx);
+  }
+  f64 in_place_ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(push_count, u32_array_count(&in_place));
+  u32_array_destroy(&in_place);
+  arena_destroy(&arn);
+
+  counting_heap heap = {};
+  u32_array copied = u32_array_create(0, counting_allocator(&heap));
+  start = std::chrono::steady_clock::now();
+  for (u32 idx = 0; idx < push_count; ++idx) {
+    u32_array_push(&copied, idx);
+  }
+  f64 copied_ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(push_count, u32_array_count(&copied));
+  u32_array_destroy(&copied);
+
+  thread_log_info("typed_array %u pushes: arena in-place growth %.2f ms, copy growth %.2f ms (%u allocations)",
+                  push_count,
+                  in_place_ms,
+                  copied_ms,
+                  heap.allocs);
+}
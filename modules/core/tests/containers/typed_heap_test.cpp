@@ -0,0 +1,176 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+namespace {
+
+  struct timed_event {
+    u64 due_tick;
+    u32 event_idx;
+  };
+
+  b32 timed_event_less(timed_event const* lhs, timed_event const* rhs) {
+    return lhs->due_tick < rhs->due_tick;
+  }
+
+  i32 timed_event_compare(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    u64 lhs = static_cast<timed_event const*>(lhs_ptr)->due_tick;
+    u64 rhs = static_cast<timed_event const*>(rhs_ptr)->due_tick;
+    return lhs < rhs ? -1 : lhs > rhs;
+  }
+
+  // Sorted descending so that due events sit at the end and pop cheaply.
+  i32 timed_event_compare_desc(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    return timed_event_compare(rhs_ptr, lhs_ptr, user_data);
+  }
+
+  TYPED_HEAP_DECLARE(event_queue, timed_event)
+  TYPED_HEAP_IMPLEMENT(event_queue, timed_event, timed_event_less, TYPED_HEAP_DEFAULT_ARITY)
+
+  TYPED_HEAP_DECLARE(max_f32_heap, f32)
+  TYPED_HEAP_IMPLEMENT(max_f32_heap, f32, TYPED_HEAP_GREATER, 2)
+
+  TYPED_HEAP_DECLARE(min_u32_heap, u32)
+  TYPED_HEAP_IMPLEMENT(min_u32_heap, u32, TYPED_HEAP_LESS, 8)
+
+}  // namespace
+
+TEST(containers_typed_heap_test, push_pop_peek) {
+  allocator zero_alloc = {0};
+  event_queue events = event_queue_create(0, zero_alloc);
+  EXPECT_EQ(nullptr, event_queue_peek(&events));
+  EXPECT_EQ(0, event_queue_pop(&events, NULL));
+
+  for (u32 idx = 0; idx < 3000; ++idx) {
+    EXPECT_NE(0, event_queue_push(&events, timed_event {(u64)((idx * 1237U) % 3000U), idx}));
+  }
+  EXPECT_EQ(3000U, event_queue_count(&events));
+  EXPECT_NE(0, event_queue_check(events.data, events.count));
+  EXPECT_EQ(0U, event_queue_peek(&events)->due_tick);
+
+  for (u64 expected = 0; expected < 3000; ++expected) {
+    timed_event event = {};
+    ASSERT_NE(0, event_queue_pop(&events, &event));
+    EXPECT_EQ(expected, event.due_tick);
+  }
+  EXPECT_EQ(0U, event_queue_count(&events));
+
+  event_queue_destroy(&events);
+  EXPECT_EQ(0U, event_queue_capacity(&events));
+}
+
+TEST(containers_typed_heap_test, max_heap_and_batches) {
+  allocator zero_alloc = {0};
+  max_f32_heap hp = max_f32_heap_create(4, zero_alloc);
+
+  f32 batch[256];
+  for (i32 idx = 0; idx < 256; ++idx) {
+    batch[idx] = (f32)((idx * 97) % 256) * 0.5F;
+  }
+  EXPECT_NE(0, max_f32_heap_push_many(&hp, batch, 256));
+  EXPECT_NE(0, max_f32_heap_push_many(&hp, batch, 3));
+  EXPECT_EQ(259U, max_f32_heap_count(&hp));
+  EXPECT_NE(0, max_f32_heap_check(hp.data, hp.count));
+  EXPECT_EQ(127.5F, *max_f32_heap_peek(&hp));
+
+  f32 prev = 1e9F;
+  f32 value = 0.0F;
+  while (max_f32_heap_pop(&hp, &value)) {
+    EXPECT_LE(value, prev);
+    prev = value;
+  }
+  max_f32_heap_destroy(&hp);
+
+  u32 values[1000];
+  for (u32 idx = 0; idx < 1000; ++idx) {
+    values[idx] = (idx * 7919U) % 1000U;
+  }
+  EXPECT_EQ(1000U, min_u32_heap_heapify(values, 1000));
+  EXPECT_NE(0, min_u32_heap_check(values, 1000));
+  EXPECT_EQ(0U, values[0]);
+}
+
+namespace {
+
+  // Scheduler-like workload: every tick schedules a few events at varying
+  // delays and runs everything that is due.
+  constexpr u32 bench_ticks = 500;
+  constexpr u32 bench_events_per_tick = 32;
+
+  u64 bench_delay(u32 tick, u32 idx) {
+    return 1 + ((u64)(tick * 2654435761U + idx * 40503U) % 200);
+  }
+
+}  // namespace
+
+// Compares the typed and generic heaps against re-sorting the pending array
+// with sort_insertion every tick. Results are logged only; timing is too noisy
+// to assert on.
+TEST(containers_typed_heap_test, benchmark_vs_insertion_resort) {
+  allocator zero_alloc = {0};
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  u64 typed_fired = 0;
+  event_queue typed = event_queue_create(0, zero_alloc);
+  auto start = std::chrono::steady_clock::now();
+  for (u32 tick = 0; tick < bench_ticks; ++tick) {
+    for (u32 idx = 0; idx < bench_events_per_tick; ++idx) {
+      event_queue_push(&typed, timed_event {tick + bench_delay(tick, idx), idx});
+    }
+    while (event_queue_count(&typed) > 0 && event_queue_peek(&typed)->due_tick <= tick) {
+      event_queue_pop(&typed, NULL);
+      typed_fired++;
+    }
+  }
+  f64 typed_ms = elapsed_ms(start);
+  event_queue_destroy(&typed);
+
+  u64 generic_fired = 0;
+  priority_queue generic = priority_queue_create(sizeof(timed_event), 0, timed_event_compare, NULL, 0, zero_alloc);
+  start = std::chrono::steady_clock::now();
+  for (u32 tick = 0; tick < bench_ticks; ++tick) {
+    for (u32 idx = 0; idx < bench_events_per_tick; ++idx) {
+      timed_event event = {tick + bench_delay(tick, idx), idx};
+      priority_queue_push(&generic, &event);
+    }
+    while (priority_queue_count(&generic) > 0 && static_cast<timed_event const*>(priority_queue_peek(&generic))->due_tick <= tick) {
+      priority_queue_pop(&generic, NULL);
+      generic_fired++;
+    }
+  }
+  f64 generic_ms = elapsed_ms(start);
+  priority_queue_destroy(&generic);
+
+  // Enough room for every event that can be pending at once.
+  static timed_event pending[bench_events_per_tick * 256];
+  sz pending_count = 0;
+  u64 sorted_fired = 0;
+  start = std::chrono::steady_clock::now();
+  for (u32 tick = 0; tick < bench_ticks; ++tick) {
+    for (u32 idx = 0; idx < bench_events_per_tick; ++idx) {
+      pending[pending_count++] = timed_event {tick + bench_delay(tick, idx), idx};
+    }
+    sort_insertion(pending, pending_count, sizeof(timed_event), timed_event_compare_desc, NULL);
+    while (pending_count > 0 && pending[pending_count - 1].due_tick <= tick) {
+      pending_count--;
+      sorted_fired++;
+    }
+  }
+  f64 sorted_ms = elapsed_ms(start);
+
+  EXPECT_EQ(typed_fired, generic_fired);
+  EXPECT_EQ(typed_fired, sorted_fired);
+  thread_log_info("%u ticks x %u events: typed_heap %.2f ms, priority_queue %.2f ms, sort_insertion per tick %.2f ms (%llu fired)",
+                  bench_ticks,
+                  bench_events_per_tick,
+                  typed_ms,
+                  generic_ms,
+                  sorted_ms,
+                  (unsigned long long)typed_fired);
+}
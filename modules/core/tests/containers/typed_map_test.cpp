@@ -0,0 +1,171 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+namespace {
+
+  struct mesh_info {
+    u32 vertex_count;
+    u32 index_count;
+  };
+
+  struct grid_cell {
+    i32 x;
+    i32 y;
+  };
+
+  u64 grid_cell_hash(grid_cell const* key) {
+    return typed_map_hash_combine(typed_map_hash_u32((u32 const*)&key->x), (u64)(u32)key->y);
+  }
+
+  b32 grid_cell_eq(grid_cell const* lhs, grid_cell const* rhs) {
+    return lhs->x == rhs->x && lhs->y == rhs->y;
+  }
+
+  TYPED_MAP_DECLARE(id_mesh_map, u64, mesh_info)
+  TYPED_MAP_IMPLEMENT(id_mesh_map, u64, mesh_info, typed_map_hash_u64, typed_map_eq_u64)
+
+  TYPED_MAP_DECLARE(name_map, cstr8, i32)
+  TYPED_MAP_IMPLEMENT(name_map, cstr8, i32, typed_map_hash_cstr8, typed_map_eq_cstr8)
+
+  TYPED_MAP_DECLARE(grid_map, grid_cell, f64)
+  TYPED_MAP_IMPLEMENT(grid_map, grid_cell, f64, grid_cell_hash, grid_cell_eq)
+
+}  // namespace
+
+TEST(containers_typed_map_test, set_get_inline_values) {
+  allocator zero_alloc = {0};
+  id_mesh_map map = id_mesh_map_create(16, zero_alloc);
+  EXPECT_EQ(16U, id_mesh_map_capacity(&map));
+
+  EXPECT_NE(0, id_mesh_map_set(&map, 7, mesh_info {24, 36}));
+  EXPECT_NE(0, id_mesh_map_set(&map, 9, mesh_info {8, 12}));
+  EXPECT_EQ(2U, id_mesh_map_count(&map));
+
+  mesh_info* cube = id_mesh_map_get(&map, 7);
+  ASSERT_NE(nullptr, cube);
+  EXPECT_EQ(24U, cube->vertex_count);
+  EXPECT_EQ(36U, cube->index_count);
+
+  // Values live in the map; writes through the pointer are visible to later lookups.
+  cube->index_count = 40;
+  EXPECT_EQ(40U, id_mesh_map_get(&map, 7)->index_count);
+  EXPECT_EQ(nullptr, id_mesh_map_get(&map, 8));
+
+  EXPECT_NE(0, id_mesh_map_set(&map, 7, mesh_info {1, 2}));
+  EXPECT_EQ(2U, id_mesh_map_count(&map));
+  EXPECT_EQ(1U, id_mesh_map_get(&map, 7)->vertex_count);
+
+  id_mesh_map_destroy(&map);
+  EXPECT_EQ(0U, id_mesh_map_capacity(&map));
+}
+
+TEST(containers_typed_map_test, growth_and_remove) {
+  allocator zero_alloc = {0};
+  id_mesh_map map = id_mesh_map_create(16, zero_alloc);
+
+  for (u64 key = 0; key < 1000; ++key) {
+    id_mesh_map_set(&map, key, mesh_info {(u32)key, (u32)(key * 3)});
+  }
+  EXPECT_EQ(1000U, id_mesh_map_count(&map));
+
+  for (u64 key = 0; key < 1000; key += 2) {
+    EXPECT_NE(0, id_mesh_map_remove(&map, key));
+  }
+  EXPECT_EQ(0, id_mesh_map_remove(&map, 0));
+  EXPECT_EQ(500U, id_mesh_map_count(&map));
+
+  for (u64 key = 0; key < 1000; ++key) {
+    mesh_info* info = id_mesh_map_get(&map, key);
+    if (key % 2 == 0) {
+      EXPECT_EQ(nullptr, info);
+    } else {
+      ASSERT_NE(nullptr, info);
+      EXPECT_EQ((u32)(key * 3), info->index_count);
+    }
+  }
+
+  id_mesh_map_clear(&map);
+  EXPECT_EQ(0U, id_mesh_map_count(&map));
+  EXPECT_EQ(0, id_mesh_map_has(&map, 1));
+
+  id_mesh_map_destroy(&map);
+}
+
+TEST(containers_typed_map_test, string_keys) {
+  allocator zero_alloc = {0};
+  name_map map = name_map_create(16, zero_alloc);
+
+  // Lookups compare by content, not by pointer.
+  c8 buffer[16] = "orange";
+  name_map_set(&map, "apple", 1);
+  name_map_set(&map, "orange", 2);
+  ASSERT_NE(nullptr, name_map_get(&map, buffer));
+  EXPECT_EQ(2, *name_map_get(&map, buffer));
+  EXPECT_EQ(0, name_map_has(&map, "pear"));
+
+  EXPECT_NE(0, name_map_remove(&map, "apple"));
+  EXPECT_EQ(1U, name_map_count(&map));
+
+  name_map_destroy(&map);
+}
+
+TEST(containers_typed_map_test, struct_keys_and_foreach) {
+  allocator zero_alloc = {0};
+  grid_map map = grid_map_create(16, zero_alloc);
+  EXPECT_NE(0, grid_map_reserve(&map, 100));
+  sz cap = grid_map_capacity(&map);
+
+  for (i32 y = -5; y < 5; ++y) {
+    for (i32 x = -5; x < 5; ++x) {
+      grid_map_set(&map, grid_cell {x, y}, (f64)(x * 100 + y));
+    }
+  }
+  EXPECT_EQ(100U, grid_map_count(&map));
+  EXPECT_EQ(cap, grid_map_capacity(&map));
+  EXPECT_EQ(-302.0, *grid_map_get(&map, grid_cell {-3, -2}));
+
+  sz visited = 0;
+  TYPED_MAP_FOREACH(grid_map, &map, idx) {
+    EXPECT_EQ((f64)(map.keys[idx].x * 100 + map.keys[idx].y), map.values[idx]);
+    visited++;
+  }
+  EXPECT_EQ(100U, visited);
+
+  grid_map_destroy(&map);
+}
+
+// Grows well past the safe-loop limit so rehashing and iteration have to scale
+// with the data instead of a fixed iteration cap.
+TEST(containers_typed_map_test, large_growth_and_foreach) {
+  allocator zero_alloc = {0};
+  id_mesh_map map = id_mesh_map_create(16, zero_alloc);
+
+  constexpr u32 large_count = 100000;
+  for (u32 key = 0; key < large_count; ++key) {
+    ASSERT_NE(0, id_mesh_map_set(&map, key, mesh_info {key, key * 3}));
+  }
+  EXPECT_EQ(static_cast<sz>(large_count), id_mesh_map_count(&map));
+  EXPECT_GT(id_mesh_map_capacity(&map), static_cast<sz>(large_count));
+
+  sz visited = 0;
+  u64 key_sum = 0;
+  TYPED_MAP_FOREACH(id_mesh_map, &map, idx) {
+    EXPECT_EQ(map.keys[idx] * 3, static_cast<u64>(map.values[idx].index_count));
+    key_sum += map.keys[idx];
+    visited++;
+  }
+  EXPECT_EQ(static_cast<sz>(large_count), visited);
+  EXPECT_EQ(static_cast<u64>(large_count) * (large_count - 1) / 2, key_sum);
+
+  for (u32 key = 0; key < large_count; key += 2) {
+    EXPECT_NE(0, id_mesh_map_remove(&map, key));
+  }
+  EXPECT_EQ(static_cast<sz>(large_count / 2), id_mesh_map_count(&map));
+  EXPECT_EQ(nullptr, id_mesh_map_get(&map, 4));
+  ASSERT_NE(nullptr, id_mesh_map_get(&map, large_count - 1));
+  EXPECT_EQ(large_count - 1, id_mesh_map_get(&map, large_count - 1)->vertex_count);
+
+  id_mesh_map_destroy(&map);
+}
@@ -0,0 +1,149 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+#include <string.h>
+
+namespace {
+
+  struct draw_item {
+    u64 sort_key;
+    u32 mesh_idx;
+    u32 material_idx;
+  };
+
+  b32 draw_item_less(draw_item const* lhs, draw_item const* rhs) {
+    return lhs->sort_key < rhs->sort_key;
+  }
+
+  i32 draw_item_compare(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    u64 lhs = ((draw_item const*)lhs_ptr)->sort_key;
+    u64 rhs = ((draw_item const*)rhs_ptr)->sort_key;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+  }
+
+  TYPED_SORT_DECLARE(i32_values, i32)
+  TYPED_SORT_IMPLEMENT(i32_values, i32, TYPED_SORT_LESS)
+
+  TYPED_SORT_DECLARE(f64_values, f64)
+  TYPED_SORT_IMPLEMENT(f64_values, f64, TYPED_SORT_LESS)
+
+  TYPED_SORT_DECLARE(draw_items, draw_item)
+  TYPED_SORT_IMPLEMENT(draw_items, draw_item, draw_item_less)
+
+  u64 typed_sort_rand(u64* state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 11;
+  }
+
+  constexpr sz typed_sort_count = 20000;
+  i32 typed_values[typed_sort_count];
+  draw_item typed_items[typed_sort_count];
+  draw_item typed_items_generic[typed_sort_count];
+
+  // Sorted, reversed, all equal, organ pipe, few distinct values, sawtooth,
+  // a sorted prefix with a random tail, and random.
+  void typed_sort_fill(i32* values, sz count, i32 kind, u64 seed) {
+    u64 state = seed;
+    for (sz idx = 0; idx < count; ++idx) {
+      i32 rnd = (i32)(typed_sort_rand(&state) % 1000000) - 500000;
+      switch (kind) {
+        case 0: values[idx] = (i32)idx; break;
+        case 1: values[idx] = (i32)(count - idx); break;
+        case 2: values[idx] = 7; break;
+        case 3: values[idx] = (i32)(idx < count / 2 ? idx : count - idx); break;
+        case 4: values[idx] = rnd % 3; break;
+        case 5: values[idx] = (i32)(idx % 131); break;
+        case 6: values[idx] = idx < count - 50 ? (i32)idx : rnd; break;
+        default: values[idx] = rnd; break;
+      }
+    }
+  }
+
+  i64 typed_sort_sum(i32 const* values, sz count) {
+    i64 sum = 0;
+    for (sz idx = 0; idx < count; ++idx) {
+      sum += values[idx] * (i64)(values[idx] % 7 + 1);
+    }
+    return sum;
+  }
+
+}  // namespace
+
+TEST(containers_typed_sort_test, small_arrays) {
+  i32 values[] = {3, 1, 4, 1, 5, 9, 2, 6};
+  EXPECT_EQ(8U, i32_values_sort(values, 8));
+  i32 expected[] = {1, 1, 2, 3, 4, 5, 6, 9};
+  for (sz idx = 0; idx < 8; ++idx) {
+    EXPECT_EQ(expected[idx], values[idx]);
+  }
+  EXPECT_NE(0, i32_values_check(values, 8));
+
+  EXPECT_EQ(0U, i32_values_sort(values, 0));
+  EXPECT_EQ(1U, i32_values_sort(values, 1));
+  EXPECT_EQ(0U, i32_values_sort(NULL, 4));
+
+  f64 reals[] = {2.5, -1.0, 0.0, -7.25, 3.0};
+  EXPECT_EQ(5U, f64_values_sort(reals, 5));
+  EXPECT_EQ(-7.25, reals[0]);
+  EXPECT_EQ(3.0, reals[4]);
+  EXPECT_NE(0, f64_values_check(reals, 5));
+}
+
+TEST(containers_typed_sort_test, patterns) {
+  for (i32 kind = 0; kind < 8; ++kind) {
+    typed_sort_fill(typed_values, typed_sort_count, kind, 100 + kind);
+    i64 before = typed_sort_sum(typed_values, typed_sort_count);
+    EXPECT_EQ(typed_sort_count, i32_values_sort(typed_values, typed_sort_count));
+    EXPECT_NE(0, i32_values_check(typed_values, typed_sort_count)) << "pattern " << kind;
+    EXPECT_EQ(before, typed_sort_sum(typed_values, typed_sort_count)) << "pattern " << kind;
+  }
+}
+
+TEST(containers_typed_sort_test, records_match_generic_sort) {
+  allocator zero_alloc = {0};
+  u64 state = 5;
+  for (sz idx = 0; idx < typed_sort_count; ++idx) {
+    // Distinct keys, so the unstable sorts must agree element for element.
+    typed_items[idx] = draw_item {(typed_sort_rand(&state) << 20) | idx, (u32)idx, (u32)(idx * 3)};
+  }
+  memcpy(typed_items_generic, typed_items, sizeof(typed_items));
+
+  EXPECT_EQ(typed_sort_count, draw_items_sort(typed_items, typed_sort_count));
+  EXPECT_EQ(typed_sort_count,
+            sort_quick(typed_items_generic, typed_sort_count, sizeof(draw_item), draw_item_compare, NULL, zero_alloc));
+  EXPECT_NE(0, draw_items_check(typed_items, typed_sort_count));
+  EXPECT_EQ(0, memcmp(typed_items, typed_items_generic, sizeof(typed_items)));
+  for (sz idx = 0; idx < typed_sort_count; ++idx) {
+    EXPECT_EQ(typed_items[idx].mesh_idx * 3, typed_items[idx].material_idx);
+  }
+}
+
+// Times the generated sort against sort_quick on the same records.
+// Results are logged only; timing is too noisy to assert on.
+TEST(containers_typed_sort_test, benchmark_vs_sort_quick) {
+  allocator zero_alloc = {0};
+  u64 state = 9;
+  for (sz idx = 0; idx < typed_sort_count; ++idx) {
+    typed_items[idx] = draw_item {typed_sort_rand(&state), (u32)idx, 0};
+  }
+  memcpy(typed_items_generic, typed_items, sizeof(typed_items));
+
+  auto start = std::chrono::steady_clock::now();
+  sort_quick(typed_items_generic, typed_sort_count, sizeof(draw_item), draw_item_compare, NULL, zero_alloc);
+  f64 generic_ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  draw_items_sort(typed_items, typed_sort_count);
+  f64 typed_ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(0, memcmp(typed_items, typed_items_generic, sizeof(typed_items)));
+  thread_log_info("typed sort %.2f ms, sort_quick %.2f ms (%llu records of %u bytes)",
+                  typed_ms,
+                  generic_ms,
+                  (unsigned long long)typed_sort_count,
+                  (u32)sizeof(draw_item));
+}
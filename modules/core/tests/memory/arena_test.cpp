@@ -78,3 +78,66 @@ TEST(memory_arena_test, total_free) {
   EXPECT_EQ(total, used + free);
   arena_destroy(&arn);
 }
+
+TEST(memory_arena_test, virtual_alloc) {
+  arena arn = arena_create_virtual(64 * 1024 * 1024, NULL);
+  EXPECT_NE(0, arena_is_virtual(&arn));
+  EXPECT_EQ(1U, arena_block_count(&arn));
+  sz initial = arena_total_size(&arn);
+  EXPECT_LT(initial, (sz)64 * 1024 * 1024);
+
+  // Allocations past the first commit step stay contiguous in the same block.
+  u8* first = (u8*)arena_alloc(&arn, 1024, 16);
+  u8* big = (u8*)arena_alloc(&arn, 4 * 1024 * 1024, 16);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, big);
+  EXPECT_GE(big, first + 1024);
+  big[4 * 1024 * 1024 - 1] = 0x5A;
+  EXPECT_EQ(1U, arena_block_count(&arn));
+  EXPECT_GT(arena_total_size(&arn), initial);
+  arena_destroy(&arn);
+  EXPECT_EQ(0, arena_is_virtual(&arn));
+}
+
+TEST(memory_arena_test, virtual_realloc_in_place) {
+  arena arn = arena_create_virtual(64 * 1024 * 1024, NULL);
+  u8* ptr = (u8*)arena_alloc(&arn, 100, 8);
+  ASSERT_NE(nullptr, ptr);
+  ptr[0] = 7;
+  u8* grown = (u8*)arena_realloc(&arn, ptr, 100, 8 * 1024 * 1024, 8);
+  EXPECT_EQ(ptr, grown);
+  EXPECT_EQ(7, grown[0]);
+  grown[8 * 1024 * 1024 - 1] = 1;
+  arena_destroy(&arn);
+}
+
+TEST(memory_arena_test, virtual_exhausted) {
+  arena arn = arena_create_virtual(256 * 1024, NULL);
+  EXPECT_EQ(nullptr, arena_alloc(&arn, 512 * 1024, 8));
+  EXPECT_NE(nullptr, arena_alloc(&arn, 128 * 1024, 8));
+  arena_destroy(&arn);
+}
+
+TEST(memory_arena_test, virtual_mutexed_reserve_failure) {
+  // No address space is this large, so the reservation fails and the arena
+  // comes back zeroed without holding on to its mutex.
+  arena arn = arena_create_virtual_mutexed(SZ_MAX / 2);
+  EXPECT_EQ(0, arena_is_virtual(&arn));
+  EXPECT_EQ(nullptr, arn.opt_mutex);
+  EXPECT_EQ(0, arn.mutex_owned);
+  arena_destroy(&arn);
+}
+
+TEST(memory_arena_test, virtual_clear_decommits) {
+  arena arn = arena_create_virtual(64 * 1024 * 1024, NULL);
+  sz initial = arena_total_size(&arn);
+  u8* ptr = (u8*)arena_alloc(&arn, 2 * 1024 * 1024, 8);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_GT(arena_total_size(&arn), initial);
+  arena_clear(&arn);
+  EXPECT_EQ(initial, arena_total_size(&arn));
+  EXPECT_EQ(0U, arena_total_used(&arn));
+  EXPECT_EQ(ptr, arena_alloc(&arn, 2 * 1024 * 1024, 8));
+  EXPECT_EQ(0, arena_remove_block(&arn, arn.vmem_base));
+  arena_destroy(&arn);
+}
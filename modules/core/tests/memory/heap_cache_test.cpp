@@ -0,0 +1,144 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+namespace {
+
+  struct heap_cache_worker_args {
+    heap* shared;
+    atomic_i32 failures;
+  };
+
+  i32 heap_cache_worker(u32 idx, void* arg) {
+    heap_cache_worker_args* args = static_cast<heap_cache_worker_args*>(arg);
+    heap_cache cache = heap_cache_create(args->shared);
+    void* ptrs[64];
+    for (i32 round = 0; round < 50; ++round) {
+      for (sz i = 0; i < 64; ++i) {
+        ptrs[i] = heap_cache_alloc(&cache, 16 + ((i + idx) % 20) * 24, 8);
+        if (ptrs[i] == NULL) {
+          atomic_i32_add(&args->failures, 1);
+          continue;
+        }
+        memset(ptrs[i], (int)idx, 16);
+      }
+      for (sz i = 0; i < 64; ++i) {
+        if (ptrs[i] != NULL && *(u8*)ptrs[i] != (u8)idx) {
+          atomic_i32_add(&args->failures, 1);
+        }
+        heap_cache_dealloc(&cache, ptrs[i]);
+      }
+    }
+    heap_cache_destroy(&cache);
+    return 0;
+  }
+
+}  // namespace
+
+TEST(memory_heap_cache_test, create) {
+  heap shared = heap_create(thread_get_allocator(), NULL, kb(64));
+  heap_cache cache = heap_cache_create(&shared);
+  EXPECT_EQ(&shared, cache.shared);
+  EXPECT_EQ(0U, heap_cache_cached_count(&cache));
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, alloc_reuses_cached_chunk) {
+  heap shared = heap_create(thread_get_allocator(), NULL, kb(64));
+  heap_cache cache = heap_cache_create(&shared);
+  void* ptr = heap_cache_alloc(&cache, 40, 8);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_EQ(0U, (up)ptr % HEAP_CACHE_ALIGN);
+  heap_cache_dealloc(&cache, ptr);
+  EXPECT_EQ(ptr, heap_cache_alloc(&cache, 40, 8));
+  heap_cache_dealloc(&cache, ptr);
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, batches_shared_heap_access) {
+  heap shared = heap_create_mutexed(thread_get_allocator(), kb(64));
+  heap_cache cache = heap_cache_create(&shared);
+  for (i32 i = 0; i < 1000; ++i) {
+    void* ptr = heap_cache_alloc(&cache, 64, 8);
+    ASSERT_NE(nullptr, ptr);
+    heap_cache_dealloc(&cache, ptr);
+  }
+  EXPECT_EQ(1U, cache.refill_count);
+  EXPECT_EQ(0U, cache.flush_count);
+
+  void* ptrs[HEAP_CACHE_BIN_CAP * 4];
+  for (sz i = 0; i < HEAP_CACHE_BIN_CAP * 4; ++i) {
+    ptrs[i] = heap_cache_alloc(&cache, 100, 8);
+    ASSERT_NE(nullptr, ptrs[i]);
+  }
+  for (sz i = 0; i < HEAP_CACHE_BIN_CAP * 4; ++i) {
+    heap_cache_dealloc(&cache, ptrs[i]);
+  }
+  // Each refill or flush moves half a magazine under one lock acquisition.
+  EXPECT_LE(cache.refill_count + cache.flush_count, 2U * HEAP_CACHE_BIN_CAP * 4 / HEAP_CACHE_BIN_BATCH);
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, large_and_aligned_requests_bypass_cache) {
+  heap shared = heap_create(thread_get_allocator(), NULL, kb(64));
+  heap_cache cache = heap_cache_create(&shared);
+  void* big = heap_cache_alloc(&cache, HEAP_CACHE_MAX_SIZE * 4, 8);
+  ASSERT_NE(nullptr, big);
+  void* aligned = heap_cache_alloc(&cache, 32, 128);
+  ASSERT_NE(nullptr, aligned);
+  EXPECT_EQ(0U, (up)aligned % 128);
+  heap_cache_dealloc(&cache, big);
+  EXPECT_EQ(0U, heap_cache_cached_count(&cache));
+  heap_cache_dealloc(&cache, aligned);
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, flush_returns_chunks) {
+  heap shared = heap_create(thread_get_allocator(), NULL, kb(64));
+  void* probe = heap_alloc(&shared, 8, 8);
+  heap_dealloc(&shared, probe);
+  sz free_before = heap_total_free(&shared);
+
+  heap_cache cache = heap_cache_create(&shared);
+  void* ptr = heap_cache_alloc(&cache, 200, 8);
+  ASSERT_NE(nullptr, ptr);
+  heap_cache_dealloc(&cache, ptr);
+  EXPECT_GT(heap_cache_cached_count(&cache), 0U);
+  heap_cache_flush(&cache);
+  EXPECT_EQ(0U, heap_cache_cached_count(&cache));
+  EXPECT_EQ(free_before, heap_total_free(&shared));
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, get_allocator) {
+  heap shared = heap_create(thread_get_allocator(), NULL, kb(64));
+  heap_cache cache = heap_cache_create(&shared);
+  allocator alloc = heap_cache_get_allocator(&cache);
+  i32* arr = (i32*)allocator_alloc(alloc, 10 * sizeof(i32));
+  ASSERT_NE(nullptr, arr);
+  arr[0] = 42;
+  arr = (i32*)allocator_realloc(alloc, arr, 400 * sizeof(i32));
+  ASSERT_NE(nullptr, arr);
+  EXPECT_EQ(42, arr[0]);
+  allocator_dealloc(alloc, arr);
+  heap_cache_destroy(&cache);
+  heap_destroy(&shared);
+}
+
+TEST(memory_heap_cache_test, threads_share_mutexed_heap) {
+  heap shared = heap_create_mutexed(thread_get_allocator(), kb(64));
+  heap_cache_worker_args args = {};
+  args.shared = &shared;
+  thread_group group = thread_group_create(4, heap_cache_worker, &args, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  EXPECT_EQ(0, atomic_i32_get(&args.failures));
+  heap_destroy(&shared);
+}
@@ -83,3 +83,221 @@ TEST(memory_heap_test, get_allocator) {
   EXPECT_NE(nullptr, ptr);
   heap_destroy(&hep);
 }
+
+TEST(memory_heap_test, alloc_respects_alignment) {
+  allocator zero_alloc = {0};
+  heap hep = heap_create(zero_alloc, NULL, 4096);
+  alignas(64) u8 buf[16384];
+  heap_add_block(&hep, buf, sizeof(buf));
+  sz aligns[] = {8, 16, 32, 64, 128, 256};
+  for (sz align : aligns) {
+    void* ptr = heap_alloc(&hep, 40, align);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_EQ(0U, (up)ptr % align);
+  }
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, dealloc_restores_free_space) {
+  allocator zero_alloc = {0};
+  heap hep = heap_create(zero_alloc, NULL, 4096);
+  alignas(16) u8 buf[65536];
+  heap_add_block(&hep, buf, sizeof(buf));
+  sz free_before = heap_total_free(&hep);
+
+  void* ptrs[256];
+  for (sz i = 0; i < 256; ++i) {
+    ptrs[i] = heap_alloc(&hep, 8 + (i % 13) * 16, 8);
+    ASSERT_NE(nullptr, ptrs[i]);
+    memset(ptrs[i], (int)i, 8);
+  }
+  for (sz i = 0; i < 256; ++i) {
+    EXPECT_EQ((u8)i, *(u8*)ptrs[i]);
+  }
+  // Releasing in reverse order lets each chunk merge with its free successor.
+  for (sz i = 256; i > 0; --i) {
+    heap_dealloc(&hep, ptrs[i - 1]);
+  }
+  EXPECT_EQ(free_before, heap_total_free(&hep));
+
+  void* big = heap_alloc(&hep, free_before - 64, 8);
+  EXPECT_NE(nullptr, big);
+  heap_destroy(&hep);
+}
+
+namespace {
+  constexpr sz many_chunks_count = 4096;
+
+  i32 compare_chunk_ptr(const void* lhs_ptr, const void* rhs_ptr, void* user_data) {
+    (void)user_data;
+    up lhs = (up)(*(void* const*)lhs_ptr);
+    up rhs = (up)(*(void* const*)rhs_ptr);
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+  }
+
+  // Allocates mixed sizes, frees every third chunk and refills the holes.
+  void many_chunks_fill(heap* hep, void** ptrs) {
+    for (sz i = 0; i < many_chunks_count; ++i) {
+      ptrs[i] = heap_alloc(hep, 16 + (i % 7) * 24, 8);
+      ASSERT_NE(nullptr, ptrs[i]);
+    }
+    for (sz i = 0; i < many_chunks_count; i += 3) {
+      heap_dealloc(hep, ptrs[i]);
+      ptrs[i] = NULL;
+    }
+    for (sz i = 0; i < many_chunks_count; i += 3) {
+      ptrs[i] = heap_alloc(hep, 16, 8);
+      ASSERT_NE(nullptr, ptrs[i]);
+    }
+  }
+
+  void many_chunks_free(heap* hep, void** ptrs) {
+    for (sz i = 0; i < many_chunks_count; ++i) {
+      heap_dealloc(hep, ptrs[i]);
+      ptrs[i] = NULL;
+    }
+  }
+}  // namespace
+
+TEST(memory_heap_test, many_live_chunks) {
+  heap hep = heap_create(thread_get_allocator(), NULL, kb(64));
+  void* ptrs[many_chunks_count];
+  void* sorted[many_chunks_count];
+
+  // The first round grows the heap to the blocks this pattern needs.
+  many_chunks_fill(&hep, ptrs);
+  many_chunks_free(&hep, ptrs);
+  sz blocks_start = heap_block_count(&hep);
+  sz free_start = heap_total_free(&hep);
+  EXPECT_GT(blocks_start, 1U);
+
+  // The second round must fit in the same blocks: freed chunks coalesced back.
+  many_chunks_fill(&hep, ptrs);
+  EXPECT_EQ(blocks_start, heap_block_count(&hep));
+
+  // Every live chunk is aligned, distinct and does not overlap its neighbour.
+  memcpy(sorted, ptrs, sizeof(ptrs));
+  allocator zero_alloc = {0};
+  sort_quick(sorted, many_chunks_count, sizeof(void*), compare_chunk_ptr, NULL, zero_alloc);
+  for (sz i = 0; i < many_chunks_count; ++i) {
+    EXPECT_EQ(0U, (up)sorted[i] % 8);
+    if (i > 0) {
+      ASSERT_LE((up)sorted[i - 1] + heap_usable_size(sorted[i - 1]), (up)sorted[i]);
+    }
+  }
+
+  many_chunks_free(&hep, ptrs);
+  EXPECT_EQ(free_start, heap_total_free(&hep));
+  EXPECT_EQ(blocks_start, heap_block_count(&hep));
+
+  EXPECT_GT(heap_trim(&hep), 0U);
+  EXPECT_EQ(0U, heap_block_count(&hep));
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, dealloc_coalesces_both_neighbours) {
+  allocator zero_alloc = {0};
+  heap hep = heap_create(zero_alloc, NULL, 4096);
+  alignas(16) u8 buf[16384];
+  heap_add_block(&hep, buf, sizeof(buf));
+  sz free_before = heap_total_free(&hep);
+
+  void* ptrs[64];
+  for (sz i = 0; i < 64; ++i) {
+    ptrs[i] = heap_alloc(&hep, 48, 8);
+    ASSERT_NE(nullptr, ptrs[i]);
+  }
+  for (sz i = 1; i < 64; i += 2) {
+    heap_dealloc(&hep, ptrs[i]);
+  }
+  for (sz i = 0; i < 64; i += 2) {
+    heap_dealloc(&hep, ptrs[i]);
+  }
+  EXPECT_EQ(free_before, heap_total_free(&hep));
+  EXPECT_NE(nullptr, heap_alloc(&hep, free_before - 64, 8));
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, trim_releases_empty_owned_blocks) {
+  heap hep = heap_create(thread_get_allocator(), NULL, 4096);
+  alignas(16) u8 buf[4096];
+  heap_add_block(&hep, buf, sizeof(buf));
+
+  void* ptrs[8];
+  for (sz i = 0; i < 8; ++i) {
+    ptrs[i] = heap_alloc(&hep, 3000, 8);
+    ASSERT_NE(nullptr, ptrs[i]);
+  }
+  sz blocks = heap_block_count(&hep);
+  EXPECT_GE(blocks, 8U);
+  EXPECT_EQ(0U, heap_trim(&hep));
+
+  for (sz i = 0; i < 8; ++i) {
+    heap_dealloc(&hep, ptrs[i]);
+  }
+  EXPECT_GT(heap_trim(&hep), 0U);
+  // The manually added block is never released.
+  EXPECT_EQ(1U, heap_block_count(&hep));
+  EXPECT_NE(nullptr, heap_alloc(&hep, 100, 8));
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, auto_trim_keeps_threshold) {
+  heap hep = heap_create(thread_get_allocator(), NULL, 4096);
+  heap_set_trim_threshold(&hep, 4096);
+
+  void* ptrs[8];
+  for (sz i = 0; i < 8; ++i) {
+    ptrs[i] = heap_alloc(&hep, 3000, 8);
+    ASSERT_NE(nullptr, ptrs[i]);
+  }
+  EXPECT_EQ(8U, heap_block_count(&hep));
+  for (sz i = 0; i < 8; ++i) {
+    heap_dealloc(&hep, ptrs[i]);
+  }
+  // Blocks are released until less than the threshold would stay free.
+  EXPECT_LT(heap_block_count(&hep), 8U);
+  EXPECT_GT(heap_block_count(&hep), 0U);
+  EXPECT_GE(heap_total_free(&hep), 4096U);
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, alloc_batch) {
+  heap hep = heap_create_mutexed(thread_get_allocator(), 4096);
+  void* ptrs[100];
+  EXPECT_EQ(100U, heap_alloc_batch(&hep, ptrs, 100, 72, 16));
+  for (sz i = 0; i < 100; ++i) {
+    ASSERT_NE(nullptr, ptrs[i]);
+    EXPECT_EQ(0U, (up)ptrs[i] % 16);
+    EXPECT_GE(heap_usable_size(ptrs[i]), 72U);
+    memset(ptrs[i], (int)i, 72);
+  }
+  for (sz i = 0; i < 100; ++i) {
+    EXPECT_EQ((u8)i, ((u8*)ptrs[i])[71]);
+  }
+  heap_dealloc_batch(&hep, ptrs, 100);
+  // Every block is empty again, so all of them can be trimmed.
+  EXPECT_GT(heap_trim(&hep), 0U);
+  EXPECT_EQ(0U, heap_block_count(&hep));
+  heap_destroy(&hep);
+}
+
+TEST(memory_heap_test, alloc_batch_large) {
+  heap hep = heap_create_mutexed(thread_get_allocator(), kb(256));
+  const sz count = 20000;
+  void** ptrs = (void**)allocator_alloc(thread_get_allocator(), count * sizeof(void*));
+  ASSERT_NE(nullptr, ptrs);
+  EXPECT_EQ(count, heap_alloc_batch(&hep, ptrs, count, 24, 8));
+  for (sz i = 0; i < count; ++i) {
+    ASSERT_NE(nullptr, ptrs[i]);
+    *(u32*)ptrs[i] = (u32)i;
+  }
+  for (sz i = 0; i < count; ++i) {
+    EXPECT_EQ((u32)i, *(u32*)ptrs[i]);
+  }
+  heap_dealloc_batch(&hep, ptrs, count);
+  EXPECT_GT(heap_trim(&hep), 0U);
+  EXPECT_EQ(0U, heap_block_count(&hep));
+  allocator_dealloc(thread_get_allocator(), ptrs);
+  heap_destroy(&hep);
+}
@@ -85,3 +85,196 @@ TEST(memory_pool_test, get_allocator) {
   EXPECT_NE(nullptr, ptr);
   pool_destroy(&pol);
 }
+
+namespace {
+
+  struct pool_lockfree_worker_args {
+    pool* pol;
+    atomic_i32 failures;
+  };
+
+  i32 pool_lockfree_worker(u32 idx, void* arg) {
+    pool_lockfree_worker_args* args = static_cast<pool_lockfree_worker_args*>(arg);
+    void* slots[32];
+    for (i32 round = 0; round < 200; ++round) {
+      for (sz i = 0; i < 32; ++i) {
+        slots[i] = pool_alloc(args->pol);
+        if (slots[i] == NULL) {
+          atomic_i32_add(&args->failures, 1);
+          continue;
+        }
+        *(u64*)slots[i] = ((u64)idx << 32) | i;
+      }
+      for (sz i = 0; i < 32; ++i) {
+        if (slots[i] == NULL) {
+          continue;
+        }
+        if (*(u64*)slots[i] != (((u64)idx << 32) | i)) {
+          atomic_i32_add(&args->failures, 1);
+        }
+        pool_dealloc(args->pol, slots[i]);
+      }
+    }
+    return 0;
+  }
+
+  // Mixes batch and single allocations so batch detaches race with pops and pushes.
+  i32 pool_lockfree_batch_worker(u32 idx, void* arg) {
+    pool_lockfree_worker_args* args = static_cast<pool_lockfree_worker_args*>(arg);
+    void* slots[48];
+    for (i32 round = 0; round < 200; ++round) {
+      sz got = pool_alloc_batch(args->pol, slots, 32);
+      if (got != 32) {
+        atomic_i32_add(&args->failures, 1);
+      }
+      for (sz i = 32; i < 48; ++i) {
+        slots[i] = pool_alloc(args->pol);
+      }
+      for (sz i = 0; i < 48; ++i) {
+        if (slots[i] != NULL) {
+          *(u64*)slots[i] = ((u64)idx << 32) | i;
+        }
+      }
+      for (sz i = 0; i < 48; ++i) {
+        if (slots[i] != NULL && *(u64*)slots[i] != (((u64)idx << 32) | i)) {
+          atomic_i32_add(&args->failures, 1);
+        }
+      }
+      pool_dealloc_batch(args->pol, slots, 32);
+      for (sz i = 32; i < 48; ++i) {
+        pool_dealloc(args->pol, slots[i]);
+      }
+    }
+    return 0;
+  }
+
+}  // namespace
+
+TEST(memory_pool_test, lockfree_alloc_dealloc) {
+  pool pol = pool_create_lockfree(thread_get_allocator(), 4096, 64, 8);
+  EXPECT_NE(0, pol.lockfree);
+  void* ptr = pool_alloc(&pol);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_EQ(1U, pool_block_count(&pol));
+  sz free_after_alloc = pool_free_count(&pol);
+  pool_dealloc(&pol, ptr);
+  EXPECT_EQ(free_after_alloc + 1, pool_free_count(&pol));
+  EXPECT_EQ(ptr, pool_alloc(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, lockfree_clear_and_add_block) {
+  pool pol = pool_create_lockfree(thread_get_allocator(), 4096, 32, 8);
+  alignas(16) u8 buf[1024];
+  pool_add_block(&pol, buf, sizeof(buf));
+  sz total = pool_free_count(&pol);
+  EXPECT_GT(total, 0U);
+  void* a = pool_alloc(&pol);
+  void* b = pool_alloc(&pol);
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  pool_clear(&pol);
+  EXPECT_EQ(total, pool_free_count(&pol));
+  EXPECT_TRUE(pool_remove_block(&pol, buf));
+  EXPECT_EQ(0U, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, lockfree_threads) {
+  pool pol = pool_create_lockfree(thread_get_allocator(), 4096, 16, 8);
+  pool_lockfree_worker_args args = {};
+  args.pol = &pol;
+  thread_group group = thread_group_create(8, pool_lockfree_worker, &args, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  EXPECT_EQ(0, atomic_i32_get(&args.failures));
+
+  // Every slot carved so far must be back on the free list exactly once.
+  sz stride = 16;
+  sz per_block = (4096 - sizeof(pool_block)) / stride;
+  EXPECT_EQ(pool_block_count(&pol) * per_block, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, alloc_batch) {
+  pool pol = pool_create_mutexed(thread_get_allocator(), 1024, 24, 8);
+  void* slots[200];
+  EXPECT_EQ(200U, pool_alloc_batch(&pol, slots, 200));
+  EXPECT_GT(pool_block_count(&pol), 1U);
+  for (sz i = 0; i < 200; ++i) {
+    ASSERT_NE(nullptr, slots[i]);
+    memset(slots[i], (int)i, 24);
+  }
+  for (sz i = 0; i < 200; ++i) {
+    EXPECT_EQ((u8)i, *(u8*)slots[i]);
+  }
+  sz free_before = pool_free_count(&pol);
+  pool_dealloc_batch(&pol, slots, 200);
+  EXPECT_EQ(free_before + 200, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, alloc_batch_partial_without_parent) {
+  allocator zero_alloc = {0};
+  pool pol = pool_create(zero_alloc, NULL, 0, 32, 8);
+  alignas(16) u8 buf[sizeof(pool_block) + 32 * 4];
+  pool_add_block(&pol, buf, sizeof(buf));
+  void* slots[8] = {};
+  EXPECT_EQ(4U, pool_alloc_batch(&pol, slots, 8));
+  EXPECT_EQ(nullptr, slots[4]);
+  pool_dealloc_batch(&pol, slots, 8);
+  EXPECT_EQ(4U, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, lockfree_batch) {
+  pool pol = pool_create_lockfree(thread_get_allocator(), 1024, 16, 8);
+  void* slots[128];
+  EXPECT_EQ(128U, pool_alloc_batch(&pol, slots, 128));
+  sz free_before = pool_free_count(&pol);
+  pool_dealloc_batch(&pol, slots, 128);
+  EXPECT_EQ(free_before + 128, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+TEST(memory_pool_test, lockfree_batch_threads) {
+  pool pol = pool_create_lockfree(thread_get_allocator(), 4096, 16, 8);
+  pool_lockfree_worker_args args = {};
+  args.pol = &pol;
+  thread_group group = thread_group_create(8, pool_lockfree_batch_worker, &args, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  EXPECT_EQ(0, atomic_i32_get(&args.failures));
+
+  sz stride = 16;
+  sz per_block = (4096 - sizeof(pool_block)) / stride;
+  EXPECT_EQ(pool_block_count(&pol) * per_block, pool_free_count(&pol));
+  pool_destroy(&pol);
+}
+
+// Free lists far beyond the safe-loop limit must survive clear and block removal.
+TEST(memory_pool_test, lockfree_large_free_list) {
+  constexpr sz block_size = 1 << 20;
+  pool pol = pool_create_lockfree(thread_get_allocator(), block_size, 16, 8);
+  void* first = pool_alloc(&pol);
+  ASSERT_NE(nullptr, first);
+  sz per_block = pool_free_count(&pol) + 1;
+  EXPECT_GT(per_block, 50000U);
+
+  void* slots[2000];
+  EXPECT_EQ(2000U, pool_alloc_batch(&pol, slots, 2000));
+  EXPECT_EQ(per_block - 2001, pool_free_count(&pol));
+  pool_clear(&pol);
+  EXPECT_EQ(per_block, pool_free_count(&pol));
+
+  u8* buf = static_cast<u8*>(allocator_alloc(thread_get_allocator(), block_size));
+  ASSERT_NE(nullptr, buf);
+  pool_add_block(&pol, buf, block_size);
+  EXPECT_EQ(2 * per_block, pool_free_count(&pol));
+  EXPECT_TRUE(pool_remove_block(&pol, buf));
+  EXPECT_EQ(per_block, pool_free_count(&pol));
+  allocator_dealloc(thread_get_allocator(), buf);
+  pool_destroy(&pol);
+}
@@ -170,3 +170,187 @@ TEST(memory_ring_test, empty_peek) {
   EXPECT_EQ(0U, peek_count);
   ring_destroy(&rng);
 }
+
+TEST(memory_ring_test, spsc_basic) {
+  u8 buf[16];
+  ring rng = ring_create_spsc(buf, sizeof(buf));
+  EXPECT_NE(0, rng.spsc);
+  u8 data[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  EXPECT_EQ(12U, ring_write(&rng, data, sizeof(data)));
+  EXPECT_EQ(12U, ring_size(&rng));
+  EXPECT_EQ(4U, ring_space(&rng));
+
+  u8 out[12] = {0};
+  EXPECT_EQ(4U, ring_peek(&rng, out, 4));
+  EXPECT_EQ(1, out[0]);
+  EXPECT_EQ(2U, ring_skip(&rng, 2));
+  EXPECT_EQ(10U, ring_read(&rng, out, sizeof(out)));
+  EXPECT_EQ(3, out[0]);
+  EXPECT_EQ(12, out[9]);
+
+  // The next write wraps around the end of the buffer.
+  EXPECT_EQ(12U, ring_write(&rng, data, sizeof(data)));
+  EXPECT_EQ(4U, ring_write(&rng, data, sizeof(data)));
+  EXPECT_EQ(0U, ring_space(&rng));
+  EXPECT_EQ(12U, ring_read(&rng, out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(out, data, sizeof(data)));
+
+  ring_clear(&rng);
+  EXPECT_EQ(0U, ring_size(&rng));
+  ring_destroy(&rng);
+}
+
+TEST(memory_ring_test, spsc_reserve_commit) {
+  u8 buf[8];
+  ring rng = ring_create_spsc(buf, sizeof(buf));
+  sz avail = 0;
+  u8* wr = (u8*)ring_reserve_write(&rng, &avail);
+  ASSERT_NE(nullptr, wr);
+  EXPECT_EQ(8U, avail);
+  wr[0] = 7;
+  wr[1] = 9;
+  EXPECT_NE(0, ring_commit_write(&rng, 2));
+  EXPECT_EQ(0, ring_commit_write(&rng, 7));
+
+  const u8* rd = (const u8*)ring_reserve_read(&rng, &avail);
+  ASSERT_NE(nullptr, rd);
+  EXPECT_EQ(2U, avail);
+  EXPECT_EQ(7, rd[0]);
+  EXPECT_EQ(9, rd[1]);
+  EXPECT_EQ(0, ring_commit_read(&rng, 3));
+  EXPECT_NE(0, ring_commit_read(&rng, 2));
+  EXPECT_EQ(nullptr, ring_reserve_read(&rng, &avail));
+  EXPECT_EQ(0U, avail);
+
+  // Only the span up to the end of the buffer is contiguous.
+  wr = (u8*)ring_reserve_write(&rng, &avail);
+  EXPECT_EQ(buf + 2, wr);
+  EXPECT_EQ(6U, avail);
+  ring_destroy(&rng);
+}
+
+namespace {
+
+  constexpr u32 ring_spsc_value_count = 50000;
+
+  struct ring_spsc_args {
+    ring* rng;
+    atomic_i32 failures;
+  };
+
+  i32 ring_spsc_worker(u32 idx, void* arg) {
+    ring_spsc_args* args = static_cast<ring_spsc_args*>(arg);
+    u32 next = 0;
+    while (next < ring_spsc_value_count) {
+      if (idx == 0) {
+        u32 vals[7];
+        u32 count = 0;
+        for (; count < 7 && next + count < ring_spsc_value_count; ++count) {
+          vals[count] = next + count;
+        }
+        // Only whole values are written so that the consumer never sees a torn one.
+        sz fit = ring_space(args->rng) / sizeof(u32);
+        count = count < fit ? count : (u32)fit;
+        if (count == 0) {
+          thread_yield();
+          continue;
+        }
+        if (ring_write(args->rng, vals, count * sizeof(u32)) != count * sizeof(u32)) {
+          atomic_i32_add(&args->failures, 1);
+          return 1;
+        }
+        next += count;
+      } else {
+        u32 vals[5];
+        sz got = ring_read(args->rng, vals, sizeof(vals)) / sizeof(u32);
+        if (got == 0) {
+          thread_yield();
+          continue;
+        }
+        for (sz i = 0; i < got; ++i) {
+          if (vals[i] != next) {
+            atomic_i32_add(&args->failures, 1);
+          }
+          next += 1;
+        }
+      }
+    }
+    return 0;
+  }
+
+}  // namespace
+
+TEST(memory_ring_test, spsc_threads) {
+  // A capacity that is not a multiple of the value size exercises split copies.
+  ring rng = ring_create_alloc_spsc(thread_get_allocator(), 64 * sizeof(u32));
+  ring_spsc_args args = {};
+  args.rng = &rng;
+  thread_group group = thread_group_create(2, ring_spsc_worker, &args, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  EXPECT_EQ(0, atomic_i32_get(&args.failures));
+  EXPECT_EQ(0U, ring_size(&rng));
+  ring_destroy(&rng);
+}
+
+TEST(memory_ring_test, mirrored_reserve_spans_wrap) {
+  ring rng = ring_create_mirrored(1, NULL);
+  if (rng.ptr == NULL) {
+    GTEST_SKIP() << "mirrored memory is not supported on this platform";
+  }
+  sz cap = ring_capacity(&rng);
+  EXPECT_EQ(vmem_page_size(), cap);
+
+  // Move both cursors close to the end so the next reservation wraps.
+  sz avail = 0;
+  ASSERT_NE(nullptr, ring_reserve_write(&rng, &avail));
+  EXPECT_NE(0, ring_commit_write(&rng, cap - 4));
+  EXPECT_NE(0, ring_commit_read(&rng, cap - 4));
+
+  u8* wr = (u8*)ring_reserve_write(&rng, &avail);
+  ASSERT_NE(nullptr, wr);
+  EXPECT_EQ(cap, avail);
+  for (u32 i = 0; i < 16; ++i) {
+    wr[i] = (u8)(i + 1);
+  }
+  EXPECT_NE(0, ring_commit_write(&rng, 16));
+  // Bytes written past the end show up at the start of the buffer.
+  EXPECT_EQ(5, rng.ptr[0]);
+
+  const u8* rd = (const u8*)ring_reserve_read(&rng, &avail);
+  ASSERT_NE(nullptr, rd);
+  EXPECT_EQ(16U, avail);
+  for (u32 i = 0; i < 16; ++i) {
+    EXPECT_EQ(i + 1, rd[i]);
+  }
+  EXPECT_NE(0, ring_commit_read(&rng, 16));
+  ring_destroy(&rng);
+  EXPECT_EQ(nullptr, rng.ptr);
+}
+
+TEST(memory_ring_test, mirrored_spsc_write_read) {
+  ring rng = ring_create_mirrored_spsc(vmem_page_size());
+  if (rng.ptr == NULL) {
+    GTEST_SKIP() << "mirrored memory is not supported on this platform";
+  }
+  sz cap = ring_capacity(&rng);
+  u8 data[64];
+  for (u32 i = 0; i < 64; ++i) {
+    data[i] = (u8)i;
+  }
+  // Advance both counters so that the next write straddles the wrap point.
+  sz avail = 0;
+  ASSERT_NE(nullptr, ring_reserve_write(&rng, &avail));
+  EXPECT_EQ(cap, avail);
+  EXPECT_NE(0, ring_commit_write(&rng, cap - 32));
+  EXPECT_EQ(cap - 32, ring_skip(&rng, cap - 32));
+
+  EXPECT_EQ(64U, ring_write(&rng, data, sizeof(data)));
+  const u8* rd = (const u8*)ring_reserve_read(&rng, &avail);
+  ASSERT_NE(nullptr, rd);
+  EXPECT_EQ(64U, avail);
+  EXPECT_EQ(0, memcmp(rd, data, sizeof(data)));
+  EXPECT_NE(0, ring_commit_read(&rng, 64));
+  ring_destroy(&rng);
+}
@@ -189,3 +189,68 @@ TEST(memory_vmem_test, multiple_allocations) {
     EXPECT_NE(0, result);
   }
 }
+
+TEST(memory_vmem_test, reserve_commit_huge_pages) {
+  sz huge = vmem_huge_page_size();
+  sz size = huge > 0 ? huge * 4 : vmem_page_size() * 16;
+  vmem_stats before = vmem_get_stats();
+
+  u8* ptr = (u8*)vmem_reserve_ex(size, VMEM_FLAG_HUGE_PAGES);
+  ASSERT_NE(nullptr, ptr);
+  if (huge > 0) {
+    EXPECT_EQ(0U, (up)ptr % huge);
+  }
+  EXPECT_NE(0, vmem_commit_ex(ptr, size, VMEM_FLAG_HUGE_PAGES));
+  ptr[0] = 1;
+  ptr[size - 1] = 2;
+
+  vmem_stats after = vmem_get_stats();
+  EXPECT_EQ(huge, after.huge_page_size);
+  EXPECT_EQ(0U, after.huge_backed_bytes);
+  if (huge > 0) {
+    EXPECT_GE(after.huge_advised_bytes, before.huge_advised_bytes + size);
+    vmem_stats backed = vmem_get_stats_ex(true);
+    EXPECT_EQ(0U, backed.huge_backed_bytes % huge);
+  }
+  EXPECT_NE(0, vmem_release(ptr, size));
+}
+
+// The aligned over-reservation must not wrap around for sizes near SZ_MAX.
+TEST(memory_vmem_test, reserve_huge_pages_rejects_overflow) {
+  EXPECT_EQ(nullptr, vmem_reserve_ex(SZ_MAX - vmem_page_size() + 1, VMEM_FLAG_HUGE_PAGES));
+}
+
+TEST(memory_vmem_test, commit_prefault) {
+  sz page_sz = vmem_page_size();
+  sz size = page_sz * 8;
+  vmem_stats before = vmem_get_stats();
+
+  u8* ptr = (u8*)vmem_reserve(size);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_NE(0, vmem_commit_ex(ptr, size, VMEM_FLAG_PREFAULT));
+  EXPECT_EQ(0, ptr[0]);
+  EXPECT_EQ(0, ptr[size - 1]);
+
+  // Prefaulting an already committed range must keep its contents.
+  ptr[page_sz] = 42;
+  EXPECT_NE(0, vmem_commit_ex(ptr, size, VMEM_FLAG_PREFAULT));
+  EXPECT_EQ(42, ptr[page_sz]);
+
+  vmem_stats after = vmem_get_stats();
+  EXPECT_EQ(before.prefaulted_bytes + size * 2, after.prefaulted_bytes);
+  EXPECT_NE(0, vmem_release(ptr, size));
+}
+
+TEST(memory_vmem_test, alloc_mirrored) {
+  sz page_sz = vmem_page_size();
+  EXPECT_EQ(nullptr, vmem_alloc_mirrored(page_sz + 1));
+  u8* ptr = (u8*)vmem_alloc_mirrored(page_sz * 2);
+  if (ptr == NULL) {
+    GTEST_SKIP() << "mirrored memory is not supported on this platform";
+  }
+  ptr[3] = 11;
+  EXPECT_EQ(11, ptr[page_sz * 2 + 3]);
+  ptr[page_sz * 4 - 1] = 22;
+  EXPECT_EQ(22, ptr[page_sz * 2 - 1]);
+  EXPECT_NE(0, vmem_free_mirrored(ptr, page_sz * 2));
+}
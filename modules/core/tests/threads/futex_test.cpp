@@ -0,0 +1,228 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+namespace {
+
+  constexpr u32 counter_threads = 4;
+  constexpr u32 counter_iterations = 20000;
+
+  struct futex_counter_ctx {
+    futex_mutex lock;
+    u64 counter;
+  };
+
+  i32 futex_counter_entry(u32 idx, void* arg) {
+    (void)idx;
+    futex_counter_ctx* ctx = static_cast<futex_counter_ctx*>(arg);
+    for (u32 iter = 0; iter < counter_iterations; ++iter) {
+      futex_mutex_lock(&ctx->lock);
+      ctx->counter += 1;
+      futex_mutex_unlock(&ctx->lock);
+    }
+    return 0;
+  }
+
+  struct mutex_counter_ctx {
+    mutex lock;
+    u64 counter;
+  };
+
+  i32 mutex_counter_entry(u32 idx, void* arg) {
+    (void)idx;
+    mutex_counter_ctx* ctx = static_cast<mutex_counter_ctx*>(arg);
+    for (u32 iter = 0; iter < counter_iterations; ++iter) {
+      mutex_lock(ctx->lock);
+      ctx->counter += 1;
+      mutex_unlock(ctx->lock);
+    }
+    return 0;
+  }
+
+  constexpr u32 queue_items = 2000;
+
+  struct futex_queue {
+    futex_mutex lock;
+    futex_condvar not_empty;
+    futex_condvar not_full;
+    u32 count;
+    u32 produced;
+    u32 consumed;
+  };
+
+  i32 futex_queue_entry(u32 idx, void* arg) {
+    futex_queue* queue = static_cast<futex_queue*>(arg);
+    if (idx == 0) {
+      for (u32 item = 0; item < queue_items; ++item) {
+        futex_mutex_lock(&queue->lock);
+        while (queue->count == 4) {
+          futex_condvar_wait(&queue->not_full, &queue->lock);
+        }
+        queue->count += 1;
+        queue->produced += 1;
+        futex_mutex_unlock(&queue->lock);
+        futex_condvar_signal(&queue->not_empty);
+      }
+      return 0;
+    }
+
+    for (u32 item = 0; item < queue_items; ++item) {
+      futex_mutex_lock(&queue->lock);
+      while (queue->count == 0) {
+        futex_condvar_wait(&queue->not_empty, &queue->lock);
+      }
+      queue->count -= 1;
+      queue->consumed += 1;
+      futex_mutex_unlock(&queue->lock);
+      futex_condvar_signal(&queue->not_full);
+    }
+    return 0;
+  }
+
+  struct futex_gate {
+    futex_mutex lock;
+    futex_condvar opened;
+    b32 is_open;
+    atomic_u32 passed;
+  };
+
+  i32 futex_gate_entry(u32 idx, void* arg) {
+    (void)idx;
+    futex_gate* gate = static_cast<futex_gate*>(arg);
+    futex_mutex_lock(&gate->lock);
+    while (!gate->is_open) {
+      futex_condvar_wait(&gate->opened, &gate->lock);
+    }
+    futex_mutex_unlock(&gate->lock);
+    atomic_u32_add(&gate->passed, 1);
+    return 0;
+  }
+
+}  // namespace
+
+TEST(threads_futex_test, zeroed_mutex_lock_unlock) {
+  futex_mutex lock = {};
+  futex_mutex_lock(&lock);
+  EXPECT_EQ(0, futex_mutex_try_lock(&lock));
+  futex_mutex_unlock(&lock);
+
+  EXPECT_NE(0, futex_mutex_try_lock(&lock));
+  futex_mutex_unlock(&lock);
+}
+
+TEST(threads_futex_test, mutex_counter) {
+  futex_counter_ctx ctx = {};
+  thread_group group = thread_group_create(counter_threads, futex_counter_entry, &ctx, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  EXPECT_NE(0, thread_group_join_all(group, NULL));
+  EXPECT_NE(0, thread_group_destroy(group));
+
+  EXPECT_EQ(static_cast<u64>(counter_threads) * counter_iterations, ctx.counter);
+}
+
+TEST(threads_futex_test, wait_returns_on_mismatch_and_timeout) {
+  atomic_u32 word = {};
+  atomic_u32_set(&word, 5);
+  EXPECT_NE(0, futex_wait(&word, 4, FUTEX_WAIT_INFINITE));
+  EXPECT_EQ(0, futex_wait(&word, 5, 10));
+}
+
+TEST(threads_futex_test, condvar_wait_timeout) {
+  futex_mutex lock = {};
+  futex_condvar cond = {};
+
+  futex_mutex_lock(&lock);
+  EXPECT_EQ(0, futex_condvar_wait_timeout(&cond, &lock, 10));
+  EXPECT_EQ(0, futex_mutex_try_lock(&lock));
+  futex_mutex_unlock(&lock);
+
+  // Nobody waits, so these only bump the sequence.
+  futex_condvar_signal(&cond);
+  futex_condvar_broadcast(&cond);
+}
+
+TEST(threads_futex_test, condvar_producer_consumer) {
+  futex_queue queue = {};
+  thread_group group = thread_group_create(2, futex_queue_entry, &queue, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  EXPECT_NE(0, thread_group_join_all(group, NULL));
+  EXPECT_NE(0, thread_group_destroy(group));
+
+  EXPECT_EQ(queue_items, queue.produced);
+  EXPECT_EQ(queue_items, queue.consumed);
+  EXPECT_EQ(0U, queue.count);
+}
+
+TEST(threads_futex_test, condvar_broadcast) {
+  futex_gate gate = {};
+  thread_group group = thread_group_create(4, futex_gate_entry, &gate, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+
+  thread_sleep(20);
+  futex_mutex_lock(&gate.lock);
+  gate.is_open = true;
+  futex_mutex_unlock(&gate.lock);
+  futex_condvar_broadcast(&gate.opened);
+
+  EXPECT_NE(0, thread_group_join_all(group, NULL));
+  EXPECT_NE(0, thread_group_destroy(group));
+  EXPECT_EQ(4U, atomic_u32_get(&gate.passed));
+}
+
+// Compares futex_mutex with the SDL-backed mutex, uncontended and with
+// counter_threads threads. Timings are logged only; they depend on the machine.
+TEST(threads_futex_test, benchmark_against_mutex) {
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  constexpr u32 uncontended_iterations = 200000;
+  ctx_setup setup = thread_get_setup();
+
+  futex_counter_ctx futex_ctx = {};
+  auto start = std::chrono::steady_clock::now();
+  for (u32 iter = 0; iter < uncontended_iterations; ++iter) {
+    futex_mutex_lock(&futex_ctx.lock);
+    futex_ctx.counter += 1;
+    futex_mutex_unlock(&futex_ctx.lock);
+  }
+  f64 futex_uncontended_ms = elapsed_ms(start);
+
+  mutex_counter_ctx mutex_ctx = {mutex_create(), 0};
+  ASSERT_NE(0, mutex_is_valid(mutex_ctx.lock));
+  start = std::chrono::steady_clock::now();
+  for (u32 iter = 0; iter < uncontended_iterations; ++iter) {
+    mutex_lock(mutex_ctx.lock);
+    mutex_ctx.counter += 1;
+    mutex_unlock(mutex_ctx.lock);
+  }
+  f64 mutex_uncontended_ms = elapsed_ms(start);
+
+  futex_ctx.counter = 0;
+  start = std::chrono::steady_clock::now();
+  thread_group group = thread_group_create(counter_threads, futex_counter_entry, &futex_ctx, setup);
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  f64 futex_contended_ms = elapsed_ms(start);
+
+  mutex_ctx.counter = 0;
+  start = std::chrono::steady_clock::now();
+  group = thread_group_create(counter_threads, mutex_counter_entry, &mutex_ctx, setup);
+  thread_group_join_all(group, NULL);
+  thread_group_destroy(group);
+  f64 mutex_contended_ms = elapsed_ms(start);
+
+  EXPECT_EQ(futex_ctx.counter, mutex_ctx.counter);
+  EXPECT_NE(0, mutex_destroy(mutex_ctx.lock));
+
+  thread_log_info("futex_mutex bench uncontended=%u: futex=%.2fms mutex=%.2fms; threads=%u x %u: futex=%.2fms mutex=%.2fms",
+                  uncontended_iterations,
+                  futex_uncontended_ms,
+                  mutex_uncontended_ms,
+                  counter_threads,
+                  counter_iterations,
+                  futex_contended_ms,
+                  mutex_contended_ms);
+}
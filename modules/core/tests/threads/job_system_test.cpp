@@ -0,0 +1,258 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+namespace {
+
+  struct fan_out_state {
+    job_system sys;
+    atomic_u32* leaf_count;
+  };
+
+  void count_job(void* arg) {
+    atomic_u32_add(static_cast<atomic_u32*>(arg), 1);
+  }
+
+  void ctx_check_job(void* arg) {
+    atomic_u32* ok_count = static_cast<atomic_u32*>(arg);
+    if (thread_ctx_is_init() && thread_get_perm_heap() != NULL) {
+      atomic_u32_add(ok_count, 1);
+    }
+  }
+
+  // Submits and waits on a nested batch from inside a job, which must not
+  // deadlock even with a single worker.
+  void fan_out_job(void* arg) {
+    fan_out_state* state = static_cast<fan_out_state*>(arg);
+    job_counter children = {};
+    for (u32 idx = 0; idx < 16; ++idx) {
+      job_system_run(state->sys, count_job, state->leaf_count, &children);
+    }
+    job_system_wait(state->sys, &children);
+  }
+
+  struct order_state {
+    atomic_u32 stage_one_done;
+    atomic_u32 violations;
+  };
+
+  void stage_one_job(void* arg) {
+    atomic_u32_add(&static_cast<order_state*>(arg)->stage_one_done, 1);
+  }
+
+  void stage_two_job(void* arg) {
+    order_state* state = static_cast<order_state*>(arg);
+    if (atomic_u32_get(&state->stage_one_done) != 64) {
+      atomic_u32_add(&state->violations, 1);
+    }
+  }
+
+  // Roughly 20 microseconds of dependent arithmetic.
+  u64 spin_work(u64 seed) {
+    volatile u64 acc = seed;
+    for (u32 idx = 0; idx < 20000; ++idx) {
+      acc = acc * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return acc;
+  }
+
+  void spin_job(void* arg) {
+    u64* slot = static_cast<u64*>(arg);
+    *slot = spin_work(*slot);
+  }
+
+  constexpr u32 bench_phases = 20;
+  constexpr u32 bench_jobs_per_phase = 128;
+
+  struct group_phase {
+    u64* slots;
+    u32 thread_count;
+  };
+
+  i32 group_phase_entry(u32 idx, void* arg) {
+    group_phase* phase = static_cast<group_phase*>(arg);
+    for (u32 job = idx; job < bench_jobs_per_phase; job += phase->thread_count) {
+      phase->slots[job] = spin_work(phase->slots[job]);
+    }
+    return 0;
+  }
+
+}  // namespace
+
+TEST(threads_job_system_test, create_destroy) {
+  job_system sys = job_system_create(3, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+  EXPECT_EQ(3U, job_system_get_worker_count(sys));
+  EXPECT_EQ(0U, job_system_get_worker_idx(sys));
+  EXPECT_NE(0, job_system_destroy(sys));
+
+  EXPECT_EQ(0, job_system_destroy(NULL));
+  EXPECT_EQ(0U, job_system_get_worker_count(NULL));
+}
+
+TEST(threads_job_system_test, default_worker_count) {
+  job_system sys = job_system_create(0, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+  EXPECT_GE(job_system_get_worker_count(sys), 1U);
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_job_system_test, run_and_wait) {
+  job_system sys = job_system_create(4, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  atomic_u32 done = {};
+  job_counter counter = {};
+  for (u32 idx = 0; idx < 2000; ++idx) {
+    job_system_run(sys, count_job, &done, &counter);
+  }
+  job_system_wait(sys, &counter);
+
+  EXPECT_EQ(2000U, atomic_u32_get(&done));
+  EXPECT_NE(0, job_counter_is_done(&counter));
+
+  // A drained counter can be reused for the next batch.
+  for (u32 idx = 0; idx < 100; ++idx) {
+    job_system_run(sys, count_job, &done, &counter);
+  }
+  job_system_wait(sys, &counter);
+  EXPECT_EQ(2100U, atomic_u32_get(&done));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_job_system_test, run_many_overflows_inline) {
+  job_system sys = job_system_create(2, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  constexpr u32 job_count = JOB_SYSTEM_QUEUE_CAPACITY * 2 + 17;
+  static job_decl jobs[job_count];
+  atomic_u32 done = {};
+  for (u32 idx = 0; idx < job_count; ++idx) {
+    jobs[idx] = job_decl {count_job, &done};
+  }
+
+  job_counter counter = {};
+  job_system_run_many(sys, jobs, job_count, &counter);
+  job_system_wait(sys, &counter);
+  EXPECT_EQ(job_count, atomic_u32_get(&done));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_job_system_test, workers_have_thread_ctx) {
+  job_system sys = job_system_create(4, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  atomic_u32 ok_count = {};
+  job_counter counter = {};
+  for (u32 idx = 0; idx < 256; ++idx) {
+    job_system_run(sys, ctx_check_job, &ok_count, &counter);
+  }
+  job_system_wait(sys, &counter);
+  EXPECT_EQ(256U, atomic_u32_get(&ok_count));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_job_system_test, nested_wait_helps) {
+  job_system sys = job_system_create(1, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  atomic_u32 leaf_count = {};
+  fan_out_state state = {sys, &leaf_count};
+  job_counter counter = {};
+  for (u32 idx = 0; idx < 32; ++idx) {
+    job_system_run(sys, fan_out_job, &state, &counter);
+  }
+  job_system_wait(sys, &counter);
+  EXPECT_EQ(32U * 16U, atomic_u32_get(&leaf_count));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_job_system_test, run_after_orders_batches) {
+  job_system sys = job_system_create(4, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  for (u32 round = 0; round < 50; ++round) {
+    order_state state = {};
+    job_counter stage_one = {};
+    job_counter stage_two = {};
+    for (u32 idx = 0; idx < 64; ++idx) {
+      job_system_run(sys, stage_one_job, &state, &stage_one);
+    }
+    for (u32 idx = 0; idx < 8; ++idx) {
+      EXPECT_NE(0, job_system_run_after(sys, &stage_one, stage_two_job, &state, &stage_two));
+    }
+    job_system_wait(sys, &stage_two);
+
+    EXPECT_EQ(64U, atomic_u32_get(&state.stage_one_done));
+    EXPECT_EQ(0U, atomic_u32_get(&state.violations));
+    EXPECT_NE(0, job_counter_is_done(&stage_one));
+  }
+
+  // A finished dependency releases the job immediately.
+  atomic_u32 done = {};
+  job_counter finished = {};
+  job_counter counter = {};
+  EXPECT_NE(0, job_system_run_after(sys, &finished, count_job, &done, &counter));
+  EXPECT_NE(0, job_system_run_after(sys, NULL, count_job, &done, &counter));
+  job_system_wait(sys, &counter);
+  EXPECT_EQ(2U, atomic_u32_get(&done));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+// Compares a persistent job system against re-creating a thread_group for
+// every parallel phase. Timings are logged only; they depend on the machine.
+TEST(threads_job_system_test, benchmark_against_thread_group) {
+  ctx_setup setup = thread_get_setup();
+  static u64 slots[bench_jobs_per_phase];
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  job_system sys = job_system_create(0, setup);
+  ASSERT_NE(0, job_system_is_valid(sys));
+  u32 worker_count = job_system_get_worker_count(sys);
+
+  for (u32 idx = 0; idx < bench_jobs_per_phase; ++idx) {
+    slots[idx] = idx;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (u32 phase = 0; phase < bench_phases; ++phase) {
+    job_counter counter = {};
+    for (u32 idx = 0; idx < bench_jobs_per_phase; ++idx) {
+      job_system_run(sys, spin_job, &slots[idx], &counter);
+    }
+    job_system_wait(sys, &counter);
+  }
+  f64 job_system_ms = elapsed_ms(start);
+  u64 job_system_check = slots[bench_jobs_per_phase - 1];
+  EXPECT_NE(0, job_system_destroy(sys));
+
+  for (u32 idx = 0; idx < bench_jobs_per_phase; ++idx) {
+    slots[idx] = idx;
+  }
+  group_phase phase_arg = {slots, worker_count + 1};
+  start = std::chrono::steady_clock::now();
+  for (u32 phase = 0; phase < bench_phases; ++phase) {
+    thread_group group = thread_group_create(phase_arg.thread_count, group_phase_entry, &phase_arg, setup);
+    ASSERT_NE(0, thread_group_is_valid(group));
+    thread_group_join_all(group, NULL);
+    thread_group_destroy(group);
+  }
+  f64 thread_group_ms = elapsed_ms(start);
+
+  EXPECT_EQ(job_system_check, slots[bench_jobs_per_phase - 1]);
+  thread_log_info("job_system bench phases=%u jobs=%u workers=%u: job_system=%.2fms thread_group=%.2fms",
+                  bench_phases,
+                  bench_jobs_per_phase,
+                  worker_count,
+                  job_system_ms,
+                  thread_group_ms);
+}
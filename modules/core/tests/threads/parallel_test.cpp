@@ -0,0 +1,212 @@
+// MIT License
+// Copyright (c) 2026 Christian Luppi
+
+#include "test_common.hpp"
+
+#include <chrono>
+
+namespace {
+
+  constexpr u64 value_count = 200000;
+  u32 values[value_count];
+
+  void fill_range(u64 begin, u64 end, void* arg) {
+    u32* out = static_cast<u32*>(arg);
+    for (u64 idx = begin; idx < end; ++idx) {
+      out[idx] += static_cast<u32>(idx * 3);
+    }
+  }
+
+  struct chunk_stats {
+    atomic_u32 chunk_count;
+    atomic_u64 covered;
+  };
+
+  void count_chunks(u64 begin, u64 end, void* arg) {
+    chunk_stats* stats = static_cast<chunk_stats*>(arg);
+    atomic_u32_add(&stats->chunk_count, 1);
+    atomic_u64_add(&stats->covered, end - begin);
+  }
+
+  void sum_range(u64 begin, u64 end, void* partial, void* arg) {
+    u32 const* in = static_cast<u32 const*>(arg);
+    u64* sum = static_cast<u64*>(partial);
+    for (u64 idx = begin; idx < end; ++idx) {
+      *sum += in[idx];
+    }
+  }
+
+  void sum_combine(void* into, void const* from, void* arg) {
+    (void)arg;
+    *static_cast<u64*>(into) += *static_cast<u64 const*>(from);
+  }
+
+  struct min_max {
+    u64 lowest;
+    u64 highest;
+  };
+
+  void min_max_range(u64 begin, u64 end, void* partial, void* arg) {
+    (void)arg;
+    min_max* acc = static_cast<min_max*>(partial);
+    if (begin < acc->lowest) {
+      acc->lowest = begin;
+    }
+    if (end - 1 > acc->highest) {
+      acc->highest = end - 1;
+    }
+  }
+
+  void min_max_combine(void* into, void const* from, void* arg) {
+    (void)arg;
+    min_max* dst = static_cast<min_max*>(into);
+    min_max const* src = static_cast<min_max const*>(from);
+    dst->lowest = src->lowest < dst->lowest ? src->lowest : dst->lowest;
+    dst->highest = src->highest > dst->highest ? src->highest : dst->highest;
+  }
+
+  struct nested_state {
+    job_system sys;
+    atomic_u64 total;
+  };
+
+  void nested_inner(u64 begin, u64 end, void* arg) {
+    atomic_u64_add(&static_cast<nested_state*>(arg)->total, end - begin);
+  }
+
+  void nested_outer(u64 begin, u64 end, void* arg) {
+    nested_state* state = static_cast<nested_state*>(arg);
+    for (u64 idx = begin; idx < end; ++idx) {
+      parallel_for(state->sys, 0, 1000, 50, nested_inner, state);
+    }
+  }
+
+  u64 expected_sum() {
+    u64 sum = 0;
+    for (u64 idx = 0; idx < value_count; ++idx) {
+      sum += static_cast<u32>(idx * 3);
+    }
+    return sum;
+  }
+
+}  // namespace
+
+TEST(threads_parallel_test, for_covers_range_once) {
+  job_system sys = job_system_create(4, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  mem_zero(values, size_of(values));
+  parallel_for(sys, 0, value_count, 0, fill_range, values);
+  for (u64 idx = 0; idx < value_count; ++idx) {
+    ASSERT_EQ(static_cast<u32>(idx * 3), values[idx]) << idx;
+  }
+
+  chunk_stats stats = {};
+  parallel_for(sys, 100, 100 + 10000, 64, count_chunks, &stats);
+  EXPECT_EQ(10000U, atomic_u64_get(&stats.covered));
+  EXPECT_LE(atomic_u32_get(&stats.chunk_count), 10000U / 64U + 1U);
+  EXPECT_GT(atomic_u32_get(&stats.chunk_count), 1U);
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_parallel_test, for_edge_cases) {
+  job_system sys = job_system_create(2, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  chunk_stats stats = {};
+  parallel_for(sys, 5, 5, 1, count_chunks, &stats);
+  parallel_for(sys, 9, 3, 1, count_chunks, &stats);
+  EXPECT_EQ(0U, atomic_u32_get(&stats.chunk_count));
+
+  // A grain covering the whole range runs inline as a single chunk.
+  parallel_for(sys, 0, 100, 1000, count_chunks, &stats);
+  EXPECT_EQ(1U, atomic_u32_get(&stats.chunk_count));
+  EXPECT_EQ(100U, atomic_u64_get(&stats.covered));
+
+  // Without a job system the whole range runs on the caller.
+  parallel_for(NULL, 0, 50, 1, count_chunks, &stats);
+  EXPECT_EQ(2U, atomic_u32_get(&stats.chunk_count));
+  EXPECT_EQ(150U, atomic_u64_get(&stats.covered));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_parallel_test, reduce_sum) {
+  job_system sys = job_system_create(4, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  mem_zero(values, size_of(values));
+  parallel_for(sys, 0, value_count, 256, fill_range, values);
+
+  u64 total = 0;
+  EXPECT_NE(0, parallel_reduce(sys, 0, value_count, 0, &total, size_of(total), sum_range, sum_combine, values));
+  EXPECT_EQ(expected_sum(), total);
+
+  u64 serial_total = 0;
+  EXPECT_NE(0, parallel_reduce(NULL, 0, value_count, 0, &serial_total, size_of(serial_total), sum_range, sum_combine, values));
+  EXPECT_EQ(expected_sum(), serial_total);
+
+  min_max bounds = {U64_MAX, 0};
+  EXPECT_NE(0, parallel_reduce(sys, 10, 90010, 17, &bounds, size_of(bounds), min_max_range, min_max_combine, NULL));
+  EXPECT_EQ(10U, bounds.lowest);
+  EXPECT_EQ(90009U, bounds.highest);
+
+  EXPECT_EQ(0, parallel_reduce(sys, 0, 10, 1, NULL, 8, sum_range, sum_combine, NULL));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+TEST(threads_parallel_test, nested_loops) {
+  job_system sys = job_system_create(3, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  nested_state state = {sys, {}};
+  parallel_for(sys, 0, 64, 1, nested_outer, &state);
+  EXPECT_EQ(64U * 1000U, atomic_u64_get(&state.total));
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
+
+// Compares a serial loop with parallel_reduce on a persistent job system.
+// Timings are logged only; they depend on the machine.
+TEST(threads_parallel_test, benchmark_reduce) {
+  job_system sys = job_system_create(0, thread_get_setup());
+  ASSERT_NE(0, job_system_is_valid(sys));
+
+  mem_zero(values, size_of(values));
+  parallel_for(sys, 0, value_count, 0, fill_range, values);
+
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  constexpr u32 bench_rounds = 50;
+  u64 serial_total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (u32 round = 0; round < bench_rounds; ++round) {
+    u64 total = 0;
+    sum_range(0, value_count, &total, values);
+    serial_total += total;
+  }
+  f64 serial_ms = elapsed_ms(start);
+
+  u64 parallel_total = 0;
+  start = std::chrono::steady_clock::now();
+  for (u32 round = 0; round < bench_rounds; ++round) {
+    u64 total = 0;
+    parallel_reduce(sys, 0, value_count, 0, &total, size_of(total), sum_range, sum_combine, values);
+    parallel_total += total;
+  }
+  f64 parallel_ms = elapsed_ms(start);
+
+  EXPECT_EQ(serial_total, parallel_total);
+  thread_log_info("parallel_reduce bench rounds=%u count=%llu workers=%u: serial=%.2fms parallel=%.2fms",
+                  bench_rounds,
+                  static_cast<unsigned long long>(value_count),
+                  job_system_get_worker_count(sys),
+                  serial_ms,
+                  parallel_ms);
+
+  EXPECT_NE(0, job_system_destroy(sys));
+}
@@ -3,6 +3,8 @@
 
 #include "test_common.hpp"
 
+#include <chrono>
+
 namespace {
 
   typedef struct rwlock_writer_ctx {
@@ -22,6 +24,113 @@ namespace {
     return 0;
   }
 
+  constexpr u32 consistency_threads = 4;
+  constexpr u32 consistency_writes = 2000;
+
+  // Writers keep both fields equal; readers must never observe them apart.
+  struct sharded_table_ctx {
+    rwlock_sharded lock;
+    u64 first;
+    u64 second;
+    atomic_u32 writer_done;
+    atomic_u32 torn_reads;
+  };
+
+  i32 sharded_table_entry(u32 idx, void* arg) {
+    sharded_table_ctx* ctx = static_cast<sharded_table_ctx*>(arg);
+    if (idx == 0) {
+      for (u32 iter = 0; iter < consistency_writes; ++iter) {
+        rwlock_sharded_write_lock(&ctx->lock);
+        ctx->first += 1;
+        ctx->second += 1;
+        rwlock_sharded_write_unlock(&ctx->lock);
+      }
+      atomic_u32_set(&ctx->writer_done, 1);
+      return 0;
+    }
+
+    while (atomic_u32_get(&ctx->writer_done) == 0) {
+      rwlock_sharded_read_lock(&ctx->lock);
+      if (ctx->first != ctx->second) {
+        atomic_u32_add(&ctx->torn_reads, 1);
+      }
+      rwlock_sharded_read_unlock(&ctx->lock);
+    }
+    return 0;
+  }
+
+  struct seq_snapshot {
+    u64 values[4];
+  };
+
+  struct seqlock_table_ctx {
+    seqlock lock;
+    seq_snapshot shared;
+    atomic_u32 writer_done;
+    atomic_u32 torn_reads;
+  };
+
+  i32 seqlock_table_entry(u32 idx, void* arg) {
+    seqlock_table_ctx* ctx = static_cast<seqlock_table_ctx*>(arg);
+    if (idx == 0) {
+      seq_snapshot next = {};
+      for (u32 iter = 1; iter <= consistency_writes; ++iter) {
+        for (u64& value : next.values) {
+          value = iter;
+        }
+        seqlock_write(&ctx->lock, &ctx->shared, &next, size_of(next));
+      }
+      atomic_u32_set(&ctx->writer_done, 1);
+      return 0;
+    }
+
+    while (atomic_u32_get(&ctx->writer_done) == 0) {
+      seq_snapshot copy = {};
+      seqlock_read(&ctx->lock, &copy, &ctx->shared, size_of(copy));
+      for (u64 value : copy.values) {
+        if (value != copy.values[0]) {
+          atomic_u32_add(&ctx->torn_reads, 1);
+          break;
+        }
+      }
+    }
+    return 0;
+  }
+
+  constexpr u32 bench_reads = 200000;
+
+  struct read_bench_ctx {
+    rwlock plain;
+    rwlock_sharded sharded;
+    seqlock seq;
+    u64 value;
+    u32 variant;
+    atomic_u64 checksum;
+  };
+
+  i32 read_bench_entry(u32 idx, void* arg) {
+    (void)idx;
+    read_bench_ctx* ctx = static_cast<read_bench_ctx*>(arg);
+    u64 sum = 0;
+    for (u32 iter = 0; iter < bench_reads; ++iter) {
+      if (ctx->variant == 0) {
+        rwlock_read_lock(ctx->plain);
+        sum += ctx->value;
+        rwlock_read_unlock(ctx->plain);
+      } else if (ctx->variant == 1) {
+        rwlock_sharded_read_lock(&ctx->sharded);
+        sum += ctx->value;
+        rwlock_sharded_read_unlock(&ctx->sharded);
+      } else {
+        u64 value = 0;
+        seqlock_read(&ctx->seq, &value, &ctx->value, size_of(value));
+        sum += value;
+      }
+    }
+    atomic_u64_add(&ctx->checksum, sum);
+    return 0;
+  }
+
 }  // namespace
 
 TEST(threads_rwlock_test, create_destroy) {
@@ -163,3 +272,113 @@ TEST(threads_rwlock_test, writer_excludes_reader) {
 
   EXPECT_NE(0, rwlock_destroy(lock));
 }
+
+TEST(threads_rwlock_test, sharded_zeroed_lock_unlock) {
+  rwlock_sharded lock = {};
+
+  rwlock_sharded_read_lock(&lock);
+  rwlock_sharded_read_lock(&lock);
+  EXPECT_NE(0, rwlock_sharded_try_read_lock(&lock));
+  rwlock_sharded_read_unlock(&lock);
+  rwlock_sharded_read_unlock(&lock);
+  rwlock_sharded_read_unlock(&lock);
+
+  rwlock_sharded_write_lock(&lock);
+  EXPECT_EQ(0, rwlock_sharded_try_read_lock(&lock));
+  rwlock_sharded_write_unlock(&lock);
+
+  EXPECT_NE(0, rwlock_sharded_try_read_lock(&lock));
+  rwlock_sharded_read_unlock(&lock);
+}
+
+TEST(threads_rwlock_test, sharded_readers_see_consistent_writes) {
+  sharded_table_ctx ctx = {};
+  thread_group group = thread_group_create(consistency_threads, sharded_table_entry, &ctx, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  EXPECT_NE(0, thread_group_join_all(group, NULL));
+  EXPECT_NE(0, thread_group_destroy(group));
+
+  EXPECT_EQ(0U, atomic_u32_get(&ctx.torn_reads));
+  EXPECT_EQ(static_cast<u64>(consistency_writes), ctx.first);
+  EXPECT_EQ(ctx.first, ctx.second);
+}
+
+TEST(threads_rwlock_test, seqlock_read_write) {
+  seqlock lock = {};
+  u64 shared = 7;
+  u64 copy = 0;
+
+  seqlock_read(&lock, &copy, &shared, size_of(copy));
+  EXPECT_EQ(7U, copy);
+
+  u32 seq = seqlock_read_begin(&lock);
+  EXPECT_EQ(0, seqlock_read_retry(&lock, seq));
+
+  u64 next = 11;
+  seqlock_write(&lock, &shared, &next, size_of(next));
+  EXPECT_NE(0, seqlock_read_retry(&lock, seq));
+  EXPECT_EQ(11U, shared);
+
+  seq = seqlock_read_begin(&lock);
+  copy = shared;
+  EXPECT_EQ(0, seqlock_read_retry(&lock, seq));
+  EXPECT_EQ(11U, copy);
+}
+
+TEST(threads_rwlock_test, seqlock_readers_see_consistent_writes) {
+  seqlock_table_ctx ctx = {};
+  thread_group group = thread_group_create(consistency_threads, seqlock_table_entry, &ctx, thread_get_setup());
+  ASSERT_NE(0, thread_group_is_valid(group));
+  EXPECT_NE(0, thread_group_join_all(group, NULL));
+  EXPECT_NE(0, thread_group_destroy(group));
+
+  EXPECT_EQ(0U, atomic_u32_get(&ctx.torn_reads));
+  for (u64 value : ctx.shared.values) {
+    EXPECT_EQ(static_cast<u64>(consistency_writes), value);
+  }
+}
+
+// Compares read-side throughput of rwlock, rwlock_sharded and seqlock as
+// reader threads are added. Timings are logged only; they depend on the machine.
+TEST(threads_rwlock_test, benchmark_read_scaling) {
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  char const* variant_names[] = {"rwlock", "sharded", "seqlock"};
+  ctx_setup setup = thread_get_setup();
+
+  read_bench_ctx* ctx = new read_bench_ctx{};
+  ctx->plain = rwlock_create();
+  ASSERT_NE(0, rwlock_is_valid(ctx->plain));
+  ctx->value = 3;
+
+  for (u32 thread_count = 1; thread_count <= 8; thread_count *= 2) {
+    f64 timings[3] = {};
+    for (u32 variant = 0; variant < 3; ++variant) {
+      ctx->variant = variant;
+      atomic_u64_set(&ctx->checksum, 0);
+
+      auto start = std::chrono::steady_clock::now();
+      thread_group group = thread_group_create(thread_count, read_bench_entry, ctx, setup);
+      ASSERT_NE(0, thread_group_is_valid(group));
+      thread_group_join_all(group, NULL);
+      thread_group_destroy(group);
+      timings[variant] = elapsed_ms(start);
+
+      EXPECT_EQ(static_cast<u64>(thread_count) * bench_reads * 3U, atomic_u64_get(&ctx->checksum));
+    }
+
+    thread_log_info("rwlock read bench threads=%u x %u: %s=%.2fms %s=%.2fms %s=%.2fms",
+                    thread_count,
+                    bench_reads,
+                    variant_names[0],
+                    timings[0],
+                    variant_names[1],
+                    timings[1],
+                    variant_names[2],
+                    timings[2]);
+  }
+
+  EXPECT_NE(0, rwlock_destroy(ctx->plain));
+  delete ctx;
+}
@@ -3,6 +3,8 @@
 
 #include "test_common.hpp"
 
+#include <chrono>
+
 namespace {
 
   typedef struct spinlock_counter_ctx {
@@ -76,3 +78,158 @@ TEST(threads_spinlock_test, critical_section_protection) {
   EXPECT_EQ(iterations * 2, counter);
   spinlock_destroy(lock);
 }
+
+namespace {
+
+  enum spinlock_kind {
+    SPINLOCK_KIND_HANDLE,
+    SPINLOCK_KIND_TICKET,
+    SPINLOCK_KIND_MCS,
+  };
+
+  struct queue_lock_ctx {
+    spinlock_kind kind;
+    spinlock handle;
+    spinlock_ticket ticket;
+    spinlock_mcs mcs;
+    u32 iterations;
+    u64 counter;
+    // Start gate: workers check in, then wait until go is set so that they all
+    // contend from the first acquisition. The last one to finish stamps end.
+    u32 thread_count;
+    atomic_u32 ready;
+    atomic_u32 go;
+    atomic_u32 done;
+    std::chrono::steady_clock::time_point end;
+  };
+
+  i32 queue_lock_entry(u32 idx, void* arg) {
+    (void)idx;
+    queue_lock_ctx* ctx = static_cast<queue_lock_ctx*>(arg);
+    atomic_u32_add(&ctx->ready, 1);
+    while (atomic_u32_get(&ctx->go) == 0) {
+      thread_yield();
+    }
+    for (u32 iter = 0; iter < ctx->iterations; ++iter) {
+      switch (ctx->kind) {
+        case SPINLOCK_KIND_HANDLE: {
+          spinlock_lock(ctx->handle);
+          ctx->counter += 1;
+          spinlock_unlock(ctx->handle);
+        } break;
+        case SPINLOCK_KIND_TICKET: {
+          spinlock_ticket_lock(&ctx->ticket);
+          ctx->counter += 1;
+          spinlock_ticket_unlock(&ctx->ticket);
+        } break;
+        case SPINLOCK_KIND_MCS: {
+          spinlock_mcs_node node;
+          spinlock_mcs_lock(&ctx->mcs, &node);
+          ctx->counter += 1;
+          spinlock_mcs_unlock(&ctx->mcs, &node);
+        } break;
+      }
+    }
+    if (atomic_u32_add(&ctx->done, 1) + 1 == ctx->thread_count) {
+      ctx->end = std::chrono::steady_clock::now();
+    }
+    return 0;
+  }
+
+  // Runs the lock loop on thread_count threads and returns the final counter.
+  // When out_ms is set it receives the time from releasing the start gate until
+  // the last thread left its loop, which excludes thread creation and joining.
+  u64 run_queue_lock(queue_lock_ctx* ctx, u32 thread_count, f64* out_ms = nullptr) {
+    ctx->counter = 0;
+    ctx->thread_count = thread_count;
+    atomic_u32_set(&ctx->ready, 0);
+    atomic_u32_set(&ctx->go, 0);
+    atomic_u32_set(&ctx->done, 0);
+    thread_group group = thread_group_create(thread_count, queue_lock_entry, ctx, thread_get_setup());
+    if (!thread_group_is_valid(group)) {
+      return 0;
+    }
+    while (atomic_u32_get(&ctx->ready) < thread_count) {
+      thread_yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    atomic_u32_set(&ctx->go, 1);
+    thread_group_join_all(group, NULL);
+    thread_group_destroy(group);
+    if (out_ms) {
+      *out_ms = std::chrono::duration<f64, std::milli>(ctx->end - start).count();
+    }
+    return ctx->counter;
+  }
+
+}  // namespace
+
+TEST(threads_spinlock_test, ticket_zeroed_lock_unlock) {
+  spinlock_ticket lock = {};
+  spinlock_ticket_lock(&lock);
+  EXPECT_EQ(0, spinlock_ticket_try_lock(&lock));
+  spinlock_ticket_unlock(&lock);
+
+  EXPECT_NE(0, spinlock_ticket_try_lock(&lock));
+  spinlock_ticket_unlock(&lock);
+  spinlock_ticket_lock(&lock);
+  spinlock_ticket_unlock(&lock);
+}
+
+TEST(threads_spinlock_test, mcs_zeroed_lock_unlock) {
+  spinlock_mcs lock = {};
+  spinlock_mcs_node owner;
+  spinlock_mcs_node other;
+  spinlock_mcs_lock(&lock, &owner);
+  EXPECT_EQ(0, spinlock_mcs_try_lock(&lock, &other));
+  spinlock_mcs_unlock(&lock, &owner);
+
+  EXPECT_NE(0, spinlock_mcs_try_lock(&lock, &other));
+  spinlock_mcs_unlock(&lock, &other);
+  EXPECT_EQ(NULL, atomic_ptr_get(&lock.tail));
+}
+
+TEST(threads_spinlock_test, queue_locks_protect_counter) {
+  constexpr u32 thread_count = 4;
+  queue_lock_ctx ctx = {};
+  ctx.iterations = 5000;
+
+  ctx.kind = SPINLOCK_KIND_TICKET;
+  EXPECT_EQ(static_cast<u64>(thread_count) * ctx.iterations, run_queue_lock(&ctx, thread_count));
+
+  ctx.kind = SPINLOCK_KIND_MCS;
+  EXPECT_EQ(static_cast<u64>(thread_count) * ctx.iterations, run_queue_lock(&ctx, thread_count));
+}
+
+// Contention benchmark for 2 to 64 threads sharing one lock. Every thread performs
+// the same number of acquisitions once all of them are running, and only that
+// loop is timed. Timings are logged only; they depend on the machine and its
+// core count.
+TEST(threads_spinlock_test, benchmark_contention) {
+  constexpr u32 iterations_per_thread = 8192;
+  constexpr u32 thread_counts[] = {2, 4, 8, 16, 32, 64};
+  constexpr spinlock_kind kinds[] = {SPINLOCK_KIND_HANDLE, SPINLOCK_KIND_TICKET, SPINLOCK_KIND_MCS};
+
+  queue_lock_ctx ctx = {};
+  ctx.handle = spinlock_create();
+  ASSERT_NE(0, spinlock_is_valid(ctx.handle));
+
+  for (u32 thread_count : thread_counts) {
+    f64 elapsed[3] = {};
+    for (u32 kind_idx = 0; kind_idx < 3; ++kind_idx) {
+      ctx.kind = kinds[kind_idx];
+      ctx.iterations = iterations_per_thread;
+      u64 counted = run_queue_lock(&ctx, thread_count, &elapsed[kind_idx]);
+      EXPECT_EQ(static_cast<u64>(iterations_per_thread) * thread_count, counted);
+    }
+
+    thread_log_info("spinlock bench threads=%u acquisitions=%u: spinlock=%.2fms ticket=%.2fms mcs=%.2fms",
+                    thread_count,
+                    iterations_per_thread * thread_count,
+                    elapsed[0],
+                    elapsed[1],
+                    elapsed[2]);
+  }
+
+  spinlock_destroy(ctx.handle);
+}